@@ -0,0 +1,561 @@
+// Copyright (c) 2007-2010  Dalian University of Technology (China).
+// All rights reserved.
+//
+// This file is part of DGAL; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; version 2.1 of the License.
+// See the file LICENSE.LGPL distributed with CGAL.
+//
+// Licensees holding a valid commercial license may use this file in
+// accordance with the commercial license agreement provided with the software.
+//
+// This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+// WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// $URL: http://jjcao1231.googlepages.com $
+// $Id: Array_subdivision.h 2026-10-17 $
+//
+//
+// Author(s)     : JJCAO <jjcao@hotmail.com>
+
+/** @file Array_subdivision.h
+ * Loop, Catmull-Clark and modified Butterfly subdivision over flat index
+ * buffers. Same stencils as Polyhedron_subdivision_rules.h, but no halfedge
+ * is created: each level builds an edge table (the edge-point of edge e is
+ * vertex nv+e of the next level, the face-point of facet f is nv+ne+f),
+ * evaluates the stencils in parallel over vertices, edges and facets, and
+ * writes the refined facets directly. k levels only swap two Array_mesh.
+ *
+ *   DGAL::Array_mesh mesh;
+ *   mesh.read_polyhedron(poly);
+ *   DGAL::Array_subdivision::Loop_subdivision(mesh, 4);
+ *   mesh.write_polyhedron(poly);
+*/
+
+#ifndef DGAL_ARRAY_SUBDIVISION_H
+#define DGAL_ARRAY_SUBDIVISION_H
+
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <DGAL/config.h>
+#include <DGAL/Polyhedron_memory_builder.h>
+
+DGAL_BEGIN_NAMESPACE
+
+// ======================================================================
+/// A polygonal mesh as flat buffers: xyz of the vertices, and the vertex
+/// indices of facet f in facet_vertex[facet_start[f]..facet_start[f+1]).
+struct Array_mesh {
+  std::vector<double> points;
+  std::vector<int>    facet_start;
+  std::vector<int>    facet_vertex;
+
+  Array_mesh() : facet_start(1, 0) {}
+
+  int size_of_vertices() const { return int(points.size()/3); }
+  int size_of_facets() const { return int(facet_start.size()) - 1; }
+  int facet_size(int f) const { return facet_start[f+1] - facet_start[f]; }
+  bool is_pure_triangle() const {
+    for (int f = 0; f < size_of_facets(); ++f)
+      if (facet_size(f) != 3) return false;
+    return true;
+  }
+  void clear() {
+    points.clear();    facet_vertex.clear();
+    facet_start.assign(1, 0);
+  }
+  void swap(Array_mesh& m) {
+    points.swap(m.points);
+    facet_start.swap(m.facet_start);
+    facet_vertex.swap(m.facet_vertex);
+  }
+
+  /// copy the vertices and the facets of a CGAL polyhedron
+  template <class Polyhedron>
+  void read_polyhedron(const Polyhedron& p) {
+    typedef typename Polyhedron::Vertex_const_iterator Vertex_const_iterator;
+    typedef typename Polyhedron::Facet_const_iterator  Facet_const_iterator;
+    typedef typename Polyhedron::Halfedge_around_facet_const_circulator
+                                            Halfedge_around_facet_const_circulator;
+    clear();
+    std::map<const void*, int> index;
+    points.reserve(3*p.size_of_vertices());
+    int i = 0;
+    for (Vertex_const_iterator vit = p.vertices_begin(); vit != p.vertices_end(); ++vit, ++i) {
+      index[&*vit] = i;
+      points.push_back(CGAL::to_double(vit->point().x()));
+      points.push_back(CGAL::to_double(vit->point().y()));
+      points.push_back(CGAL::to_double(vit->point().z()));
+    }
+    facet_start.reserve(p.size_of_facets()+1);
+    for (Facet_const_iterator fit = p.facets_begin(); fit != p.facets_end(); ++fit) {
+      Halfedge_around_facet_const_circulator hcir = fit->facet_begin();
+      do {
+        facet_vertex.push_back(index[&*hcir->vertex()]);
+      } while (++hcir != fit->facet_begin());
+      facet_start.push_back(int(facet_vertex.size()));
+    }
+  }
+
+  /// rebuild p from the buffers with Polyhedron_memory_builder
+  template <class Polyhedron>
+  void write_polyhedron(Polyhedron& p) const {
+    typedef typename Polyhedron::Traits::Kernel::FT FT;
+    int nv = size_of_vertices(), nf = size_of_facets();
+    std::vector<FT> point_buffer(points.begin(), points.end());
+    std::vector<int> facet_data(facet_vertex.size() + nf);
+    std::vector<int*> facet_buffer(nf);
+    for (int f = 0, k = 0; f < nf; ++f) {
+      facet_buffer[f] = &facet_data[k];
+      facet_data[k++] = facet_size(f);
+      for (int j = facet_start[f]; j < facet_start[f+1]; ++j)
+        facet_data[k++] = facet_vertex[j];
+    }
+    p.clear();
+    Polyhedron_memory_builder<Polyhedron> pb(nv, nv ? &point_buffer[0] : NULL,
+                                             nf, nf ? &facet_buffer[0] : NULL);
+    p.delegate(pb);
+  }
+};
+
+// ======================================================================
+/// Edges and one-rings of an Array_mesh, rebuilt for every level.
+/// Corner c of facet f is the halfedge facet_vertex[c] -> next vertex of f.
+struct Array_mesh_topology {
+  int num_vertex, num_edge;
+  std::vector<int> edge_vertex;   ///< 2 per edge, as in its first facet
+  std::vector<int> edge_facet;    ///< 2 per edge, -1 on the border
+  std::vector<int> edge_opposite; ///< 2 per edge, vertex of the facet across
+                                  ///< the edge (triangles only)
+  std::vector<int> corner_edge;   ///< edge of each corner
+  std::vector<int> corner_facet;
+  std::vector<int> ring_start;    ///< incident edges of vertex v in
+  std::vector<int> ring_edge;     ///< ring_edge[ring_start[v]..ring_start[v+1])
+  std::vector<char> on_border;
+
+  int other_vertex(int e, int v) const {
+    return edge_vertex[2*e] == v ? edge_vertex[2*e+1] : edge_vertex[2*e];
+  }
+  bool is_border_edge(int e) const { return edge_facet[2*e+1] < 0; }
+  int valence(int v) const { return ring_start[v+1] - ring_start[v]; }
+
+  void build(const Array_mesh& m, bool triangles) {
+    num_vertex = m.size_of_vertices();
+    int nf = m.size_of_facets();
+    int nc = int(m.facet_vertex.size());
+    corner_facet.resize(nc);
+    for (int f = 0; f < nf; ++f)
+      for (int c = m.facet_start[f]; c < m.facet_start[f+1]; ++c)
+        corner_facet[c] = f;
+
+    // bucket the halfedges by their smaller vertex, then pair them by the other one
+    std::vector<int> bucket_start(num_vertex+1, 0), bucket(nc), next_vertex(nc);
+    for (int c = 0; c < nc; ++c) {
+      int f = corner_facet[c];
+      int cn = c+1 < m.facet_start[f+1] ? c+1 : m.facet_start[f];
+      next_vertex[c] = m.facet_vertex[cn];
+      ++bucket_start[std::min(m.facet_vertex[c], next_vertex[c])+1];
+    }
+    for (int v = 0; v < num_vertex; ++v) bucket_start[v+1] += bucket_start[v];
+    {
+      std::vector<int> pos(bucket_start.begin(), bucket_start.end()-1);
+      for (int c = 0; c < nc; ++c)
+        bucket[pos[std::min(m.facet_vertex[c], next_vertex[c])]++] = c;
+    }
+    corner_edge.assign(nc, -1);
+    edge_vertex.clear(); edge_facet.clear();
+    edge_vertex.reserve(nc+4); edge_facet.reserve(nc+4);
+    for (int v = 0; v < num_vertex; ++v) {
+      int n = bucket_start[v+1] - bucket_start[v];
+      if (n == 0) continue;
+      int* b = &bucket[0] + bucket_start[v];
+      for (int i = 1; i < n; ++i)   // insertion sort, buckets are small
+        for (int j = i; j > 0 && Max_vertex(m, next_vertex, b[j]) < Max_vertex(m, next_vertex, b[j-1]); --j)
+          std::swap(b[j], b[j-1]);
+      for (int i = 0; i < n; ) {
+        int e = int(edge_facet.size()/2);
+        int c = b[i];
+        edge_vertex.push_back(m.facet_vertex[c]);
+        edge_vertex.push_back(next_vertex[c]);
+        edge_facet.push_back(corner_facet[c]);
+        corner_edge[c] = e;
+        // a manifold edge has at most 2 halfedges, extra ones make new edges
+        if (i+1 < n && Max_vertex(m, next_vertex, b[i+1]) == Max_vertex(m, next_vertex, c)) {
+          edge_facet.push_back(corner_facet[b[i+1]]);
+          corner_edge[b[i+1]] = e;
+          i += 2;
+        } else {
+          edge_facet.push_back(-1);
+          i += 1;
+        }
+      }
+    }
+    num_edge = int(edge_facet.size()/2);
+
+    if (triangles) {
+      edge_opposite.assign(2*num_edge, -1);
+      for (int c = 0; c < nc; ++c) {
+        int f = corner_facet[c], e = corner_edge[c];
+        int s = m.facet_start[f];
+        int third = m.facet_vertex[s + (c-s+2)%3];
+        edge_opposite[2*e + (edge_facet[2*e] == f ? 0 : 1)] = third;
+      }
+    }
+
+    // incident edges of the vertices
+    ring_start.assign(num_vertex+1, 0);
+    for (int e = 0; e < num_edge; ++e) {
+      ++ring_start[edge_vertex[2*e]+1];
+      ++ring_start[edge_vertex[2*e+1]+1];
+    }
+    for (int v = 0; v < num_vertex; ++v) ring_start[v+1] += ring_start[v];
+    ring_edge.resize(ring_start[num_vertex]);
+    std::vector<int> pos(ring_start.begin(), ring_start.end()-1);
+    on_border.assign(num_vertex, 0);
+    for (int e = 0; e < num_edge; ++e) {
+      int v0 = edge_vertex[2*e], v1 = edge_vertex[2*e+1];
+      ring_edge[pos[v0]++] = e;
+      ring_edge[pos[v1]++] = e;
+      if (is_border_edge(e)) on_border[v0] = on_border[v1] = 1;
+    }
+  }
+
+  /// order the ring of an interior vertex of a triangle mesh so that
+  /// ring[j] is the j-th neighbor around v starting from `first`
+  void ordered_ring(int v, int first, std::vector<int>& ring) const {
+    int n = valence(v);
+    ring.resize(n);
+    ring[0] = first;
+    for (int j = 1; j < n; ++j) {
+      // the two facets of the spoke (v,cur) hold the previous and the next neighbors
+      int cur = ring[j-1], prev = j > 1 ? ring[j-2] : -1, next = -1;
+      for (int k = ring_start[v]; k < ring_start[v+1]; ++k) {
+        int e = ring_edge[k];
+        if (other_vertex(e, v) != cur) continue;
+        next = edge_opposite[2*e] != prev ? edge_opposite[2*e] : edge_opposite[2*e+1];
+        break;
+      }
+      ring[j] = next;
+    }
+  }
+
+private:
+  static int Max_vertex(const Array_mesh& m, const std::vector<int>& next_vertex, int c) {
+    return std::max(m.facet_vertex[c], next_vertex[c]);
+  }
+};
+
+// ======================================================================
+///
+class Array_subdivision {
+public:
+  /** Loop subdivision of a triangle mesh, `step` levels.
+      Interior vertices use Loop's weight 5/8 - (3/8 + cos(2pi/n)/4)^2 for
+      the ring (the closed form Loop_rule approximates), border edges and
+      vertices the cubic B-spline rules.
+      Returns false, m unchanged, if m is not a pure triangle mesh. */
+  static bool Loop_subdivision(Array_mesh& m, int step = 1) {
+    if (!m.is_pure_triangle()) return false;
+    Array_mesh next;
+    Array_mesh_topology t;
+    for (int i = 0; i < step; ++i) {
+      t.build(m, true);
+      Loop_points(m, t, next);
+      tri_quadralize(m, t, next);
+      m.swap(next);
+    }
+    return true;
+  }
+
+  /** Modified Butterfly subdivision of a triangle mesh (interpolating),
+      the stencils of Modify_Butterfly_rule: edges touching the border are
+      split at their midpoint, the 10-point stencil between regular vertices,
+      and the irregular stencil (averaged when both ends are irregular).
+      Returns false, m unchanged, if m is not a pure triangle mesh. */
+  static bool Modify_Butterfly_subdivision(Array_mesh& m, int step = 1) {
+    if (!m.is_pure_triangle()) return false;
+    Array_mesh next;
+    Array_mesh_topology t;
+    for (int i = 0; i < step; ++i) {
+      t.build(m, true);
+      Butterfly_points(m, t, next);
+      tri_quadralize(m, t, next);
+      m.swap(next);
+    }
+    return true;
+  }
+
+  /** Catmull-Clark subdivision of a polygonal mesh, the output is made of
+      quads. */
+  static void CatmullClark_subdivision(Array_mesh& m, int step = 1) {
+    Array_mesh next;
+    Array_mesh_topology t;
+    for (int i = 0; i < step; ++i) {
+      t.build(m, false);
+      CatmullClark_points(m, t, next);
+      quad_quadralize(m, t, next);
+      m.swap(next);
+    }
+  }
+
+protected:
+  static void Loop_points(const Array_mesh& m, const Array_mesh_topology& t, Array_mesh& next) {
+    const int nv = t.num_vertex, ne = t.num_edge;
+    const double* P = &m.points[0];
+    next.points.resize(3*(nv+ne));
+    double* Q = &next.points[0];
+
+    #pragma omp parallel for schedule(static)
+    for (int e = 0; e < ne; ++e) {
+      const double* p1 = P + 3*t.edge_vertex[2*e];
+      const double* p2 = P + 3*t.edge_vertex[2*e+1];
+      double* q = Q + 3*(nv+e);
+      if (t.is_border_edge(e)) {
+        for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k])/2;
+      } else {
+        const double* f1 = P + 3*t.edge_opposite[2*e];
+        const double* f2 = P + 3*t.edge_opposite[2*e+1];
+        for (int k = 0; k < 3; ++k) q[k] = (3*(p1[k]+p2[k])+f1[k]+f2[k])/8;
+      }
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < nv; ++v) {
+      const double* S = P + 3*v;
+      double* q = Q + 3*v;
+      double R[] = {0, 0, 0};
+      if (t.on_border[v]) {
+        int nb = 0;
+        for (int k = t.ring_start[v]; k < t.ring_start[v+1]; ++k) {
+          int e = t.ring_edge[k];
+          if (!t.is_border_edge(e)) continue;
+          const double* p = P + 3*t.other_vertex(e, v);
+          R[0] += p[0], R[1] += p[1], R[2] += p[2];
+          ++nb;
+        }
+        if (nb == 2) {
+          for (int k = 0; k < 3; ++k) q[k] = (R[k] + 6*S[k])/8;
+        } else {                     // corner of a non-manifold border
+          for (int k = 0; k < 3; ++k) q[k] = S[k];
+        }
+        continue;
+      }
+      int n = t.valence(v);
+      for (int k = t.ring_start[v]; k < t.ring_start[v+1]; ++k) {
+        const double* p = P + 3*t.other_vertex(t.ring_edge[k], v);
+        R[0] += p[0], R[1] += p[1], R[2] += p[2];
+      }
+      if (n == 6) {
+        for (int k = 0; k < 3; ++k) q[k] = (10*S[k]+R[k])/16;
+      } else {
+        double c = 3.0/8.0 + std::cos(2*3.14159265358979323846/n)/4;
+        double Cn = 5.0/8.0 - c*c;
+        for (int k = 0; k < 3; ++k) q[k] = (1-Cn)*S[k] + Cn*R[k]/n;
+      }
+    }
+  }
+
+  static double Butterfly_param(int n, int i) {
+    if (n == 3) return i == 0 ? 5.0/12.0 : -1.0/12.0;
+    if (n == 4) return i == 0 ? 3.0/8.0 : (i == 2 ? -1.0/8.0 : 0.0);
+    const double pi = 3.14159265358979323846;
+    return (0.25 + std::cos(2*pi*i/n) + 0.5*std::cos(4*pi*i/n))/n;
+  }
+
+  // stencil of an irregular end v of the edge (v,w), false if the ring of v
+  // cannot be ordered (non-manifold neighborhood)
+  static bool Butterfly_irregular(const double* P, const Array_mesh_topology& t, int v, int w,
+                                  std::vector<int>& ring, double* q) {
+    t.ordered_ring(v, w, ring);
+    int n = int(ring.size());
+    for (int j = 0; j < n; ++j)
+      if (ring[j] < 0) return false;
+    for (int k = 0; k < 3; ++k) q[k] = 0.75*P[3*v+k];
+    for (int j = 0; j < n; ++j) {
+      double a = Butterfly_param(n, j);
+      for (int k = 0; k < 3; ++k) q[k] += a*P[3*ring[j]+k];
+    }
+    return true;
+  }
+
+  // vertex across the edge (a,b) from the facet containing c, -1 if the edge
+  // is missing or on the border (non-manifold neighborhood)
+  static int Wing(const Array_mesh_topology& t, int a, int b, int c) {
+    for (int k = t.ring_start[a]; k < t.ring_start[a+1]; ++k) {
+      int e = t.ring_edge[k];
+      if (t.other_vertex(e, a) != b) continue;
+      return t.edge_opposite[2*e] == c ? t.edge_opposite[2*e+1] : t.edge_opposite[2*e];
+    }
+    return -1;
+  }
+
+  static void Butterfly_points(const Array_mesh& m, const Array_mesh_topology& t, Array_mesh& next) {
+    const int nv = t.num_vertex, ne = t.num_edge;
+    const double* P = &m.points[0];
+    next.points.resize(3*(nv+ne));
+    double* Q = &next.points[0];
+    std::copy(P, P+3*nv, Q);
+
+    #pragma omp parallel
+    {
+      std::vector<int> ring;
+      #pragma omp for schedule(static)
+      for (int e = 0; e < ne; ++e) {
+        int v1 = t.edge_vertex[2*e], v2 = t.edge_vertex[2*e+1];
+        const double* p1 = P + 3*v1;
+        const double* p2 = P + 3*v2;
+        double* q = Q + 3*(nv+e);
+        if (t.on_border[v1] || t.on_border[v2]) {
+          for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k])/2;
+          continue;
+        }
+        int n1 = t.valence(v1), n2 = t.valence(v2);
+        if (n1 == 6 && n2 == 6) {
+          int f1 = t.edge_opposite[2*e], f2 = t.edge_opposite[2*e+1];
+          int w[] = { Wing(t, v1, f1, v2), Wing(t, v2, f1, v1),
+                      Wing(t, v1, f2, v2), Wing(t, v2, f2, v1) };
+          if (w[0] < 0 || w[1] < 0 || w[2] < 0 || w[3] < 0) {
+            // incomplete 10-point stencil: midpoint rule, as on the border
+            for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k])/2;
+            continue;
+          }
+          for (int k = 0; k < 3; ++k)
+            q[k] = (p1[k]+p2[k])/2 + (P[3*f1+k]+P[3*f2+k])/8
+                 - (P[3*w[0]+k]+P[3*w[1]+k]+P[3*w[2]+k]+P[3*w[3]+k])/16;
+        } else if (n1 != 6 && n2 == 6) {
+          if (!Butterfly_irregular(P, t, v1, v2, ring, q))
+            for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k])/2;
+        } else if (n1 == 6) {
+          if (!Butterfly_irregular(P, t, v2, v1, ring, q))
+            for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k])/2;
+        } else {
+          double q2[3];
+          if (Butterfly_irregular(P, t, v1, v2, ring, q) &&
+              Butterfly_irregular(P, t, v2, v1, ring, q2)) {
+            for (int k = 0; k < 3; ++k) q[k] = (q[k]+q2[k])/2;
+          } else {
+            for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k])/2;
+          }
+        }
+      }
+    }
+  }
+
+  static void CatmullClark_points(const Array_mesh& m, const Array_mesh_topology& t, Array_mesh& next) {
+    const int nv = t.num_vertex, ne = t.num_edge, nf = m.size_of_facets();
+    const double* P = &m.points[0];
+    next.points.resize(3*(nv+ne+nf));
+    double* Q = &next.points[0];
+    double* F = Q + 3*(nv+ne);
+
+    #pragma omp parallel for schedule(static)
+    for (int f = 0; f < nf; ++f) {
+      double p[] = {0, 0, 0};
+      for (int c = m.facet_start[f]; c < m.facet_start[f+1]; ++c)
+        for (int k = 0; k < 3; ++k) p[k] += P[3*m.facet_vertex[c]+k];
+      int n = m.facet_size(f);
+      for (int k = 0; k < 3; ++k) F[3*f+k] = p[k]/n;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int e = 0; e < ne; ++e) {
+      const double* p1 = P + 3*t.edge_vertex[2*e];
+      const double* p2 = P + 3*t.edge_vertex[2*e+1];
+      double* q = Q + 3*(nv+e);
+      if (t.is_border_edge(e)) {
+        for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k])/2;
+      } else {
+        const double* f1 = F + 3*t.edge_facet[2*e];
+        const double* f2 = F + 3*t.edge_facet[2*e+1];
+        for (int k = 0; k < 3; ++k) q[k] = (p1[k]+p2[k]+f1[k]+f2[k])/4;
+      }
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < nv; ++v) {
+      const double* S = P + 3*v;
+      double* q = Q + 3*v;
+      double R[] = {0, 0, 0}, Qf[] = {0, 0, 0};
+      if (t.on_border[v]) {
+        int nb = 0;
+        for (int k = t.ring_start[v]; k < t.ring_start[v+1]; ++k) {
+          int e = t.ring_edge[k];
+          if (!t.is_border_edge(e)) continue;
+          const double* p = P + 3*t.other_vertex(e, v);
+          R[0] += p[0], R[1] += p[1], R[2] += p[2];
+          ++nb;
+        }
+        if (nb == 2) {
+          for (int k = 0; k < 3; ++k) q[k] = (R[k] + 6*S[k])/8;
+        } else {
+          for (int k = 0; k < 3; ++k) q[k] = S[k];
+        }
+        continue;
+      }
+      // an interior vertex has as many facets as edges, each facet being
+      // shared by two of its edges
+      int n = t.valence(v);
+      for (int k = t.ring_start[v]; k < t.ring_start[v+1]; ++k) {
+        int e = t.ring_edge[k];
+        const double* p = P + 3*t.other_vertex(e, v);
+        const double* f1 = F + 3*t.edge_facet[2*e];
+        const double* f2 = F + 3*t.edge_facet[2*e+1];
+        for (int j = 0; j < 3; ++j) {
+          R[j] += (S[j]+p[j])/2;
+          Qf[j] += (f1[j]+f2[j])/2;
+        }
+      }
+      for (int k = 0; k < 3; ++k)
+        q[k] = (Qf[k]/n + 2*R[k]/n + S[k]*(n-3))/n;
+    }
+  }
+
+  // (a,b,c) -> (a,ab,ca) (b,bc,ab) (c,ca,bc) (ab,bc,ca), false if m has a
+  // facet which is not a triangle
+  static bool tri_quadralize(const Array_mesh& m, const Array_mesh_topology& t, Array_mesh& next) {
+    if (!m.is_pure_triangle()) return false;
+    const int nv = t.num_vertex, nf = m.size_of_facets();
+    next.facet_start.resize(4*nf+1);
+    next.facet_vertex.resize(12*nf);
+    #pragma omp parallel for schedule(static)
+    for (int f = 0; f < nf; ++f) {
+      int c = m.facet_start[f];
+      int a = m.facet_vertex[c], b = m.facet_vertex[c+1], d = m.facet_vertex[c+2];
+      int ab = nv + t.corner_edge[c], bd = nv + t.corner_edge[c+1], da = nv + t.corner_edge[c+2];
+      int* fv = &next.facet_vertex[12*f];
+      fv[0] = a;   fv[1] = ab;  fv[2] = da;
+      fv[3] = b;   fv[4] = bd;  fv[5] = ab;
+      fv[6] = d;   fv[7] = da;  fv[8] = bd;
+      fv[9] = ab;  fv[10] = bd; fv[11] = da;
+    }
+    for (int f = 0; f <= 4*nf; ++f) next.facet_start[f] = 3*f;
+    return true;
+  }
+
+  // a facet of n vertices -> n quads (v_k, e_k, face point, e_k-1)
+  static void quad_quadralize(const Array_mesh& m, const Array_mesh_topology& t, Array_mesh& next) {
+    const int nv = t.num_vertex, ne = t.num_edge, nf = m.size_of_facets();
+    const int nc = int(m.facet_vertex.size());
+    next.facet_start.resize(nc+1);
+    next.facet_vertex.resize(4*nc);
+    #pragma omp parallel for schedule(static)
+    for (int f = 0; f < nf; ++f) {
+      int s = m.facet_start[f], n = m.facet_size(f);
+      for (int k = 0; k < n; ++k) {
+        int c = s+k, cp = s + (k+n-1)%n;
+        int* fv = &next.facet_vertex[4*c];
+        fv[0] = m.facet_vertex[c];
+        fv[1] = nv + t.corner_edge[c];
+        fv[2] = nv + ne + f;
+        fv[3] = nv + t.corner_edge[cp];
+      }
+    }
+    for (int c = 0; c <= nc; ++c) next.facet_start[c] = 4*c;
+  }
+};
+
+DGAL_END_NAMESPACE
+
+#endif // DGAL_ARRAY_SUBDIVISION_H
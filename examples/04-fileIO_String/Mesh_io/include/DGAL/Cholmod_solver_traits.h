@@ -240,6 +240,8 @@ std::cout << "cholmod_solve: " << timer.time() << " seconds." << std::endl;
 	void matrix(cholmod_sparse* matrix){m_At = matrix;}
 	cholmod_factor* factor(){return m_L;}
 	cholmod_sparse* matrix(){return m_At;}
+	/// free the matrix and the factorization owned by the solver
+	void clear(){release_precomputation();}
 
 	// -- private operations -----------------------
 private:
@@ -12,7 +12,6 @@ using std::endl;
 using namespace GW;
 
 DGAL_BEGIN_NAMESPACE
-void* fb_instance;
 
 /// Compute a geodesic distance field from specified vertices. 
 template<
@@ -63,15 +62,18 @@ public:
 			start_vertices_id.push_back( (*it)->index());		
 		}
 		
-		// for using memeber function as callback, I've to set all member variables used in callback to self, but not this
-		Self* self = (Self*)fb_instance;
+		// the callbacks are static, they get this builder back as their context
 		int nverts = m_geo_mesh->GetNbrVertex();
-		self->m_nbr_iter = 0;
-		self->m_niter_max = std::numeric_limits<int>::max();
-		self->m_niter_max = std::min(self->m_niter_max, int(1.2*nverts));
+		m_nbr_iter = 0;
+		m_niter_max = std::numeric_limits<int>::max();
+		m_niter_max = std::min(m_niter_max, int(1.2*nverts));
 
-		if(self->m_weight.empty())
-			self->m_weight.insert(self->m_weight.begin(), nverts, 1.0);
+		if(m_weight.empty())
+			m_weight.insert(m_weight.begin(), nverts, 1.0);
+		m_is_end_vertex.assign(nverts, false);
+		for(std::vector<int>::iterator it = m_end_vertices_id.begin(); it!=m_end_vertices_id.end();++it)
+			if( *it>=0 && *it<nverts )
+				m_is_end_vertex[*it] = true;
 
 		// set up fast marching		
 		m_geo_mesh->ResetGeodesicMesh();
@@ -82,12 +84,12 @@ public:
 			m_geo_mesh->AddStartVertex( *v );
 		}
 		m_geo_mesh->SetUpFastMarching();
-		m_geo_mesh->RegisterWeightCallbackFunction( WeightCallback );
-		m_geo_mesh->RegisterForceStopCallbackFunction( StopMarchingCallback );
-		m_geo_mesh->RegisterVertexInsersionCallbackFunction( InsersionCallback );
+		m_geo_mesh->RegisterWeightCallbackFunction( WeightCallback, this );
+		m_geo_mesh->RegisterForceStopCallbackFunction( StopMarchingCallback, this );
+		m_geo_mesh->RegisterVertexInsersionCallbackFunction( InsersionCallback, this );
 
-		if( !self->m_H.empty() )
-			m_geo_mesh->RegisterHeuristicToGoalCallbackFunction( HeuristicCallback );
+		if( !m_H.empty() )
+			m_geo_mesh->RegisterHeuristicToGoalCallbackFunction( HeuristicCallback, this );
 			
 		// initialize the distance of the starting points
 		
@@ -154,28 +156,24 @@ public:
 	void* matrix(){return 0;}
 	void* factor(){return 0;}
 private:
-	static GW_Float WeightCallback(GW_GeodesicVertex& Vert)
+	static GW_Float WeightCallback(GW_GeodesicVertex& Vert, void* pContext)
 	{
-		Self* self = (Self*)fb_instance;
+		Self* self = (Self*)pContext;
 		GW_U32 i = Vert.GetID();
 		return self->m_weight[i];
 	}
-	static GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert )
+	static GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert, void* pContext )
 	{
-		Self* self = (Self*)fb_instance;
+		Self* self = (Self*)pContext;
 		// check if the end point has been reached
 		GW_U32 i = Vert.GetID();
 		if( Vert.GetDistance()>self->m_dist_max )
 			return true;
-			
-		for(std::vector<int>::iterator it = self->m_end_vertices_id.begin(); it!=self->m_end_vertices_id.end();++it)
-			if( *it==i )
-				return true;
-		return false;
+		return self->m_is_end_vertex[i];
 	}
-	static GW_Bool InsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist )
+	static GW_Bool InsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist, void* pContext )
 	{
-		Self* self = (Self*)fb_instance;
+		Self* self = (Self*)pContext;
 		// check if the distance of the new point is less than the given distance
 		GW_U32 i = Vert.GetID();
 		bool doinsersion = self->m_nbr_iter <= self->m_niter_max;
@@ -184,9 +182,9 @@ private:
 		++(self->m_nbr_iter);
 		return doinsersion;
 	}
-	static GW_Float HeuristicCallback( GW_GeodesicVertex& Vert )
+	static GW_Float HeuristicCallback( GW_GeodesicVertex& Vert, void* pContext )
 	{
-		Self* self = (Self*)fb_instance;
+		Self* self = (Self*)pContext;
 		// return the heuristic distance
 		GW_U32 i = Vert.GetID();
 		return self->m_H[i];
@@ -231,8 +229,7 @@ private:
 		m_mesh = mesh;
 	}
 	void set_end_vertices(std::vector<int>& in){
-		Self* self = (Self*)fb_instance;
-		self->m_end_vertices_id = in;
+		m_end_vertices_id = in;
 	}
 	Polyhedron* m_mesh;//just a reference, do not new and del in this class
 	GW_GeodesicMesh *m_geo_mesh;
@@ -241,6 +238,7 @@ private:
 	double m_dist_max;// max distance
 	std::vector<double> m_weight;	// weight,provide non-uniform speed for each vertex.
 	std::vector<int> m_end_vertices_id; //stop when these points are reached
+	std::vector<bool> m_is_end_vertex; //m_end_vertices_id as a bitmap, built by compute
 	std::vector<double> m_H;	// heuristic(typically that try to guess the distance 
 	//that remains from a given node to a given target). This is an array of same size as m_weight.
 	std::vector<double> m_L;	// reduce the set of explored points. 
@@ -5,6 +5,7 @@
 #include <DGAL/Polyhedron_3.h>
 #include <DGAL/Cholmod_solver_traits.h>
 #include <DGAL/Weight_strategy.h>
+#include <DGAL/Laplacian_operator.h>
 #include <DGAL/Border_parameterizer.h>
 DGAL_BEGIN_NAMESPACE
 
@@ -24,6 +25,7 @@ public:
 	typedef typename Solver::Vector     Vector;	
 	typedef typename Polyhedron::Vertex              Vertex;
 	typedef typename Polyhedron::Vertex_handle       Vertex_handle;
+	typedef Laplacian_operator<Polyhedron, Weight_strategy, Solver> Operator;
 	struct Set_row
 	{
 		Set_row(Weight_strategy& ws,Matrix* matrix):matrix(matrix),ws(ws){}
@@ -42,9 +44,10 @@ public:
 		Matrix* matrix;
 	};
 public:
-	Laplacian_kernel():m_matrix(0){}
+	Laplacian_kernel():m_matrix(0),m_use_operator(false){}
 	virtual ~Laplacian_kernel(){
 		if(m_matrix) delete m_matrix;
+		detach_operator();
 	}
 	template<class Const_iterator>
 	void compute_laplacian_matrix(Polyhedron* mesh, Const_iterator first, Const_iterator last)
@@ -55,6 +58,7 @@ public:
 		//////////////////////////////////////////////////////////////////////////
 		if (m_matrix)
 			delete m_matrix;
+		detach_operator();
 
 #ifdef OUTPUT_INFO
 		CGAL::Timer timer;	timer.start();
@@ -75,17 +79,69 @@ public:
 		timer.reset();
 #endif
 	}
+	/// Same system as compute_laplacian_matrix, through the cached operator:
+	/// the weights are evaluated only the first time a mesh is seen, and the
+	/// factorization is kept while the constraints do not change, so
+	/// solving for a new right hand side is only a back-substitution.
+	/// Moving the vertices rebuilds the operator; call
+	/// clear_laplacian_operator() after changing the weight strategy.
+	template<class Const_iterator>
+	bool compute_laplacian_operator(Polyhedron* mesh, Const_iterator first, Const_iterator last)
+	{
+		const int tag_free = 0;
+		const int tag_done = 1;
+
+		detach_operator();
+		// a factorization left by compute_laplacian_matrix is the solver's own
+		m_solver.clear();
+#ifdef OUTPUT_INFO
+		CGAL::Timer timer;	timer.start();
+#endif
+		if (!m_operator.is_init(mesh) && !m_operator.init(mesh, m_weight_strategy))
+			return false;
+		m_constraints.clear();
+		std::copy(first,last, std::back_inserter(m_constraints));
+
+		mesh->tag_vertices(tag_free);
+		std::for_each(m_constraints.begin(),m_constraints.end(),Polyhedron::Set_tag(tag_done));
+
+		if (!m_operator.set_constraints(m_constraints.begin(), m_constraints.end()))
+			return false;
+#ifdef OUTPUT_INFO
+		std::cout << "operator setup: " << timer.time() << " seconds." << std::endl;
+#endif
+		// the solver only borrows them, see detach_operator()
+		m_solver.matrix(m_operator.matrix());
+		m_solver.factor(m_operator.factor());
+		m_use_operator = true;
+		return true;
+	}
+	void clear_laplacian_operator(){
+		detach_operator();
+		m_operator.clear();
+	}
 	//void set_constraints(){}
 	void factor(cholmod_factor* factor){m_solver.factor(factor);}
 	void matrix(cholmod_sparse* matrix){m_solver.matrix(matrix);}
 	cholmod_factor* factor(){return m_solver.factor();}
 	cholmod_sparse* matrix(){return m_solver.matrix();}
 	Weight_strategy& weight_strategy(){return m_weight_strategy;}
+	Operator& laplacian_operator(){return m_operator;}
 
 protected:
+	/// give the operator's matrix and factor back before the solver frees them
+	void detach_operator(){
+		if (!m_use_operator) return;
+		m_solver.matrix(0);
+		m_solver.factor(0);
+		m_use_operator = false;
+	}
+
 	Weight_strategy m_weight_strategy;
 	Matrix* m_matrix;
 	std::list<Vertex_handle> m_constraints;
+	Operator m_operator;
+	bool m_use_operator;
 	Solver m_solver;
 };
 
@@ -128,6 +184,8 @@ public:
 	{
 		if(factor) 
 			return m_solver.solve(B, X, factor);
+		else if(m_use_operator)
+			return m_solver.solve(B, X);
 		else
 			return m_solver.linear_solver(*m_matrix, B, X, factor);
 	}
@@ -166,8 +224,17 @@ public:
 		Dense_matrix& x;
 	};
 
+	/// Repeated calls on the same mesh reuse the weights and the factorization.
+	/// A factor handed in through factor(cholmod_factor*) is used as is.
 	bool parameterize(Polyhedron* mesh, Vertex_handle v1 = NULL){
-		compute_laplacian_matrix(mesh, mesh->main_border_begin(), mesh->main_border_end());
+		bool external = m_solver.has_precomputed() && !m_use_operator;
+		if (external)
+			compute_laplacian_matrix(mesh, mesh->main_border_begin(), mesh->main_border_end());
+		else if (!compute_laplacian_operator(mesh, mesh->main_border_begin(), mesh->main_border_end()))
+		{
+			std::cout << "factorization failed!" << std::endl;
+			return false;
+		}
 
 		Border_strategy bs;
 		bs.parameterize_border(mesh->main_border_begin(), mesh->main_border_end(),v1);
@@ -178,7 +245,7 @@ public:
 		std::for_each(mesh->main_border_begin(), mesh->main_border_end(),Set_uv2matrix(b));
 
 		// solve
-		if(!m_solver.linear_solver(*m_matrix,b,x))
+		if(external ? !m_solver.linear_solver(*m_matrix,b,x) : !m_solver.solve(b,x))
 		{
 			std::cout << "solved failed!" << std::endl;
 			return false;
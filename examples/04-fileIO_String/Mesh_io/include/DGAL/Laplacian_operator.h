@@ -0,0 +1,222 @@
+#ifndef DGAL_LAPLACIAN_OPERATOR__H__
+#define DGAL_LAPLACIAN_OPERATOR__H__
+
+#include <vector>
+#include <algorithm>
+#include <DGAL/config.h>
+#include <DGAL/Cholmod_solver_traits.h>
+
+DGAL_BEGIN_NAMESPACE
+
+/// Laplacian operator of one mesh, cached for repeated solves.
+///
+/// The free row of every vertex is evaluated once by Weight_strategy and kept
+/// in compressed form, together with a cholmod matrix whose pattern holds the
+/// free rows and the diagonal. Constraining a vertex only rewrites the values
+/// of its row (1 on the diagonal, explicit 0 elsewhere), so the pattern and
+/// the symbolic analysis never change: a new constraint set costs a numeric
+/// factorization, the same constraint set costs nothing, and every field
+/// after that is a back-substitution.
+///
+/// As Cholmod_solver_traits does for a general matrix, matrix() is A' and
+/// factor() is the factor of A'A, so both can be handed to a solver through
+/// its matrix(cholmod_sparse*) and factor(cholmod_factor*) hooks.
+///
+/// The weights depend on the geometry: init() keeps a copy of the vertex
+/// positions and is_init() compares it with the mesh, so moving a vertex
+/// rebuilds the operator. Call clear() after changing the weight strategy.
+template<
+	class Polyhedron_3,
+	class Weight_strategy,
+	class Solver
+>
+class Laplacian_operator
+{
+public:
+	typedef Polyhedron_3                             Polyhedron;
+	typedef typename Polyhedron::Vertex_handle       Vertex_handle;
+	typedef typename Polyhedron::Vertex_iterator     Vertex_iterator;
+	typedef typename Polyhedron::Vertex_const_iterator Vertex_const_iterator;
+	typedef typename Solver::Matrix                  Matrix;
+	typedef typename Matrix::Coordinate_const_iterator Coordinate_const_iterator;
+
+public:
+	Laplacian_operator():m_mesh(0),m_nv(0),m_nh(0),m_At(0),m_L(0),m_factorized(false)
+	{
+		cholmod_start(&m_cholmod_common);
+	}
+	virtual ~Laplacian_operator()
+	{
+		clear();
+		cholmod_finish(&m_cholmod_common);
+	}
+
+	/// Is the operator built for this mesh, with the same connectivity size
+	/// and the same vertex positions?
+	bool is_init(Polyhedron* mesh) const
+	{
+		if (m_At==0 || mesh!=m_mesh || int(mesh->size_of_vertices())!=m_nv
+			|| mesh->size_of_halfedges()!=m_nh)
+			return false;
+		std::vector<double>::const_iterator p = m_points.begin();
+		for (Vertex_const_iterator it = mesh->vertices_begin(); it != mesh->vertices_end(); ++it)
+		{
+			if (*p++ != CGAL::to_double(it->point().x())) return false;
+			if (*p++ != CGAL::to_double(it->point().y())) return false;
+			if (*p++ != CGAL::to_double(it->point().z())) return false;
+		}
+		return true;
+	}
+	/// Evaluate the weights of all the vertices and analyze the pattern.
+	/// Vertices are expected to be indexed from 0 to size_of_vertices()-1.
+	bool init(Polyhedron* mesh, Weight_strategy& ws)
+	{
+		clear();
+		m_nv = int(mesh->size_of_vertices());
+		if (m_nv<1) return false;
+
+		// free rows, with duplicate entries
+		Matrix free_rows(m_nv);
+		for (Vertex_iterator it = mesh->vertices_begin(); it != mesh->vertices_end(); ++it)
+		{
+			Vertex_handle vh = it;
+			ws.set_row(vh, &free_rows);
+		}
+
+		// bucket the entries by row, then sort and merge each row
+		m_row_start.assign(m_nv+1, 0);
+		for (Coordinate_const_iterator it = free_rows.coords_begin(); it != free_rows.coords_end(); ++it)
+			++m_row_start[it->i+1];
+		for (int i = 0; i < m_nv; ++i)
+			m_row_start[i+1] += m_row_start[i]+1;// room for the diagonal
+		std::vector<Entry> entries(m_row_start[m_nv]);
+		std::vector<int> fill(m_row_start.begin(), m_row_start.end()-1);
+		for (int i = 0; i < m_nv; ++i)
+			entries[fill[i]++] = Entry(i, 0);
+		for (Coordinate_const_iterator it = free_rows.coords_begin(); it != free_rows.coords_end(); ++it)
+			entries[fill[it->i]++] = Entry(it->j, it->value);
+
+		m_col.clear(); m_value.clear(); m_diag.resize(m_nv);
+		std::vector<int> row_start(m_nv+1, 0);
+		for (int i = 0; i < m_nv; ++i)
+		{
+			std::sort(entries.begin()+m_row_start[i], entries.begin()+m_row_start[i+1]);
+			for (int k = m_row_start[i]; k < m_row_start[i+1]; ++k)
+			{
+				if (k > m_row_start[i] && entries[k].col == m_col.back())
+					m_value.back() += entries[k].value;
+				else
+				{
+					if (entries[k].col == i) m_diag[i] = int(m_col.size());
+					m_col.push_back(entries[k].col);
+					m_value.push_back(entries[k].value);
+				}
+			}
+			row_start[i+1] = int(m_col.size());
+		}
+		m_row_start.swap(row_start);
+
+		// row i of A is column i of A'
+		m_At = cholmod_allocate_sparse(m_nv, m_nv, m_col.size(), 1, 1, 0, CHOLMOD_REAL, &m_cholmod_common);
+		if (m_At == 0) return false;
+		std::copy(m_row_start.begin(), m_row_start.end(), static_cast<int*>(m_At->p));
+		std::copy(m_col.begin(), m_col.end(), static_cast<int*>(m_At->i));
+		std::copy(m_value.begin(), m_value.end(), static_cast<double*>(m_At->x));
+
+		m_L = cholmod_analyze(m_At, &m_cholmod_common);
+		if (m_L == 0)
+		{
+			clear();
+			return false;
+		}
+		m_constrained.assign(m_nv, 0);
+		m_factorized = false;
+		m_mesh = mesh;
+		m_nh = mesh->size_of_halfedges();
+		m_points.reserve(3*m_nv);
+		for (Vertex_iterator it = mesh->vertices_begin(); it != mesh->vertices_end(); ++it)
+		{
+			m_points.push_back(CGAL::to_double(it->point().x()));
+			m_points.push_back(CGAL::to_double(it->point().y()));
+			m_points.push_back(CGAL::to_double(it->point().z()));
+		}
+		return true;
+	}
+
+	/// Constrain the vertices in [first, last), all the others are free.
+	/// The matrix is refactored only if the constraint set changed.
+	template<class Const_iterator>
+	bool set_constraints(Const_iterator first, Const_iterator last)
+	{
+		if (m_At == 0) return false;
+		std::vector<char> constrained(m_nv, 0);
+		for (; first != last; ++first)
+			constrained[(*first)->index()] = 1;
+		if (m_factorized && constrained == m_constrained)
+			return true;
+
+		double* x = static_cast<double*>(m_At->x);
+		for (int i = 0; i < m_nv; ++i)
+		{
+			if (constrained[i] == m_constrained[i] && m_factorized) continue;
+			if (constrained[i])
+			{
+				std::fill(x+m_row_start[i], x+m_row_start[i+1], 0.0);
+				x[m_diag[i]] = 1;
+			}
+			else
+				std::copy(m_value.begin()+m_row_start[i], m_value.begin()+m_row_start[i+1], x+m_row_start[i]);
+		}
+		m_constrained.swap(constrained);
+
+		m_factorized = cholmod_factorize(m_At, m_L, &m_cholmod_common) != 0
+			&& m_cholmod_common.status == CHOLMOD_OK;
+		return m_factorized;
+	}
+
+	/// Release the weights and the factorization.
+	void clear()
+	{
+		cholmod_free_factor(&m_L, &m_cholmod_common);
+		cholmod_free_sparse(&m_At, &m_cholmod_common);
+		m_mesh = 0; m_nv = 0; m_nh = 0; m_factorized = false;
+		m_points.clear();
+		m_row_start.clear(); m_col.clear(); m_value.clear(); m_diag.clear(); m_constrained.clear();
+	}
+
+	bool is_factorized() const {return m_factorized;}
+	/// A', owned by the operator.
+	cholmod_sparse* matrix(){return m_At;}
+	/// factor of A'A, owned by the operator.
+	cholmod_factor* factor(){return m_factorized ? m_L : 0;}
+
+protected:
+	struct Entry
+	{
+		Entry():col(0),value(0){}
+		Entry(int c, double v):col(c),value(v){}
+		bool operator<(const Entry& rhs) const {return col < rhs.col;}
+		int col;
+		double value;
+	};
+
+	Polyhedron* m_mesh;
+	int m_nv;
+	// geometry the weights were evaluated on, see is_init()
+	std::size_t m_nh;
+	std::vector<double> m_points;
+	// free rows of A in compressed row form, m_diag[i] is the position of a_ii
+	std::vector<int> m_row_start;
+	std::vector<int> m_col;
+	std::vector<double> m_value;
+	std::vector<int> m_diag;
+	std::vector<char> m_constrained;
+
+	cholmod_common m_cholmod_common;
+	cholmod_sparse* m_At;
+	cholmod_factor* m_L;
+	bool m_factorized;
+};
+
+DGAL_END_NAMESPACE
+#endif //DGAL_LAPLACIAN_OPERATOR__H__
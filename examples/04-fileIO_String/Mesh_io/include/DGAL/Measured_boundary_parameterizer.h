@@ -14,6 +14,8 @@ DGAL_BEGIN_NAMESPACE
 /// constraints: constraints
 /// weight: spring
 /// right hand: mean spoke length, set constrained line as 0
+/// Calling compute again on the same mesh reuses the weights, and the
+/// factorization too if the constraints are the same.
 template<
 	class Polyhedron, 
 	class Weight_strategy = Weight_spring<Polyhedron>,
@@ -28,7 +30,10 @@ public:
 	Poisson_distance_field_builder(){m_builder.weight_strategy().normailze(false);}
 	bool compute(Polyhedron* mesh,std::list<Vertex_handle>& constraints)
 	{
-		m_builder.compute_laplacian_matrix(mesh, constraints.begin(), constraints.end());
+		if(!m_builder.compute_laplacian_operator(mesh, constraints.begin(), constraints.end())){
+			std::cout << "factorization failed!" << std::endl;
+			return false;
+		}
 
 		// compute right hand
 		int n(mesh->size_of_vertices());
@@ -69,7 +74,10 @@ public:
 	}
 	bool compute(Polyhedron* mesh, std::list<Vertex_handle>& cvs)
 	{
-		m_builder.compute_laplacian_matrix(mesh, cvs.begin(), cvs.end());
+		if(!m_builder.compute_laplacian_operator(mesh, cvs.begin(), cvs.end())){
+			std::cout << "factorization failed!" << std::endl;
+			return false;
+		}
 
 		// compute right hand
 		int n(mesh->size_of_vertices());
@@ -0,0 +1,256 @@
+#ifndef DGAL_PARAMETERIZATION_MEASURER_ARRAY_H
+#define DGAL_PARAMETERIZATION_MEASURER_ARRAY_H
+
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <DGAL/config.h>
+
+DGAL_BEGIN_NAMESPACE
+
+// Distortion of the parameterizations of one triangle mesh, over flat arrays.
+//
+// The same measures as Parameterization_measurer_3 (stretch of Sander et al.
+// 2001, angle distortion of Equation 1 of Sheffer & de Sturler), plus an area
+// distortion and the flip count, all computed in one parallel pass over the
+// facets. What only depends on the mesh (3D areas and angles, border
+// vertices, total angle around each vertex) is computed once in the
+// constructor, so many uv layouts of the same mesh can be measured cheaply.
+//
+//   Parameterization_measurer_array measurer(xyz, nv, faces, nf);
+//   Parameterization_distortion d;
+//   measurer.measure(uv, d);
+//
+// xyz is nv x 3, uv nv x 2, faces nf x 3 (0-based), all row major.
+// Differences with Parameterization_measurer_3:
+//   L_infinite is max(tau)*sqrt(uvArea/meshArea), as l_infinite_distortion;
+//   the measures stay positive, flips are reported by num_flip_facets.
+struct Parameterization_distortion
+{
+	double l2;				//L2 stretch of the whole mesh
+	double l_infinite;		//L_infinite stretch of the whole mesh
+	double angle;			//mean angle distortion per vertex
+	double area;			//sum_f w_f (r_f + 1/r_f)/2, r_f = normalized area ratio, 1 if equiareal
+	int num_flip_facets;	//min(#negative, #positive) uv facets
+
+	std::vector<double> l2_per_facet;		//sqrt((a+c)/2)
+	std::vector<double> l_infinite_per_facet;//max singular value tau
+	std::vector<double> uv_area_per_facet;	//signed
+	std::vector<double> angle_per_vertex;	//as getAngleDistortionPerV
+};
+
+class Parameterization_measurer_array
+{
+public:
+	Parameterization_measurer_array(const double* xyz, int nv, const int* faces, int nf)
+		: m_xyz(xyz, xyz+3*nv), m_faces(faces, faces+3*nf), m_nv(nv), m_nf(nf)
+	{
+		prepare();
+	}
+
+	/// from a mesh with u(), v() vertices (DGAL::Polyhedron_3); uv is filled
+	/// in the order of the vertex iterator, to be given to measure()
+	template<class Mesh>
+	static Parameterization_measurer_array* create(Mesh* mesh, std::vector<double>& uv)
+	{
+		typedef typename Mesh::Vertex_iterator Vertex_iterator;
+		typedef typename Mesh::Facet_iterator Facet_iterator;
+		typedef typename Mesh::Halfedge_around_facet_circulator Halfedge_facet_circulator;
+
+		std::map<const void*, int> index;
+		std::vector<double> xyz;
+		std::vector<int> faces;
+		uv.clear();
+		int i = 0;
+		for (Vertex_iterator vi = mesh->vertices_begin(); vi != mesh->vertices_end(); ++vi, ++i)
+		{
+			index[&*vi] = i;
+			xyz.push_back(vi->point().x()); xyz.push_back(vi->point().y()); xyz.push_back(vi->point().z());
+			uv.push_back(vi->u()); uv.push_back(vi->v());
+		}
+		for (Facet_iterator fi = mesh->facets_begin(); fi != mesh->facets_end(); ++fi)
+		{
+			Halfedge_facet_circulator hfc = fi->facet_begin();
+			for (int k = 0; k < 3; ++k, ++hfc)
+				faces.push_back(index[&*hfc->vertex()]);
+		}
+		int nf = int(faces.size()/3);
+		return new Parameterization_measurer_array(xyz.empty() ? NULL : &xyz[0], i, faces.empty() ? NULL : &faces[0], nf);
+	}
+
+	int size_of_vertices() const { return m_nv; }
+	int size_of_facets() const { return m_nf; }
+
+	void measure(const double* uv, Parameterization_distortion& d) const
+	{
+		const int nf = m_nf;
+		d.l2_per_facet.resize(nf);
+		d.l_infinite_per_facet.resize(nf);
+		d.uv_area_per_facet.resize(nf);
+		d.angle_per_vertex.assign(m_nv, 0.0);
+		std::vector<double> cornerAngle(3*nf);
+
+		double l2 = 0, uvArea = 0;
+		int numNeg = 0;
+		#pragma omp parallel for schedule(static) reduction(+:l2,uvArea,numNeg)
+		for (int f = 0; f < nf; ++f)
+		{
+			const int* fv = &m_faces[3*f];
+			const double *q1 = &m_xyz[3*fv[0]], *q2 = &m_xyz[3*fv[1]], *q3 = &m_xyz[3*fv[2]];
+			const double *p1 = uv + 2*fv[0], *p2 = uv + 2*fv[1], *p3 = uv + 2*fv[2];
+
+			double area = 0.5*((p2[0]-p1[0])*(p3[1]-p1[1]) - (p3[0]-p1[0])*(p2[1]-p1[1]));
+			d.uv_area_per_facet[f] = area;
+			if (area < 0) ++numNeg;
+			area = std::abs(area);
+			uvArea += area;
+
+			// Jacobian of the map uv -> xyz
+			double two_a = 2*area, Ss[3], St[3];
+			for (int k = 0; k < 3; ++k)
+			{
+				Ss[k] = (q1[k]*(p2[1]-p3[1]) + q2[k]*(p3[1]-p1[1]) + q3[k]*(p1[1]-p2[1]))/two_a;
+				St[k] = (q1[k]*(p3[0]-p2[0]) + q2[k]*(p1[0]-p3[0]) + q3[k]*(p2[0]-p1[0]))/two_a;
+			}
+			double a = Ss[0]*Ss[0] + Ss[1]*Ss[1] + Ss[2]*Ss[2];
+			double b = Ss[0]*St[0] + Ss[1]*St[1] + Ss[2]*St[2];
+			double c = St[0]*St[0] + St[1]*St[1] + St[2]*St[2];
+			double a_c = 0.5*(a + c);
+			double a_b_c = 0.5*std::sqrt((a-c)*(a-c) + 4*b*b);
+			d.l2_per_facet[f] = std::sqrt(a_c);
+			d.l_infinite_per_facet[f] = std::sqrt(a_c + a_b_c);
+			l2 += a_c*m_meshArea[f];
+
+			// angle distortion of the 3 corners, summed per vertex afterwards
+			for (int k = 0; k < 3; ++k)
+			{
+				const double *p = uv + 2*fv[k], *pl = uv + 2*fv[(k+1)%3], *pr = uv + 2*fv[(k+2)%3];
+				double alpha = angle_2(pl, p, pr);
+				double phi = m_phi[3*f+k];
+				cornerAngle[3*f+k] = phi != 0 ? (alpha-phi)*(alpha-phi)/(phi*phi) : 0;
+			}
+		}
+
+		double linf = 0;
+		for (int f = 0; f < nf; ++f)
+			linf = std::max(linf, d.l_infinite_per_facet[f]);
+
+		double angle = 0;
+		#pragma omp parallel for schedule(static) reduction(+:angle)
+		for (int v = 0; v < m_nv; ++v)
+		{
+			double s = 0;
+			for (int k = m_cornerStart[v]; k < m_cornerStart[v+1]; ++k)
+				s += cornerAngle[m_corner[k]];
+			d.angle_per_vertex[v] = s;
+			angle += s;
+		}
+
+		double area = 0;
+		#pragma omp parallel for schedule(static) reduction(+:area)
+		for (int f = 0; f < nf; ++f)
+		{
+			double w = m_meshArea[f]/m_totalArea;
+			double r = (std::abs(d.uv_area_per_facet[f])/uvArea)/w;
+			area += w*0.5*(r + 1/r);
+		}
+
+		double scale = std::sqrt(uvArea/m_totalArea);
+		d.l2 = std::sqrt(l2/m_totalArea)*scale;
+		d.l_infinite = linf*scale;
+		d.angle = m_nv ? angle/m_nv : 0;
+		d.area = area;
+		d.num_flip_facets = std::min(numNeg, nf - numNeg);
+	}
+
+private:
+	void prepare()
+	{
+		const int nf = m_nf, nv = m_nv;
+		m_meshArea.resize(nf);
+		std::vector<double> alphaM(3*nf);
+		double total = 0;
+		#pragma omp parallel for schedule(static) reduction(+:total)
+		for (int f = 0; f < nf; ++f)
+		{
+			const int* fv = &m_faces[3*f];
+			const double *q1 = &m_xyz[3*fv[0]], *q2 = &m_xyz[3*fv[1]], *q3 = &m_xyz[3*fv[2]];
+			double u[3], v[3];
+			for (int k = 0; k < 3; ++k) { u[k] = q2[k]-q1[k]; v[k] = q3[k]-q2[k]; }
+			double cx = u[1]*v[2]-u[2]*v[1], cy = u[2]*v[0]-u[0]*v[2], cz = u[0]*v[1]-u[1]*v[0];
+			m_meshArea[f] = 0.5*std::sqrt(cx*cx + cy*cy + cz*cz);
+			total += m_meshArea[f];
+			for (int k = 0; k < 3; ++k)
+				alphaM[3*f+k] = angle_3(&m_xyz[3*fv[(k+1)%3]], &m_xyz[3*fv[k]], &m_xyz[3*fv[(k+2)%3]]);
+		}
+		m_totalArea = total;
+
+		// corners of each vertex
+		m_cornerStart.assign(nv+1, 0);
+		for (int c = 0; c < 3*nf; ++c) ++m_cornerStart[m_faces[c]+1];
+		for (int v = 0; v < nv; ++v) m_cornerStart[v+1] += m_cornerStart[v];
+		m_corner.resize(3*nf);
+		std::vector<int> pos(m_cornerStart.begin(), m_cornerStart.end()-1);
+		for (int c = 0; c < 3*nf; ++c) m_corner[pos[m_faces[c]]++] = c;
+
+		// a vertex is on the border if one of its edges is used by one facet only
+		std::vector<char> onBorder(nv, 0);
+		#pragma omp parallel for schedule(static)
+		for (int v = 0; v < nv; ++v)
+		{
+			for (int k = m_cornerStart[v]; k < m_cornerStart[v+1] && !onBorder[v]; ++k)
+			{
+				int c = m_corner[k], f = c/3;
+				int w = m_faces[3*f + (c%3+1)%3];	//halfedge v->w, look for w->v
+				bool found = false;
+				for (int j = m_cornerStart[v]; j < m_cornerStart[v+1] && !found; ++j)
+				{
+					int cj = m_corner[j], fj = cj/3;
+					found = m_faces[3*fj + (cj%3+2)%3] == w;
+				}
+				if (!found) onBorder[v] = 1;
+			}
+		}
+
+		// phi of computeAngleDistortion: the mesh angle, scaled to 2pi around inner vertices
+		m_phi.resize(3*nf);
+		#pragma omp parallel for schedule(static)
+		for (int v = 0; v < nv; ++v)
+		{
+			double sum = 0;
+			for (int k = m_cornerStart[v]; k < m_cornerStart[v+1]; ++k)
+				sum += alphaM[m_corner[k]];
+			double s = onBorder[v] ? 1.0 : 2*3.14159265358979323846/sum;
+			for (int k = m_cornerStart[v]; k < m_cornerStart[v+1]; ++k)
+				m_phi[m_corner[k]] = alphaM[m_corner[k]]*s;
+		}
+	}
+
+	// angle (in radians) of the (P,Q,R) corner
+	static double angle_3(const double* P, const double* Q, const double* R)
+	{
+		double u[3] = {P[0]-Q[0], P[1]-Q[1], P[2]-Q[2]};
+		double v[3] = {R[0]-Q[0], R[1]-Q[1], R[2]-Q[2]};
+		double cx = u[1]*v[2]-u[2]*v[1], cy = u[2]*v[0]-u[0]*v[2], cz = u[0]*v[1]-u[1]*v[0];
+		return std::atan2(std::sqrt(cx*cx + cy*cy + cz*cz), u[0]*v[0] + u[1]*v[1] + u[2]*v[2]);
+	}
+	static double angle_2(const double* P, const double* Q, const double* R)
+	{
+		double u[2] = {P[0]-Q[0], P[1]-Q[1]};
+		double v[2] = {R[0]-Q[0], R[1]-Q[1]};
+		return std::atan2(std::abs(u[0]*v[1]-u[1]*v[0]), u[0]*v[0] + u[1]*v[1]);
+	}
+
+	std::vector<double> m_xyz;
+	std::vector<int> m_faces;
+	int m_nv, m_nf;
+	std::vector<double> m_meshArea;	//per facet
+	double m_totalArea;
+	std::vector<double> m_phi;			//per corner
+	std::vector<int> m_cornerStart, m_corner;
+};
+
+DGAL_END_NAMESPACE
+
+#endif//DGAL_PARAMETERIZATION_MEASURER_ARRAY_H
@@ -0,0 +1,644 @@
+#include "SgpEngine.h"
+#include <cmath>
+#include <algorithm>
+
+static const double PI = 3.14159265358979323846;
+//barycentric tolerance under which an edge crossing is snapped to a vertex
+static const double SNAP = 1.0e-9;
+
+static inline void sub(const double* a, const double* b, double* r)
+{
+	r[0] = a[0]-b[0]; r[1] = a[1]-b[1]; r[2] = a[2]-b[2];
+}
+static inline double dot(const double* a, const double* b)
+{
+	return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+static inline void cross(const double* a, const double* b, double* r)
+{
+	r[0] = a[1]*b[2] - a[2]*b[1];
+	r[1] = a[2]*b[0] - a[0]*b[2];
+	r[2] = a[0]*b[1] - a[1]*b[0];
+}
+static inline double norm(const double* a)
+{
+	return std::sqrt(dot(a,a));
+}
+static inline double normalize(double* a)
+{
+	double len = norm(a);
+	if(len>0)
+	{
+		a[0] /= len; a[1] /= len; a[2] /= len;
+	}
+	return len;
+}
+static inline double distance(const double* a, const double* b)
+{
+	double v[3];
+	sub(a,b,v);
+	return norm(v);
+}
+static inline void push(std::vector<double>& line, const double* p)
+{
+	line.push_back(p[0]); line.push_back(p[1]); line.push_back(p[2]);
+}
+static double polylineLength(const std::vector<double>& line)
+{
+	double len(0);
+	for(size_t i = 3; i < line.size(); i += 3)
+		len += distance(&line[i-3], &line[i]);
+	return len;
+}
+
+void SgpEngine::Paths::clear()
+{
+	points.clear();
+	start.assign(1,0);
+	length.clear();
+	reached.clear();
+}
+
+SgpEngine::SgpEngine():m_nv(0),m_nf(0),m_maxSteps(0),m_eps(0)
+{
+}
+
+void SgpEngine::setMesh(const double* xyz, int nv, const int* faces, int nf)
+{
+	m_nv = nv;
+	m_nf = nf;
+	m_xyz.assign(xyz, xyz+3*nv);
+	m_faces.assign(faces, faces+3*nf);
+
+	double sum(0);
+	for(int i = 0; i < 3*m_nf; ++i)
+		sum += distance(X(m_faces[i]), X(m_faces[i - i%3 + (i+1)%3]));
+	m_eps = m_nf ? 1.0e-9*sum/(3*m_nf) : 0;
+
+	buildTopology();
+}
+
+void SgpEngine::buildTopology()
+{
+	//pair the halfedges by their end points
+	m_adj.assign(3*m_nf, -1);
+	m_adjEdge.assign(3*m_nf, -1);
+	std::vector<std::pair<long long,int> > keys(3*m_nf);
+	for(int h = 0; h < 3*m_nf; ++h)
+	{
+		long long a = V(h/3, h%3), b = V(h/3, (h%3+1)%3);
+		keys[h] = std::make_pair(std::min(a,b)*m_nv + std::max(a,b), h);
+	}
+	std::sort(keys.begin(), keys.end());
+	for(size_t i = 0; i < keys.size(); )
+	{
+		size_t j = i+1;
+		while(j < keys.size() && keys[j].first==keys[i].first) ++j;
+		int h0 = keys[i].second, h1 = keys[i+1 < j ? i+1 : i].second;
+		//a manifold edge with consistent orientations
+		if(j-i==2 && V(h0/3, h0%3)==V(h1/3, (h1%3+1)%3))
+		{
+			m_adj[h0] = h1/3; m_adjEdge[h0] = h1%3;
+			m_adj[h1] = h0/3; m_adjEdge[h1] = h0%3;
+		}
+		i = j;
+	}
+
+	//normals and angles
+	m_normal.resize(3*m_nf);
+	m_angle.resize(3*m_nf);
+	for(int f = 0; f < m_nf; ++f)
+	{
+		double e1[3], e2[3], n[3];
+		sub(X(V(f,1)), X(V(f,0)), e1);
+		sub(X(V(f,2)), X(V(f,0)), e2);
+		cross(e1, e2, n);
+		normalize(n);
+		std::copy(n, n+3, &m_normal[3*f]);
+		for(int k = 0; k < 3; ++k)
+		{
+			sub(X(V(f,(k+1)%3)), X(V(f,k)), e1);
+			sub(X(V(f,(k+2)%3)), X(V(f,k)), e2);
+			cross(e1, e2, n);
+			m_angle[3*f+k] = std::atan2(norm(n), dot(e1,e2));
+		}
+	}
+
+	//fans: rotate clockwise to the border, then collect counterclockwise
+	std::vector<int> vertexCorner(m_nv, -1), degree(m_nv, 0);
+	for(int c = 0; c < 3*m_nf; ++c)
+	{
+		int v = m_faces[c];
+		if(vertexCorner[v]<0) vertexCorner[v] = c;
+		++degree[v];
+	}
+	m_fanStart.assign(m_nv+1, 0);
+	m_fanCorner.clear();
+	m_fanAngle.clear();
+	m_totalAngle.assign(m_nv, 0);
+	m_cornerFan.assign(3*m_nf, -1);
+	m_border.assign(m_nv, 1);
+	for(int v = 0; v < m_nv; ++v)
+	{
+		m_fanStart[v] = int(m_fanCorner.size());
+		int c = vertexCorner[v];
+		if(c<0)
+		{
+			m_fanStart[v+1] = m_fanStart[v];
+			continue;
+		}
+		bool border(false);
+		for(int i = 0; i < degree[v]; ++i)
+		{
+			int f = c/3, k = c%3;
+			int g = m_adj[3*f+k];
+			if(g<0)
+			{
+				border = true;
+				break;
+			}
+			c = 3*g + (m_adjEdge[3*f+k]+1)%3;
+			if(c==vertexCorner[v]) break;
+		}
+		int first = c;
+		double angle(0);
+		for(int i = 0; i < degree[v]; ++i)
+		{
+			m_cornerFan[c] = int(m_fanCorner.size());
+			m_fanCorner.push_back(c);
+			m_fanAngle.push_back(angle);
+			angle += m_angle[c];
+
+			int f = c/3, e = 3*f+(c%3+2)%3;
+			if(m_adj[e]<0)
+			{
+				border = true;
+				break;
+			}
+			c = 3*m_adj[e] + m_adjEdge[e];
+			if(c==first) break;
+		}
+		m_totalAngle[v] = angle;
+		m_border[v] = border;
+		m_fanStart[v+1] = int(m_fanCorner.size());
+	}
+}
+
+void SgpEngine::vertexNormal(int v, double n[3]) const
+{
+	n[0] = n[1] = n[2] = 0;
+	for(int i = m_fanStart[v]; i < m_fanStart[v+1]; ++i)
+	{
+		int c = m_fanCorner[i];
+		for(int j = 0; j < 3; ++j)
+			n[j] += m_angle[c]*m_normal[3*(c/3)+j];
+	}
+	normalize(n);
+}
+
+int SgpEngine::fanCorner(int v, double a, double& local) const
+{
+	if(m_fanStart[v]==m_fanStart[v+1]) return -1;
+	int i = m_fanStart[v];
+	while(i+1 < m_fanStart[v+1] && m_fanAngle[i+1] <= a) ++i;
+	int c = m_fanCorner[i];
+	local = std::max(0.0, std::min(a-m_fanAngle[i], m_angle[c]));
+	return c;
+}
+
+void SgpEngine::cornerDirection(int corner, double local, double d[3]) const
+{
+	int f = corner/3, k = corner%3;
+	double e1[3], w[3];
+	sub(X(V(f,(k+1)%3)), X(V(f,k)), e1);
+	normalize(e1);
+	cross(&m_normal[3*f], e1, w);
+	for(int j = 0; j < 3; ++j)
+		d[j] = std::cos(local)*e1[j] + std::sin(local)*w[j];
+}
+
+double SgpEngine::cornerAngleOf(int corner, const double d[3]) const
+{
+	int f = corner/3, k = corner%3;
+	double e1[3], c[3];
+	sub(X(V(f,(k+1)%3)), X(V(f,k)), e1);
+	normalize(e1);
+	cross(e1, d, c);
+	double a = std::atan2(dot(c, &m_normal[3*f]), dot(e1,d));
+	return std::max(0.0, std::min(a, m_angle[corner]));
+}
+
+bool SgpEngine::faceExit(int f, const double p[3], const double d[3], int skip, double& t, int& edge, double& s) const
+{
+	const double* n = &m_normal[3*f];
+	edge = -1;
+	for(int j = 0; j < 3; ++j)
+	{
+		if(j==skip) continue;
+		const double* a = X(V(f,j));
+		double e[3], ap[3], c[3];
+		sub(X(V(f,(j+1)%3)), a, e);
+		sub(a, p, ap);
+		cross(d, e, c);
+		double den = dot(c, n);
+		if(den==0) continue;
+		cross(ap, e, c);
+		double tj = dot(c, n)/den;
+		cross(ap, d, c);
+		double sj = dot(c, n)/den;
+		if(tj > m_eps && sj > -SNAP && sj < 1+SNAP && (edge<0 || tj<t))
+		{
+			t = tj; s = std::max(0.0, std::min(sj, 1.0)); edge = j;
+		}
+	}
+	return edge>=0;
+}
+
+void SgpEngine::unfold(int f, int edge, double d[3]) const
+{
+	//keep the angle with the edge, rotate the rest into the next face
+	double e[3], m[3];
+	sub(X(V(f,(edge+1)%3)), X(V(f,edge)), e);
+	normalize(e);
+	double de = dot(d, e);
+	double perp = std::sqrt(std::max(0.0, 1-de*de));
+	int g = m_adj[3*f+edge];
+	cross(e, &m_normal[3*g], m);//left side of the reversed edge in g
+	for(int j = 0; j < 3; ++j)
+		d[j] = de*e[j] + perp*m[j];
+	normalize(d);
+}
+
+double SgpEngine::traceStraightest(int center, double angle, double maxLength, Polyline& line, bool& reached) const
+{
+	line.clear();
+	push(line, X(center));
+	reached = false;
+	if(maxLength<=0)
+	{
+		reached = true;
+		return 0;
+	}
+	double local;
+	int corner = fanCorner(center, angle/(2*PI)*m_totalAngle[center], local);
+	if(corner<0) return 0;
+
+	int f = corner/3, skip = corner%3;
+	double p[3], d[3], len(0);
+	std::copy(X(center), X(center)+3, p);
+	cornerDirection(corner, local, d);
+	int maxSteps = m_maxSteps>0 ? m_maxSteps : 4*m_nf+16;
+	for(int step = 0; step < maxSteps; ++step)
+	{
+		double t, s;
+		int edge;
+		if(!faceExit(f, p, d, skip, t, edge, s)) break;
+
+		int vhit = -1;
+		if(s < SNAP) vhit = V(f,edge);
+		else if(s > 1-SNAP) vhit = V(f,(edge+1)%3);
+		double q[3];
+		if(vhit>=0)
+			std::copy(X(vhit), X(vhit)+3, q);
+		else
+			for(int j = 0; j < 3; ++j)
+				q[j] = p[j] + t*d[j];
+
+		double seg = distance(p, q);
+		if(len+seg >= maxLength)
+		{
+			for(int j = 0; j < 3; ++j)
+				q[j] = p[j] + (maxLength-len)*d[j];
+			push(line, q);
+			len = maxLength;
+			reached = true;
+			break;
+		}
+		push(line, q);
+		len += seg;
+
+		if(vhit>=0)
+		{
+			//straightest continuation: half of the total angle on each side
+			if(m_border[vhit]) break;
+			int k = 0;
+			while(V(f,k)!=vhit) ++k;
+			int c = 3*f+k;
+			if(m_cornerFan[c]<0) break;
+			double r[3] = {-d[0], -d[1], -d[2]};
+			double total = m_totalAngle[vhit];
+			double a = m_fanAngle[m_cornerFan[c]] + cornerAngleOf(c, r) + 0.5*total;
+			if(a >= total) a -= total;
+			corner = fanCorner(vhit, a, local);
+			f = corner/3;
+			skip = corner%3;
+			cornerDirection(corner, local, d);
+		}
+		else
+		{
+			if(m_adj[3*f+edge]<0) break;
+			unfold(f, edge, d);
+			skip = m_adjEdge[3*f+edge];
+			f = m_adj[3*f+edge];
+		}
+		std::copy(q, q+3, p);
+	}
+	return len;
+}
+
+double SgpEngine::tracePlane(int center, int target, const double normal[3], Polyline& line, bool& reached) const
+{
+	line.clear();
+	push(line, X(center));
+	reached = center==target;
+	if(reached) return 0;
+
+	double ct[3], pn[3];
+	sub(X(center), X(target), ct);
+	cross(ct, normal, pn);
+	if(normalize(pn) <= m_eps*norm(normal)) return 0;
+
+	//the side of a vertex on the cut plane, center and target are on it:
+	//vertices on the plane count as positive, so that the plane meets the
+	//mesh along simple polylines
+	struct Side
+	{
+		const SgpEngine* e;
+		int c, t;
+		const double* pn;
+		double dist(int v) const
+		{
+			if(v==c || v==t) return 0;
+			double cv[3];
+			sub(e->X(v), e->X(c), cv);
+			return dot(cv, pn);
+		}
+		bool positive(int v) const {return dist(v) >= 0;}
+		void crossing(int a, int b, double q[3]) const
+		{
+			double da = dist(a), db = dist(b);
+			double s = da/(da-db);
+			for(int j = 0; j < 3; ++j)
+				q[j] = e->X(a)[j] + s*(e->X(b)[j]-e->X(a)[j]);
+		}
+	} side = {this, center, target, pn};
+
+	int maxSteps = m_maxSteps>0 ? m_maxSteps : 4*m_nf+16;
+	double best(-1), bestEnd(0);
+	bool bestReached(false);
+	Polyline cand;
+	//every corner of the center whose opposite edge is cut starts a path
+	for(int i = m_fanStart[center]; i < m_fanStart[center+1]; ++i)
+	{
+		int f = m_fanCorner[i]/3, edge = (m_fanCorner[i]%3+1)%3;
+		if(side.positive(V(f,edge))==side.positive(V(f,(edge+1)%3))) continue;
+
+		cand.clear();
+		push(cand, X(center));
+		bool hit(false);
+		for(int step = 0; step < maxSteps; ++step)
+		{
+			double q[3];
+			side.crossing(V(f,edge), V(f,(edge+1)%3), q);
+			push(cand, q);
+			if(distance(q, X(target)) <= m_eps)
+			{
+				hit = true;
+				break;
+			}
+			if(step>0 && distance(q, X(center)) <= m_eps) break;//closed loop
+
+			int g = m_adj[3*f+edge];
+			if(g<0) break;
+			int e = m_adjEdge[3*f+edge];
+			f = g;
+			edge = (e+1)%3;
+			if(side.positive(V(f,edge))==side.positive(V(f,(edge+1)%3)))
+				edge = (e+2)%3;
+		}
+
+		double len = polylineLength(cand);
+		double end = distance(&cand[cand.size()-3], X(target));
+		//a reached target, by the shortest path, else the nearest end
+		bool better = best<0 || (hit && (!bestReached || len<best)) || (!hit && !bestReached && end<bestEnd);
+		if(better)
+		{
+			line.swap(cand);
+			best = len;
+			bestEnd = end;
+			bestReached = hit;
+		}
+	}
+	reached = bestReached;
+	return best<0 ? 0 : best;
+}
+
+double SgpEngine::traceField(int start, const double* field, const double* grad, double sign, int target, Polyline& line, bool& reached) const
+{
+	line.clear();
+	push(line, X(start));
+	reached = false;
+
+	int v = start, f = -1, skip = -1;
+	double p[3], d[3];
+	int maxSteps = m_maxSteps>0 ? m_maxSteps : 4*m_nf+16;
+	for(int step = 0; step < maxSteps; ++step)
+	{
+		if(v>=0)
+		{
+			if(v==target)
+			{
+				reached = true;
+				break;
+			}
+			//the face whose flow leaves v inside its corner, the steepest one
+			int best = -1;
+			double bestSlope = 0;
+			for(int i = m_fanStart[v]; i < m_fanStart[v+1]; ++i)
+			{
+				int c = m_fanCorner[i], g = c/3;
+				double dir[3] = {sign*grad[3*g], sign*grad[3*g+1], sign*grad[3*g+2]};
+				double slope = normalize(dir);
+				if(slope<=bestSlope) continue;
+				double e1[3], cr[3];
+				sub(X(V(g,(c%3+1)%3)), X(v), e1);
+				cross(e1, dir, cr);
+				double a = std::atan2(dot(cr, &m_normal[3*g]), dot(e1,dir));
+				if(a >= -SNAP && a <= m_angle[c]+SNAP)
+				{
+					best = c;
+					bestSlope = slope;
+				}
+			}
+			if(best>=0)
+			{
+				f = best/3;
+				skip = best%3;
+				std::copy(X(v), X(v)+3, p);
+				for(int j = 0; j < 3; ++j)
+					d[j] = sign*grad[3*f+j];
+				normalize(d);
+				v = -1;
+				continue;
+			}
+			//else along the steepest edge
+			int next = -1;
+			for(int i = m_fanStart[v]; i < m_fanStart[v+1]; ++i)
+			{
+				int c = m_fanCorner[i];
+				for(int k = 1; k < 3; ++k)
+				{
+					int w = V(c/3, (c%3+k)%3);
+					double slope = sign*(field[w]-field[v])/distance(X(w), X(v));
+					if(slope>bestSlope)
+					{
+						next = w;
+						bestSlope = slope;
+					}
+				}
+			}
+			if(next<0) break;//local extremum
+			v = next;
+			push(line, X(v));
+			continue;
+		}
+
+		double t, s;
+		int edge;
+		if(!faceExit(f, p, d, skip, t, edge, s))
+		{
+			//the flow leaves the face through the entry edge: follow that edge
+			if(skip<0) break;
+			int a = V(f,skip), b = V(f,(skip+1)%3);
+			v = sign*field[a] > sign*field[b] ? a : b;
+			push(line, X(v));
+			continue;
+		}
+		if(s < SNAP || s > 1-SNAP)
+		{
+			v = s < SNAP ? V(f,edge) : V(f,(edge+1)%3);
+			push(line, X(v));
+			continue;
+		}
+		for(int j = 0; j < 3; ++j)
+			p[j] += t*d[j];
+		push(line, p);
+		if(target>=0 && distance(p, X(target)) <= m_eps)
+		{
+			reached = true;
+			break;
+		}
+		int g = m_adj[3*f+edge];
+		if(g<0) break;
+		skip = m_adjEdge[3*f+edge];
+		f = g;
+		for(int j = 0; j < 3; ++j)
+			d[j] = sign*grad[3*f+j];
+		if(normalize(d)==0) break;
+	}
+	return polylineLength(line);
+}
+
+void SgpEngine::gather(std::vector<Polyline>& lines, std::vector<double>& lengths, std::vector<char>& reached, Paths& out) const
+{
+	out.clear();
+	size_t total(0);
+	for(size_t i = 0; i < lines.size(); ++i)
+		total += lines[i].size();
+	out.points.reserve(total);
+	out.start.reserve(lines.size()+1);
+	for(size_t i = 0; i < lines.size(); ++i)
+	{
+		out.points.insert(out.points.end(), lines[i].begin(), lines[i].end());
+		out.start.push_back(int(out.points.size()/3));
+	}
+	out.length.swap(lengths);
+	out.reached.swap(reached);
+}
+
+void SgpEngine::traceDirections(const int* centers, int ncenters, int ndirs, double maxLength, Paths& out) const
+{
+	std::vector<int> c(ncenters*ndirs);
+	std::vector<double> a(ncenters*ndirs);
+	for(int i = 0; i < ncenters; ++i)
+		for(int j = 0; j < ndirs; ++j)
+		{
+			c[i*ndirs+j] = centers[i];
+			a[i*ndirs+j] = 2*PI*j/ndirs;
+		}
+	traceDirections(c.empty() ? 0 : &c[0], a.empty() ? 0 : &a[0], int(c.size()), maxLength, out);
+}
+
+void SgpEngine::traceDirections(const int* centers, const double* angles, int n, double maxLength, Paths& out) const
+{
+	std::vector<Polyline> lines(n);
+	std::vector<double> lengths(n);
+	std::vector<char> reached(n);
+	#pragma omp parallel for schedule(dynamic,16)
+	for(int i = 0; i < n; ++i)
+	{
+		bool r;
+		lengths[i] = traceStraightest(centers[i], angles[i], maxLength, lines[i], r);
+		reached[i] = r;
+	}
+	gather(lines, lengths, reached, out);
+}
+
+void SgpEngine::traceToTargets(const int* centers, const int* targets, int n, const double* normals, Paths& out) const
+{
+	std::vector<Polyline> lines(n);
+	std::vector<double> lengths(n);
+	std::vector<char> reached(n);
+	#pragma omp parallel for schedule(dynamic,16)
+	for(int i = 0; i < n; ++i)
+	{
+		double normal[3];
+		if(normals && norm(normals+3*i)>0)
+			std::copy(normals+3*i, normals+3*i+3, normal);
+		else
+			vertexNormal(centers[i], normal);
+		bool r;
+		lengths[i] = tracePlane(centers[i], targets[i], normal, lines[i], r);
+		reached[i] = r;
+	}
+	gather(lines, lengths, reached, out);
+}
+
+void SgpEngine::traceGradient(const int* starts, int n, const double* field, int target, Paths& out) const
+{
+	//gradient of the linear interpolation in each face
+	std::vector<double> grad(3*m_nf+1);
+	#pragma omp parallel for schedule(static)
+	for(int f = 0; f < m_nf; ++f)
+	{
+		double e1[3], e2[3], c[3];
+		sub(X(V(f,1)), X(V(f,0)), e1);
+		sub(X(V(f,2)), X(V(f,0)), e2);
+		cross(e1, e2, c);
+		double area2 = norm(c);
+		double* g = &grad[3*f];
+		g[0] = g[1] = g[2] = 0;
+		if(area2==0) continue;
+		for(int k = 0; k < 3; ++k)
+		{
+			double e[3], ne[3];
+			sub(X(V(f,(k+2)%3)), X(V(f,(k+1)%3)), e);
+			cross(&m_normal[3*f], e, ne);
+			for(int j = 0; j < 3; ++j)
+				g[j] += field[V(f,k)]*ne[j]/area2;
+		}
+	}
+
+	std::vector<Polyline> lines(n);
+	std::vector<double> lengths(n);
+	std::vector<char> reached(n);
+	#pragma omp parallel for schedule(dynamic,16)
+	for(int i = 0; i < n; ++i)
+	{
+		double sign = (target>=0 && field[target]>field[starts[i]]) ? 1 : -1;
+		bool r;
+		lengths[i] = traceField(starts[i], field, &grad[0], sign, target, lines[i], r);
+		reached[i] = r;
+	}
+	gather(lines, lengths, reached, out);
+}
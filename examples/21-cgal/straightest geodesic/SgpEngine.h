@@ -0,0 +1,147 @@
+#ifndef SGPENGINE_H
+#define SGPENGINE_H
+
+#include <vector>
+#include <map>
+
+//Headless tracing of geodesic-like paths on a triangle mesh, no VTK, no Qt.
+//The mesh is kept as flat arrays, so many paths can be traced in parallel
+//(the tags of the Polyhedron are not touched).
+//  traceDirections: straightest geodesics from a vertex in given polar
+//                   directions, refer to: Polthier and Schmies,
+//                   "Straightest Geodesics on Polyhedral Surfaces"
+//  traceToTargets:  straightest paths from a center to target vertices by
+//                   cutting planes, as SgpProp::createSgp, refer to:
+//                   "Straightest Paths on Meshes by Cutting Planes"
+//  traceGradient:   paths following the gradient of a scalar field, as
+//                   SgpProp::createPgp and createRK
+//
+//  SgpEngine engine;
+//  engine.setMesh(xyz, nv, faces, nf);
+//  SgpEngine::Paths paths;
+//  engine.traceDirections(centers, ncenters, 36, radius, paths);
+//  //path i: paths.points[3*paths.start[i] .. 3*paths.start[i+1])
+class SgpEngine
+{
+public:
+	//polylines in flat buffers
+	struct Paths
+	{
+		std::vector<double> points;//xyz of the points of all the paths
+		std::vector<int> start;//path i has points start[i]..start[i+1]-1
+		std::vector<double> length;
+		std::vector<char> reached;//target reached, or full length traced
+		int size() const {return int(length.size());}
+		int size(int i) const {return start[i+1]-start[i];}
+		const double* point(int i, int j) const {return &points[3*(start[i]+j)];}
+		void clear();
+	};
+
+	SgpEngine();
+	//xyz: 3*nv, faces: 3*nf, 0-based, consistently oriented
+	void setMesh(const double* xyz, int nv, const int* faces, int nf);
+	//index (optional): vertex address -> index used by the engine
+	template<class Polyhedron>
+	void setMesh(const Polyhedron& mesh, std::map<const void*, int>* index = 0);
+
+	int numVertices() const {return m_nv;}
+	int numFaces() const {return m_nf;}
+	bool isBorder(int v) const {return m_border[v]!=0;}
+	//sum of the angles around v
+	double totalAngle(int v) const {return m_totalAngle[v];}
+	//angle weighted normal
+	void vertexNormal(int v, double n[3]) const;
+	//0: 4*numFaces()+16
+	void setMaxSteps(int in){m_maxSteps = in;}
+
+	//Straightest geodesics of length maxLength, ndirs per center. Direction j
+	//of center c has the polar angle 2*pi*j/ndirs, scaled to the total angle
+	//around c and measured from its first edge; path c*ndirs+j of out.
+	//A path stops early on the border (reached=0).
+	void traceDirections(const int* centers, int ncenters, int ndirs, double maxLength, Paths& out) const;
+	//path i from centers[i] with polar angle angles[i] in [0, 2*pi)
+	void traceDirections(const int* centers, const double* angles, int n, double maxLength, Paths& out) const;
+	//Path i from centers[i] to targets[i] in the plane through both, parallel
+	//to normals[3*i] (NULL: the vertex normal of the center). If the target
+	//is not reached, the path which ends nearest to it is returned.
+	void traceToTargets(const int* centers, const int* targets, int n, const double* normals, Paths& out) const;
+	//Path i from starts[i], following the gradient of field (per vertex)
+	//towards the value of target (descending if target<0), until target, a
+	//local extremum or the border.
+	void traceGradient(const int* starts, int n, const double* field, int target, Paths& out) const;
+
+private:
+	typedef std::vector<double> Polyline;
+	void buildTopology();
+	const double* X(int v) const {return &m_xyz[3*v];}
+	int V(int f, int k) const {return m_faces[3*f+k];}
+	//corner c of v in its fan covering the angle a, a in [0, totalAngle(v)]
+	int fanCorner(int v, double a, double& local) const;
+	void cornerDirection(int corner, double local, double d[3]) const;
+	double cornerAngleOf(int corner, const double d[3]) const;
+	//exit of the ray p+t*d, t>0, from face f, skipping edge skip (-1: none)
+	bool faceExit(int f, const double p[3], const double d[3], int skip, double& t, int& edge, double& s) const;
+	void unfold(int f, int edge, double d[3]) const;
+
+	double traceStraightest(int center, double angle, double maxLength, Polyline& line, bool& reached) const;
+	double tracePlane(int center, int target, const double n[3], Polyline& line, bool& reached) const;
+	double traceField(int start, const double* field, const double* grad, double sign, int target, Polyline& line, bool& reached) const;
+	void gather(std::vector<Polyline>& lines, std::vector<double>& lengths, std::vector<char>& reached, Paths& out) const;
+
+	int m_nv, m_nf, m_maxSteps;
+	double m_eps;//distance under which two points are the same
+	std::vector<double> m_xyz;
+	std::vector<int> m_faces;
+	std::vector<int> m_adj;//face across edge 3f+j (v_j -> v_j+1), -1 on the border
+	std::vector<int> m_adjEdge;//edge index in that face
+	std::vector<double> m_normal;//unit normal of each face
+	std::vector<double> m_angle;//angle of each corner 3f+k
+	//corners around each vertex, counterclockwise, starting from the border:
+	//m_fanCorner[m_fanStart[v]..m_fanStart[v+1]), m_fanAngle the angle
+	//around v before each corner
+	std::vector<int> m_fanStart;
+	std::vector<int> m_fanCorner;
+	std::vector<double> m_fanAngle;
+	std::vector<double> m_totalAngle;
+	std::vector<int> m_cornerFan;//position of corner 3f+k in the fans
+	std::vector<char> m_border;
+};
+
+template<class Polyhedron>
+void SgpEngine::setMesh(const Polyhedron& mesh, std::map<const void*, int>* index)
+{
+	typedef typename Polyhedron::Vertex_const_iterator Vertex_const_iterator;
+	typedef typename Polyhedron::Facet_const_iterator Facet_const_iterator;
+	typedef typename Polyhedron::Halfedge_around_facet_const_circulator Halfedge_facet_const_circulator;
+
+	std::map<const void*, int> local;
+	std::map<const void*, int>& vindex = index ? *index : local;
+	vindex.clear();
+	std::vector<double> xyz;
+	std::vector<int> faces;
+	xyz.reserve(3*mesh.size_of_vertices());
+	int i(0);
+	for(Vertex_const_iterator it = mesh.vertices_begin(); it != mesh.vertices_end(); ++it, ++i)
+	{
+		vindex[&*it] = i;
+		xyz.push_back(double(it->point().x()));
+		xyz.push_back(double(it->point().y()));
+		xyz.push_back(double(it->point().z()));
+	}
+	faces.reserve(3*mesh.size_of_facets());
+	for(Facet_const_iterator it = mesh.facets_begin(); it != mesh.facets_end(); ++it)
+	{
+		//only triangles are traced
+		int tri[3], k(0);
+		Halfedge_facet_const_circulator hc = it->facet_begin();
+		do
+		{
+			if(k<3) tri[k] = vindex[&*hc->vertex()];
+			++k;
+		}while(++hc != it->facet_begin());
+		if(k==3) faces.insert(faces.end(), tri, tri+3);
+	}
+	setMesh(xyz.empty() ? 0 : &xyz[0], i, faces.empty() ? 0 : &faces[0], int(faces.size()/3));
+}
+
+#endif // SGPENGINE_H
@@ -22,6 +22,7 @@ typedef CGAL::Plane_3<K> Plane_3;
 
 //Prop of straightest geodesic path
 //refer to: "Straightest Paths on Meshes by Cutting Planes"
+//the paths are traced by the headless SgpEngine, this class only shows them
 class PROPLIB_EXPORT SgpProp : public QObject
 {
 	Q_OBJECT
@@ -0,0 +1,249 @@
+/*=================================================================
+*
+* Color transfer between images in the decorrelated l alpha beta space,
+* refer to: Reinhard et al., "Color transfer between images", CGA 2001.
+* Same conversions as RGB2lAlphaBeta.m, channels_transfer.m and
+* lAlphaBeta2RGB.m, including log10(1+LMS).
+*
+* Images are planar (m*n*3 as in Matlab), uint8 in [0,255] or float/double
+* in [0,1], and are processed in tiles of LAB_TRANSFER_TILE pixels: no copy
+* of the image is made.
+*
+* lab = M*log10(1+B*rgb) with M orthonormal, so the per channel transfer
+* lab' = S*(lab-ms)+mt is an affine map of the log LMS values:
+* log' = M'*S*M*log + M'*(mt-S*ms). A pixel is thus transferred in one pass:
+* B, log10, one 3*3 affine map, 10^x-1, inverse of B.
+*
+*   LabStats t = LabColorTransfer::stats(tgt, ntgt);
+*   LabStats s = LabColorTransfer::stats(src, nsrc);
+*   LabColorTransfer transfer(s, t);
+*   transfer.apply(src, out, nsrc);
+*
+* Streaming: stats of an image given in pieces are merged with
+* LabStats::merge, a video uses a fixed target and the stats of each frame,
+* optionally smoothed over the frames (LabStats::blend).
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#ifndef LAB_COLOR_TRANSFER_H
+#define LAB_COLOR_TRANSFER_H
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#define LAB_TRANSFER_TILE 1024
+
+// mean and standard deviation (normalized by n-1, as std) of l alpha beta
+struct LabStats
+{
+	double mean[3];
+	double m2[3];// sum of squared deviations
+	double n;
+
+	LabStats():n(0){
+		for (int c = 0; c < 3; ++c) mean[c] = m2[c] = 0;
+	}
+	double sigma(int c) const {return n > 1 ? sqrt(m2[c]/(n-1)) : 0;}
+	// from mean and standard deviation, of n pixels
+	void set(const double *mu, const double *sd, double count){
+		n = count;
+		for (int c = 0; c < 3; ++c){
+			mean[c] = mu[c];
+			m2[c] = sd[c]*sd[c]*(n > 1 ? n-1 : 1);
+		}
+	}
+	// add the pixels of b (Chan et al.)
+	void merge(const LabStats &b){
+		if (b.n == 0) return;
+		double n1 = n + b.n;
+		for (int c = 0; c < 3; ++c){
+			double d = b.mean[c] - mean[c];
+			mean[c] += d*b.n/n1;
+			m2[c] += b.m2[c] + d*d*n*b.n/n1;
+		}
+		n = n1;
+	}
+	// (1-w)*this + w*b in mean and standard deviation, for a sequence of frames
+	void blend(const LabStats &b, double w){
+		if (n == 0) {*this = b; return;}
+		double mu[3], sd[3];
+		for (int c = 0; c < 3; ++c){
+			mu[c] = (1-w)*mean[c] + w*b.mean[c];
+			sd[c] = (1-w)*sigma(c) + w*b.sigma(c);
+		}
+		set(mu, sd, b.n);
+	}
+};
+
+class LabColorTransfer
+{
+public:
+	// transfer from the statistics of source to the ones of target
+	LabColorTransfer(const LabStats &source, const LabStats &target){
+		setStats(source, target);
+	}
+	void setStats(const LabStats &source, const LabStats &target){
+		double M[3][3], S[3], c[3];
+		lab(M);
+		for (int k = 0; k < 3; ++k){
+			double ss = source.sigma(k);
+			S[k] = ss > 0 ? target.sigma(k)/ss : 1;
+			c[k] = target.mean[k] - S[k]*source.mean[k];
+		}
+		for (int i = 0; i < 3; ++i){
+			m_offset[i] = 0;
+			for (int j = 0; j < 3; ++j){
+				double a(0);
+				for (int k = 0; k < 3; ++k) a += M[k][i]*S[k]*M[k][j];
+				m_affine[i][j] = (float)a;
+			}
+			for (int k = 0; k < 3; ++k) m_offset[i] += M[k][i]*c[k];
+		}
+	}
+
+	// statistics of the n pixels of the planar image img, one parallel pass
+	template<class T>
+	static LabStats stats(const T *img, long long n){
+		int ntiles = int((n + LAB_TRANSFER_TILE - 1)/LAB_TRANSFER_TILE);
+		std::vector<LabStats> tiles(ntiles);
+		#pragma omp parallel for schedule(static)
+		for (int t = 0; t < ntiles; ++t)
+			tileStats(img, n, t, tiles[t]);
+		return mergeTiles(tiles, 0, ntiles);
+	}
+	// statistics of two images, in the same parallel pass
+	template<class T, class U>
+	static void stats(const T *a, long long na, const U *b, long long nb, LabStats &sa, LabStats &sb){
+		int ta = int((na + LAB_TRANSFER_TILE - 1)/LAB_TRANSFER_TILE);
+		int tb = int((nb + LAB_TRANSFER_TILE - 1)/LAB_TRANSFER_TILE);
+		std::vector<LabStats> tiles(ta+tb);
+		#pragma omp parallel for schedule(static)
+		for (int t = 0; t < ta+tb; ++t){
+			if (t < ta) tileStats(a, na, t, tiles[t]);
+			else tileStats(b, nb, t-ta, tiles[t]);
+		}
+		sa = mergeTiles(tiles, 0, ta);
+		sb = mergeTiles(tiles, ta, ta+tb);
+	}
+
+	// out = transfer of the n pixels of the planar image img, may be img
+	template<class T, class U>
+	void apply(const T *img, U *out, long long n) const{
+		int ntiles = int((n + LAB_TRANSFER_TILE - 1)/LAB_TRANSFER_TILE);
+		#pragma omp parallel for schedule(static)
+		for (int t = 0; t < ntiles; ++t){
+			long long b = (long long)t*LAB_TRANSFER_TILE, e = std::min(n, b + LAB_TRANSFER_TILE);
+			int len = int(e-b);
+			float l[3][LAB_TRANSFER_TILE], q[3][LAB_TRANSFER_TILE];
+			logLms(img, n, b, len, l);
+			const float (*A)[3] = m_affine;
+			const float o0 = (float)m_offset[0], o1 = (float)m_offset[1], o2 = (float)m_offset[2];
+			for (int i = 0; i < len; ++i){
+				q[0][i] = A[0][0]*l[0][i] + A[0][1]*l[1][i] + A[0][2]*l[2][i] + o0;
+				q[1][i] = A[1][0]*l[0][i] + A[1][1]*l[1][i] + A[1][2]*l[2][i] + o1;
+				q[2][i] = A[2][0]*l[0][i] + A[2][1]*l[1][i] + A[2][2]*l[2][i] + o2;
+			}
+			// LMS = 10^log-1
+			const float ln10 = 2.302585093f;
+			for (int c = 0; c < 3; ++c)
+				for (int i = 0; i < len; ++i)
+					q[c][i] = expf(ln10*q[c][i]) - 1;
+			// rgb, as lAlphaBeta2RGB.m
+			static const float B2[3][3] = {
+				{ 4.4687f, -3.5887f,  0.1196f},
+				{-1.2197f,  2.3831f, -0.1626f},
+				{ 0.0585f, -0.2611f,  1.2057f}};
+			for (int c = 0; c < 3; ++c){
+				U *o = out + c*n + b;
+				for (int i = 0; i < len; ++i)
+					o[i] = store<U>(B2[c][0]*q[0][i] + B2[c][1]*q[1][i] + B2[c][2]*q[2][i]);
+			}
+		}
+	}
+
+private:
+	// c1*d1 of RGB2lAlphaBeta.m
+	static void lab(double M[3][3]){
+		const double a = 1/sqrt(3.0), b = 1/sqrt(6.0), c = 1/sqrt(2.0);
+		M[0][0] = a; M[0][1] = a;  M[0][2] = a;
+		M[1][0] = b; M[1][1] = b;  M[1][2] = -2*b;
+		M[2][0] = c; M[2][1] = -c; M[2][2] = 0;
+	}
+	static void labf(float Mf[3][3]){
+		double M[3][3];
+		lab(M);
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j) Mf[i][j] = (float)M[i][j];
+	}
+
+	template<class T>
+	static void tileStats(const T *img, long long n, int t, LabStats &s){
+		long long b = (long long)t*LAB_TRANSFER_TILE, e = std::min(n, b + LAB_TRANSFER_TILE);
+		int len = int(e-b);
+		float l[3][LAB_TRANSFER_TILE];
+		logLms(img, n, b, len, l);
+		float M[3][3];
+		labf(M);
+		s.n = len;
+		for (int c = 0; c < 3; ++c){
+			// lab channel c of the tile, two pass within the tile
+			double sum(0);
+			for (int i = 0; i < len; ++i)
+				sum += M[c][0]*l[0][i] + M[c][1]*l[1][i] + M[c][2]*l[2][i];
+			double mu = sum/len, m2(0);
+			for (int i = 0; i < len; ++i){
+				double d = M[c][0]*l[0][i] + M[c][1]*l[1][i] + M[c][2]*l[2][i] - mu;
+				m2 += d*d;
+			}
+			s.mean[c] = mu;
+			s.m2[c] = m2;
+		}
+	}
+	// in order, so that the result does not depend on the threads
+	static LabStats mergeTiles(const std::vector<LabStats> &tiles, int b, int e){
+		LabStats all;
+		for (int t = b; t < e; ++t)
+			all.merge(tiles[t]);
+		return all;
+	}
+
+	static float load(unsigned char v){return v*(1.0f/255);}
+	static float load(float v){return v;}
+	static float load(double v){return (float)v;}
+	template<class U> static U store(float v);
+
+	// log10(1+B*rgb) of the pixels [b,b+len)
+	template<class T>
+	static void logLms(const T *img, long long n, long long b, int len, float l[3][LAB_TRANSFER_TILE]){
+		static const float B1[3][3] = {
+			{.3811f, .5783f, .0402f},
+			{.1967f, .7244f, .0782f},
+			{.0241f, .1288f, .8444f}};
+		const T *r = img + b, *g = img + n + b, *bl = img + 2*n + b;
+		float rgb[3][LAB_TRANSFER_TILE];
+		for (int i = 0; i < len; ++i){
+			rgb[0][i] = load(r[i]);
+			rgb[1][i] = load(g[i]);
+			rgb[2][i] = load(bl[i]);
+		}
+		const float inv_ln10 = 0.4342944819f;
+		for (int c = 0; c < 3; ++c)
+			for (int i = 0; i < len; ++i)
+				l[c][i] = logf(1 + B1[c][0]*rgb[0][i] + B1[c][1]*rgb[1][i] + B1[c][2]*rgb[2][i])*inv_ln10;
+	}
+
+	float m_affine[3][3];// M'*S*M
+	double m_offset[3];// M'*(mt-S*ms)
+};
+
+template<> inline unsigned char LabColorTransfer::store<unsigned char>(float v){
+	v = v*255 + 0.5f;
+	return (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+template<> inline float LabColorTransfer::store<float>(float v){return v;}
+template<> inline double LabColorTransfer::store<double>(float v){return v;}
+
+#endif // LAB_COLOR_TRANSFER_H
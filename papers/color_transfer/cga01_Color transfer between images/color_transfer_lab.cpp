@@ -0,0 +1,188 @@
+/*=================================================================
+*
+* Color transfer between images in l alpha beta space, the same as
+* RGB2lAlphaBeta + channels_transfer + lAlphaBeta2RGB in one pass over the
+* images, see LabColorTransfer.h.
+*
+* usage:
+		im = color_transfer_lab(src, tgt);
+		im = color_transfer_lab(src, tgt, srcStats);
+		stats = color_transfer_lab('stats', img);
+		stats = color_transfer_lab('stats', img, stats);
+		color_transfer_lab('target', tgt);
+		im = color_transfer_lab('frame', frame, smooth);
+* compile:
+		mex -O COMPFLAGS="$COMPFLAGS /openmp" color_transfer_lab.cpp
+* inputs:
+		src, tgt, img, frame: m*n*3 images, uint8, single or double (in [0,1]).
+			tgt may also be the stats of the target.
+		srcStats: stats of the source, when src is a piece of a larger image
+		stats: struct with fields mean (1*3), std (1*3) and n, of l alpha beta.
+			Given as third input, the stats of img are merged into it, so
+			the stats of an image can be computed piece by piece.
+		'target': keeps the stats of tgt for the following frames
+		smooth: in [0,1), the stats of the frames are smoothed as
+			smooth*previous + (1-smooth)*current, 0 by default
+* outputs:
+		im: transferred image, same class as the input, uint8 is clamped
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "mex.h"
+#include <cstring>
+#include "LabColorTransfer.h"
+
+static LabStats targetStats, frameStats;
+static bool hasTarget(false);
+
+long long numPixels( const mxArray *img )
+{
+	if( mxGetNumberOfDimensions(img)!=3 || mxGetDimensions(img)[2]!=3 )
+		mexErrMsgTxt("images are expected to be m*n*3");
+	if( !mxIsUint8(img) && !mxIsSingle(img) && !mxIsDouble(img) )
+		mexErrMsgTxt("images are expected to be uint8, single or double");
+	return (long long)mxGetDimensions(img)[0]*mxGetDimensions(img)[1];
+}
+
+LabStats imageStats( const mxArray *img )
+{
+	long long n = numPixels(img);
+	if( mxIsUint8(img) )
+		return LabColorTransfer::stats((const unsigned char*)mxGetData(img), n);
+	if( mxIsSingle(img) )
+		return LabColorTransfer::stats((const float*)mxGetData(img), n);
+	return LabColorTransfer::stats(mxGetPr(img), n);
+}
+
+template<class T>
+void twoStats( const T *a, long long na, const mxArray *b, LabStats &sa, LabStats &sb )
+{
+	long long nb = numPixels(b);
+	if( mxIsUint8(b) )
+		LabColorTransfer::stats(a, na, (const unsigned char*)mxGetData(b), nb, sa, sb);
+	else if( mxIsSingle(b) )
+		LabColorTransfer::stats(a, na, (const float*)mxGetData(b), nb, sa, sb);
+	else
+		LabColorTransfer::stats(a, na, mxGetPr(b), nb, sa, sb);
+}
+
+// stats of two images, both in one parallel pass
+void imageStats( const mxArray *a, const mxArray *b, LabStats &sa, LabStats &sb )
+{
+	long long na = numPixels(a);
+	if( mxIsUint8(a) )
+		twoStats((const unsigned char*)mxGetData(a), na, b, sa, sb);
+	else if( mxIsSingle(a) )
+		twoStats((const float*)mxGetData(a), na, b, sa, sb);
+	else
+		twoStats(mxGetPr(a), na, b, sa, sb);
+}
+
+mxArray* transfer( const mxArray *src, const LabStats &source, const LabStats &target )
+{
+	long long n = numPixels(src);
+	LabColorTransfer t(source, target);
+	mxArray *out = mxCreateNumericArray(3, mxGetDimensions(src), mxGetClassID(src), mxREAL);
+	if( mxIsUint8(src) )
+		t.apply((const unsigned char*)mxGetData(src), (unsigned char*)mxGetData(out), n);
+	else if( mxIsSingle(src) )
+		t.apply((const float*)mxGetData(src), (float*)mxGetData(out), n);
+	else
+		t.apply(mxGetPr(src), mxGetPr(out), n);
+	return out;
+}
+
+bool isStats( const mxArray *a )
+{
+	return mxIsStruct(a) && mxGetField(a, 0, "mean") && mxGetField(a, 0, "std") && mxGetField(a, 0, "n");
+}
+LabStats toStats( const mxArray *a )
+{
+	if( mxGetNumberOfElements(mxGetField(a, 0, "mean"))!=3 || mxGetNumberOfElements(mxGetField(a, 0, "std"))!=3 )
+		mexErrMsgTxt("stats.mean and stats.std are expected to be 1*3");
+	LabStats s;
+	s.set(mxGetPr(mxGetField(a, 0, "mean")), mxGetPr(mxGetField(a, 0, "std")), mxGetScalar(mxGetField(a, 0, "n")));
+	return s;
+}
+mxArray* fromStats( const LabStats &s )
+{
+	const char *fields[] = {"mean", "std", "n"};
+	mxArray *a = mxCreateStructMatrix(1, 1, 3, fields);
+	mxArray *mean = mxCreateDoubleMatrix(1, 3, mxREAL), *sd = mxCreateDoubleMatrix(1, 3, mxREAL);
+	for( int c=0; c<3; ++c )
+	{
+		mxGetPr(mean)[c] = s.mean[c];
+		mxGetPr(sd)[c] = s.sigma(c);
+	}
+	mxSetField(a, 0, "mean", mean);
+	mxSetField(a, 0, "std", sd);
+	mxSetField(a, 0, "n", mxCreateDoubleScalar(s.n));
+	return a;
+}
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+{
+	if( nrhs<1 )
+		mexErrMsgTxt("Usage: im = color_transfer_lab(src, tgt, srcStats).");
+
+	if( mxIsChar(prhs[0]) )
+	{
+		char cmd[16];
+		mxGetString(prhs[0], cmd, sizeof(cmd));
+		if( !strcmp(cmd, "stats") )
+		{
+			if( nrhs<2 )
+				mexErrMsgTxt("Usage: stats = color_transfer_lab('stats', img, stats).");
+			LabStats s = imageStats(prhs[1]);
+			if( nrhs>2 && isStats(prhs[2]) )
+			{
+				LabStats all = toStats(prhs[2]);
+				all.merge(s);
+				s = all;
+			}
+			plhs[0] = fromStats(s);
+		}
+		else if( !strcmp(cmd, "target") )
+		{
+			if( nrhs<2 )
+				mexErrMsgTxt("Usage: color_transfer_lab('target', tgt).");
+			targetStats = isStats(prhs[1]) ? toStats(prhs[1]) : imageStats(prhs[1]);
+			frameStats = LabStats();
+			hasTarget = true;
+		}
+		else if( !strcmp(cmd, "frame") )
+		{
+			if( !hasTarget )
+				mexErrMsgTxt("no target, call color_transfer_lab('target', tgt) first.");
+			if( nrhs<2 )
+				mexErrMsgTxt("Usage: im = color_transfer_lab('frame', frame, smooth).");
+			double smooth = nrhs>2 ? mxGetScalar(prhs[2]) : 0;
+			if( smooth<0 || smooth>=1 )
+				mexErrMsgTxt("smooth is expected to be in [0,1).");
+			frameStats.blend(imageStats(prhs[1]), 1-smooth);
+			plhs[0] = transfer(prhs[1], frameStats, targetStats);
+		}
+		else
+			mexErrMsgTxt("unknown command, expected 'stats', 'target' or 'frame'.");
+		return;
+	}
+
+	if( nrhs<2 )
+		mexErrMsgTxt("Usage: im = color_transfer_lab(src, tgt, srcStats).");
+	LabStats source, target;
+	bool srcGiven = nrhs>2 && isStats(prhs[2]);
+	if( srcGiven )
+		source = toStats(prhs[2]);
+	if( isStats(prhs[1]) )
+	{
+		target = toStats(prhs[1]);
+		if( !srcGiven ) source = imageStats(prhs[0]);
+	}
+	else if( srcGiven )
+		target = imageStats(prhs[1]);
+	else
+		imageStats(prhs[0], prhs[1], source, target);
+	plhs[0] = transfer(prhs[0], source, target);
+}
@@ -20,6 +20,13 @@
 close all;clear all; % clc;
 addpath(genpath('../../'));
 USE_GPU = false;
+USE_MEX = true; % one pass over the images, no double copies, see LabColorTransfer.h
+if USE_GPU && USE_MEX
+    error('color_transfer_lab works on host arrays, USE_GPU and USE_MEX cannot be both true.');
+end
+if USE_MEX
+    mex -O COMPFLAGS="$COMPFLAGS /openmp" color_transfer_lab.cpp
+end
 
 src=imread('11.jpg');
 if USE_GPU
@@ -38,13 +45,25 @@ subplot(132);imshow(tgt);title('Target');
 %%
 tic
 % for i = 1:1000
-lAlphaBetaT = RGB2lAlphaBeta(tgt);
-lAlphaBetaS = RGB2lAlphaBeta(src);
+if USE_MEX
+    im = color_transfer_lab(src, tgt);
+else
+    lAlphaBetaT = RGB2lAlphaBeta(tgt);
+    lAlphaBetaS = RGB2lAlphaBeta(src);
 
-lAlphaBetaN = channels_transfer(lAlphaBetaT, lAlphaBetaS);
-im=lAlphaBeta2RGB(lAlphaBetaN, size(src));
+    lAlphaBetaN = channels_transfer(lAlphaBetaT, lAlphaBetaS);
+    im=lAlphaBeta2RGB(lAlphaBetaN, size(src));
+end
 % end
 toc
 
 %%
 subplot(133);imshow(im);title('Result');
+
+%% video or pieces of a large image: fixed target, stats of each frame
+% color_transfer_lab('target', tgt);
+% for i = 1:nframes
+%     out = color_transfer_lab('frame', frames{i}, 0.8); % smoothed stats
+% end
+% stats = color_transfer_lab('stats', piece1); stats = color_transfer_lab('stats', piece2, stats);
+% out1 = color_transfer_lab(piece1, tgt, stats);
@@ -0,0 +1,40 @@
+% spectral residual saliency of a frame sequence with the mex engine.
+% Same pipeline as demo_spectral_residual_saliency.m, but the frames are
+% shrunk by area averaging instead of imresize's default bicubic kernel.
+%
+% jjcao @ 2026
+%
+
+clear;clc;close all;
+addpath(genpath('../../../'));
+mex -O COMPFLAGS="$COMPFLAGS /openmp" spectral_residual_saliency.cpp
+%% a sequence : the image shifted along x
+img = imread('curve.jpg');
+n = 16;
+frames = zeros([size(img), n], 'uint8');
+for k = 1:n
+    frames(:,:,:,k) = circshift(img, [0, 4*(k-1), 0]);
+end
+%% whole batch in one call
+options.rgb = 1;
+options.width = 64;
+tic; S = spectral_residual_saliency(frames, options); toc
+%% or frame by frame, the FFT plans are kept between calls
+tic;
+for k = 1:n
+    s = spectral_residual_saliency(frames(:,:,:,k), options);
+end
+toc
+%% compare with the matlab version on the first frame, resized with a box
+% kernel (area averaging) as the mex does
+inImg = im2double(rgb2gray(img));
+inImg = imresize(inImg, 64/size(inImg, 2), 'box');
+myFFT = fft2(inImg);
+myLogAmplitude = log(abs(myFFT));
+mySpectralResidual = myLogAmplitude - imfilter(myLogAmplitude, fspecial('average', 3), 'replicate');
+saliencyMap = abs(ifft2(exp(mySpectralResidual + i*angle(myFFT)))).^2;
+saliencyMap = mat2gray(imfilter(saliencyMap, fspecial('gaussian', [10, 10], 2.5)));
+figure;
+subplot(1,3,1); imshow(img);
+subplot(1,3,2); imshow(saliencyMap); title('matlab');
+subplot(1,3,3); imshow(S(:,:,1)); title('mex');
@@ -0,0 +1,374 @@
+/*=================================================================
+% spectral_residual.h - spectral residual saliency engine for image sequences
+%
+%   All frames have the same size and are processed at a fixed working
+%   resolution, so the FFT plans (twiddles, bit reversal), the resampling
+%   weights and the scratch buffers are built once by Init and reused:
+%
+%       SpectralResidual engine;
+%       engine.Init( inRows, inCols, workRows, workCols );
+%       engine.Process( frame, saliency );              // streaming, one frame
+%       engine.ProcessBatch( frames, n, saliencies );   // OpenMP over frames
+%
+%   Images are column major (MATLAB layout), gray, in [0,1]; uint8 frames
+%   are scaled by 1/255. Output maps are workRows x workCols in [0,1].
+%
+%   Per frame, as in demo_spectral_residual_saliency.m except that the
+%   frame is shrunk by area averaging instead of bicubic interpolation:
+%       F = fft2(img);  A = log|F|;  R = A - mean3x3(A);
+%       S = |ifft2(exp(R + i*angle(F)))|^2;  S = mat2gray(gauss(S));
+%   The 3x3 averaging (replicate border) is done while rebuilding the
+%   spectrum, and the squared modulus is taken inside the first pass of the
+%   separable Gaussian (zero border, fspecial/imfilter alignment).
+%
+% JJCAO, 2026
+*=================================================================*/
+
+#ifndef _SPECTRAL_RESIDUAL_H_
+#define _SPECTRAL_RESIDUAL_H_
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+typedef std::complex<double> Complex;
+
+// 1-D DFT of a fixed length. Radix-2 for powers of 2, a cached DFT table otherwise
+// (the working resolutions are small).
+class FFTPlan
+{
+public:
+	FFTPlan():n_(0) {}
+	void Init( int n )
+	{
+		n_ = n;
+		pow2_ = n>0 && (n & (n-1))==0;
+		const double pi = 3.14159265358979323846;
+		if( pow2_ )
+		{
+			twiddle_.resize( n/2 );
+			for( int k=0; k<n/2; ++k )
+				twiddle_[k] = Complex( cos(2*pi*k/n), -sin(2*pi*k/n) );
+			bitrev_.resize(n);
+			int logn = 0;
+			while( (1<<logn)<n ) ++logn;
+			for( int i=0; i<n; ++i )
+			{
+				int r = 0;
+				for( int b=0; b<logn; ++b )
+					if( i & (1<<b) ) r |= 1<<(logn-1-b);
+				bitrev_[i] = r;
+			}
+		}
+		else
+		{
+			twiddle_.resize(n);
+			for( int k=0; k<n; ++k )
+				twiddle_[k] = Complex( cos(2*pi*k/n), -sin(2*pi*k/n) );
+		}
+	}
+	int Size() const { return n_; }
+
+	// unnormalized transform of x in place, scratch must hold Size() values
+	void Transform( Complex *x, bool inverse, Complex *scratch ) const
+	{
+		if( pow2_ )
+		{
+			for( int i=0; i<n_; ++i )
+				if( i<bitrev_[i] ) std::swap( x[i], x[bitrev_[i]] );
+			for( int len=2; len<=n_; len<<=1 )
+			{
+				int half = len/2, step = n_/len;
+				for( int i=0; i<n_; i+=len )
+					for( int k=0; k<half; ++k )
+					{
+						Complex w = inverse ? conj(twiddle_[k*step]) : twiddle_[k*step];
+						Complex u = x[i+k], v = x[i+k+half]*w;
+						x[i+k] = u+v;
+						x[i+k+half] = u-v;
+					}
+			}
+		}
+		else
+		{
+			for( int k=0; k<n_; ++k )
+			{
+				Complex s = 0;
+				for( int j=0, jk=0; j<n_; ++j, jk=(jk+k)%n_ )
+					s += x[j]*( inverse ? conj(twiddle_[jk]) : twiddle_[jk] );
+				scratch[k] = s;
+			}
+			std::copy( scratch, scratch+n_, x );
+		}
+	}
+
+private:
+	int n_;
+	bool pow2_;
+	std::vector<Complex> twiddle_;
+	std::vector<int> bitrev_;
+};
+
+// Area resampling weights along one dimension : output i averages the input
+// samples src[first[i]..first[i]+count) with weights w[offset[i]...].
+struct Resampler
+{
+	std::vector<int> first, count, offset;
+	std::vector<double> w;
+	void Init( int nin, int nout )
+	{
+		first.resize(nout); count.resize(nout); offset.resize(nout);
+		w.clear();
+		double scale = (double) nin/nout;
+		for( int i=0; i<nout; ++i )
+		{
+			double a = i*scale, b = (i+1)*scale;
+			int j0 = (int) floor(a), j1 = std::min( nin, (int) ceil(b) );
+			first[i] = j0; count[i] = j1-j0; offset[i] = (int) w.size();
+			for( int j=j0; j<j1; ++j )
+				w.push_back( ( std::min(b,j+1.0) - std::max(a,(double)j) )/scale );
+		}
+	}
+};
+
+class SpectralResidual
+{
+public:
+	struct Workspace
+	{
+		std::vector<double> resampled;	// workRows x inCols
+		std::vector<Complex> spectrum;	// workRows x workCols
+		std::vector<Complex> line;		// one row or column of the spectrum
+		std::vector<Complex> scratch;
+		std::vector<double> logAmp;		// workRows x workCols
+		std::vector<double> blurred;	// workRows x workCols
+	};
+
+	SpectralResidual():inRows_(0),inCols_(0),rows_(0),cols_(0) {}
+
+	void Init( int inRows, int inCols, int workRows, int workCols,
+			   int avgSize = 3, double sigma = 2.5, int gaussSize = 10 )
+	{
+		inRows_ = inRows; inCols_ = inCols;
+		rows_ = workRows; cols_ = workCols;
+		avgSize_ = avgSize; sigma_ = sigma; gaussSize_ = gaussSize;
+		rowPlan_.Init( cols_ );		// along a row : length cols
+		colPlan_.Init( rows_ );
+		resampleRows_.Init( inRows_, rows_ );
+		resampleCols_.Init( inCols_, cols_ );
+		// fspecial('gaussian',n,sigma) is separable, imfilter puts its center at ceil(n/2)
+		gauss_.resize( gaussSize_ );
+		double sum = 0;
+		for( int k=0; k<gaussSize_; ++k )
+		{
+			double x = k - (gaussSize_-1)/2.0;
+			gauss_[k] = exp( -x*x/(2*sigma_*sigma_) );
+			sum += gauss_[k];
+		}
+		for( int k=0; k<gaussSize_; ++k )
+			gauss_[k] /= sum;
+		gaussOrigin_ = (gaussSize_+1)/2 - 1;
+
+		int nthreads = 1;
+#ifdef _OPENMP
+		nthreads = omp_get_max_threads();
+#endif
+		workspaces_.resize( nthreads );
+		for( int t=0; t<nthreads; ++t )
+			this->AllocateWorkspace( workspaces_[t] );
+	}
+
+	bool IsInit( int inRows, int inCols, int workRows, int workCols, int avgSize, double sigma, int gaussSize ) const
+	{
+		return inRows==inRows_ && inCols==inCols_ && workRows==rows_ && workCols==cols_ &&
+			avgSize==avgSize_ && sigma==sigma_ && gaussSize==gaussSize_;
+	}
+	int WorkRows() const { return rows_; }
+	int WorkCols() const { return cols_; }
+
+	// streaming API : one frame, the buffers of the first workspace are reused
+	template<class T>
+	void Process( const T *frame, double *saliency )
+	{
+		this->Process( frame, saliency, workspaces_[0] );
+	}
+
+	// frames are inRows x inCols x n, saliencies workRows x workCols x n
+	template<class T>
+	void ProcessBatch( const T *frames, int n, double *saliencies )
+	{
+		const int inSize = inRows_*inCols_, outSize = rows_*cols_;
+		// never more threads than workspaces, the team size may have grown since Init
+		#pragma omp parallel for schedule(dynamic,1) num_threads((int)workspaces_.size())
+		for( int f=0; f<n; ++f )
+		{
+			int t = 0;
+#ifdef _OPENMP
+			t = omp_get_thread_num();
+#endif
+			this->Process( frames + (size_t)f*inSize, saliencies + (size_t)f*outSize, workspaces_[t] );
+		}
+	}
+
+	template<class T>
+	void Process( const T *frame, double *saliency, Workspace &ws ) const
+	{
+		this->Resample( frame, ws );
+		this->Forward( ws );
+		this->Residual( ws );
+		this->Inverse( ws );
+		this->BlurAndNormalize( ws, saliency );
+	}
+
+private:
+	void AllocateWorkspace( Workspace &ws ) const
+	{
+		ws.resampled.resize( (size_t)rows_*inCols_ );
+		ws.spectrum.resize( (size_t)rows_*cols_ );
+		ws.line.resize( std::max(rows_,cols_) );
+		ws.scratch.resize( std::max(rows_,cols_) );
+		ws.logAmp.resize( (size_t)rows_*cols_ );
+		ws.blurred.resize( (size_t)rows_*cols_ );
+	}
+
+	static double ToUnit( double v ) { return v; }
+	static double ToUnit( unsigned char v ) { return v/255.0; }
+
+	// area resampling, along the columns then along the rows
+	template<class T>
+	void Resample( const T *frame, Workspace &ws ) const
+	{
+		for( int c=0; c<inCols_; ++c )
+		{
+			const T *src = frame + (size_t)c*inRows_;
+			double *dst = &ws.resampled[ (size_t)c*rows_ ];
+			for( int r=0; r<rows_; ++r )
+			{
+				const double *w = &resampleRows_.w[ resampleRows_.offset[r] ];
+				const T *s = src + resampleRows_.first[r];
+				double v = 0;
+				for( int k=0; k<resampleRows_.count[r]; ++k )
+					v += w[k]*ToUnit( s[k] );
+				dst[r] = v;
+			}
+		}
+		for( int c=0; c<cols_; ++c )
+		{
+			const double *w = &resampleCols_.w[ resampleCols_.offset[c] ];
+			Complex *dst = &ws.spectrum[ (size_t)c*rows_ ];
+			for( int r=0; r<rows_; ++r )
+				dst[r] = 0;
+			for( int k=0; k<resampleCols_.count[c]; ++k )
+			{
+				const double *src = &ws.resampled[ (size_t)(resampleCols_.first[c]+k)*rows_ ];
+				for( int r=0; r<rows_; ++r )
+					dst[r] += w[k]*src[r];
+			}
+		}
+	}
+
+	void Transform2D( Workspace &ws, bool inverse ) const
+	{
+		Complex *a = &ws.spectrum[0];
+		for( int c=0; c<cols_; ++c )
+			colPlan_.Transform( a + (size_t)c*rows_, inverse, &ws.scratch[0] );
+		Complex *line = &ws.line[0];
+		for( int r=0; r<rows_; ++r )
+		{
+			for( int c=0; c<cols_; ++c )
+				line[c] = a[ r + (size_t)c*rows_ ];
+			rowPlan_.Transform( line, inverse, &ws.scratch[0] );
+			for( int c=0; c<cols_; ++c )
+				a[ r + (size_t)c*rows_ ] = line[c];
+		}
+	}
+	void Forward( Workspace &ws ) const { this->Transform2D( ws, false ); }
+	void Inverse( Workspace &ws ) const { this->Transform2D( ws, true ); }	// unscaled, see BlurAndNormalize
+
+	// spectrum <- exp( logAmp - mean(logAmp) ) * phase, the mean over an
+	// avgSize x avgSize window with replicated borders
+	void Residual( Workspace &ws ) const
+	{
+		const int n = rows_*cols_;
+		for( int i=0; i<n; ++i )
+			ws.logAmp[i] = log( std::max( abs(ws.spectrum[i]), 1e-300 ) );
+		const int h0 = (avgSize_-1)/2, h1 = avgSize_/2;
+		const double inv = 1.0/(avgSize_*avgSize_);
+		for( int c=0; c<cols_; ++c )
+			for( int r=0; r<rows_; ++r )
+			{
+				double mean = 0;
+				for( int dc=-h0; dc<=h1; ++dc )
+				{
+					int cc = std::min( cols_-1, std::max( 0, c+dc ) );
+					const double *col = &ws.logAmp[ (size_t)cc*rows_ ];
+					for( int dr=-h0; dr<=h1; ++dr )
+						mean += col[ std::min( rows_-1, std::max( 0, r+dr ) ) ];
+				}
+				size_t i = r + (size_t)c*rows_;
+				double amp = abs( ws.spectrum[i] );
+				Complex phase = amp>0 ? ws.spectrum[i]/amp : Complex(1,0);
+				ws.spectrum[i] = exp( ws.logAmp[i] - mean*inv ) * phase;
+			}
+	}
+
+	// saliency = mat2gray( gauss( |spectrum/(rows*cols)|^2 ) ), zero padded
+	void BlurAndNormalize( Workspace &ws, double *saliency ) const
+	{
+		const double scale = 1.0/((double)rows_*cols_*rows_*cols_);
+		// vertical pass, reading the squared modulus directly
+		for( int c=0; c<cols_; ++c )
+		{
+			const Complex *src = &ws.spectrum[ (size_t)c*rows_ ];
+			double *dst = &ws.blurred[ (size_t)c*rows_ ];
+			for( int r=0; r<rows_; ++r )
+			{
+				double v = 0;
+				for( int k=0; k<gaussSize_; ++k )
+				{
+					int rr = r + k - gaussOrigin_;
+					if( rr>=0 && rr<rows_ )
+						v += gauss_[k]*norm( src[rr] );
+				}
+				dst[r] = v*scale;
+			}
+		}
+		// horizontal pass
+		double vmin = 1e300, vmax = -1e300;
+		for( int c=0; c<cols_; ++c )
+			for( int r=0; r<rows_; ++r )
+			{
+				double v = 0;
+				for( int k=0; k<gaussSize_; ++k )
+				{
+					int cc = c + k - gaussOrigin_;
+					if( cc>=0 && cc<cols_ )
+						v += gauss_[k]*ws.blurred[ r + (size_t)cc*rows_ ];
+				}
+				saliency[ r + (size_t)c*rows_ ] = v;
+				vmin = std::min( vmin, v );
+				vmax = std::max( vmax, v );
+			}
+		const int n = rows_*cols_;
+		if( vmax>vmin )
+			for( int i=0; i<n; ++i )
+				saliency[i] = (saliency[i]-vmin)/(vmax-vmin);
+		else
+			for( int i=0; i<n; ++i )
+				saliency[i] = 0;
+	}
+
+	int inRows_, inCols_, rows_, cols_;
+	int avgSize_, gaussSize_, gaussOrigin_;
+	double sigma_;
+	FFTPlan rowPlan_, colPlan_;
+	Resampler resampleRows_, resampleCols_;
+	std::vector<double> gauss_;
+	std::vector<Workspace> workspaces_;
+};
+
+#endif // _SPECTRAL_RESIDUAL_H_
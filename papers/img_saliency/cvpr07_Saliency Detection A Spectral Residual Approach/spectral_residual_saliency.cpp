@@ -0,0 +1,126 @@
+/*=================================================================
+% spectral_residual_saliency - spectral residual saliency of a batch of frames
+%
+%   S = spectral_residual_saliency(frames, options);
+%
+%   The pipeline of demo_spectral_residual_saliency.m, for a whole sequence
+%   in one call. Frames are shrunk by area averaging (imresize 'box') rather
+%   than bicubic, so the maps differ slightly from the .m version. The FFT
+%   plans and buffers are kept between calls while the frame size and the
+%   options do not change, so a video can also be fed frame by frame
+%   without reallocation.
+%
+%   inputs:
+%       frames: row x col x n gray frames (or row x col x 3 x n with
+%           options.rgb), uint8 or double in [0,1].
+%       options.rgb: frames are RGB, converted as rgb2gray does (0).
+%       options.width: working width (64).
+%       options.height: working height (default: keeps the aspect ratio).
+%       options.avg_size: size of the averaging filter of the log amplitude (3).
+%       options.sigma, options.gauss_size: final Gaussian blur (2.5, 10).
+%
+%   outputs:
+%       S: height x width x n saliency maps in [0,1].
+%
+% JJCAO, 2026
+*=================================================================*/
+
+#include <mex.h>
+#include "spectral_residual.h"
+using namespace std;
+
+static SpectralResidual *engine = NULL;
+
+static void cleanup()
+{
+	delete engine;
+	engine = NULL;
+}
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+template<class T>
+void rgb_to_gray( const T *rgb, int npix, int n, double scale, double *gray )
+{
+	#pragma omp parallel for schedule(static)
+	for( int f=0; f<n; ++f )
+	{
+		const T *src = rgb + (size_t)f*3*npix;
+		double *dst = gray + (size_t)f*npix;
+		for( int i=0; i<npix; ++i )
+			dst[i] = scale*( 0.2989*src[i] + 0.5870*src[i+npix] + 0.1140*src[i+2*npix] );
+	}
+}
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+{
+	if( nrhs<1 )
+		mexErrMsgTxt("Usage: S = spectral_residual_saliency(frames, options).");
+	const mxArray *mxFrames = prhs[0];
+	const mxArray *options = ( nrhs>=2 && mxIsStruct(prhs[1]) ) ? prhs[1] : NULL;
+	if( !mxIsUint8(mxFrames) && !mxIsDouble(mxFrames) )
+		mexErrMsgTxt("frames must be uint8 or double.");
+
+	bool rgb = get_option( options, "rgb", 0 )!=0;
+	mwSize ndim = mxGetNumberOfDimensions(mxFrames);
+	const mwSize *dims = mxGetDimensions(mxFrames);
+	int row = (int) dims[0], col = (int) dims[1];
+	int n = 1;
+	if( rgb )
+	{
+		if( ndim<3 || dims[2]!=3 )
+			mexErrMsgTxt("frames must be row x col x 3 x n with options.rgb.");
+		if( ndim>=4 ) n = (int) dims[3];
+	}
+	else if( ndim>=3 )
+		n = (int) dims[2];
+	if( row<1 || col<1 )
+		mexErrMsgTxt("frames must not be empty.");
+
+	int width = (int) get_option( options, "width", 64 );
+	if( width<1 )
+		mexErrMsgTxt("options.width must be positive.");
+	// imresize(img, width/col) rounds the scaled height up
+	int height = (int) get_option( options, "height", ceil( row*(double)width/col ) );
+	if( height<1 )
+		mexErrMsgTxt("options.height must be positive.");
+	int avgSize = (int) get_option( options, "avg_size", 3 );
+	double sigma = get_option( options, "sigma", 2.5 );
+	int gaussSize = (int) get_option( options, "gauss_size", 10 );
+	if( avgSize<1 || gaussSize<1 || sigma<=0 )
+		mexErrMsgTxt("options.avg_size, options.gauss_size and options.sigma must be positive.");
+
+	if( engine==NULL )
+	{
+		engine = new SpectralResidual;
+		mexAtExit( cleanup );
+	}
+	if( !engine->IsInit( row, col, height, width, avgSize, sigma, gaussSize ) )
+		engine->Init( row, col, height, width, avgSize, sigma, gaussSize );
+
+	mwSize odims[3] = { (mwSize)height, (mwSize)width, (mwSize)n };
+	plhs[0] = mxCreateNumericArray( 3, odims, mxDOUBLE_CLASS, mxREAL );
+	double *S = mxGetPr(plhs[0]);
+
+	if( rgb )
+	{
+		vector<double> gray( (size_t)row*col*n );
+		if( mxIsUint8(mxFrames) )
+			rgb_to_gray( (const unsigned char*) mxGetData(mxFrames), row*col, n, 1.0/255, &gray[0] );
+		else
+			rgb_to_gray( mxGetPr(mxFrames), row*col, n, 1.0, &gray[0] );
+		engine->ProcessBatch( &gray[0], n, S );
+	}
+	else if( mxIsUint8(mxFrames) )
+		engine->ProcessBatch( (const unsigned char*) mxGetData(mxFrames), n, S );
+	else
+		engine->ProcessBatch( mxGetPr(mxFrames), n, S );
+}
@@ -13,6 +13,10 @@ addpath(genpath('../../../toolbox/jjcao_img'));
 addpath(genpath('../../../toolbox/jjcao_plot'));
 addpath(genpath('../../../toolbox/kdtree'));
 DEBUG = 1;
+USE_MEX = 1; % native lazy greedy selection and saliency map, same result
+if USE_MEX && ~exist('submodular_saliency', 'file')
+    mex -O COMPFLAGS="$COMPFLAGS /openmp" submodular_saliency.cpp
+end
 
 train_data_dir = 'TrainedData';
 %% parameters
@@ -104,7 +108,12 @@ for ii=1:length(imnames)
     K = 5;    lambda =0; C_theta = 0.05;
 %     pos_label_inds = [superpixels(197,157),superpixels(77,142),superpixels(88,126),superpixels(158,115),superpixels(186,103)];
 % pos_label_inds = [451,60,540,101];  
-    [fa_location, fa_assig,K] = submodular_salient_region_detection(aff_mat,prior,K, lambda, pos_label_inds,sp_num,C_theta);
+    if USE_MEX
+        ssrdOpts.K = K; ssrdOpts.lambda = lambda; ssrdOpts.C_param = C_theta; ssrdOpts.sigma = 0.2;
+        [sp_saliency, fa_location, fa_assig, f] = submodular_saliency(aff_mat, prior, pos_label_inds, sp_fea, sp_center, ssrdOpts);
+    else
+        [fa_location, fa_assig,K] = submodular_salient_region_detection(aff_mat,prior,K, lambda, pos_label_inds,sp_num,C_theta);
+    end
         
     %
     outname=[saldir imnames(ii).name(1:end-4) '_ssrd.png'];
@@ -115,7 +124,11 @@ for ii=1:length(imnames)
     end
     
     %% 3.4. Saliency Map Construction
-    [f, sregion] = compute_saliency_map(fa_location, fa_assig, sp_fea, sp_center);
+    if USE_MEX
+        sregion = arrayfun(@(l) find(fa_assig == l), fa_location, 'UniformOutput', false);
+    else
+        [f, sregion] = compute_saliency_map(fa_location, fa_assig, sp_fea, sp_center);
+    end
 
     if DEBUG
         F = zeros(sp_num,1);
@@ -127,7 +140,9 @@ for ii=1:length(imnames)
         imshow(tmp);
     end
     %
-    sp_saliency = compute_S(fa_location, f, sp_fea, 0.2); % sigma*20
+    if ~USE_MEX
+        sp_saliency = compute_S(fa_location, f, sp_fea, 0.2); % sigma*20
+    end
     im_saliency = saliency_sp2im( sp_saliency, sp_inds, sp_num, m, n, w);
      
     %% output
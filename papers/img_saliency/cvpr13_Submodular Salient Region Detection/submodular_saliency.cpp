@@ -0,0 +1,471 @@
+/*=================================================================
+% submodular_saliency - submodular salient region detection, native version
+%
+%   [sp_saliency, fa_location, fa_assig, f, obj_val] = submodular_saliency(aff_mat, prior, pos_label_inds, sp_fea, sp_center, options);
+%
+%   Same result as submodular_salient_region_detection.m followed by
+%   compute_saliency_map.m and compute_S.m:
+%   1. C(:,j) = get_cij_prior(aff_mat, prior, pos_label_inds(j), ...) for all
+%      candidates. With M = I - (1-C_param)*P on the superpixels (the ground
+%      node is a label with h=0), every C(:,j) is a rank one correction of
+%      the solution of one system, so M is factorized once instead of
+%      inverting a sub matrix per candidate.
+%   2. Facility location greedy with lazy evaluation: marginal gains only
+%      decrease, so a candidate is re-evaluated only when it reaches the top
+%      of the priority queue. Ties are broken by the order of
+%      pos_label_inds, as max() does in the matlab version.
+%   3. Region saliency f (color distinctness * spatial compactness) and
+%      superpixel saliency S = W*f.
+%
+%   inputs:
+%       aff_mat: sp_num x sp_num affinity, dense or sparse (gene_weight).
+%       prior: sp_num (or sp_num+1) x 1 prior.
+%       pos_label_inds: candidate superpixels (1-based).
+%       sp_fea: sp_num x d features; sp_center: sp_num x 2 centers.
+%       options.K: max number of regions (5).
+%       options.lambda: cost of a region (0).
+%       options.C_param: restart probability of the random walk (0.05).
+%       options.ground_cond: affinity to the ground node (0.1).
+%       options.sigma: bandwidth of compute_S (0.2).
+%
+%   outputs:
+%       sp_saliency: sp_num x 1, to be given to saliency_sp2im.
+%       fa_location: 1 x K selected superpixels; fa_assig: sp_num x 1 region
+%           (selected superpixel) of each superpixel.
+%       f: K x 1 region saliency; obj_val: 1 x (K+1) objective values.
+%
+% JJCAO, 2026
+*=================================================================*/
+
+#include <mex.h>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace std;
+
+struct SSRDOptions
+{
+	int K;
+	double lambda;
+	double C_param;
+	double ground_cond;
+	double sigma;
+};
+
+// compressed rows of the affinity matrix
+struct SparseRows
+{
+	vector<int> start, col;
+	vector<double> val;
+};
+
+void read_affinity( const mxArray *mxA, int n, SparseRows &A )
+{
+	A.start.assign( n+1, 0 );
+	A.col.clear(); A.val.clear();
+	if( mxIsSparse(mxA) )
+	{
+		const mwIndex *ir = mxGetIr(mxA), *jc = mxGetJc(mxA);
+		const double *pr = mxGetPr(mxA);
+		for( int j=0; j<n; ++j )
+			for( mwIndex k=jc[j]; k<jc[j+1]; ++k )
+				if( pr[k]!=0 ) ++A.start[ ir[k]+1 ];
+		for( int i=0; i<n; ++i )
+			A.start[i+1] += A.start[i];
+		A.col.resize( A.start[n] ); A.val.resize( A.start[n] );
+		vector<int> pos( A.start.begin(), A.start.end()-1 );
+		for( int j=0; j<n; ++j )
+			for( mwIndex k=jc[j]; k<jc[j+1]; ++k )
+				if( pr[k]!=0 )
+				{
+					int p = pos[ ir[k] ]++;
+					A.col[p] = j; A.val[p] = pr[k];
+				}
+	}
+	else
+	{
+		const double *pr = mxGetPr(mxA);
+		for( int i=0; i<n; ++i )
+		{
+			for( int j=0; j<n; ++j )
+				if( pr[i+(size_t)j*n]!=0 )
+				{
+					A.col.push_back(j);
+					A.val.push_back( pr[i+(size_t)j*n] );
+				}
+			A.start[i+1] = (int) A.col.size();
+		}
+	}
+}
+
+// M = I - (1-c)*D^-1*A restricted to the superpixels, LU without pivoting
+// (M is strictly diagonally dominant by rows), row major
+void factorize( const SparseRows &A, int n, const SSRDOptions &opt, vector<double> &LU )
+{
+	LU.assign( (size_t)n*n, 0 );
+	for( int i=0; i<n; ++i )
+	{
+		double sum = opt.ground_cond;
+		for( int k=A.start[i]; k<A.start[i+1]; ++k )
+			sum += A.val[k];
+		double *row = &LU[(size_t)i*n];
+		for( int k=A.start[i]; k<A.start[i+1]; ++k )
+			row[ A.col[k] ] -= (1-opt.C_param)*A.val[k]/sum;
+		row[i] += 1;
+	}
+	for( int k=0; k<n; ++k )
+	{
+		const double *rk = &LU[(size_t)k*n];
+		#pragma omp parallel for schedule(static)
+		for( int i=k+1; i<n; ++i )
+		{
+			double *ri = &LU[(size_t)i*n];
+			if( ri[k]==0 ) continue;
+			double l = ri[k] /= rk[k];
+			for( int j=k+1; j<n; ++j )
+				ri[j] -= l*rk[j];
+		}
+	}
+}
+
+void lu_solve( const vector<double> &LU, int n, double *x )
+{
+	for( int i=0; i<n; ++i )
+	{
+		const double *ri = &LU[(size_t)i*n];
+		double s = x[i];
+		for( int j=0; j<i; ++j )
+			s -= ri[j]*x[j];
+		x[i] = s;
+	}
+	for( int i=n-1; i>=0; --i )
+	{
+		const double *ri = &LU[(size_t)i*n];
+		double s = x[i];
+		for( int j=i+1; j<n; ++j )
+			s -= ri[j]*x[j];
+		x[i] = s/ri[i];
+	}
+}
+
+// C(:,m) for all candidates, and the initial value sum(C(:,m)) of each candidate.
+// For the label j the system of get_cij_prior is M with its row j replaced by
+// e_j', solved by Sherman-Morrison from z0 = M\(c*q) and x = M\e_j.
+void compute_cij( const vector<double> &LU, int n, const double *prior, const vector<int> &labels,
+				  const SSRDOptions &opt, vector<double> &C, vector<double> &F0 )
+{
+	const double c = opt.C_param;
+	int nlabel = (int) labels.size();
+	vector<double> z0(n);
+	for( int i=0; i<n; ++i )
+		z0[i] = c*(1-prior[i]);
+	lu_solve( LU, n, &z0[0] );
+
+	C.resize( (size_t)n*nlabel );
+	F0.resize( nlabel );
+	#pragma omp parallel for schedule(dynamic,1)
+	for( int m=0; m<nlabel; ++m )
+	{
+		int j = labels[m];
+		vector<double> x( n, 0.0 );
+		x[j] = 1;
+		lu_solve( LU, n, &x[0] );
+		double *h = &C[(size_t)m*n];
+		double bj = 1 - c*(1-prior[j]);
+		for( int i=0; i<n; ++i )
+			h[i] = z0[i] + bj*x[i];
+		double t = (h[j]-1)/x[j];
+		double sum = 0;
+		for( int i=0; i<n; ++i )
+		{
+			h[i] -= t*x[i];
+			sum += h[i];
+		}
+		sum += 1 - h[j];
+		h[j] = 1;
+		F0[m] = sum;
+	}
+}
+
+struct Candidate
+{
+	double gain;
+	int index;		// in pos_label_inds
+	int round;		// when gain was computed
+	bool operator<( const Candidate &b ) const
+	{
+		return gain<b.gain || ( gain==b.gain && index>b.index );
+	}
+};
+
+// lazy greedy facility location, fills the selected candidates and the assignment
+void lazy_greedy( const vector<double> &C, int n, const vector<int> &labels, const vector<double> &F0,
+				  const SSRDOptions &opt, vector<int> &selected, vector<int> &assig, vector<double> &obj )
+{
+	int nlabel = (int) labels.size();
+	int K = min( opt.K, nlabel );
+	vector<double> pi( n, 0.0 );
+	vector<bool> isSelected( n, false );
+	assig.assign( n, -1 );
+	selected.clear();
+	obj.assign( 1, 0.0 );
+
+	priority_queue<Candidate> queue;
+	for( int m=0; m<nlabel; ++m )
+	{
+		Candidate cand = { F0[m], m, 0 };
+		queue.push( cand );
+	}
+	double Fcur = 0;
+	for( int round=0; round<K && !queue.empty(); ++round )
+	{
+		Candidate top = queue.top();
+		while( top.round!=round )
+		{
+			queue.pop();
+			const double *cm = &C[(size_t)top.index*n];
+			double F = 0;
+			for( int i=0; i<n; ++i )
+				F += max( pi[i], cm[i] );
+			top.gain = F - Fcur;
+			top.round = round;
+			queue.push( top );
+			top = queue.top();
+		}
+		if( top.gain<=opt.lambda )
+			break;
+		queue.pop();
+		Fcur += top.gain;
+		obj.push_back( Fcur - opt.lambda*(round+1) );
+
+		int loc = labels[top.index];
+		selected.push_back( top.index );
+		isSelected[loc] = true;
+		pi[loc] = 1;
+		const double *cm = &C[(size_t)top.index*n];
+		for( int i=0; i<n; ++i )
+			if( !isSelected[i] && pi[i]<cm[i] )
+			{
+				pi[i] = cm[i];
+				assig[i] = loc;
+			}
+		for( size_t s=0; s<selected.size(); ++s )
+			assig[ labels[selected[s]] ] = labels[selected[s]];
+	}
+}
+
+// compute_saliency_map.m : f = normalized distinctness .* normalized compactness
+void region_saliency( const vector<int> &locations, const vector<int> &assig, int n,
+					  const double *fea, int dim, const double *center, vector<double> &f )
+{
+	int R = (int) locations.size();
+	vector<int> region( n, -1 ), npix( R, 0 );
+	for( int r=0; r<R; ++r )
+		for( int i=0; i<n; ++i )
+			if( assig[i]==locations[r] )
+			{
+				region[i] = r;
+				++npix[r];
+			}
+
+	// Dc(r,s) = mean feature distance between the superpixels of r and s
+	vector<double> pairSum( (size_t)n*R, 0.0 );
+	#pragma omp parallel for schedule(dynamic,16)
+	for( int p=0; p<n; ++p )
+	{
+		if( region[p]<0 ) continue;
+		double *acc = &pairSum[(size_t)p*R];
+		for( int q=0; q<n; ++q )
+		{
+			if( region[q]<0 ) continue;
+			double d2 = 0;
+			for( int d=0; d<dim; ++d )
+			{
+				double t = fea[p+(size_t)d*n] - fea[q+(size_t)d*n];
+				d2 += t*t;
+			}
+			acc[ region[q] ] += sqrt(d2);
+		}
+	}
+	vector<double> Dc( (size_t)R*R, 0.0 );
+	for( int p=0; p<n; ++p )
+		if( region[p]>=0 )
+			for( int s=0; s<R; ++s )
+				Dc[ region[p]*R + s ] += pairSum[(size_t)p*R+s];
+	for( int r=0; r<R; ++r )
+		for( int s=0; s<R; ++s )
+			Dc[r*R+s] /= (double) npix[r]*npix[s];
+
+	// V(r) = sum_k mean distance from the superpixels of r to the center of k
+	vector<double> rc( 2*R, 0.0 );
+	for( int i=0; i<n; ++i )
+		if( region[i]>=0 )
+		{
+			rc[2*region[i]] += center[i];
+			rc[2*region[i]+1] += center[i+n];
+		}
+	for( int r=0; r<R; ++r )
+	{
+		rc[2*r] /= npix[r];
+		rc[2*r+1] /= npix[r];
+	}
+	vector<double> V( R, 0.0 );
+	for( int r=0; r<R; ++r )
+		for( int k=0; k<R; ++k )
+		{
+			double sum = 0;
+			for( int i=0; i<n; ++i )
+				if( region[i]==r )
+				{
+					double dx = rc[2*k]-center[i], dy = rc[2*k+1]-center[i+n];
+					sum += sqrt( dx*dx + dy*dy );
+				}
+			V[r] += sum/npix[r];
+		}
+	double maxV = *max_element( V.begin(), V.end() );
+
+	vector<double> fc( R, 0.0 ), fs( R );
+	for( int r=0; r<R; ++r )
+	{
+		for( int s=0; s<R; ++s )
+			fc[r] += Dc[r*R+s]*npix[s];
+		fs[r] = 1 - V[r]/maxV;
+	}
+	double fcmin = *min_element(fc.begin(),fc.end()), fcmax = *max_element(fc.begin(),fc.end());
+	double fsmin = *min_element(fs.begin(),fs.end()), fsmax = *max_element(fs.begin(),fs.end());
+	f.resize(R);
+	for( int r=0; r<R; ++r )
+		f[r] = (fc[r]-fcmin)/(fcmax-fcmin) * (fs[r]-fsmin)/(fsmax-fsmin);
+}
+
+// compute_S.m : S = W*f, W(p,r) = exp(-beta*|fea_p - fea_loc(r)|^2)
+void superpixel_saliency( const vector<int> &locations, const vector<double> &f, int n,
+						  const double *fea, int dim, double sigma, double *S )
+{
+	int R = (int) locations.size();
+	vector<double> dist( (size_t)n*R );
+	double dmin = DBL_MAX, dsum = 0;
+	for( int r=0; r<R; ++r )
+		for( int p=0; p<n; ++p )
+		{
+			double d2 = 0;
+			for( int d=0; d<dim; ++d )
+			{
+				double t = fea[p+(size_t)d*n] - fea[locations[r]+(size_t)d*n];
+				d2 += t*t;
+			}
+			d2 += DBL_EPSILON;
+			dist[p+(size_t)r*n] = d2;
+			dmin = min( dmin, d2 );
+			dsum += d2;
+		}
+	double beta = 1.0/max( dmin, sigma*dsum/((double)n*R) );
+	for( int p=0; p<n; ++p )
+	{
+		double s = 0;
+		for( int r=0; r<R; ++r )
+			s += exp( -beta*dist[p+(size_t)r*n] )*f[r];
+		S[p] = s;
+	}
+}
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+{
+	if( nrhs<5 )
+		mexErrMsgTxt("Usage: [sp_saliency, fa_location, fa_assig, f, obj_val] = submodular_saliency(aff_mat, prior, pos_label_inds, sp_fea, sp_center, options).");
+	const mxArray *options = ( nrhs>=6 && mxIsStruct(prhs[5]) ) ? prhs[5] : NULL;
+
+	int n = (int) mxGetM(prhs[0]);
+	if( !mxIsDouble(prhs[0]) || (int)mxGetN(prhs[0])!=n )
+		mexErrMsgTxt("aff_mat must be a sp_num x sp_num double matrix.");
+	if( (int)mxGetNumberOfElements(prhs[1])<n )
+		mexErrMsgTxt("prior must have sp_num (or sp_num+1) elements.");
+	const double *prior = mxGetPr(prhs[1]);
+	int nlabel = (int) mxGetNumberOfElements(prhs[2]);
+	const double *pLabels = mxGetPr(prhs[2]);
+	vector<int> labels( nlabel );
+	for( int m=0; m<nlabel; ++m )
+	{
+		labels[m] = (int) pLabels[m] - 1;
+		if( labels[m]<0 || labels[m]>=n )
+			mexErrMsgTxt("pos_label_inds must be in 1..sp_num.");
+	}
+	if( (int)mxGetM(prhs[3])!=n || (int)mxGetM(prhs[4])!=n || mxGetN(prhs[4])<2 )
+		mexErrMsgTxt("sp_fea must be sp_num x d and sp_center sp_num x 2.");
+	const double *fea = mxGetPr(prhs[3]);
+	int dim = (int) mxGetN(prhs[3]);
+	const double *center = mxGetPr(prhs[4]);
+
+	SSRDOptions opt;
+	opt.K = (int) get_option( options, "K", 5 );
+	opt.lambda = get_option( options, "lambda", 0 );
+	opt.C_param = get_option( options, "C_param", 0.05 );
+	opt.ground_cond = get_option( options, "ground_cond", 0.1 );
+	opt.sigma = get_option( options, "sigma", 0.2 );
+	if( opt.C_param<=0 || opt.C_param>1 || opt.ground_cond<=0 )
+		mexErrMsgTxt("options.C_param must be in (0,1] and options.ground_cond positive.");
+
+	SparseRows A;
+	read_affinity( prhs[0], n, A );
+	vector<double> LU;
+	factorize( A, n, opt, LU );
+	vector<double> C, F0;
+	compute_cij( LU, n, prior, labels, opt, C, F0 );
+	LU.clear();
+
+	vector<int> selected, assig;
+	vector<double> obj;
+	lazy_greedy( C, n, labels, F0, opt, selected, assig, obj );
+	int R = (int) selected.size();
+	vector<int> locations( R );
+	for( int r=0; r<R; ++r )
+		locations[r] = labels[ selected[r] ];
+
+	vector<double> f;
+	plhs[0] = mxCreateDoubleMatrix( n, 1, mxREAL );
+	if( R>0 )
+	{
+		region_saliency( locations, assig, n, fea, dim, center, f );
+		superpixel_saliency( locations, f, n, fea, dim, opt.sigma, mxGetPr(plhs[0]) );
+	}
+
+	if( nlhs>=2 )
+	{
+		plhs[1] = mxCreateDoubleMatrix( 1, R, mxREAL );
+		for( int r=0; r<R; ++r )
+			mxGetPr(plhs[1])[r] = locations[r]+1;
+	}
+	if( nlhs>=3 )
+	{
+		plhs[2] = mxCreateDoubleMatrix( n, 1, mxREAL );
+		for( int i=0; i<n; ++i )
+			mxGetPr(plhs[2])[i] = assig[i]+1;
+	}
+	if( nlhs>=4 )
+	{
+		plhs[3] = mxCreateDoubleMatrix( R, 1, mxREAL );
+		for( int r=0; r<R; ++r )
+			mxGetPr(plhs[3])[r] = f[r];
+	}
+	if( nlhs>=5 )
+	{
+		plhs[4] = mxCreateDoubleMatrix( 1, obj.size(), mxREAL );
+		for( size_t k=0; k<obj.size(); ++k )
+			mxGetPr(plhs[4])[k] = obj[k];
+	}
+}
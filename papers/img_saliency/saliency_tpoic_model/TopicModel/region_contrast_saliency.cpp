@@ -0,0 +1,372 @@
+/*=================================================================
+% region_contrast_saliency - region contrast saliency of a superpixel segmentation
+%
+%   [sal, salImg, dist, colors] = region_contrast_saliency(img, spImg, options);
+%
+%   Colors are quantized to binnum^3 bins, only the most frequent bins
+%   covering options.ratio of the pixels are kept and the others are merged
+%   into their nearest kept color. Each region is then a sparse histogram of
+%   kept colors, and its saliency is its color contrast to the other regions,
+%   weighted by their size and by their spatial distance:
+%       sal(k) = sum_i exp(-|c_k-c_i|^2/sigma_s) * n_i * dist(k,i)
+%       dist(k,i) = sum_{p,q} f_k(p) f_i(q) |Lab(p)-Lab(q)|
+%
+%   inputs:
+%       img: row x col x 3, RGB in [0,255], uint8 or double.
+%       spImg: row x col superpixel labels in 1..nSeg (double).
+%       options.binnum: bins per channel (12).
+%       options.ratio: fraction of the pixels covered by the kept colors (0.95).
+%       options.sigma_s: spatial weighting, centroids are normalized to
+%           [0,1]; <=0 disables it (0.4).
+%
+%   outputs:
+%       sal: nSeg x 1, region saliency normalized to [0,1].
+%       salImg: row x col saliency map.
+%       dist: nSeg x nSeg color distance between the region histograms
+%           (what patch_distance computes, from a C x C color table).
+%       colors: C x 3, Lab of the kept colors.
+%
+% JJCAO, 2026
+*=================================================================*/
+
+#include <mex.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace std;
+
+struct RCOptions
+{
+	int binnum;
+	double ratio;
+	double sigma_s;
+};
+
+// same conversion as RGB2Lab.m, rgb in [0,1]
+void rgb2lab( double r, double g, double b, double *lab )
+{
+	const double T = 0.008856;
+	double X = (0.412453*r + 0.357580*g + 0.180423*b) / 0.950456;
+	double Y =  0.212671*r + 0.715160*g + 0.072169*b;
+	double Z = (0.019334*r + 0.119193*g + 0.950227*b) / 1.088754;
+	double fX = X>T ? pow(X,1.0/3) : 7.787*X + 16.0/116;
+	double fY = Y>T ? pow(Y,1.0/3) : 7.787*Y + 16.0/116;
+	double fZ = Z>T ? pow(Z,1.0/3) : 7.787*Z + 16.0/116;
+	lab[0] = Y>T ? 116*fY - 16.0 : 903.3*Y;
+	lab[1] = 500*(fX-fY);
+	lab[2] = 200*(fY-fZ);
+}
+
+// Quantized color of each pixel, in 0..C-1, and the Lab of the C kept colors.
+template<class T>
+int quantize_colors( const T *img, int npix, const RCOptions &opt, vector<int> &pixColor, vector<double> &colorLab )
+{
+	const int binnum = opt.binnum;
+	const int nbin = binnum*binnum*binnum;
+	vector<int> binCount(nbin,0);
+	vector<double> binSum(3*nbin,0);
+	vector<int> pixBin(npix);
+	for( int i=0; i<npix; ++i )
+	{
+		double c[3] = { (double)img[i], (double)img[i+npix], (double)img[i+2*npix] };
+		int idx[3];
+		for( int d=0; d<3; ++d )
+			idx[d] = min( binnum-1, max( 0, (int)(c[d]*binnum/256.0) ) );
+		int bin = idx[0] + binnum*(idx[1] + binnum*idx[2]);
+		pixBin[i] = bin;
+		++binCount[bin];
+		for( int d=0; d<3; ++d )
+			binSum[3*bin+d] += c[d];
+	}
+
+	// non empty bins, most frequent first. Only the head covering ratio*npix is
+	// needed, so partial sort a growing prefix instead of sorting everything.
+	vector< pair<int,int> > bins;
+	for( int b=0; b<nbin; ++b )
+		if( binCount[b]>0 )
+			bins.push_back( make_pair(binCount[b], b) );
+	const long maxCover = (long) ceil( opt.ratio*npix );
+	int nkept = 0;
+	long cover = 0;
+	int nsorted = 0;
+	while( cover<maxCover && nkept<(int)bins.size() )
+	{
+		if( nkept==nsorted )
+		{
+			int next = min( (int)bins.size(), max(64, 2*nsorted) );
+			partial_sort( bins.begin()+nsorted, bins.begin()+next, bins.end(), greater< pair<int,int> >() );
+			nsorted = next;
+		}
+		cover += bins[nkept].first;
+		++nkept;
+	}
+	if( nkept==0 )
+		nkept = min( 1, (int)bins.size() );
+
+	// Lab of every non empty bin, from the mean RGB of its pixels
+	vector<int> binToColor(nbin,-1);
+	vector<double> binLab(3*bins.size());
+	for( size_t k=0; k<bins.size(); ++k )
+	{
+		int b = bins[k].second;
+		double n = 255.0*binCount[b];
+		rgb2lab( binSum[3*b]/n, binSum[3*b+1]/n, binSum[3*b+2]/n, &binLab[3*k] );
+	}
+	colorLab.assign( binLab.begin(), binLab.begin()+3*nkept );
+	for( int k=0; k<nkept; ++k )
+		binToColor[ bins[k].second ] = k;
+
+	// the rare colors go to their nearest kept color
+	for( int k=nkept; k<(int)bins.size(); ++k )
+	{
+		const double *lab = &binLab[3*k];
+		int best = 0;
+		double bestDist = 1e300;
+		for( int j=0; j<nkept; ++j )
+		{
+			double dL = lab[0]-colorLab[3*j], da = lab[1]-colorLab[3*j+1], db = lab[2]-colorLab[3*j+2];
+			double dist = dL*dL + da*da + db*db;
+			if( dist<bestDist ) { bestDist = dist; best = j; }
+		}
+		binToColor[ bins[k].second ] = best;
+	}
+
+	pixColor.resize(npix);
+	for( int i=0; i<npix; ++i )
+		pixColor[i] = binToColor[ pixBin[i] ];
+	return nkept;
+}
+
+// Sparse color histogram of each region in CSR form : the colors of region k are
+// color[offset[k]..offset[k+1]) with frequencies freq[...], summing to 1.
+struct RegionHistograms
+{
+	vector<int> offset;
+	vector<int> color;
+	vector<double> freq;
+	vector<int> npix;
+	vector<double> cx, cy;	// normalized centroid
+};
+
+void build_region_histograms( const double *labels, int row, int col, int nseg, int ncolor,
+							  const vector<int> &pixColor, RegionHistograms &h )
+{
+	const int npix = row*col;
+	// bucket the pixels by region
+	h.npix.assign( nseg, 0 );
+	for( int i=0; i<npix; ++i )
+		++h.npix[ (int)labels[i]-1 ];
+	vector<int> start(nseg+1,0);
+	for( int k=0; k<nseg; ++k )
+		start[k+1] = start[k] + h.npix[k];
+	vector<int> order(npix);
+	{
+		vector<int> pos( start.begin(), start.end()-1 );
+		for( int i=0; i<npix; ++i )
+			order[ pos[(int)labels[i]-1]++ ] = i;
+	}
+
+	// each region is independent, count its colors with a per thread scratch
+	vector< vector<int> > regColor(nseg);
+	vector< vector<double> > regFreq(nseg);
+	h.cx.assign( nseg, 0 );
+	h.cy.assign( nseg, 0 );
+	#pragma omp parallel
+	{
+		vector<int> count(ncolor,0);
+		vector<int> touched;
+		#pragma omp for schedule(dynamic,16)
+		for( int k=0; k<nseg; ++k )
+		{
+			touched.clear();
+			double sx = 0, sy = 0;
+			for( int p=start[k]; p<start[k+1]; ++p )
+			{
+				int i = order[p];
+				int c = pixColor[i];
+				if( count[c]++==0 )
+					touched.push_back(c);
+				sy += i%row;
+				sx += i/row;
+			}
+			sort( touched.begin(), touched.end() );
+			int n = h.npix[k];
+			regColor[k] = touched;
+			regFreq[k].resize( touched.size() );
+			for( size_t j=0; j<touched.size(); ++j )
+			{
+				regFreq[k][j] = (double) count[touched[j]]/n;
+				count[touched[j]] = 0;
+			}
+			if( n>0 )
+			{
+				h.cx[k] = sx/n/col;
+				h.cy[k] = sy/n/row;
+			}
+		}
+	}
+
+	h.offset.assign( nseg+1, 0 );
+	for( int k=0; k<nseg; ++k )
+		h.offset[k+1] = h.offset[k] + (int) regColor[k].size();
+	h.color.resize( h.offset[nseg] );
+	h.freq.resize( h.offset[nseg] );
+	for( int k=0; k<nseg; ++k )
+	{
+		copy( regColor[k].begin(), regColor[k].end(), h.color.begin()+h.offset[k] );
+		copy( regFreq[k].begin(), regFreq[k].end(), h.freq.begin()+h.offset[k] );
+	}
+}
+
+// dist is nseg x nseg, column major. Only the upper triangle is computed.
+void region_distance( const RegionHistograms &h, int nseg, const vector<double> &colorDist, int ncolor, double *dist )
+{
+	#pragma omp parallel for schedule(dynamic,8)
+	for( int k=0; k<nseg; ++k )
+	{
+		for( int i=k; i<nseg; ++i )
+		{
+			double d = 0;
+			for( int p=h.offset[k]; p<h.offset[k+1]; ++p )
+			{
+				const double *row = &colorDist[ h.color[p]*ncolor ];
+				double s = 0;
+				for( int q=h.offset[i]; q<h.offset[i+1]; ++q )
+					s += h.freq[q]*row[ h.color[q] ];
+				d += h.freq[p]*s;
+			}
+			dist[k+i*nseg] = d;
+			dist[i+k*nseg] = d;
+		}
+	}
+}
+
+void region_saliency( const RegionHistograms &h, int nseg, const double *dist, double sigma_s, double *sal )
+{
+	#pragma omp parallel for schedule(static)
+	for( int k=0; k<nseg; ++k )
+	{
+		double s = 0;
+		for( int i=0; i<nseg; ++i )
+		{
+			if( i==k || h.npix[i]==0 )
+				continue;
+			double w = h.npix[i];
+			if( sigma_s>0 )
+			{
+				double dx = h.cx[k]-h.cx[i], dy = h.cy[k]-h.cy[i];
+				w *= exp( -(dx*dx+dy*dy)/sigma_s );
+			}
+			s += w*dist[k+i*nseg];
+		}
+		sal[k] = s;
+	}
+	double smin = 1e300, smax = -1e300;
+	for( int k=0; k<nseg; ++k )
+	{
+		if( h.npix[k]==0 ) continue;
+		smin = min( smin, sal[k] );
+		smax = max( smax, sal[k] );
+	}
+	for( int k=0; k<nseg; ++k )
+		sal[k] = ( h.npix[k]==0 || smax<=smin ) ? 0 : (sal[k]-smin)/(smax-smin);
+}
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+{
+	if( nrhs<2 )
+		mexErrMsgTxt("Usage: [sal, salImg, dist, colors] = region_contrast_saliency(img, spImg, options).");
+	const mxArray *mxImg = prhs[0];
+	const mxArray *mxLabels = prhs[1];
+	const mxArray *options = ( nrhs>=3 && mxIsStruct(prhs[2]) ) ? prhs[2] : NULL;
+
+	const mwSize *dims = mxGetDimensions(mxImg);
+	if( mxGetNumberOfDimensions(mxImg)!=3 || dims[2]!=3 )
+		mexErrMsgTxt("img must be row x col x 3.");
+	if( !mxIsUint8(mxImg) && !mxIsDouble(mxImg) )
+		mexErrMsgTxt("img must be uint8 or double.");
+	int row = (int) dims[0], col = (int) dims[1];
+	int npix = row*col;
+	if( !mxIsDouble(mxLabels) || (int)mxGetM(mxLabels)!=row || (int)mxGetN(mxLabels)!=col )
+		mexErrMsgTxt("spImg must be a row x col double matrix.");
+	const double *labels = mxGetPr(mxLabels);
+	int nseg = 0;
+	for( int i=0; i<npix; ++i )
+	{
+		if( labels[i]<1 || labels[i]!=floor(labels[i]) )
+			mexErrMsgTxt("spImg must contain labels in 1..nSeg.");
+		nseg = max( nseg, (int)labels[i] );
+	}
+
+	RCOptions opt;
+	opt.binnum = (int) get_option( options, "binnum", 12 );
+	opt.ratio = get_option( options, "ratio", 0.95 );
+	opt.sigma_s = get_option( options, "sigma_s", 0.4 );
+	if( opt.binnum<1 || opt.binnum>256 )
+		mexErrMsgTxt("options.binnum must be in 1..256.");
+
+	// color quantization
+	vector<int> pixColor;
+	vector<double> colorLab;
+	int ncolor;
+	if( mxIsUint8(mxImg) )
+		ncolor = quantize_colors( (const unsigned char*) mxGetData(mxImg), npix, opt, pixColor, colorLab );
+	else
+		ncolor = quantize_colors( mxGetPr(mxImg), npix, opt, pixColor, colorLab );
+
+	// the color distances are computed once
+	vector<double> colorDist( (size_t)ncolor*ncolor );
+	#pragma omp parallel for schedule(static)
+	for( int p=0; p<ncolor; ++p )
+		for( int q=0; q<ncolor; ++q )
+		{
+			double dL = colorLab[3*p]-colorLab[3*q], da = colorLab[3*p+1]-colorLab[3*q+1], db = colorLab[3*p+2]-colorLab[3*q+2];
+			colorDist[(size_t)p*ncolor+q] = sqrt( dL*dL + da*da + db*db );
+		}
+
+	RegionHistograms h;
+	build_region_histograms( labels, row, col, nseg, ncolor, pixColor, h );
+
+	mxArray *mxDist = mxCreateDoubleMatrix( nseg, nseg, mxREAL );
+	double *dist = mxGetPr(mxDist);
+	region_distance( h, nseg, colorDist, ncolor, dist );
+
+	plhs[0] = mxCreateDoubleMatrix( nseg, 1, mxREAL );
+	double *sal = mxGetPr(plhs[0]);
+	region_saliency( h, nseg, dist, opt.sigma_s, sal );
+
+	if( nlhs>=2 )
+	{
+		plhs[1] = mxCreateDoubleMatrix( row, col, mxREAL );
+		double *salImg = mxGetPr(plhs[1]);
+		for( int i=0; i<npix; ++i )
+			salImg[i] = sal[ (int)labels[i]-1 ];
+	}
+	if( nlhs>=3 )
+		plhs[2] = mxDist;
+	else
+		mxDestroyArray(mxDist);
+	if( nlhs>=4 )
+	{
+		plhs[3] = mxCreateDoubleMatrix( ncolor, 3, mxREAL );
+		double *colors = mxGetPr(plhs[3]);
+		for( int k=0; k<ncolor; ++k )
+			for( int d=0; d<3; ++d )
+				colors[k+d*ncolor] = colorLab[3*k+d];
+	}
+}
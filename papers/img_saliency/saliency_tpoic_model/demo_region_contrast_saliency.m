@@ -0,0 +1,32 @@
+% Demo of region_contrast_saliency: region contrast saliency on the SLIC
+% superpixels of one MSRA image.
+%
+% jjcao @ 2026
+
+clear;clc;close all;
+addpath('TopicModel');
+addpath('../cvpr13_Submodular Salient Region Detection/pre_proce');
+if ~exist('region_contrast_saliency', 'file')
+    cd TopicModel;
+    mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" region_contrast_saliency.cpp
+    cd ..;
+end
+
+%% input
+name = 'Imgs_0001';
+img = imread(['../img/input/MSRA1000/' name '.bmp']);
+[row,col,~] = size(img);
+spImg = read_dat([row,col], ['../img/output/superpixels/' name '.dat']);
+
+%% saliency
+options.binnum = 12;
+options.ratio = 0.95;
+options.sigma_s = 0.4;
+tic;
+[sal, salImg, dist, colors] = region_contrast_saliency(img, double(spImg), options);
+toc
+fprintf('%d regions, %d colors\n', numel(sal), size(colors,1));
+
+figure;set(gcf,'color','white');
+subplot(1,2,1); imshow(img);
+subplot(1,2,2); imshow(salImg,[]);
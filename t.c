@@ -0,0 +1,11 @@
+#include "vl/sift.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+int main(){int W=233,H=177,i,x,y;float*im=malloc(sizeof(float)*W*H);srand(3);
+for(y=0;y<H;y++)for(x=0;x<W;x++)im[x+y*W]=0.5+0.25*sin(x*0.13+y*0.07)*cos(y*0.11)+0.1*(rand()/(float)RAND_MAX)+((x/20+y/25)%2)*0.2;
+VlSiftFilt*f=vl_sift_new(W,H,-1,3,-1);vl_sift_set_peak_thresh(f,0.003);
+int err=vl_sift_process_first_octave(f,im);while(!err){vl_sift_detect(f);int n=vl_sift_get_nkeypoints(f);VlSiftKeypoint const*k=vl_sift_get_keypoints(f);
+for(i=0;i<n;i++){double a[4];int na=vl_sift_calc_keypoint_orientations(f,a,k+i);float d[128];int j;printf("%a %a %a %d",k[i].x,k[i].y,k[i].sigma,na);
+ if(na){vl_sift_calc_keypoint_descriptor(f,d,k+i,a[0]);for(j=0;j<128;j+=17)printf(" %a",d[j]);}printf("\n");}
+err=vl_sift_process_next_octave(f);}return 0;}
@@ -109,9 +109,44 @@ GNU GPLv2, or (at your option) any later version.
   we fall in the last case. In common cases one has \f$\gamma(N)
   \approx \mathrm{const.}\f$, so the time saving is significant.
  
+ @section aib-candidates Candidate mode
+
+ For very large vocabularies (say @f$N = 10^5@f$) even the
+ @f$O(CN^2)@f$ algorithm is too slow. If a number of candidates
+ <em>K</em> is set by ::vl_aib_set_num_candidates, ::vl_aib_process
+ only considers the merges of each value with <em>K</em> candidate
+ values:
+
+ - The candidates are the <em>K</em> nearest neighbors of the value in
+   the space of the square roots of the conditionals
+   @f$\sqrt{p(c|x_i)}@f$ (Hellinger distance), found by a
+   KD-forest (::vl_aib_set_max_num_comparisons makes the search
+   approximate).
+ - The merge costs @f$D_{ij}@f$ of the candidates are kept in a
+   priority queue (heap). Merges change entries, but the queue is not
+   updated: every entry is stamped with the versions of its two
+   values and the stale entries are detected when popped. A stale
+   entry whose first value did not change is evaluated again with the
+   merged value replacing the second one.
+ - The merged value takes as candidates the best <em>K</em> among
+   the candidates of the two values.
+ - The information after each merge is updated by subtracting
+   @f$D_{ij}@f$, rather than recomputed.
+ - If the queue runs dry (the candidate graph is not connected), the
+   candidates of the remaining values are searched again. They are
+   also searched again when at most <em>K+1</em> values remain, so that
+   the last merges are exact.
+
+ The cost of the candidates is evaluated in parallel when VLFeat is
+ compiled with OpenMP. The result is an approximation of AIB, exact
+ if each value is a candidate of all the others. It takes
+ @f$O(NKC\log N)@f$ time (plus the candidate search) and
+ @f$O(N(K+C))@f$ space.
+
 **/
 
 #include "aib.h"
+#include "kdtree.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -514,6 +549,10 @@ VlAIB * vl_aib_new(double * Pcx, vl_uint nvalues, vl_uint nlabels)
 
     /* Allocate cost output vector */
     aib->costs = vl_malloc (sizeof(double) * (aib->nvalues - 1 + 1)) ;
+
+    /* exact AIB by default */
+    aib->numCandidates     = 0 ;
+    aib->maxNumComparisons = 0 ;
   
 
     return aib ;
@@ -541,6 +580,407 @@ vl_aib_delete (VlAIB * aib)
   }
 }
 
+/* -------------------------------------------------------------------
+ *                                                      Candidate mode
+ * ---------------------------------------------------------------- */
+
+/** @internal @brief Candidate merge (element of the priority queue) */
+typedef struct _VlAIBPair
+{
+  double  cost ;    /**< merge cost */
+  vl_uint a ;       /**< first entry */
+  vl_uint b ;       /**< second entry */
+  vl_uint stampa ;  /**< version of the first entry */
+  vl_uint stampb ;  /**< version of the second entry */
+} VlAIBPair ;
+
+#define VL_HEAP_prefix     vl_aib_pair_heap
+#define VL_HEAP_type       VlAIBPair
+#define VL_HEAP_cmp(v,x,y) (v[x].cost - v[y].cost)
+#include "heap-def.h"
+
+/** @internal @brief Candidate mode state */
+typedef struct _VlAIBCandidates
+{
+  vl_uint   *owner ;     /**< entry an entry was merged into (union-find) */
+  vl_uint   *stamp ;     /**< version of each entry */
+  double    *A ;         /**< sum_c p(x,c) log(p(x,c)/p(x)) of each entry */
+  vl_uint   *cand ;      /**< candidates, numCandidates per entry */
+  vl_uint   *ncand ;     /**< number of candidates of each entry */
+  vl_uint   *ubuf ;      /**< buffer of 2*numCandidates entries */
+  double    *ucost ;     /**< buffer of 2*numCandidates costs */
+  VlAIBPair *heap ;      /**< priority queue */
+  vl_size    heapSize ;  /**< number of elements of the queue */
+  vl_size    heapAlloc ; /**< size of the queue buffer */
+} VlAIBCandidates ;
+
+/** ------------------------------------------------------------------
+ ** @internal @brief Find the entry holding a merged entry
+ **/
+
+static vl_uint
+vl_aib_find (VlAIBCandidates * st, vl_uint a)
+{
+  vl_uint root = a ;
+  while (st->owner[root] != root) root = st->owner[root] ;
+  while (st->owner[a] != root) {
+    vl_uint next = st->owner[a] ;
+    st->owner[a] = root ;
+    a = next ;
+  }
+  return root ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal @brief Compute the term A (see ::vl_aib_update_beta) of an entry
+ **/
+
+static double
+vl_aib_entry_A (VlAIB const * aib, vl_uint a)
+{
+  double const * Pa = aib->Pcx + a*aib->nlabels ;
+  double A = 0 ;
+  vl_uint c ;
+  for (c = 0 ; c < aib->nlabels ; c++) {
+    if (Pa[c] != 0) A += Pa[c] * log (Pa[c] / aib->Px[a]) ;
+  }
+  return A ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal @brief Cost of merging entries @a a and @a b
+ **
+ ** Same as the cost computed by ::vl_aib_update_beta.
+ **/
+
+static double
+vl_aib_pair_cost (VlAIB const * aib, VlAIBCandidates const * st,
+                  vl_uint a, vl_uint b)
+{
+  double const * Pa = aib->Pcx + a*aib->nlabels ;
+  double const * Pb = aib->Pcx + b*aib->nlabels ;
+  double T1 ;
+  vl_uint c ;
+
+  T1 = PLOGP ((aib->Px[a] + aib->Px[b])) ;          /* - C2 */
+  T1 += st->A[a] + st->A[b] ;                       /* + A + B */
+  for (c = 0 ; c < aib->nlabels ; ++ c) {
+    if (Pa[c] == 0 && Pb[c] == 0) continue ;
+    T1 += - PLOGP ((Pa[c] + Pb[c])) ;              /* - C1 */
+  }
+  return T1 ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal @brief Push a candidate merge to the priority queue
+ **/
+
+static void
+vl_aib_push_pair (VlAIBCandidates * st, double cost, vl_uint a, vl_uint b)
+{
+  VlAIBPair * pair ;
+  if (st->heapSize == st->heapAlloc) {
+    st->heapAlloc = 2 * st->heapAlloc + 16 ;
+    st->heap = vl_realloc (st->heap, sizeof(VlAIBPair) * st->heapAlloc) ;
+  }
+  pair = st->heap + st->heapSize ;
+  pair->cost   = cost ;
+  pair->a      = a ;
+  pair->b      = b ;
+  pair->stampa = st->stamp[a] ;
+  pair->stampb = st->stamp[b] ;
+  vl_aib_pair_heap_push (st->heap, &st->heapSize) ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal @brief Search the candidates of a list of entries
+ **
+ ** @param aib      AIB data structure.
+ ** @param st       candidate mode state.
+ ** @param entries  entries (with non null probability).
+ ** @param n        number of entries.
+ **
+ ** Sets the candidates of the @a entries, among the @a entries, and
+ ** pushes the corresponding merges to the queue.
+ **/
+
+static void
+vl_aib_search_candidates (VlAIB * aib, VlAIBCandidates * st,
+                          vl_uint const * entries, vl_uint n)
+{
+  vl_uint K = VL_MIN (aib->numCandidates, n - 1) ;
+  vl_uint C = aib->nlabels ;
+  float * data = vl_malloc (sizeof(float) * n * C) ;
+  double * costs = vl_malloc (sizeof(double) * n * K) ;
+  VlKDForestNeighbor * first =
+    vl_malloc (sizeof(VlKDForestNeighbor) * (K + 1)) ;
+  VlKDForest * forest ;
+  vl_uint i, k, c ;
+  int t ;
+
+  /* embed the conditionals p(c|x) (Hellinger distance) */
+  for (i = 0 ; i < n ; i++) {
+    vl_uint a = entries[i] ;
+    for (c = 0 ; c < C ; c++) {
+      data[i*C + c] = (float) sqrt (aib->Pcx[a*C + c] / aib->Px[a]) ;
+    }
+  }
+
+  forest = vl_kdforest_new (VL_TYPE_FLOAT, C,
+                            aib->maxNumComparisons ? 4 : 1) ;
+  vl_kdforest_set_max_num_comparisons (forest, aib->maxNumComparisons) ;
+  vl_kdforest_build (forest, n, data) ;
+
+  /* the first query completes the trees (node bounds) */
+  vl_kdforest_query (forest, first, K + 1, data) ;
+  vl_free (first) ;
+
+  /*
+     A query only writes the search state of the forest, so each
+     thread queries a copy of the forest with its own search state,
+     sharing the trees.
+  */
+#if defined(_OPENMP)
+#pragma omp parallel private(k)
+#endif
+  {
+    VlKDForest searcher = *forest ;
+    vl_size numNodes = 0 ;
+    vl_uindex ti ;
+    VlKDForestNeighbor * neighbors =
+      vl_malloc (sizeof(VlKDForestNeighbor) * (K + 1)) ;
+
+    for (ti = 0 ; ti < searcher.numTrees ; ++ti) {
+      numNodes += searcher.trees[ti]->numUsedNodes ;
+    }
+    searcher.searchHeapArray =
+      vl_malloc (sizeof(VlKDForestSearchState) * numNodes) ;
+    searcher.searchIdBook = vl_calloc (sizeof(vl_uindex), n) ;
+    searcher.searchId = 0 ;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic,64)
+#endif
+    for (t = 0 ; t < (int) n ; t++) {
+      vl_uint a = entries[t] ;
+      vl_kdforest_query (&searcher, neighbors, K + 1, data + t*C) ;
+      st->ncand[a] = 0 ;
+      for (k = 0 ; k < K + 1 && st->ncand[a] < K ; k++) {
+        if (neighbors[k].index == (vl_uindex) -1) break ;
+        if (neighbors[k].index == (vl_uindex) t) continue ;
+        st->cand[a*aib->numCandidates + st->ncand[a]++] =
+          entries[neighbors[k].index] ;
+      }
+    }
+
+    vl_free (searcher.searchHeapArray) ;
+    vl_free (searcher.searchIdBook) ;
+    vl_free (neighbors) ;
+  }
+  vl_kdforest_delete (forest) ;
+  vl_free (data) ;
+
+  /* evaluate the merge costs in parallel */
+#if defined(_OPENMP)
+#pragma omp parallel for private(k) schedule(dynamic,64)
+#endif
+  for (t = 0 ; t < (int) n ; t++) {
+    vl_uint a = entries[t] ;
+    for (k = 0 ; k < st->ncand[a] ; k++) {
+      costs[t*K + k] =
+        vl_aib_pair_cost (aib, st, a, st->cand[a*aib->numCandidates + k]) ;
+    }
+  }
+
+  for (i = 0 ; i < n ; i++) {
+    vl_uint a = entries[i] ;
+    for (k = 0 ; k < st->ncand[a] ; k++) {
+      vl_aib_push_pair (st, costs[i*K + k], a,
+                        st->cand[a*aib->numCandidates + k]) ;
+    }
+  }
+  vl_free (costs) ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal @brief Set the candidates of a merged entry
+ **
+ ** @param aib  AIB data structure.
+ ** @param st   candidate mode state.
+ ** @param a    merged entry.
+ ** @param b    entry merged into @a a.
+ **
+ ** The candidates of @a a become the best among the (current
+ ** entries of the) candidates of @a a and @a b, and the corresponding
+ ** merges are pushed to the queue.
+ **/
+
+static void
+vl_aib_merge_candidates (VlAIB * aib, VlAIBCandidates * st,
+                         vl_uint a, vl_uint b)
+{
+  vl_uint K = aib->numCandidates ;
+  vl_uint * union_ = st->ubuf ;
+  double * ucost = st->ucost ;
+  vl_uint n = 0, i, k, src ;
+  int t ;
+
+  /* union of the candidates, resolved to the current entries */
+  for (src = 0 ; src < 2 ; src++) {
+    vl_uint e = src ? b : a ;
+    for (k = 0 ; k < st->ncand[e] ; k++) {
+      vl_uint x = vl_aib_find (st, st->cand[e*K + k]) ;
+      if (x == a) continue ;
+      for (i = 0 ; i < n && union_[i] != x ; i++) ;
+      if (i == n) union_[n++] = x ;
+    }
+  }
+
+#if defined(_OPENMP)
+#pragma omp parallel for if(n * aib->nlabels > 4096)
+#endif
+  for (t = 0 ; t < (int) n ; t++) {
+    ucost[t] = vl_aib_pair_cost (aib, st, a, union_[t]) ;
+  }
+
+  /* keep the K best (selection sort, n <= 2K) */
+  st->ncand[a] = VL_MIN (n, K) ;
+  for (k = 0 ; k < st->ncand[a] ; k++) {
+    vl_uint best = k ;
+    for (i = k + 1 ; i < n ; i++) {
+      if (ucost[i] < ucost[best]) best = i ;
+    }
+    if (best != k) {
+      vl_uint tu = union_[k] ; double tc = ucost[k] ;
+      union_[k] = union_[best] ; ucost[k] = ucost[best] ;
+      union_[best] = tu ; ucost[best] = tc ;
+    }
+    st->cand[a*K + k] = union_[k] ;
+    vl_aib_push_pair (st, ucost[k], a, union_[k]) ;
+  }
+}
+
+/** ------------------------------------------------------------------
+ ** @internal @brief Runs AIB restricted to candidate merges
+ **
+ ** @param aib AIB data structure.
+ **
+ ** @sa @ref aib-candidates
+ **/
+
+static void
+vl_aib_process_candidates (VlAIB * aib)
+{
+  VlAIBCandidates st ;
+  vl_uint N = aib->nvalues ;
+  vl_uint K = aib->numCandidates ;
+  vl_uint * entries = vl_malloc (sizeof(vl_uint) * N) ;
+  vl_uint nactive = 0, nentries, nmerges = 0, i ;
+  vl_bool complete = VL_FALSE ;
+  double I, H ;
+
+  st.owner     = vl_aib_new_nodelist (N) ;
+  st.stamp     = vl_calloc (N, sizeof(vl_uint)) ;
+  st.A         = vl_malloc (sizeof(double) * N) ;
+  st.cand      = vl_malloc (sizeof(vl_uint) * N * K) ;
+  st.ncand     = vl_calloc (N, sizeof(vl_uint)) ;
+  st.ubuf      = vl_malloc (sizeof(vl_uint) * 2 * K) ;
+  st.ucost     = vl_malloc (sizeof(double) * 2 * K) ;
+  st.heap      = 0 ;
+  st.heapSize  = 0 ;
+  st.heapAlloc = 0 ;
+
+  /* Calculate initial value of cost function */
+  vl_aib_calculate_information (aib, &I, &H) ;
+  aib->costs[0] = I ;
+
+  /* entries with null probability are ignored */
+  for (i = 0 ; i < N ; i++) {
+    st.A[i] = vl_aib_entry_A (aib, i) ;
+    if (aib->Px[i] != 0) entries[nactive++] = i ;
+  }
+  nentries = nactive ;
+
+  /* For each merge */
+  while (nmerges + 1 < nactive) {
+    VlAIBPair pair ;
+    vl_uint a, b, newnode, nodea, nodeb, c ;
+
+    if (! complete && nactive - nmerges <= K + 1) {
+      /* all the remaining pairs fit in the candidate lists: search
+         them once more, the last merges are then exact */
+      complete = VL_TRUE ;
+      st.heapSize = 0 ;
+    }
+
+    if (st.heapSize == 0) {
+      /* (re)search the candidates of the remaining entries */
+      vl_uint n = 0 ;
+      for (i = 0 ; i < nentries ; i++) {
+        if (st.owner[entries[i]] == entries[i]) entries[n++] = entries[i] ;
+      }
+      nentries = n ;
+      vl_aib_search_candidates (aib, &st, entries, nentries) ;
+      continue ;
+    }
+
+    pair = st.heap [vl_aib_pair_heap_pop (st.heap, &st.heapSize)] ;
+    a = pair.a ;
+    b = pair.b ;
+
+    if (st.stamp[a] != pair.stampa || st.stamp[b] != pair.stampb) {
+      /* stale: evaluate again if the first entry did not change */
+      if (st.stamp[a] == pair.stampa && st.owner[a] == a) {
+        b = vl_aib_find (&st, b) ;
+        if (a != b) {
+          vl_aib_push_pair (&st, vl_aib_pair_cost (aib, &st, a, b), a, b) ;
+        }
+      }
+      continue ;
+    }
+
+    /* Add the parent pointers for the new node */
+    newnode = N + nmerges ;
+    nodea = aib->nodes[a] ;
+    nodeb = aib->nodes[b] ;
+
+    aib->parents [nodea] = newnode ;
+    aib->parents [nodeb] = newnode ;
+    aib->parents [newnode] = 0 ;
+
+    /* Merge b into a */
+    aib->Px [a] += aib->Px [b] ;
+    for (c = 0 ; c < aib->nlabels ; c++)
+      aib->Pcx [a*aib->nlabels + c] += aib->Pcx [b*aib->nlabels + c] ;
+    aib->nodes [a] = newnode ;
+    st.A [a] = vl_aib_entry_A (aib, a) ;
+    st.owner [b] = a ;
+    st.stamp [a] ++ ;
+    st.stamp [b] ++ ;
+
+    /* the information decreases by the merge cost */
+    I -= pair.cost ;
+    aib->costs[nmerges+1] = I ;
+    nmerges ++ ;
+
+    vl_aib_merge_candidates (aib, &st, a, b) ;
+  }
+
+  /* fill ignored entries with NaNs */
+  for (i = nmerges ; i < N - 1 ; i++)
+    aib->costs[i+1] = VL_NAN_D ;
+
+  vl_free (entries) ;
+  vl_free (st.owner) ;
+  vl_free (st.stamp) ;
+  vl_free (st.A) ;
+  vl_free (st.cand) ;
+  vl_free (st.ncand) ;
+  vl_free (st.ubuf) ;
+  vl_free (st.ucost) ;
+  if (st.heap) vl_free (st.heap) ;
+}
+
 /** ------------------------------------------------------------------
  ** @brief Runs AIB on Pcx
  **
@@ -575,6 +1015,9 @@ vl_aib_delete (VlAIB * aib)
  ** cost has @c nvalues entries: The first is the value of the cost
  ** functional before any merge, and the others are the cost after the
  ** @c nvalues-1 merges.
+ **
+ ** If a number of candidates is set (::vl_aib_set_num_candidates),
+ ** the function runs the approximate algorithm of @ref aib-candidates.
  ** 
  **/ 
 
@@ -585,6 +1028,11 @@ void vl_aib_process(VlAIB *aib)
     double I, H;
     double minbeta;
 
+    if (aib->numCandidates > 0) {
+      vl_aib_process_candidates (aib) ;
+      return ;
+    }
+
     /* Calculate initial value of cost function */
     vl_aib_calculate_information (aib, &I, &H) ;
     aib->costs[0] = I;
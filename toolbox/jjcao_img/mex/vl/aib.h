@@ -53,6 +53,9 @@ typedef struct _VlAIB
 
   vl_uint   *parents;   /**< Array of parents */
   double    *costs;     /**< Cost of each merge */
+
+  vl_uint    numCandidates ;     /**< Candidates per entry (0 = exact AIB) */
+  vl_size    maxNumComparisons ; /**< Candidate search comparisons (0 = exact) */
 } VlAIB;
 
 /** @name Create and destroy
@@ -79,6 +82,15 @@ VL_INLINE vl_uint * vl_aib_get_parents(VlAIB const * aib);
 VL_INLINE double  * vl_aib_get_costs(VlAIB const * aib);
 /** @} */
 
+/** @name Retrieving and setting parameters
+ ** @{
+ **/
+VL_INLINE void    vl_aib_set_num_candidates (VlAIB * aib, vl_uint n);
+VL_INLINE vl_uint vl_aib_get_num_candidates (VlAIB const * aib);
+VL_INLINE void    vl_aib_set_max_num_comparisons (VlAIB * aib, vl_size n);
+VL_INLINE vl_size vl_aib_get_max_num_comparisons (VlAIB const * aib);
+/** @} */
+
 
 /* -------------------------------------------------------------------
  *                                     Inline functions implementation
@@ -107,5 +119,57 @@ double * vl_aib_get_costs(VlAIB const * aib)
   return aib->costs;
 }
 
+/** ------------------------------------------------------------------
+ ** @brief Set the number of merge candidates of each entry
+ ** @param aib AIB filter.
+ ** @param n number of candidates.
+ **
+ ** If @a n is zero (the default), ::vl_aib_process runs the exact
+ ** algorithm. Otherwise each entry only considers merges with its
+ ** @a n candidates (@ref aib-candidates).
+ **/
+VL_INLINE
+void vl_aib_set_num_candidates (VlAIB * aib, vl_uint n)
+{
+  aib->numCandidates = n ;
+}
+
+/** ------------------------------------------------------------------
+ ** @brief Get the number of merge candidates of each entry
+ ** @param aib AIB filter.
+ ** @return number of candidates.
+ **/
+VL_INLINE
+vl_uint vl_aib_get_num_candidates (VlAIB const * aib)
+{
+  return aib->numCandidates ;
+}
+
+/** ------------------------------------------------------------------
+ ** @brief Set the maximum number of comparisons of the candidate search
+ ** @param aib AIB filter.
+ ** @param n maximum number of comparisons (0 for an exact search).
+ **
+ ** The exact search of the candidates is nearly quadratic in the
+ ** number of values when there are many labels. For large
+ ** vocabularies bound it, for instance to a few hundred comparisons.
+ **/
+VL_INLINE
+void vl_aib_set_max_num_comparisons (VlAIB * aib, vl_size n)
+{
+  aib->maxNumComparisons = n ;
+}
+
+/** ------------------------------------------------------------------
+ ** @brief Get the maximum number of comparisons of the candidate search
+ ** @param aib AIB filter.
+ ** @return maximum number of comparisons.
+ **/
+VL_INLINE
+vl_size vl_aib_get_max_num_comparisons (VlAIB const * aib)
+{
+  return aib->maxNumComparisons ;
+}
+
 /* VL_AIB_H */
 #endif
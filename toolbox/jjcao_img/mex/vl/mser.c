@@ -21,7 +21,9 @@ GNU GPLv2, or (at your option) any later version.
  **   filter can be reused for images of the same size.
  ** - Compute the MSERs by ::vl_mser_process().
  ** - Optionally fit ellipsoids to the MSERs by  ::vl_mser_ell_fit().
- ** - Retrieve the results by ::vl_mser_get_regions() (and optionally ::vl_mser_get_ell()).
+ ** - Optionally list the pixels of the MSERs by ::vl_mser_fill().
+ ** - Retrieve the results by ::vl_mser_get_regions() (and optionally ::vl_mser_get_ell()
+ **   and ::vl_mser_get_fill()).
  ** - Optionally retrieve filter statistics by ::vl_mser_get_stats().
  ** - Delete the MSER filter by ::vl_mser_delete().
  **
@@ -156,12 +158,25 @@ GNU GPLv2, or (at your option) any later version.
  ** calculations, the pixel coordinate @f$x=(x_1,...,x_n)@f$ use the
  ** standard index order and ranges.
  **
+ ** @subsection mser-fill Region pixels
+ **
+ ** ::vl_mser_fill() lists the pixels of the MSERs from the forest
+ ** computed by ::vl_mser_process(), without flood filling the image
+ ** again. The descendants of the pivot of a MSER are exactly its
+ ** pixels, so the forest is laid out in depth first order and each
+ ** region becomes a range of this order. The pixels of the region
+ ** <em>i</em> are the ::vl_mser_get_fill_areas()[i] elements of
+ ** ::vl_mser_get_fill() starting at ::vl_mser_get_fill_offsets()[i],
+ ** in no particular order. The pixels of nested regions share the
+ ** same storage, so the memory is linear in the image size.
+ **
  ** @subsection mser-algo Algorithm
  **
  ** The algorithm is quite efficient. While some details may be
  ** tricky, the overall idea is easy to grasp.
  **
- ** - Pixels are sorted by increasing intensity.
+ ** - Pixels are sorted by increasing intensity (by a bucket sort, linear in
+ **   the number of pixels).
  ** - Pixels are added to a forest by increasing intensity. The forest has the
  **   following properties:
  **   - All the descendent of a certain pixels are subset of an extremal region.
@@ -325,6 +340,8 @@ vl_mser_new (int ndims, int const* dims)
   f-> rmer   = 0 ;
   f-> ell    = 0 ;
   f-> rell   = 0 ;
+  f-> fill   = 0 ;
+  f-> rfill  = 0 ;
 
   /* other parameters */
   f-> delta         = 5 ;
@@ -351,6 +368,11 @@ vl_mser_delete (VlMserFilt* f)
     if(f-> acc   )  vl_free( f-> acc    ) ;
     if(f-> ell   )  vl_free( f-> ell    ) ;
 
+    if(f-> fill     ) vl_free( f-> fill      ) ;
+    if(f-> fill_pos ) vl_free( f-> fill_pos  ) ;
+    if(f-> fill_off ) vl_free( f-> fill_off  ) ;
+    if(f-> fill_area) vl_free( f-> fill_area ) ;
+
     if(f-> er    )  vl_free( f-> er     ) ;
     if(f-> r     )  vl_free( f-> r      ) ;
     if(f-> joins )  vl_free( f-> joins  ) ;
@@ -407,8 +429,9 @@ vl_mser_process (VlMserFilt* f, vl_mser_pix const* im)
 
   int i, j, k ;
 
-  /* delete any previosuly computed ellipsoid */
-  f-> nell = 0 ;
+  /* delete any previosuly computed ellipsoid and pixel lists */
+  f-> nell  = 0 ;
+  f-> nfill = 0 ;
 
   /* -----------------------------------------------------------------
    *                                          Sort pixels by intensity
@@ -520,8 +543,8 @@ vl_mser_process (VlMserFilt* f, vl_mser_pix const* im)
 
         vl_mser_pix nr_val = 0 ;
         vl_uint     nr_idx = 0 ;
-        int         hgt   = r [ r_idx] .height ;
-        int         n_hgt = r [nr_idx] .height ;
+        int         hgt ;
+        int         n_hgt ;
         
         /*
           Now we join the two subtrees rooted at
@@ -535,6 +558,10 @@ vl_mser_process (VlMserFilt* f, vl_mser_pix const* im)
         
          r_idx = climb(r,   idx) ;
         nr_idx = climb(r, n_idx) ;
+
+        /* the heights of the roots (not of stale nodes) */
+        hgt   = r [ r_idx] .height ;
+        n_hgt = r [nr_idx] .height ;
         
         /*  
           At this point we have three possibilities:
@@ -965,3 +992,93 @@ vl_mser_ell_fit (VlMserFilt* f)
   f-> nell = nmer ;
 }
 
+/** -------------------------------------------------------------------
+ ** @brief List the pixels of the regions
+ **
+ ** @param f MSER filter.
+ **
+ ** @sa @ref mser-fill
+ **/
+
+VL_EXPORT
+void
+vl_mser_fill (VlMserFilt* f)
+{
+  /* shortcuts */
+  int                nel = f-> nel ;
+  int             njoins = f-> njoins ;
+  vl_uint         *joins = f-> joins ;
+  VlMserReg           *r = f-> r ;
+  vl_uint           *mer = f-> mer ;
+  int               nmer = f-> nmer ;
+  vl_uint          *fill ;
+  vl_uint           *pos ;
+
+  int i, next ;
+
+  /* already filled ? */
+  if (f->nfill == f->nmer && f->fill) return ;
+
+  /* make room */
+  if (f->fill == 0) {
+    f->fill     = vl_malloc (sizeof(vl_uint) * nel) ;
+    f->fill_pos = vl_malloc (sizeof(vl_uint) * nel) ;
+  }
+  if (f->rfill < nmer) {
+    if (f->fill_off)  vl_free (f->fill_off) ;
+    if (f->fill_area) vl_free (f->fill_area) ;
+    f->fill_off  = vl_malloc (sizeof(vl_uint) * nmer) ;
+    f->fill_area = vl_malloc (sizeof(vl_uint) * nmer) ;
+    f->rfill     = nmer ;
+  }
+
+  fill = f-> fill ;
+  pos  = f-> fill_pos ;
+
+  /* -----------------------------------------------------------------
+   *                                             Depth first positions
+   * -------------------------------------------------------------- */
+
+  /*
+     The area of a node is the size of its subtree. A node is joined
+     to its parent before the parent is joined to anything else, so
+     visiting the joins backward places each parent before its
+     children. FILL [I] is used temporarily as the next free position
+     in the subtree of I.
+  */
+
+  /* the roots (only one for a connected image) */
+  next = 0 ;
+  for(i = 0 ; i < nel ; ++i) {
+    if (r [i] .parent == (vl_uint) i) {
+      pos  [i] = next ;
+      fill [i] = next + 1 ;
+      next    += r [i] .area ;
+    }
+  }
+
+  for(i = njoins - 1 ; i >= 0 ; --i) {
+    vl_uint idx    = joins [i] ;
+    vl_uint parent = r [idx] .parent ;
+    pos  [idx]     = fill [parent] ;
+    fill [parent] += r [idx] .area ;
+    fill [idx]     = pos [idx] + 1 ;
+  }
+
+  /* -----------------------------------------------------------------
+   *                                                    Lay out pixels
+   * -------------------------------------------------------------- */
+
+  for(i = 0 ; i < nel ; ++i) {
+    fill [pos [i]] = i ;
+  }
+
+  for(i = 0 ; i < nmer ; ++i) {
+    vl_uint idx = mer [i] ;
+    f-> fill_off  [i] = pos [idx] ;
+    f-> fill_area [i] = r [idx] .area ;
+  }
+
+  /* save back */
+  f-> nfill = nmer ;
+}
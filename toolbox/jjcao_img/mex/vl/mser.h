@@ -67,6 +67,7 @@ VL_EXPORT void             vl_mser_delete  (VlMserFilt *f) ;
 VL_EXPORT void             vl_mser_process (VlMserFilt *f, 
                                             vl_mser_pix const *im) ;
 VL_EXPORT void             vl_mser_ell_fit (VlMserFilt *f) ;
+VL_EXPORT void             vl_mser_fill    (VlMserFilt *f) ;
 /** @} */
 
 /** @name Retrieving data
@@ -77,6 +78,10 @@ VL_INLINE vl_uint const*   vl_mser_get_regions      (VlMserFilt const *f) ;
 VL_INLINE float const*     vl_mser_get_ell          (VlMserFilt const *f) ;
 VL_INLINE vl_uint          vl_mser_get_ell_num      (VlMserFilt const *f) ;
 VL_INLINE vl_uint          vl_mser_get_ell_dof      (VlMserFilt const *f) ;
+VL_INLINE vl_uint const*   vl_mser_get_fill         (VlMserFilt const *f) ;
+VL_INLINE vl_uint const*   vl_mser_get_fill_offsets (VlMserFilt const *f) ;
+VL_INLINE vl_uint const*   vl_mser_get_fill_areas   (VlMserFilt const *f) ;
+VL_INLINE vl_uint          vl_mser_get_fill_num     (VlMserFilt const *f) ;
 VL_INLINE VlMserStats const*  vl_mser_get_stats     (VlMserFilt const *f) ;
 /** @} */
 
@@ -236,6 +241,16 @@ struct _VlMserFilt
 
   /*@}*/
 
+  /** @name Region pixels */
+  /*@{*/
+  vl_uint           *fill ;      /**< pixels, each region is a range       */
+  vl_uint           *fill_pos ;  /**< position of each pixel in fill       */
+  vl_uint           *fill_off ;  /**< offset of each region in fill        */
+  vl_uint           *fill_area ; /**< number of pixels of each region      */
+  int                rfill ;     /**< size of fill_off and fill_area       */
+  int                nfill ;     /**< number of regions filled             */
+  /*@}*/
+
   /** @name Configuration */
   /*@{*/
   vl_bool   verbose ;          /**< be verbose                             */
@@ -417,5 +432,46 @@ vl_mser_get_ell_num (VlMserFilt const* f)
   return f-> nell ;
 }
 
+/* ----------------------------------------------------------------- */
+/** @brief Get region pixels
+ ** @param f MSER filter.
+ ** @return pixels of the regions (::vl_mser_fill).
+ **/
+VL_INLINE vl_uint const*
+vl_mser_get_fill (VlMserFilt const* f)
+{
+  return f-> fill ;
+}
+
+/** @brief Get offsets of the region pixels
+ ** @param f MSER filter.
+ ** @return offset in ::vl_mser_get_fill of the pixels of each region.
+ **/
+VL_INLINE vl_uint const*
+vl_mser_get_fill_offsets (VlMserFilt const* f)
+{
+  return f-> fill_off ;
+}
+
+/** @brief Get number of pixels of the regions
+ ** @param f MSER filter.
+ ** @return number of pixels of each region.
+ **/
+VL_INLINE vl_uint const*
+vl_mser_get_fill_areas (VlMserFilt const* f)
+{
+  return f-> fill_area ;
+}
+
+/** @brief Get number of filled regions
+ ** @param f MSER filter.
+ ** @return number of filled regions.
+ **/
+VL_INLINE vl_uint
+vl_mser_get_fill_num (VlMserFilt const* f)
+{
+  return f-> nfill ;
+}
+
 /* VL_MSER */
 #endif
@@ -279,6 +279,19 @@ To use a <b>SIFT filter</b> object:
       - Use ::vl_sift_calc_keypoint_descriptor() to get the keypoint descriptor.
 - Delete the SIFT filter by ::vl_sift_delete().
 
+Alternatively, to process a whole image at once (in parallel when
+compiled with OpenMP):
+
+- Run ::vl_sift_process_image() to compute the scale space of all the
+  octaves and get the keypoints of all of them.
+- Use ::vl_sift_calc_image_orientations() to get the orientation(s)
+  of all the keypoints.
+- Use ::vl_sift_calc_image_descriptors() to get the descriptors of
+  all the (keypoint, orientation) pairs.
+
+The keypoints, orientations and descriptors are the same as the
+ones of the octave by octave processing.
+
 To compute SIFT descriptors of custom keypoints, use
 ::vl_sift_calc_raw_descriptor().
 
@@ -674,6 +687,7 @@ Gaussian window size is set to have standard deviation
 **/
 
 #include "sift.h"
+#include "sift_sse2.h"
 #include "imopv.h"
 #include "mathop.h"
 
@@ -693,6 +707,8 @@ double expn_tab [EXPN_SZ+1] ; /**< ::fast_expn table      @internal */
 #define NBO 8
 #define NBP 4
 
+#define SIFT_SMOOTH_BLOCK 64  /**< columns smoothed by a thread @internal */
+
 #define log2(x) (log(x)/VL_LOG_OF_2)
 
 /** ------------------------------------------------------------------
@@ -821,17 +837,43 @@ _vl_sift_smooth (VlSiftFilt * self,
     return ;
   }
 
-  vl_imconvcol_vf (tempImage, height,
-                   inputImage, width, height, width,
-                   self->gaussFilter,
-                   - self->gaussFilterWidth, self->gaussFilterWidth,
-                   1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
-
-  vl_imconvcol_vf (outputImage, width,
-                   tempImage, height, width, height,
-                   self->gaussFilter,
-                   - self->gaussFilterWidth, self->gaussFilterWidth,
-                   1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
+  /*
+   * The columns are convolved independently, by blocks of
+   * SIFT_SMOOTH_BLOCK columns in parallel. The blocks start at
+   * multiples of the SIMD width, so each column is computed exactly
+   * as by a single call.
+   */
+  {
+    int const filtWidth = (int) self->gaussFilterWidth ;
+    vl_sift_pix const * filt = self->gaussFilter ;
+    int nblocks = ((int) width + SIFT_SMOOTH_BLOCK - 1) / SIFT_SMOOTH_BLOCK ;
+    int b ;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(width * height > 4096)
+#endif
+    for (b = 0 ; b < nblocks ; ++b) {
+      int x0 = b * SIFT_SMOOTH_BLOCK ;
+      int nx = VL_MIN(SIFT_SMOOTH_BLOCK, (int) width - x0) ;
+      vl_imconvcol_vf (tempImage + x0 * height, height,
+                       inputImage + x0, nx, height, width,
+                       filt, - filtWidth, filtWidth,
+                       1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
+    }
+
+    nblocks = ((int) height + SIFT_SMOOTH_BLOCK - 1) / SIFT_SMOOTH_BLOCK ;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(width * height > 4096)
+#endif
+    for (b = 0 ; b < nblocks ; ++b) {
+      int y0 = b * SIFT_SMOOTH_BLOCK ;
+      int ny = VL_MIN(SIFT_SMOOTH_BLOCK, (int) height - y0) ;
+      vl_imconvcol_vf (outputImage + y0 * width, width,
+                       tempImage + y0, ny, width, height,
+                       filt, - filtWidth, filtWidth,
+                       1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
+    }
+  }
 }
 
 /** ------------------------------------------------------------------
@@ -946,6 +988,10 @@ vl_sift_new (int width, int height,
 
   f-> grad_o  = o_min - 1 ;
 
+  f-> pyr      = NULL ;
+  f-> pyr_res  = 0 ;
+  f-> pyr_grad = 0 ;
+
   /* initialize fast_expn stuff */
   fast_expn_init () ;
 
@@ -966,6 +1012,7 @@ vl_sift_delete (VlSiftFilt* f)
 {
   if (f) {
     if (f->keys) vl_free (f->keys) ;
+    if (f->pyr) vl_free (f->pyr) ;
     if (f->grad) vl_free (f->grad) ;
     if (f->dog) vl_free (f->dog) ;
     if (f->octave) vl_free (f->octave) ;
@@ -976,28 +1023,20 @@ vl_sift_delete (VlSiftFilt* f)
 }
 
 /** ------------------------------------------------------------------
- ** @brief Start processing a new image
- **
- ** @param f  SIFT filter.
- ** @param im image data.
- **
- ** The function starts processing a new image by computing its
- ** Gaussian scale space at the lower octave. It also empties the
- ** internal keypoint buffer.
- **
- ** @return error code. The function returns ::VL_ERR_EOF if there are
- ** no more octaves to process.
+ ** @internal
+ ** @brief Compute the Gaussian scale space of the first octave
  **
- ** @sa ::vl_sift_process_next_octave().
+ ** @param f      SIFT filter.
+ ** @param octave levels @c s_min to @c s_max of the octave (output).
+ ** @param im     image data.
  **/
 
-VL_EXPORT
-int
-vl_sift_process_first_octave (VlSiftFilt *f, vl_sift_pix const *im)
+static void
+_vl_sift_gss_first_octave (VlSiftFilt *f, vl_sift_pix *octave,
+                           vl_sift_pix const *im)
 {
   int o, s, h, w ;
   double sa, sb ;
-  vl_sift_pix *octave ;
 
   /* shortcuts */
   vl_sift_pix *temp   = f-> temp ;
@@ -1011,15 +1050,8 @@ vl_sift_process_first_octave (VlSiftFilt *f, vl_sift_pix const *im)
   double sigman       = f-> sigman ;
   double dsigma0      = f-> dsigma0 ;
 
-  /* restart from the first */
-  f->o_cur = o_min ;
-  f->nkeys = 0 ;
-  w = f-> octave_width  = VL_SHIFT_LEFT(f->width,  - f->o_cur) ;
-  h = f-> octave_height = VL_SHIFT_LEFT(f->height, - f->o_cur) ;
-
-  /* is there at least one octave? */
-  if (f->O == 0)
-    return VL_ERR_EOF ;
+  w = VL_SHIFT_LEFT(width,  - o_min) ;
+  h = VL_SHIFT_LEFT(height, - o_min) ;
 
   /* ------------------------------------------------------------------
    *                     Compute the first sublevel of the first octave
@@ -1031,8 +1063,6 @@ vl_sift_process_first_octave (VlSiftFilt *f, vl_sift_pix const *im)
    * the first octave has index zero, we just copy the image.
    */
 
-  octave = vl_sift_get_octave (f, s_min) ;
-
   if (o_min < 0) {
     /* double once */
     copy_and_upsample_rows (temp,   im,   width,      height) ;
@@ -1075,66 +1105,49 @@ vl_sift_process_first_octave (VlSiftFilt *f, vl_sift_pix const *im)
 
   for(s = s_min + 1 ; s <= s_max ; ++s) {
     double sd = dsigma0 * pow (sigmak, s) ;
-    _vl_sift_smooth (f, vl_sift_get_octave(f, s), temp,
-                     vl_sift_get_octave(f, s - 1), w, h, sd) ;
+    _vl_sift_smooth (f, octave + w * h * (s - s_min), temp,
+                     octave + w * h * (s - 1 - s_min), w, h, sd) ;
   }
-
-  return VL_ERR_OK ;
 }
 
 /** ------------------------------------------------------------------
- ** @brief Process next octave
- **
- ** @param f SIFT filter.
- **
- ** The function computes the next octave of the Gaussian scale space.
- ** Notice that this clears the record of any feature detected in the
- ** previous octave.
+ ** @internal
+ ** @brief Compute the Gaussian scale space of the next octave
  **
- ** @return error code. The function returns the error
- ** ::VL_ERR_EOF when there are no more octaves to process.
+ ** @param f      SIFT filter.
+ ** @param octave levels @c s_min to @c s_max of the octave (output).
+ ** @param prev   levels of the previous octave.
+ ** @param o      index of the octave.
  **
- ** @sa ::vl_sift_process_first_octave().
+ ** The buffers @a octave and @a prev may be the same.
  **/
 
-VL_EXPORT
-int
-vl_sift_process_next_octave (VlSiftFilt *f)
+static void
+_vl_sift_gss_next_octave (VlSiftFilt *f, vl_sift_pix *octave,
+                          vl_sift_pix const *prev, int o)
 {
-
   int s, h, w, s_best ;
   double sa, sb ;
-  vl_sift_pix *octave, *pt ;
 
   /* shortcuts */
   vl_sift_pix *temp   = f-> temp ;
-  int O               = f-> O ;
   int S               = f-> S ;
-  int o_min           = f-> o_min ;
   int s_min           = f-> s_min ;
   int s_max           = f-> s_max ;
   double sigma0       = f-> sigma0 ;
   double sigmak       = f-> sigmak ;
   double dsigma0      = f-> dsigma0 ;
 
-  /* is there another octave ? */
-  if (f->o_cur == o_min + O - 1)
-    return VL_ERR_EOF ;
-
   /* retrieve base */
   s_best = VL_MIN(s_min + S, s_max) ;
-  w      = vl_sift_get_octave_width  (f) ;
-  h      = vl_sift_get_octave_height (f) ;
-  pt     = vl_sift_get_octave        (f, s_best) ;
-  octave = vl_sift_get_octave        (f, s_min) ;
+  w      = VL_SHIFT_LEFT(f->width,  - (o - 1)) ;
+  h      = VL_SHIFT_LEFT(f->height, - (o - 1)) ;
 
   /* next octave */
-  copy_and_downsample (octave, pt, w, h, 1) ;
+  copy_and_downsample (octave, prev + w * h * (s_best - s_min), w, h, 1) ;
 
-  f-> o_cur            += 1 ;
-  f-> nkeys             = 0 ;
-  w = f-> octave_width  = VL_SHIFT_LEFT(f->width,  - f->o_cur) ;
-  h = f-> octave_height = VL_SHIFT_LEFT(f->height, - f->o_cur) ;
+  w = VL_SHIFT_LEFT(f->width,  - o) ;
+  h = VL_SHIFT_LEFT(f->height, - o) ;
 
   sa = sigma0 * powf (sigmak, s_min     ) ;
   sb = sigma0 * powf (sigmak, s_best - S) ;
@@ -1150,440 +1163,664 @@ vl_sift_process_next_octave (VlSiftFilt *f)
 
   for(s = s_min + 1 ; s <= s_max ; ++s) {
     double sd = dsigma0 * pow (sigmak, s) ;
-    _vl_sift_smooth (f, vl_sift_get_octave(f, s), temp,
-                     vl_sift_get_octave(f, s - 1), w, h, sd) ;
+    _vl_sift_smooth (f, octave + w * h * (s - s_min), temp,
+                     octave + w * h * (s - 1 - s_min), w, h, sd) ;
   }
+}
+
+/** ------------------------------------------------------------------
+ ** @brief Start processing a new image
+ **
+ ** @param f  SIFT filter.
+ ** @param im image data.
+ **
+ ** The function starts processing a new image by computing its
+ ** Gaussian scale space at the lower octave. It also empties the
+ ** internal keypoint buffer.
+ **
+ ** @return error code. The function returns ::VL_ERR_EOF if there are
+ ** no more octaves to process.
+ **
+ ** @sa ::vl_sift_process_next_octave().
+ **/
+
+VL_EXPORT
+int
+vl_sift_process_first_octave (VlSiftFilt *f, vl_sift_pix const *im)
+{
+  /* restart from the first */
+  f->o_cur = f->o_min ;
+  f->nkeys = 0 ;
+  f-> octave_width  = VL_SHIFT_LEFT(f->width,  - f->o_cur) ;
+  f-> octave_height = VL_SHIFT_LEFT(f->height, - f->o_cur) ;
+
+  /* is there at least one octave? */
+  if (f->O == 0)
+    return VL_ERR_EOF ;
 
+  _vl_sift_gss_first_octave (f, f->octave, im) ;
   return VL_ERR_OK ;
 }
 
 /** ------------------------------------------------------------------
- ** @brief Detect keypoints
- **
- ** The function detect keypoints in the current octave filling the
- ** internal keypoint buffer. Keypoints can be retrieved by
- ** ::vl_sift_get_keypoints().
+ ** @brief Process next octave
  **
  ** @param f SIFT filter.
+ **
+ ** The function computes the next octave of the Gaussian scale space.
+ ** Notice that this clears the record of any feature detected in the
+ ** previous octave.
+ **
+ ** @return error code. The function returns the error
+ ** ::VL_ERR_EOF when there are no more octaves to process.
+ **
+ ** @sa ::vl_sift_process_first_octave().
  **/
 
 VL_EXPORT
-void
-vl_sift_detect (VlSiftFilt * f)
+int
+vl_sift_process_next_octave (VlSiftFilt *f)
 {
-  vl_sift_pix* dog   = f-> dog ;
-  int          s_min = f-> s_min ;
-  int          s_max = f-> s_max ;
-  int          w     = f-> octave_width ;
-  int          h     = f-> octave_height ;
-  double       te    = f-> edge_thresh ;
-  double       tp    = f-> peak_thresh ;
+  /* is there another octave ? */
+  if (f->o_cur == f->o_min + f->O - 1)
+    return VL_ERR_EOF ;
 
-  int const    xo    = 1 ;      /* x-stride */
-  int const    yo    = w ;      /* y-stride */
-  int const    so    = w * h ;  /* s-stride */
+  f-> o_cur            += 1 ;
+  f-> nkeys             = 0 ;
+  f-> octave_width  = VL_SHIFT_LEFT(f->width,  - f->o_cur) ;
+  f-> octave_height = VL_SHIFT_LEFT(f->height, - f->o_cur) ;
 
-  double       xper  = pow (2.0, f->o_cur) ;
+  _vl_sift_gss_next_octave (f, f->octave, f->octave, f->o_cur) ;
+  return VL_ERR_OK ;
+}
 
-  int x, y, s, i, ii, jj ;
-  vl_sift_pix *pt, v ;
-  VlSiftKeypoint *k ;
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Smallest float not lower than a double
+ **
+ ** @param t value.
+ **
+ ** For a float @c v, <code>v >= t</code> (compared in double) is the
+ ** same as <code>v >= _vl_sift_float_ceil(t)</code> (compared in
+ ** float).
+ **/
 
-  /* clear current list */
-  f-> nkeys = 0 ;
+static vl_sift_pix
+_vl_sift_float_ceil (double t)
+{
+  union { float f ; vl_uint32 i ; } u ;
+  u.f = (float) t ;
+  if ((double) u.f < t) {
+    if (u.f == 0) { u.i = 1 ; }
+    else if (u.f > 0) { u.i += 1 ; }
+    else { u.i -= 1 ; }
+  }
+  return u.f ;
+}
 
-  /* compute difference of gaussian (DoG) */
-  pt = f-> dog ;
-  for (s = s_min ; s <= s_max - 1 ; ++s) {
-    vl_sift_pix* src_a = vl_sift_get_octave (f, s    ) ;
-    vl_sift_pix* src_b = vl_sift_get_octave (f, s + 1) ;
-    vl_sift_pix* end_a = src_a + w * h ;
-    while (src_a != end_a) {
-      *pt++ = *src_b++ - *src_a++ ;
-    }
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Difference of two Gaussian levels
+ **
+ ** @param dog output level.
+ ** @param a   lower level.
+ ** @param b   upper level.
+ ** @param n   number of pixels.
+ **/
+
+static void
+_vl_sift_dog (vl_sift_pix *dog, vl_sift_pix const *a,
+              vl_sift_pix const *b, int n)
+{
+  vl_sift_pix const *end_a = a + n ;
+
+#ifndef VL_DISABLE_SSE2
+  if (vl_cpu_has_sse2() && vl_get_simd_enabled()) {
+    _vl_sift_dog_sse2 (dog, a, b, n) ;
+    return ;
   }
+#endif
 
-  /* -----------------------------------------------------------------
-   *                                          Find local maxima of DoG
-   * -------------------------------------------------------------- */
+  while (a != end_a) {
+    *dog++ = *b++ - *a++ ;
+  }
+}
 
-  /* start from dog [1,1,s_min+1] */
-  pt  = dog + xo + yo + so ;
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Find the local extrema in a row of the DoG
+ **
+ ** @param xs output offsets of the extrema.
+ ** @param pt first pixel of the row to test.
+ ** @param n  number of pixels to test.
+ ** @param yo y-stride.
+ ** @param so s-stride.
+ ** @param tp peak threshold.
+ ** @return number of extrema.
+ **
+ ** A pixel is an extremum if it is larger (smaller) than its 26
+ ** neighbors and larger than <code>0.8 tp</code> (smaller than
+ ** <code>-0.8 tp</code>). The offsets are in increasing order.
+ **/
 
-  for(s = s_min + 1 ; s <= s_max - 2 ; ++s) {
-    for(y = 1 ; y < h - 1 ; ++y) {
-      for(x = 1 ; x < w - 1 ; ++x) {
-        v = *pt ;
+static int
+_vl_sift_find_extrema_row (int *xs, vl_sift_pix const *pt, int n,
+                           int yo, int so, double tp)
+{
+  int const xo = 1 ;
+  int x, nx = 0 ;
+  vl_sift_pix v ;
+
+#ifndef VL_DISABLE_SSE2
+  if (vl_cpu_has_sse2() && vl_get_simd_enabled()) {
+    return _vl_sift_find_extrema_row_sse2
+      (xs, pt, n, yo, so, _vl_sift_float_ceil (0.8 * tp)) ;
+  }
+#endif
+
+  for (x = 0 ; x < n ; ++x, ++pt) {
+    v = *pt ;
 
 #define CHECK_NEIGHBORS(CMP,SGN)                    \
-        ( v CMP ## = SGN 0.8 * tp &&                \
-          v CMP *(pt + xo) &&                       \
-          v CMP *(pt - xo) &&                       \
-          v CMP *(pt + so) &&                       \
-          v CMP *(pt - so) &&                       \
-          v CMP *(pt + yo) &&                       \
-          v CMP *(pt - yo) &&                       \
+    ( v CMP ## = SGN 0.8 * tp &&                    \
+      v CMP *(pt + xo) &&                           \
+      v CMP *(pt - xo) &&                           \
+      v CMP *(pt + so) &&                           \
+      v CMP *(pt - so) &&                           \
+      v CMP *(pt + yo) &&                           \
+      v CMP *(pt - yo) &&                           \
                                                     \
-          v CMP *(pt + yo + xo) &&                  \
-          v CMP *(pt + yo - xo) &&                  \
-          v CMP *(pt - yo + xo) &&                  \
-          v CMP *(pt - yo - xo) &&                  \
+      v CMP *(pt + yo + xo) &&                      \
+      v CMP *(pt + yo - xo) &&                      \
+      v CMP *(pt - yo + xo) &&                      \
+      v CMP *(pt - yo - xo) &&                      \
                                                     \
-          v CMP *(pt + xo      + so) &&             \
-          v CMP *(pt - xo      + so) &&             \
-          v CMP *(pt + yo      + so) &&             \
-          v CMP *(pt - yo      + so) &&             \
-          v CMP *(pt + yo + xo + so) &&             \
-          v CMP *(pt + yo - xo + so) &&             \
-          v CMP *(pt - yo + xo + so) &&             \
-          v CMP *(pt - yo - xo + so) &&             \
+      v CMP *(pt + xo      + so) &&                 \
+      v CMP *(pt - xo      + so) &&                 \
+      v CMP *(pt + yo      + so) &&                 \
+      v CMP *(pt - yo      + so) &&                 \
+      v CMP *(pt + yo + xo + so) &&                 \
+      v CMP *(pt + yo - xo + so) &&                 \
+      v CMP *(pt - yo + xo + so) &&                 \
+      v CMP *(pt - yo - xo + so) &&                 \
                                                     \
-          v CMP *(pt + xo      - so) &&             \
-          v CMP *(pt - xo      - so) &&             \
-          v CMP *(pt + yo      - so) &&             \
-          v CMP *(pt - yo      - so) &&             \
-          v CMP *(pt + yo + xo - so) &&             \
-          v CMP *(pt + yo - xo - so) &&             \
-          v CMP *(pt - yo + xo - so) &&             \
-          v CMP *(pt - yo - xo - so) )
-
-        if (CHECK_NEIGHBORS(>,+) ||
-            CHECK_NEIGHBORS(<,-) ) {
-
-          /* make room for more keypoints */
-          if (f->nkeys >= f->keys_res) {
-            f->keys_res += 500 ;
-            if (f->keys) {
-              f->keys = vl_realloc (f->keys,
-                                    f->keys_res *
-                                    sizeof(VlSiftKeypoint)) ;
-            } else {
-              f->keys = vl_malloc (f->keys_res *
-                                   sizeof(VlSiftKeypoint)) ;
-            }
-          }
+      v CMP *(pt + xo      - so) &&                 \
+      v CMP *(pt - xo      - so) &&                 \
+      v CMP *(pt + yo      - so) &&                 \
+      v CMP *(pt - yo      - so) &&                 \
+      v CMP *(pt + yo + xo - so) &&                 \
+      v CMP *(pt + yo - xo - so) &&                 \
+      v CMP *(pt - yo + xo - so) &&                 \
+      v CMP *(pt - yo - xo - so) )
+
+    if (CHECK_NEIGHBORS(>,+) ||
+        CHECK_NEIGHBORS(<,-) ) {
+      xs [nx++] = x ;
+    }
+  }
+  return nx ;
+}
 
-          k = f->keys + (f->nkeys ++) ;
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Append a keypoint to a list
+ **
+ ** @param keys  keypoint list (in/out).
+ ** @param nkeys number of keypoints (in/out).
+ ** @param res   size of the list (in/out).
+ ** @return the new keypoint.
+ **/
 
-          k-> ix = x ;
-          k-> iy = y ;
-          k-> is = s ;
-        }
-        pt += 1 ;
-      }
-      pt += 2 ;
+static VlSiftKeypoint *
+_vl_sift_push_keypoint (VlSiftKeypoint **keys, int *nkeys, int *res)
+{
+  /* make room for more keypoints */
+  if (*nkeys >= *res) {
+    *res += 500 ;
+    if (*keys) {
+      *keys = vl_realloc (*keys, *res * sizeof(VlSiftKeypoint)) ;
+    } else {
+      *keys = vl_malloc (*res * sizeof(VlSiftKeypoint)) ;
     }
-    pt += 2 * yo ;
   }
+  return *keys + (*nkeys) ++ ;
+}
 
-  /* -----------------------------------------------------------------
-   *                                               Refine local maxima
-   * -------------------------------------------------------------- */
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Find the local extrema of a DoG level
+ **
+ ** @param f     SIFT filter.
+ ** @param dog   DoG levels @c s_min to @c s_max-1 of the octave.
+ ** @param w     octave width.
+ ** @param h     octave height.
+ ** @param s     level.
+ ** @param xs    buffer of @a w integers.
+ ** @param keys  keypoint list (in/out).
+ ** @param nkeys number of keypoints (in/out).
+ ** @param res   size of the list (in/out).
+ **
+ ** The extrema are appended by rows, in the order of ::vl_sift_detect().
+ **/
 
-  /* this pointer is used to write the keypoints back */
-  k = f->keys ;
+static void
+_vl_sift_scan_level (VlSiftFilt const *f, vl_sift_pix const *dog,
+                     int w, int h, int s, int *xs,
+                     VlSiftKeypoint **keys, int *nkeys, int *res)
+{
+  int const yo = w ;
+  int const so = w * h ;
+  int y, i, nx ;
+
+  for (y = 1 ; y < h - 1 ; ++y) {
+    vl_sift_pix const *pt = dog + (s - f->s_min) * so + y * yo + 1 ;
+    nx = _vl_sift_find_extrema_row (xs, pt, w - 2, yo, so, f->peak_thresh) ;
+    for (i = 0 ; i < nx ; ++i) {
+      VlSiftKeypoint *k = _vl_sift_push_keypoint (keys, nkeys, res) ;
+      k-> ix = xs [i] + 1 ;
+      k-> iy = y ;
+      k-> is = s ;
+    }
+  }
+}
 
-  for (i = 0 ; i < f->nkeys ; ++i) {
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Refine a local extremum of the DoG
+ **
+ ** @param f   SIFT filter.
+ ** @param dog DoG levels @c s_min to @c s_max-1 of the octave.
+ ** @param w   octave width.
+ ** @param h   octave height.
+ ** @param o   octave index.
+ ** @param k   keypoint, @c ix, @c iy and @c is are the extremum (in),
+ **            all the fields are set (out).
+ ** @return true if the keypoint passes the peak and edge thresholds.
+ **/
+
+static vl_bool
+_vl_sift_refine_keypoint (VlSiftFilt const *f, vl_sift_pix const *dog,
+                          int w, int h, int o, VlSiftKeypoint *k)
+{
+  int          s_min = f-> s_min ;
+  int          s_max = f-> s_max ;
+  double       te    = f-> edge_thresh ;
+  double       tp    = f-> peak_thresh ;
+
+  int const    xo    = 1 ;      /* x-stride */
+  int const    yo    = w ;      /* y-stride */
+  int const    so    = w * h ;  /* s-stride */
+
+  double       xper  = pow (2.0, o) ;
 
-    int x = f-> keys [i] .ix ;
-    int y = f-> keys [i] .iy ;
-    int s = f-> keys [i]. is ;
+  int x = k-> ix ;
+  int y = k-> iy ;
+  int s = k-> is ;
 
-    double Dx=0,Dy=0,Ds=0,Dxx=0,Dyy=0,Dss=0,Dxy=0,Dxs=0,Dys=0 ;
-    double A [3*3], b [3] ;
+  double Dx=0,Dy=0,Ds=0,Dxx=0,Dyy=0,Dss=0,Dxy=0,Dxs=0,Dys=0 ;
+  double A [3*3], b [3] ;
+  vl_sift_pix const *pt ;
 
-    int dx = 0 ;
-    int dy = 0 ;
+  int dx = 0 ;
+  int dy = 0 ;
 
-    int iter, i, j ;
+  int iter, i, j, ii, jj ;
 
-    for (iter = 0 ; iter < 5 ; ++iter) {
+  for (iter = 0 ; iter < 5 ; ++iter) {
 
-      x += dx ;
-      y += dy ;
+    x += dx ;
+    y += dy ;
 
-      pt = dog
-        + xo * x
-        + yo * y
-        + so * (s - s_min) ;
+    pt = dog
+      + xo * x
+      + yo * y
+      + so * (s - s_min) ;
 
-      /** @brief Index GSS @internal */
+    /** @brief Index GSS @internal */
 #define at(dx,dy,ds) (*( pt + (dx)*xo + (dy)*yo + (ds)*so))
 
-      /** @brief Index matrix A @internal */
+    /** @brief Index matrix A @internal */
 #define Aat(i,j)     (A[(i)+(j)*3])
 
-      /* compute the gradient */
-      Dx = 0.5 * (at(+1,0,0) - at(-1,0,0)) ;
-      Dy = 0.5 * (at(0,+1,0) - at(0,-1,0));
-      Ds = 0.5 * (at(0,0,+1) - at(0,0,-1)) ;
-
-      /* compute the Hessian */
-      Dxx = (at(+1,0,0) + at(-1,0,0) - 2.0 * at(0,0,0)) ;
-      Dyy = (at(0,+1,0) + at(0,-1,0) - 2.0 * at(0,0,0)) ;
-      Dss = (at(0,0,+1) + at(0,0,-1) - 2.0 * at(0,0,0)) ;
-
-      Dxy = 0.25 * ( at(+1,+1,0) + at(-1,-1,0) - at(-1,+1,0) - at(+1,-1,0) ) ;
-      Dxs = 0.25 * ( at(+1,0,+1) + at(-1,0,-1) - at(-1,0,+1) - at(+1,0,-1) ) ;
-      Dys = 0.25 * ( at(0,+1,+1) + at(0,-1,-1) - at(0,-1,+1) - at(0,+1,-1) ) ;
-
-      /* solve linear system ....................................... */
-      Aat(0,0) = Dxx ;
-      Aat(1,1) = Dyy ;
-      Aat(2,2) = Dss ;
-      Aat(0,1) = Aat(1,0) = Dxy ;
-      Aat(0,2) = Aat(2,0) = Dxs ;
-      Aat(1,2) = Aat(2,1) = Dys ;
-
-      b[0] = - Dx ;
-      b[1] = - Dy ;
-      b[2] = - Ds ;
-
-      /* Gauss elimination */
-      for(j = 0 ; j < 3 ; ++j) {
-        double maxa    = 0 ;
-        double maxabsa = 0 ;
-        int    maxi    = -1 ;
-        double tmp ;
-
-        /* look for the maximally stable pivot */
-        for (i = j ; i < 3 ; ++i) {
-          double a    = Aat (i,j) ;
-          double absa = vl_abs_d (a) ;
-          if (absa > maxabsa) {
-            maxa    = a ;
-            maxabsa = absa ;
-            maxi    = i ;
-          }
+    /* compute the gradient */
+    Dx = 0.5 * (at(+1,0,0) - at(-1,0,0)) ;
+    Dy = 0.5 * (at(0,+1,0) - at(0,-1,0));
+    Ds = 0.5 * (at(0,0,+1) - at(0,0,-1)) ;
+
+    /* compute the Hessian */
+    Dxx = (at(+1,0,0) + at(-1,0,0) - 2.0 * at(0,0,0)) ;
+    Dyy = (at(0,+1,0) + at(0,-1,0) - 2.0 * at(0,0,0)) ;
+    Dss = (at(0,0,+1) + at(0,0,-1) - 2.0 * at(0,0,0)) ;
+
+    Dxy = 0.25 * ( at(+1,+1,0) + at(-1,-1,0) - at(-1,+1,0) - at(+1,-1,0) ) ;
+    Dxs = 0.25 * ( at(+1,0,+1) + at(-1,0,-1) - at(-1,0,+1) - at(+1,0,-1) ) ;
+    Dys = 0.25 * ( at(0,+1,+1) + at(0,-1,-1) - at(0,-1,+1) - at(0,+1,-1) ) ;
+
+    /* solve linear system ....................................... */
+    Aat(0,0) = Dxx ;
+    Aat(1,1) = Dyy ;
+    Aat(2,2) = Dss ;
+    Aat(0,1) = Aat(1,0) = Dxy ;
+    Aat(0,2) = Aat(2,0) = Dxs ;
+    Aat(1,2) = Aat(2,1) = Dys ;
+
+    b[0] = - Dx ;
+    b[1] = - Dy ;
+    b[2] = - Ds ;
+
+    /* Gauss elimination */
+    for(j = 0 ; j < 3 ; ++j) {
+      double maxa    = 0 ;
+      double maxabsa = 0 ;
+      int    maxi    = -1 ;
+      double tmp ;
+
+      /* look for the maximally stable pivot */
+      for (i = j ; i < 3 ; ++i) {
+        double a    = Aat (i,j) ;
+        double absa = vl_abs_d (a) ;
+        if (absa > maxabsa) {
+          maxa    = a ;
+          maxabsa = absa ;
+          maxi    = i ;
         }
+      }
 
-        /* if singular give up */
-        if (maxabsa < 1e-10f) {
-          b[0] = 0 ;
-          b[1] = 0 ;
-          b[2] = 0 ;
-          break ;
-        }
+      /* if singular give up */
+      if (maxabsa < 1e-10f) {
+        b[0] = 0 ;
+        b[1] = 0 ;
+        b[2] = 0 ;
+        break ;
+      }
 
-        i = maxi ;
+      i = maxi ;
 
-        /* swap j-th row with i-th row and normalize j-th row */
-        for(jj = j ; jj < 3 ; ++jj) {
-          tmp = Aat(i,jj) ; Aat(i,jj) = Aat(j,jj) ; Aat(j,jj) = tmp ;
-          Aat(j,jj) /= maxa ;
-        }
-        tmp = b[j] ; b[j] = b[i] ; b[i] = tmp ;
-        b[j] /= maxa ;
-
-        /* elimination */
-        for (ii = j+1 ; ii < 3 ; ++ii) {
-          double x = Aat(ii,j) ;
-          for (jj = j ; jj < 3 ; ++jj) {
-            Aat(ii,jj) -= x * Aat(j,jj) ;
-          }
-          b[ii] -= x * b[j] ;
-        }
+      /* swap j-th row with i-th row and normalize j-th row */
+      for(jj = j ; jj < 3 ; ++jj) {
+        tmp = Aat(i,jj) ; Aat(i,jj) = Aat(j,jj) ; Aat(j,jj) = tmp ;
+        Aat(j,jj) /= maxa ;
       }
-
-      /* backward substitution */
-      for (i = 2 ; i > 0 ; --i) {
-        double x = b[i] ;
-        for (ii = i-1 ; ii >= 0 ; --ii) {
-          b[ii] -= x * Aat(ii,i) ;
+      tmp = b[j] ; b[j] = b[i] ; b[i] = tmp ;
+      b[j] /= maxa ;
+
+      /* elimination */
+      for (ii = j+1 ; ii < 3 ; ++ii) {
+        double x = Aat(ii,j) ;
+        for (jj = j ; jj < 3 ; ++jj) {
+          Aat(ii,jj) -= x * Aat(j,jj) ;
         }
+        b[ii] -= x * b[j] ;
       }
+    }
 
-      /* .......................................................... */
-      /* If the translation of the keypoint is big, move the keypoint
-       * and re-iterate the computation. Otherwise we are all set.
-       */
-
-      dx= ((b[0] >  0.6 && x < w - 2) ?  1 : 0)
-        + ((b[0] < -0.6 && x > 1    ) ? -1 : 0) ;
+    /* backward substitution */
+    for (i = 2 ; i > 0 ; --i) {
+      double x = b[i] ;
+      for (ii = i-1 ; ii >= 0 ; --ii) {
+        b[ii] -= x * Aat(ii,i) ;
+      }
+    }
 
-      dy= ((b[1] >  0.6 && y < h - 2) ?  1 : 0)
-        + ((b[1] < -0.6 && y > 1    ) ? -1 : 0) ;
+    /* .......................................................... */
+    /* If the translation of the keypoint is big, move the keypoint
+     * and re-iterate the computation. Otherwise we are all set.
+     */
 
-      if (dx == 0 && dy == 0) break ;
-    }
+    dx= ((b[0] >  0.6 && x < w - 2) ?  1 : 0)
+      + ((b[0] < -0.6 && x > 1    ) ? -1 : 0) ;
 
-    /* check threshold and other conditions */
-    {
-      double val   = at(0,0,0)
-        + 0.5 * (Dx * b[0] + Dy * b[1] + Ds * b[2]) ;
-      double score = (Dxx+Dyy)*(Dxx+Dyy) / (Dxx*Dyy - Dxy*Dxy) ;
-      double xn = x + b[0] ;
-      double yn = y + b[1] ;
-      double sn = s + b[2] ;
-
-      vl_bool good =
-        vl_abs_d (val)  > tp                  &&
-        score           < (te+1)*(te+1)/te    &&
-        score           >= 0                  &&
-        vl_abs_d (b[0]) <  1.5                &&
-        vl_abs_d (b[1]) <  1.5                &&
-        vl_abs_d (b[2]) <  1.5                &&
-        xn              >= 0                  &&
-        xn              <= w - 1              &&
-        yn              >= 0                  &&
-        yn              <= h - 1              &&
-        sn              >= s_min              &&
-        sn              <= s_max ;
-
-      if (good) {
-        k-> o     = f->o_cur ;
-        k-> ix    = x ;
-        k-> iy    = y ;
-        k-> is    = s ;
-        k-> s     = sn ;
-        k-> x     = xn * xper ;
-        k-> y     = yn * xper ;
-        k-> sigma = f->sigma0 * pow (2.0, sn/f->S) * xper ;
-        ++ k ;
-      }
+    dy= ((b[1] >  0.6 && y < h - 2) ?  1 : 0)
+      + ((b[1] < -0.6 && y > 1    ) ? -1 : 0) ;
 
-    } /* done checking */
-  } /* next keypoint to refine */
+    if (dx == 0 && dy == 0) break ;
+  }
 
-  /* update keypoint count */
-  f-> nkeys = k - f->keys ;
+  /* check threshold and other conditions */
+  {
+    double val   = at(0,0,0)
+      + 0.5 * (Dx * b[0] + Dy * b[1] + Ds * b[2]) ;
+    double score = (Dxx+Dyy)*(Dxx+Dyy) / (Dxx*Dyy - Dxy*Dxy) ;
+    double xn = x + b[0] ;
+    double yn = y + b[1] ;
+    double sn = s + b[2] ;
+
+    vl_bool good =
+      vl_abs_d (val)  > tp                  &&
+      score           < (te+1)*(te+1)/te    &&
+      score           >= 0                  &&
+      vl_abs_d (b[0]) <  1.5                &&
+      vl_abs_d (b[1]) <  1.5                &&
+      vl_abs_d (b[2]) <  1.5                &&
+      xn              >= 0                  &&
+      xn              <= w - 1              &&
+      yn              >= 0                  &&
+      yn              <= h - 1              &&
+      sn              >= s_min              &&
+      sn              <= s_max ;
+
+    if (good) {
+      k-> o     = o ;
+      k-> ix    = x ;
+      k-> iy    = y ;
+      k-> is    = s ;
+      k-> s     = sn ;
+      k-> x     = xn * xper ;
+      k-> y     = yn * xper ;
+      k-> sigma = f->sigma0 * pow (2.0, sn/f->S) * xper ;
+    }
+    return good ;
+  }
 }
 
-
 /** ------------------------------------------------------------------
- ** @internal
- ** @brief Update gradients to current GSS octave
- **
- ** @param f SIFT filter.
+ ** @brief Detect keypoints
  **
- ** The function makes sure that the gradient buffer is up-to-date
- ** with the current GSS data.
+ ** The function detect keypoints in the current octave filling the
+ ** internal keypoint buffer. Keypoints can be retrieved by
+ ** ::vl_sift_get_keypoints().
  **
- ** @remark The minimum octave size is 2x2xS.
+ ** @param f SIFT filter.
  **/
 
-static void
-update_gradient (VlSiftFilt *f)
+VL_EXPORT
+void
+vl_sift_detect (VlSiftFilt * f)
 {
-  int       s_min = f->s_min ;
-  int       s_max = f->s_max ;
-  int       w     = vl_sift_get_octave_width  (f) ;
-  int       h     = vl_sift_get_octave_height (f) ;
-  int const xo    = 1 ;
-  int const yo    = w ;
-  int const so    = h * w ;
-  int y, s ;
-
-  if (f->grad_o == f->o_cur) return ;
+  vl_sift_pix* dog   = f-> dog ;
+  int          s_min = f-> s_min ;
+  int          s_max = f-> s_max ;
+  int          w     = f-> octave_width ;
+  int          h     = f-> octave_height ;
 
-  for (s  = s_min + 1 ;
-       s <= s_max - 2 ; ++ s) {
+  int s, i ;
+  int *xs ;
+  VlSiftKeypoint *k ;
 
-    vl_sift_pix *src, *end, *grad, gx, gy ;
+  /* clear current list */
+  f-> nkeys = 0 ;
 
-#define SAVE_BACK                                                       \
-    *grad++ = vl_fast_sqrt_f (gx*gx + gy*gy) ;                          \
-    *grad++ = vl_mod_2pi_f   (vl_fast_atan2_f (gy, gx) + 2*VL_PI) ;     \
-    ++src ;                                                             \
+  /* compute difference of gaussian (DoG) */
+  for (s = s_min ; s <= s_max - 1 ; ++s) {
+    _vl_sift_dog (dog + w * h * (s - s_min),
+                  vl_sift_get_octave (f, s    ),
+                  vl_sift_get_octave (f, s + 1), w * h) ;
+  }
 
-    src  = vl_sift_get_octave (f,s) ;
-    grad = f->grad + 2 * so * (s - s_min -1) ;
+  /* -----------------------------------------------------------------
+   *                                          Find local maxima of DoG
+   * -------------------------------------------------------------- */
 
-    /* first pixel of the first row */
-    gx = src[+xo] - src[0] ;
-    gy = src[+yo] - src[0] ;
-    SAVE_BACK ;
+  xs = vl_malloc (sizeof(int) * w) ;
+  for(s = s_min + 1 ; s <= s_max - 2 ; ++s) {
+    _vl_sift_scan_level (f, dog, w, h, s, xs,
+                         &f->keys, &f->nkeys, &f->keys_res) ;
+  }
+  vl_free (xs) ;
 
-    /* middle pixels of the  first row */
-    end = (src - 1) + w - 1 ;
-    while (src < end) {
-      gx = 0.5 * (src[+xo] - src[-xo]) ;
-      gy =        src[+yo] - src[0] ;
-      SAVE_BACK ;
+  /* -----------------------------------------------------------------
+   *                                               Refine local maxima
+   * -------------------------------------------------------------- */
+
+  /* this pointer is used to write the keypoints back */
+  k = f->keys ;
+
+  for (i = 0 ; i < f->nkeys ; ++i) {
+    VlSiftKeypoint key = f->keys [i] ;
+    if (_vl_sift_refine_keypoint (f, dog, w, h, f->o_cur, &key)) {
+      *k++ = key ;
     }
+  }
 
-    /* last pixel of the first row */
-    gx = src[0]   - src[-xo] ;
-    gy = src[+yo] - src[0] ;
-    SAVE_BACK ;
+  /* update keypoint count */
+  f-> nkeys = k - f->keys ;
+}
 
-    for (y = 1 ; y < h -1 ; ++y) {
 
-      /* first pixel of the middle rows */
-      gx =        src[+xo] - src[0] ;
-      gy = 0.5 * (src[+yo] - src[-yo]) ;
-      SAVE_BACK ;
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Gradient of a GSS level
+ **
+ ** @param grad gradient modulus and angle, interleaved (output).
+ ** @param src  GSS level.
+ ** @param w    octave width.
+ ** @param h    octave height.
+ **/
 
-      /* middle pixels of the middle rows */
-      end = (src - 1) + w - 1 ;
-      while (src < end) {
-        gx = 0.5 * (src[+xo] - src[-xo]) ;
-        gy = 0.5 * (src[+yo] - src[-yo]) ;
-        SAVE_BACK ;
-      }
+static void
+_vl_sift_gradient_level (vl_sift_pix *grad, vl_sift_pix const *src,
+                         int w, int h)
+{
+  int const xo    = 1 ;
+  int const yo    = w ;
+  int y ;
+  vl_sift_pix const *end ;
+  vl_sift_pix gx, gy ;
 
-      /* last pixel of the middle row */
-      gx =        src[0]   - src[-xo] ;
-      gy = 0.5 * (src[+yo] - src[-yo]) ;
-      SAVE_BACK ;
-    }
+#define SAVE_BACK                                                       \
+  *grad++ = vl_fast_sqrt_f (gx*gx + gy*gy) ;                            \
+  *grad++ = vl_mod_2pi_f   (vl_fast_atan2_f (gy, gx) + 2*VL_PI) ;       \
+  ++src ;                                                               \
+
+  /* first pixel of the first row */
+  gx = src[+xo] - src[0] ;
+  gy = src[+yo] - src[0] ;
+  SAVE_BACK ;
+
+  /* middle pixels of the  first row */
+  end = (src - 1) + w - 1 ;
+  while (src < end) {
+    gx = 0.5 * (src[+xo] - src[-xo]) ;
+    gy =        src[+yo] - src[0] ;
+    SAVE_BACK ;
+  }
+
+  /* last pixel of the first row */
+  gx = src[0]   - src[-xo] ;
+  gy = src[+yo] - src[0] ;
+  SAVE_BACK ;
+
+  for (y = 1 ; y < h -1 ; ++y) {
 
-    /* first pixel of the last row */
-    gx = src[+xo] - src[0] ;
-    gy = src[  0] - src[-yo] ;
+    /* first pixel of the middle rows */
+    gx =        src[+xo] - src[0] ;
+    gy = 0.5 * (src[+yo] - src[-yo]) ;
     SAVE_BACK ;
 
-    /* middle pixels of the last row */
+    /* middle pixels of the middle rows */
     end = (src - 1) + w - 1 ;
     while (src < end) {
       gx = 0.5 * (src[+xo] - src[-xo]) ;
-      gy =        src[0]   - src[-yo] ;
+      gy = 0.5 * (src[+yo] - src[-yo]) ;
       SAVE_BACK ;
     }
 
-    /* last pixel of the last row */
-    gx = src[0]   - src[-xo] ;
-    gy = src[0]   - src[-yo] ;
+    /* last pixel of the middle row */
+    gx =        src[0]   - src[-xo] ;
+    gy = 0.5 * (src[+yo] - src[-yo]) ;
     SAVE_BACK ;
   }
-  f->grad_o = f->o_cur ;
+
+  /* first pixel of the last row */
+  gx = src[+xo] - src[0] ;
+  gy = src[  0] - src[-yo] ;
+  SAVE_BACK ;
+
+  /* middle pixels of the last row */
+  end = (src - 1) + w - 1 ;
+  while (src < end) {
+    gx = 0.5 * (src[+xo] - src[-xo]) ;
+    gy =        src[0]   - src[-yo] ;
+    SAVE_BACK ;
+  }
+
+  /* last pixel of the last row */
+  gx = src[0]   - src[-xo] ;
+  gy = src[0]   - src[-yo] ;
+  SAVE_BACK ;
 }
 
 /** ------------------------------------------------------------------
- ** @brief Calculate the keypoint orientation(s)
+ ** @internal
+ ** @brief Update gradients to current GSS octave
  **
- ** @param f        SIFT filter.
- ** @param angles   orientations (output).
- ** @param k        keypoint.
+ ** @param f SIFT filter.
  **
- ** The function computes the orientation(s) of the keypoint @a k.
- ** The function returns the number of orientations found (up to
- ** four). The orientations themselves are written to the vector @a
- ** angles.
+ ** The function makes sure that the gradient buffer is up-to-date
+ ** with the current GSS data.
  **
- ** @remark The function requires the keypoint octave @a k->o to be
- ** equal to the filter current octave ::vl_sift_get_octave. If this
- ** is not the case, the function returns zero orientations.
+ ** @remark The minimum octave size is 2x2xS.
+ **/
+
+static void
+update_gradient (VlSiftFilt *f)
+{
+  int       s_min = f->s_min ;
+  int       s_max = f->s_max ;
+  int       w     = vl_sift_get_octave_width  (f) ;
+  int       h     = vl_sift_get_octave_height (f) ;
+  int const so    = h * w ;
+  int s ;
+
+  if (f->grad_o == f->o_cur) return ;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic,1) if(so > 4096)
+#endif
+  for (s  = s_min + 1 ;
+       s <= s_max - 2 ; ++ s) {
+    _vl_sift_gradient_level (f->grad + 2 * so * (s - s_min -1),
+                             vl_sift_get_octave (f,s), w, h) ;
+  }
+  f->grad_o = f->o_cur ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Calculate the keypoint orientation(s)
  **
- ** @remark The function requires the keypoint scale level @c k->s to
- ** be in the range @c s_min+1 and @c s_max-2 (where usually @c
- ** s_min=0 and @c s_max=S+2). If this is not the case, the function
- ** returns zero orientations.
+ ** @param f      SIFT filter.
+ ** @param grad   gradient of the keypoint octave.
+ ** @param w      octave width.
+ ** @param h      octave height.
+ ** @param o      octave index.
+ ** @param angles orientations (output).
+ ** @param k      keypoint.
  **
  ** @return number of orientations found.
+ ** @sa ::vl_sift_calc_keypoint_orientations().
  **/
 
-VL_EXPORT
-int
-vl_sift_calc_keypoint_orientations (VlSiftFilt *f,
-                                    double angles [4],
-                                    VlSiftKeypoint const *k)
+static int
+_vl_sift_calc_keypoint_orientations (VlSiftFilt const *f,
+                                     vl_sift_pix const *grad,
+                                     int w, int h, int o,
+                                     double angles [4],
+                                     VlSiftKeypoint const *k)
 {
   double const winf   = 1.5 ;
-  double       xper   = pow (2.0, f->o_cur) ;
+  double       xper   = pow (2.0, o) ;
 
-  int          w      = f-> octave_width ;
-  int          h      = f-> octave_height ;
   int const    xo     = 2 ;         /* x-stride */
   int const    yo     = 2 * w ;     /* y-stride */
   int const    so     = 2 * w * h ; /* s-stride */
@@ -1606,10 +1843,6 @@ vl_sift_calc_keypoint_orientations (VlSiftFilt *f,
   vl_sift_pix const * pt ;
   int xs, ys, iter, i ;
 
-  /* skip if the keypoint octave is not current */
-  if(k->o != f->o_cur)
-    return 0 ;
-
   /* skip the keypoint if it is out of bounds */
   if(xi < 0            ||
      xi > w - 1        ||
@@ -1620,14 +1853,11 @@ vl_sift_calc_keypoint_orientations (VlSiftFilt *f,
     return 0 ;
   }
 
-  /* make gradient up to date */
-  update_gradient (f) ;
-
   /* clear histogram */
   memset (hist, 0, sizeof(double) * nbins) ;
 
   /* compute orientation histogram */
-  pt = f-> grad + xo*xi + yo*yi + so*(si - f->s_min - 1) ;
+  pt = grad + xo*xi + yo*yi + so*(si - f->s_min - 1) ;
 
 #undef  at
 #define at(dx,dy) (*(pt + xo * (dx) + yo * (dy)))
@@ -1711,6 +1941,47 @@ vl_sift_calc_keypoint_orientations (VlSiftFilt *f,
 }
 
 
+/** ------------------------------------------------------------------
+ ** @brief Calculate the keypoint orientation(s)
+ **
+ ** @param f        SIFT filter.
+ ** @param angles   orientations (output).
+ ** @param k        keypoint.
+ **
+ ** The function computes the orientation(s) of the keypoint @a k.
+ ** The function returns the number of orientations found (up to
+ ** four). The orientations themselves are written to the vector @a
+ ** angles.
+ **
+ ** @remark The function requires the keypoint octave @a k->o to be
+ ** equal to the filter current octave ::vl_sift_get_octave. If this
+ ** is not the case, the function returns zero orientations.
+ **
+ ** @remark The function requires the keypoint scale level @c k->s to
+ ** be in the range @c s_min+1 and @c s_max-2 (where usually @c
+ ** s_min=0 and @c s_max=S+2). If this is not the case, the function
+ ** returns zero orientations.
+ **
+ ** @return number of orientations found.
+ **/
+
+VL_EXPORT
+int
+vl_sift_calc_keypoint_orientations (VlSiftFilt *f,
+                                    double angles [4],
+                                    VlSiftKeypoint const *k)
+{
+  /* skip if the keypoint octave is not current */
+  if(k->o != f->o_cur)
+    return 0 ;
+
+  /* make gradient up to date */
+  update_gradient (f) ;
+
+  return _vl_sift_calc_keypoint_orientations
+    (f, f->grad, f->octave_width, f->octave_height, f->o_cur, angles, k) ;
+}
+
 /** ------------------------------------------------------------------
  ** @internal
  ** @brief Normalizes in norm L_2 a descriptor
@@ -1922,27 +2193,28 @@ vl_sift_calc_raw_descriptor (VlSiftFilt const *f,
 }
 
 /** ------------------------------------------------------------------
+ ** @internal
  ** @brief Compute the descriptor of a keypoint
  **
  ** @param f        SIFT filter.
+ ** @param grad     gradient of the keypoint octave.
+ ** @param w        octave width.
+ ** @param h        octave height.
+ ** @param o        octave index.
  ** @param descr    SIFT descriptor (output)
  ** @param k        keypoint.
  ** @param angle0   keypoint direction.
  **
- ** The function computes the SIFT descriptor of the keypoint @a k of
- ** orientation @a angle0. The function fills the buffer @a descr
- ** which must be large enough to hold the descriptor.
- **
- ** The function assumes that the keypoint is on the current octave.
- ** If not, it does not do anything.
+ ** @sa ::vl_sift_calc_keypoint_descriptor().
  **/
 
-VL_EXPORT
-void
-vl_sift_calc_keypoint_descriptor (VlSiftFilt *f,
-                                  vl_sift_pix *descr,
-                                  VlSiftKeypoint const* k,
-                                  double angle0)
+static void
+_vl_sift_calc_keypoint_descriptor (VlSiftFilt const *f,
+                                   vl_sift_pix const *grad,
+                                   int w, int h, int o,
+                                   vl_sift_pix *descr,
+                                   VlSiftKeypoint const* k,
+                                   double angle0)
 {
   /*
      The SIFT descriptor is a three dimensional histogram of the
@@ -1962,10 +2234,8 @@ vl_sift_calc_keypoint_descriptor (VlSiftFilt *f,
 
   double const magnif      = f-> magnif ;
 
-  double       xper        = pow (2.0, f->o_cur) ;
+  double       xper        = pow (2.0, o) ;
 
-  int          w           = f-> octave_width ;
-  int          h           = f-> octave_height ;
   int const    xo          = 2 ;         /* x-stride */
   int const    yo          = 2 * w ;     /* y-stride */
   int const    so          = 2 * w * h ; /* s-stride */
@@ -1992,8 +2262,7 @@ vl_sift_calc_keypoint_descriptor (VlSiftFilt *f,
   vl_sift_pix       *dpt ;
 
   /* check bounds */
-  if(k->o  != f->o_cur        ||
-     xi    <  0               ||
+  if(xi    <  0               ||
      xi    >= w               ||
      yi    <  0               ||
      yi    >= h -    1        ||
@@ -2001,9 +2270,6 @@ vl_sift_calc_keypoint_descriptor (VlSiftFilt *f,
      si    >  f->s_max - 2     )
     return ;
 
-  /* synchronize gradient buffer */
-  update_gradient (f) ;
-
   /* VL_PRINTF("W = %d ; magnif = %g ; SBP = %g\n", W,magnif,SBP) ; */
 
   /* clear descriptor */
@@ -2012,7 +2278,7 @@ vl_sift_calc_keypoint_descriptor (VlSiftFilt *f,
   /* Center the scale space and the descriptor on the current keypoint.
    * Note that dpt is pointing to the bin of center (SBP/2,SBP/2,0).
    */
-  pt  = f->grad + xi*xo + yi*yo + (si - f->s_min - 1)*so ;
+  pt  = grad + xi*xo + yi*yo + (si - f->s_min - 1)*so ;
   dpt = descr + (NBP/2) * binyo + (NBP/2) * binxo ;
 
 #undef atd
@@ -2111,6 +2377,363 @@ vl_sift_calc_keypoint_descriptor (VlSiftFilt *f,
 
 }
 
+/** ------------------------------------------------------------------
+ ** @brief Compute the descriptor of a keypoint
+ **
+ ** @param f        SIFT filter.
+ ** @param descr    SIFT descriptor (output)
+ ** @param k        keypoint.
+ ** @param angle0   keypoint direction.
+ **
+ ** The function computes the SIFT descriptor of the keypoint @a k of
+ ** orientation @a angle0. The function fills the buffer @a descr
+ ** which must be large enough to hold the descriptor.
+ **
+ ** The function assumes that the keypoint is on the current octave.
+ ** If not, it does not do anything.
+ **/
+
+VL_EXPORT
+void
+vl_sift_calc_keypoint_descriptor (VlSiftFilt *f,
+                                  vl_sift_pix *descr,
+                                  VlSiftKeypoint const* k,
+                                  double angle0)
+{
+  if(k->o != f->o_cur)
+    return ;
+
+  /* synchronize gradient buffer */
+  update_gradient (f) ;
+
+  _vl_sift_calc_keypoint_descriptor
+    (f, f->grad, f->octave_width, f->octave_height, f->o_cur,
+     descr, k, angle0) ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Get the buffers of an octave of the pyramid
+ **
+ ** @param f    SIFT filter.
+ ** @param o    octave index.
+ ** @param gss  GSS levels @c s_min to @c s_max (output).
+ ** @param dog  DoG levels @c s_min to @c s_max-1 (output).
+ ** @param grad gradient of the levels @c s_min+1 to @c s_max-2 (output).
+ ** @return number of pixels of the pyramid up to this octave (included).
+ **
+ ** The octaves are stored one after the other, each as its GSS, DoG
+ ** and gradient levels.
+ **/
+
+static int
+_vl_sift_pyr_octave (VlSiftFilt const *f, int o,
+                     vl_sift_pix **gss, vl_sift_pix **dog,
+                     vl_sift_pix **grad)
+{
+  int const nlevels = (f->s_max - f->s_min + 1)
+    + (f->s_max - f->s_min) + 2 * (f->s_max - f->s_min - 2) ;
+  int size = 0 ;
+  int p, nel ;
+  for (p = f->o_min ; p < o ; ++p) {
+    size += VL_SHIFT_LEFT(f->width,  - p) * VL_SHIFT_LEFT(f->height, - p) * nlevels ;
+  }
+  nel = VL_SHIFT_LEFT(f->width,  - o) * VL_SHIFT_LEFT(f->height, - o) ;
+  if (f->pyr) {
+    if (gss)  *gss  = f->pyr + size ;
+    if (dog)  *dog  = f->pyr + size + nel * (f->s_max - f->s_min + 1) ;
+    if (grad) *grad = f->pyr + size + nel * (2 * (f->s_max - f->s_min) + 1) ;
+  }
+  return size + nel * nlevels ;
+}
+
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Update the gradients of the pyramid
+ **
+ ** @param f SIFT filter.
+ **/
+
+static void
+_vl_sift_update_pyr_gradient (VlSiftFilt *f)
+{
+  int const nlevels = f->s_max - f->s_min - 2 ;
+  int j ;
+
+  if (f->pyr_grad) return ;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+  for (j = 0 ; j < f->O * nlevels ; ++j) {
+    int o = f->o_min + j / nlevels ;
+    int s = f->s_min + 1 + j % nlevels ;
+    int w = VL_SHIFT_LEFT(f->width,  - o) ;
+    int h = VL_SHIFT_LEFT(f->height, - o) ;
+    vl_sift_pix *gss, *grad ;
+    _vl_sift_pyr_octave (f, o, &gss, NULL, &grad) ;
+    _vl_sift_gradient_level (grad + 2 * w * h * (s - f->s_min - 1),
+                             gss + w * h * (s - f->s_min), w, h) ;
+  }
+  f->pyr_grad = 1 ;
+}
+
+/** ------------------------------------------------------------------
+ ** @brief Process a whole image
+ **
+ ** @param f  SIFT filter.
+ ** @param im image data.
+ **
+ ** The function computes the Gaussian scale space of all the octaves
+ ** and detects the keypoints of all of them. The keypoints, retrieved
+ ** by ::vl_sift_get_keypoints(), are the same and in the same order as
+ ** the ones of ::vl_sift_detect() octave after octave.
+ **
+ ** The Gaussian smoothing of an octave is sequential (each level is
+ ** smoothed by columns blocks in parallel), the base of each octave
+ ** being downsampled from the previous one. The rest of the work is
+ ** then scheduled as parallel tasks over the levels of all the
+ ** octaves: DoG, extrema (compared by SSE2 four pixels at once) and
+ ** refinement.
+ **
+ ** The scale space is kept for ::vl_sift_calc_image_orientations()
+ ** and ::vl_sift_calc_image_descriptors(). It is independent of the
+ ** current octave of ::vl_sift_process_first_octave() and
+ ** ::vl_sift_process_next_octave().
+ **
+ ** @return error code. The function returns ::VL_ERR_EOF if there are
+ ** no octaves.
+ **/
+
+VL_EXPORT
+int
+vl_sift_process_image (VlSiftFilt *f, vl_sift_pix const *im)
+{
+  int const O      = f->O ;
+  int const o_min  = f->o_min ;
+  int const s_min  = f->s_min ;
+  int const ndog   = f->s_max - f->s_min ;
+  int const nscan  = f->s_max - f->s_min - 2 ;
+  int size, o, j, i, total ;
+  VlSiftKeypoint **lists ;
+  int *nlist, *reslist ;
+  vl_bool *good ;
+  VlSiftKeypoint *k ;
+
+  f->nkeys = 0 ;
+  f->pyr_grad = 0 ;
+  if (O == 0)
+    return VL_ERR_EOF ;
+
+  /* -----------------------------------------------------------------
+   *                                            Gaussian scale space
+   * -------------------------------------------------------------- */
+
+  size = _vl_sift_pyr_octave (f, o_min + O - 1, NULL, NULL, NULL) ;
+  if (size > f->pyr_res) {
+    if (f->pyr) vl_free (f->pyr) ;
+    f->pyr = vl_malloc (sizeof(vl_sift_pix) * size) ;
+    f->pyr_res = size ;
+  }
+
+  for (o = o_min ; o < o_min + O ; ++o) {
+    vl_sift_pix *gss, *prev ;
+    _vl_sift_pyr_octave (f, o, &gss, NULL, NULL) ;
+    if (o == o_min) {
+      _vl_sift_gss_first_octave (f, gss, im) ;
+    } else {
+      _vl_sift_pyr_octave (f, o - 1, &prev, NULL, NULL) ;
+      _vl_sift_gss_next_octave (f, gss, prev, o) ;
+    }
+  }
+
+  /* -----------------------------------------------------------------
+   *                                  DoG, one task per level of octave
+   * -------------------------------------------------------------- */
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+  for (j = 0 ; j < O * ndog ; ++j) {
+    int o = o_min + j / ndog ;
+    int s = s_min + j % ndog ;
+    int nel = VL_SHIFT_LEFT(f->width, - o) * VL_SHIFT_LEFT(f->height, - o) ;
+    vl_sift_pix *gss, *dog ;
+    _vl_sift_pyr_octave (f, o, &gss, &dog, NULL) ;
+    _vl_sift_dog (dog + nel * (s - s_min),
+                  gss + nel * (s - s_min),
+                  gss + nel * (s + 1 - s_min), nel) ;
+  }
+
+  /* -----------------------------------------------------------------
+   *                              Extrema, one task per level of octave
+   * -------------------------------------------------------------- */
+
+  lists   = vl_malloc (sizeof(VlSiftKeypoint*) * O * nscan) ;
+  nlist   = vl_malloc (sizeof(int) * O * nscan) ;
+  reslist = vl_malloc (sizeof(int) * O * nscan) ;
+  for (j = 0 ; j < O * nscan ; ++j) {
+    lists [j] = NULL ;
+    nlist [j] = reslist [j] = 0 ;
+  }
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+  for (j = 0 ; j < O * nscan ; ++j) {
+    int o = o_min + j / nscan ;
+    int s = s_min + 1 + j % nscan ;
+    int w = VL_SHIFT_LEFT(f->width,  - o) ;
+    int h = VL_SHIFT_LEFT(f->height, - o) ;
+    int *xs = vl_malloc (sizeof(int) * w) ;
+    vl_sift_pix *dog ;
+    _vl_sift_pyr_octave (f, o, NULL, &dog, NULL) ;
+    _vl_sift_scan_level (f, dog, w, h, s, xs,
+                         &lists [j], &nlist [j], &reslist [j]) ;
+    vl_free (xs) ;
+  }
+
+  /* gather the candidates, octave after octave */
+  total = 0 ;
+  for (j = 0 ; j < O * nscan ; ++j) total += nlist [j] ;
+  if (total > f->keys_res) {
+    if (f->keys) vl_free (f->keys) ;
+    f->keys = vl_malloc (sizeof(VlSiftKeypoint) * total) ;
+    f->keys_res = total ;
+  }
+  k = f->keys ;
+  for (j = 0 ; j < O * nscan ; ++j) {
+    for (i = 0 ; i < nlist [j] ; ++i) {
+      *k = lists [j][i] ;
+      (k++)-> o = o_min + j / nscan ;
+    }
+    if (lists [j]) vl_free (lists [j]) ;
+  }
+  vl_free (lists) ;
+  vl_free (nlist) ;
+  vl_free (reslist) ;
+
+  /* -----------------------------------------------------------------
+   *                                                      Refinement
+   * -------------------------------------------------------------- */
+
+  good = vl_malloc (sizeof(vl_bool) * (total + 1)) ;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+  for (i = 0 ; i < total ; ++i) {
+    int o = f->keys [i].o ;
+    vl_sift_pix *dog ;
+    _vl_sift_pyr_octave (f, o, NULL, &dog, NULL) ;
+    good [i] = _vl_sift_refine_keypoint
+      (f, dog, VL_SHIFT_LEFT(f->width, - o), VL_SHIFT_LEFT(f->height, - o),
+       o, f->keys + i) ;
+  }
+
+  k = f->keys ;
+  for (i = 0 ; i < total ; ++i) {
+    if (good [i]) *k++ = f->keys [i] ;
+  }
+  f->nkeys = k - f->keys ;
+  vl_free (good) ;
+
+  return VL_ERR_OK ;
+}
+
+/** ------------------------------------------------------------------
+ ** @brief Calculate the orientations of keypoints of the whole image
+ **
+ ** @param f       SIFT filter.
+ ** @param angles  orientations, @c 4 per keypoint (output).
+ ** @param nangles number of orientations of each keypoint (output).
+ ** @param keys    keypoints, of any octave.
+ ** @param nkeys   number of keypoints.
+ **
+ ** The function is ::vl_sift_calc_keypoint_orientations() on the scale
+ ** space of ::vl_sift_process_image(), for all the keypoints in
+ ** parallel. The orientations of the keypoint @c i are
+ ** <code>angles[4*i]</code> to <code>angles[4*i+nangles[i]-1]</code>.
+ **
+ ** @return total number of orientations.
+ **/
+
+VL_EXPORT
+int
+vl_sift_calc_image_orientations (VlSiftFilt *f,
+                                 double *angles,
+                                 int *nangles,
+                                 VlSiftKeypoint const *keys,
+                                 int nkeys)
+{
+  int i, total = 0 ;
+
+  if (! f->pyr) {
+    for (i = 0 ; i < nkeys ; ++i) nangles [i] = 0 ;
+    return 0 ;
+  }
+  _vl_sift_update_pyr_gradient (f) ;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic,16) reduction(+:total)
+#endif
+  for (i = 0 ; i < nkeys ; ++i) {
+    int o = keys [i].o ;
+    vl_sift_pix *grad ;
+    nangles [i] = 0 ;
+    if (o < f->o_min || o >= f->o_min + f->O) continue ;
+    _vl_sift_pyr_octave (f, o, NULL, NULL, &grad) ;
+    nangles [i] = _vl_sift_calc_keypoint_orientations
+      (f, grad, VL_SHIFT_LEFT(f->width, - o), VL_SHIFT_LEFT(f->height, - o),
+       o, angles + 4 * i, keys + i) ;
+    total += nangles [i] ;
+  }
+  return total ;
+}
+
+/** ------------------------------------------------------------------
+ ** @brief Compute the descriptors of keypoints of the whole image
+ **
+ ** @param f      SIFT filter.
+ ** @param descrs descriptors, @c 128 per keypoint (output).
+ ** @param keys   keypoints, of any octave.
+ ** @param angles orientation of each keypoint.
+ ** @param n      number of keypoints.
+ **
+ ** The function is ::vl_sift_calc_keypoint_descriptor() on the scale
+ ** space of ::vl_sift_process_image(), for all the keypoints in
+ ** parallel. A keypoint with several orientations is passed once per
+ ** orientation. The descriptor of a keypoint which is not in the
+ ** scale space is left untouched.
+ **/
+
+VL_EXPORT
+void
+vl_sift_calc_image_descriptors (VlSiftFilt *f,
+                                vl_sift_pix *descrs,
+                                VlSiftKeypoint const *keys,
+                                double const *angles,
+                                int n)
+{
+  int i ;
+
+  if (! f->pyr) return ;
+  _vl_sift_update_pyr_gradient (f) ;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic,16)
+#endif
+  for (i = 0 ; i < n ; ++i) {
+    int o = keys [i].o ;
+    vl_sift_pix *grad ;
+    if (o < f->o_min || o >= f->o_min + f->O) continue ;
+    _vl_sift_pyr_octave (f, o, NULL, NULL, &grad) ;
+    _vl_sift_calc_keypoint_descriptor
+      (f, grad, VL_SHIFT_LEFT(f->width, - o), VL_SHIFT_LEFT(f->height, - o),
+       o, descrs + NBO*NBP*NBP * i, keys + i, angles [i]) ;
+  }
+}
+
 /** ------------------------------------------------------------------
  ** @brief Initialize a keypoint from its position and scale
  **
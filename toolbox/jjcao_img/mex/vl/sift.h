@@ -85,6 +85,10 @@ typedef struct _VlSiftFilt
   vl_sift_pix *grad ;   /**< GSS gradient data. */
   int grad_o ;          /**< GSS gradient data octave. */
 
+  vl_sift_pix *pyr ;    /**< GSS, DoG and gradient of all the octaves. */
+  int pyr_res ;         /**< size of the pyramid buffer. */
+  vl_bool pyr_grad ;    /**< whether the pyramid gradient is up to date. */
+
 } VlSiftFilt ;
 
 /** @name Create and destroy
@@ -112,6 +116,24 @@ int   vl_sift_process_next_octave        (VlSiftFilt *f) ;
 VL_EXPORT
 void  vl_sift_detect                     (VlSiftFilt *f) ;
 
+VL_EXPORT
+int   vl_sift_process_image              (VlSiftFilt *f,
+                                          vl_sift_pix const *im) ;
+
+VL_EXPORT
+int   vl_sift_calc_image_orientations    (VlSiftFilt *f,
+                                          double *angles,
+                                          int *nangles,
+                                          VlSiftKeypoint const *keys,
+                                          int nkeys) ;
+
+VL_EXPORT
+void  vl_sift_calc_image_descriptors     (VlSiftFilt *f,
+                                          vl_sift_pix *descrs,
+                                          VlSiftKeypoint const *keys,
+                                          double const *angles,
+                                          int n) ;
+
 VL_EXPORT
 int   vl_sift_calc_keypoint_orientations (VlSiftFilt *f,
                                           double angles [4],
@@ -0,0 +1,122 @@
+/** @internal
+ ** @file     sift_sse2.c
+ ** @brief    SIFT detector - SSE2 - Definition
+ **/
+
+/* AUTORIGHTS
+Copyright (C) 2007-10 Andrea Vedaldi and Brian Fulkerson
+
+This file is part of VLFeat, available under the terms of the
+GNU GPLv2, or (at your option) any later version.
+*/
+
+#if ! defined(VL_DISABLE_SSE2) & ! defined(__SSE2__)
+#error "Compiling with SSE2 enabled, but no __SSE2__ defined"
+#endif
+
+#if ! defined(VL_DISABLE_SSE2)
+
+#include <emmintrin.h>
+#include "sift_sse2.h"
+
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Difference of two Gaussian levels - SSE2
+ **
+ ** @param dog output level.
+ ** @param a   lower level.
+ ** @param b   upper level.
+ ** @param n   number of pixels.
+ **/
+
+VL_EXPORT
+void
+_vl_sift_dog_sse2 (vl_sift_pix *dog,
+                   vl_sift_pix const *a,
+                   vl_sift_pix const *b,
+                   int n)
+{
+  int i = 0 ;
+  for ( ; i + 4 <= n ; i += 4) {
+    _mm_storeu_ps (dog + i, _mm_sub_ps (_mm_loadu_ps (b + i),
+                                        _mm_loadu_ps (a + i))) ;
+  }
+  for ( ; i < n ; ++i) {
+    dog [i] = b [i] - a [i] ;
+  }
+}
+
+/** ------------------------------------------------------------------
+ ** @internal
+ ** @brief Find the local extrema in a row of the DoG - SSE2
+ **
+ ** @param xs   output offsets of the extrema.
+ ** @param pt   first pixel of the row to test.
+ ** @param n    number of pixels to test.
+ ** @param yo   y-stride.
+ ** @param so   s-stride.
+ ** @param tmax smallest value of a maximum, the largest value of a
+ **             minimum is @c -tmax.
+ ** @return number of extrema.
+ **
+ ** Four pixels are compared at once with their 26 neighbors.
+ **/
+
+VL_EXPORT
+int
+_vl_sift_find_extrema_row_sse2 (int *xs,
+                                vl_sift_pix const *pt, int n,
+                                int yo, int so,
+                                vl_sift_pix tmax)
+{
+  /* the 26 neighbors, as (dx,dy,ds) */
+  static int const nb [26][3] = {
+    {+1,0,0}, {-1,0,0}, {0,0,+1}, {0,0,-1}, {0,+1,0}, {0,-1,0},
+    {+1,+1,0}, {-1,+1,0}, {+1,-1,0}, {-1,-1,0},
+    {+1,0,+1}, {-1,0,+1}, {0,+1,+1}, {0,-1,+1},
+    {+1,+1,+1}, {-1,+1,+1}, {+1,-1,+1}, {-1,-1,+1},
+    {+1,0,-1}, {-1,0,-1}, {0,+1,-1}, {0,-1,-1},
+    {+1,+1,-1}, {-1,+1,-1}, {+1,-1,-1}, {-1,-1,-1} } ;
+  int off [26] ;
+  __m128 const thi = _mm_set1_ps (  tmax) ;
+  __m128 const tlo = _mm_set1_ps (- tmax) ;
+  int x = 0, nx = 0, j ;
+
+  for (j = 0 ; j < 26 ; ++j) {
+    off [j] = nb [j][0] + nb [j][1] * yo + nb [j][2] * so ;
+  }
+
+  for ( ; x + 4 <= n ; x += 4) {
+    vl_sift_pix const *p = pt + x ;
+    __m128 v    = _mm_loadu_ps (p) ;
+    __m128 ismax = _mm_cmpge_ps (v, thi) ;
+    __m128 ismin = _mm_cmple_ps (v, tlo) ;
+    int mask ;
+    if (_mm_movemask_ps (_mm_or_ps (ismax, ismin)) == 0) continue ;
+    for (j = 0 ; j < 26 ; ++j) {
+      __m128 q = _mm_loadu_ps (p + off [j]) ;
+      ismax = _mm_and_ps (ismax, _mm_cmpgt_ps (v, q)) ;
+      ismin = _mm_and_ps (ismin, _mm_cmplt_ps (v, q)) ;
+    }
+    mask = _mm_movemask_ps (_mm_or_ps (ismax, ismin)) ;
+    for (j = 0 ; j < 4 ; ++j) {
+      if (mask & (1 << j)) xs [nx++] = x + j ;
+    }
+  }
+
+  for ( ; x < n ; ++x) {
+    vl_sift_pix const *p = pt + x ;
+    vl_sift_pix v = *p ;
+    vl_bool ismax = v >=   tmax ;
+    vl_bool ismin = v <= - tmax ;
+    for (j = 0 ; j < 26 && (ismax || ismin) ; ++j) {
+      ismax = ismax && v > p [off [j]] ;
+      ismin = ismin && v < p [off [j]] ;
+    }
+    if (ismax || ismin) xs [nx++] = x ;
+  }
+  return nx ;
+}
+
+/* ! VL_DISABLE_SSE2 */
+#endif
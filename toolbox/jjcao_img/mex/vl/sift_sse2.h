@@ -0,0 +1,35 @@
+/** @internal
+ ** @file     sift_sse2.h
+ ** @brief    SIFT detector - SSE2
+ **/
+
+/* AUTORIGHTS
+Copyright (C) 2007-10 Andrea Vedaldi and Brian Fulkerson
+
+This file is part of VLFeat, available under the terms of the
+GNU GPLv2, or (at your option) any later version.
+*/
+
+#ifndef VL_SIFT_SSE2_H
+#define VL_SIFT_SSE2_H
+
+#include "sift.h"
+
+#ifndef VL_DISABLE_SSE2
+
+VL_EXPORT
+void _vl_sift_dog_sse2 (vl_sift_pix *dog,
+                        vl_sift_pix const *a,
+                        vl_sift_pix const *b,
+                        int n) ;
+
+VL_EXPORT
+int _vl_sift_find_extrema_row_sse2 (int *xs,
+                                    vl_sift_pix const *pt, int n,
+                                    int yo, int so,
+                                    vl_sift_pix tmax) ;
+
+#endif
+
+/* VL_SIFT_SSE2_H */
+#endif
@@ -14,6 +14,30 @@ GNU GPLv2, or (at your option) any later version.
 #include "vl/mser.h"
 #include "vl/mathop.h"
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+/*
+  Usage:
+
+    [SEEDS, FRAMES, PIXELS] = vl_mser (I, 'OptionName', value, ...)
+
+  I is an UINT8 array of any dimension (a volume is processed as a
+  volume). PIXELS(K) is a cell with the (one based) indexes of the
+  pixels of the region SEEDS(K), listed from the region forest without
+  a second flood fill (vl_erfill). They are in no particular order.
+
+  With the option 'Batch' the last dimension of I indexes a stack of
+  images of the same size (HxWxN for 2-D images, HxWxDxN for volumes;
+  a 2-D I is a single image), processed in parallel (with OpenMP) by one
+  reused MSER filter per thread. SEEDS, FRAMES and PIXELS are then 1xN
+  cell arrays with the results of each image. Both polarities of an
+  image are processed in parallel too.
+*/
 
 enum {
   opt_delta = 0,
@@ -23,6 +47,7 @@ enum {
   opt_min_diversity,
   opt_bright_on_dark,
   opt_dark_on_bright,
+  opt_batch,
   opt_verbose
 } ;
 
@@ -34,10 +59,135 @@ vlmxOption  options [] = {
   {"MinDiversity",        1,   opt_min_diversity  },
   {"BrightOnDark",        1,   opt_bright_on_dark },
   {"DarkOnBright",        1,   opt_dark_on_bright },
+  {"Batch",               0,   opt_batch          },
   {"Verbose",             0,   opt_verbose        },
   {0,                     0,   0                  }
 } ;
 
+/** @brief Results of one image and polarity */
+typedef struct _MserJob
+{
+  int          nregions ;
+  vl_uint     *regions ;
+  int          nframes ;
+  float       *frames ;
+  vl_uint     *fill ;
+  vl_uint     *fill_off ;
+  vl_uint     *fill_area ;
+  VlMserStats  stats ;
+} MserJob ;
+
+/** @internal @brief Copy an array of the filter into the job */
+static void *
+copy_array (void const *src, size_t size)
+{
+  void *dst = vl_malloc (size ? size : 1) ;
+  if (size) memcpy (dst, src, size) ;
+  return dst ;
+}
+
+/** @internal @brief Run the filter and save the results into the job
+ **
+ ** @param filt   MSER filter.
+ ** @param job    job.
+ ** @param data   image.
+ ** @param fit    fit ellipsoids.
+ ** @param fill   list the pixels of the regions.
+ **/
+static void
+process_job (VlMserFilt *filt, MserJob *job,
+             vl_mser_pix const *data, int fit, int fill)
+{
+  int nel ;
+
+  vl_mser_process (filt, data) ;
+
+  job-> nregions = vl_mser_get_regions_num (filt) ;
+  job-> regions  = copy_array (vl_mser_get_regions (filt),
+                               sizeof(vl_uint) * job-> nregions) ;
+  job-> stats    = *vl_mser_get_stats (filt) ;
+
+  if (fit) {
+    vl_mser_ell_fit (filt) ;
+    job-> nframes = vl_mser_get_ell_num (filt) ;
+    job-> frames  = copy_array (vl_mser_get_ell (filt),
+                                sizeof(float) * job-> nframes *
+                                vl_mser_get_ell_dof (filt)) ;
+  }
+
+  if (fill) {
+    vl_mser_fill (filt) ;
+    nel = filt-> nel ;
+    job-> fill      = copy_array (vl_mser_get_fill (filt),
+                                  sizeof(vl_uint) * nel) ;
+    job-> fill_off  = copy_array (vl_mser_get_fill_offsets (filt),
+                                  sizeof(vl_uint) * job-> nregions) ;
+    job-> fill_area = copy_array (vl_mser_get_fill_areas (filt),
+                                  sizeof(vl_uint) * job-> nregions) ;
+  }
+}
+
+/** @internal @brief Convert the results of the polarities of an image
+ **
+ ** @param jobs   the jobs of the image (dark on bright first).
+ ** @param njobs  number of jobs.
+ ** @param sign   sign of the seeds of each job.
+ ** @param ndims  image dimensions.
+ ** @param dof    ellipsoid dof.
+ ** @param out    SEEDS, FRAMES and PIXELS (only the first NOUT are set).
+ ** @param nout   number of outputs.
+ **/
+static void
+save_jobs (MserJob const *jobs, int njobs, int const *sign,
+           int ndims, int dof, mxArray **out, int nout)
+{
+  int      i, j, k, n = 0, m = 0 ;
+  mwSize   odims [2] ;
+  double  *pt ;
+
+  for (k = 0 ; k < njobs ; ++k) n += jobs[k].nregions ;
+
+  odims [0] = n ;
+  out [0]   = mxCreateNumericArray (1, odims, mxDOUBLE_CLASS, mxREAL) ;
+  pt        = mxGetPr (out [0]) ;
+  for (k = 0 ; k < njobs ; ++k) {
+    for (i = 0 ; i < jobs[k].nregions ; ++i) {
+      /* Inverted seed means dark on bright */
+      *pt++ = sign[k] * ((int)jobs[k].regions [i] + 1) ;
+    }
+  }
+
+  if (nout > 1) {
+    for (k = 0 ; k < njobs ; ++k) m += jobs[k].nframes ;
+    odims [0] = dof ;
+    odims [1] = m ;
+    out [1]   = mxCreateNumericArray (2, odims, mxDOUBLE_CLASS, mxREAL) ;
+    pt        = mxGetPr (out [1]) ;
+    for (k = 0 ; k < njobs ; ++k) {
+      for (i = 0 ; i < jobs[k].nframes ; ++i) {
+        for (j = 0 ; j < dof ; ++j) {
+          *pt++ = jobs[k].frames [i * dof + j] + ((j < ndims)?1.0:0.0) ;
+        }
+      }
+    }
+  }
+
+  if (nout > 2) {
+    out [2] = mxCreateCellMatrix (n, 1) ;
+    m = 0 ;
+    for (k = 0 ; k < njobs ; ++k) {
+      for (i = 0 ; i < jobs[k].nregions ; ++i) {
+        vl_uint const *fill = jobs[k].fill + jobs[k].fill_off [i] ;
+        int area = jobs[k].fill_area [i] ;
+        mxArray *members = mxCreateDoubleMatrix (area, 1, mxREAL) ;
+        pt = mxGetPr (members) ;
+        for (j = 0 ; j < area ; ++j) pt [j] = fill [j] + 1 ;
+        mxSetCell (out [2], m++, members) ;
+      }
+    }
+  }
+}
+
 /** @brief MEX entry point */
 void
 mexFunction(int nout, mxArray *out[],
@@ -46,9 +196,11 @@ mexFunction(int nout, mxArray *out[],
   enum {IN_I = 0,
         IN_END } ;
   enum {OUT_SEEDS = 0,
-        OUT_FRAMES } ;
+        OUT_FRAMES,
+        OUT_PIXELS } ;
 
   int             verbose = 0 ;
+  int             batch = 0 ;
   int             opt ;
   int             next = IN_END ;
   mxArray const  *optarg ;
@@ -65,20 +217,18 @@ mexFunction(int nout, mxArray *out[],
   int nel ;
   int ndims ;
   mwSize const* dims ;
+  int nimages = 1 ;
 
   vl_mser_pix const *data ;
-  vl_mser_pix *datainv = 0;
-
-  VlMserFilt        *filt, *filtinv ;
-  vl_uint     const *regions = 0 ;
-  vl_uint     const *regionsinv = 0 ;
-  float       const *frames = 0;
-  float       const *framesinv = 0 ;
-  int nregions = 0, nregionsinv = 0;
-  int nframes = 0, nframesinv = 0;
-  int                i, j, dof = 0 ;
-  mwSize             odims [2] ;
-  double            *pt ;
+  vl_mser_pix      **datainv = 0 ;
+
+  VlMserFilt       **filts = 0 ;
+  MserJob           *jobs = 0 ;
+  int                npol, njobs, nthreads = 1 ;
+  int                sign [2] ;
+  int                polarity [2] ;
+  int                i, k, dof ;
+  VlMserStats        stats ;
 
   VL_USE_MATLAB_ENV ;
 
@@ -90,7 +240,7 @@ mexFunction(int nout, mxArray *out[],
     mexErrMsgTxt("At least one input argument is required.") ;
   }
 
-  if (nout > 2) {
+  if (nout > 3) {
     mexErrMsgTxt("Too many output arguments.");
   }
 
@@ -111,6 +261,10 @@ mexFunction(int nout, mxArray *out[],
       ++ verbose ;
       break ;
 
+    case opt_batch :
+      batch = 1 ;
+      break ;
+
     case opt_delta :
       if (!vlmxIsPlainScalar(optarg) || (delta = *mxGetPr(optarg)) < 0) {
         mexErrMsgTxt("'Delta' must be non-negative.") ;
@@ -169,118 +323,153 @@ mexFunction(int nout, mxArray *out[],
     }
   }
 
+  /* with 'Batch' the last dimension indexes the images */
+  if (batch && ndims > 2) {
+    nimages = dims [ndims-1] ;
+    ndims  -= 1 ;
+    nel     = nimages ? nel / nimages : 0 ;
+  }
+  if (nel == 0 && nimages > 0) {
+    mexErrMsgTxt("I must not be empty.") ;
+  }
+
   /* -----------------------------------------------------------------
    *                                                     Run algorithm
    * -------------------------------------------------------------- */
 
-  /* new filter */
+  npol = 0 ;
+  if (dark_on_bright) { polarity [npol] = 0 ; sign [npol++] = +1 ; }
+  if (bright_on_dark) { polarity [npol] = 1 ; sign [npol++] = -1 ; }
+  njobs = nimages * npol ;
+
+#if defined(_OPENMP)
+  nthreads = VL_MAX (1, VL_MIN (omp_get_max_threads (), njobs)) ;
+#endif
+
+  /*
+     mxMalloc cannot be called from the worker threads, so the filters
+     and the results allocate from the C heap (VLFeat's allocation
+     functions must be set before starting the threads). The results
+     are converted to MATLAB arrays afterwards.
+  */
+  vl_set_alloc_func (malloc, realloc, calloc, free) ;
+
+  /* new filters, one per thread, reused for all the images */
+  filts   = vl_calloc (nthreads, sizeof(VlMserFilt*)) ;
+  datainv = vl_calloc (nthreads, sizeof(vl_mser_pix*)) ;
+  jobs    = vl_calloc (njobs ? njobs : 1, sizeof(MserJob)) ;
   {
-    int * vlDims = mxMalloc(sizeof(int) * ndims) ;
+    int * vlDims = vl_malloc (sizeof(int) * ndims) ;
     for (i = 0 ; i < ndims ; ++i) vlDims [i] = dims [i] ;
-    filt = vl_mser_new (ndims, vlDims) ;
-    filtinv = vl_mser_new (ndims, vlDims) ;
-    mxFree(vlDims) ;
+    for (k = 0 ; k < nthreads ; ++k) {
+      VlMserFilt *filt = vl_mser_new (ndims, vlDims) ;
+      filts [k] = filt ;
+      if (!filt) continue ;
+      if (delta         >= 0) vl_mser_set_delta          (filt, (vl_mser_pix) delta) ;
+      if (max_area      >= 0) vl_mser_set_max_area       (filt, max_area) ;
+      if (min_area      >= 0) vl_mser_set_min_area       (filt, min_area) ;
+      if (max_variation >= 0) vl_mser_set_max_variation  (filt, max_variation) ;
+      if (min_diversity >= 0) vl_mser_set_min_diversity  (filt, min_diversity) ;
+      if (bright_on_dark) datainv [k] = vl_malloc (sizeof(vl_mser_pix) * nel) ;
+    }
+    vl_free (vlDims) ;
   }
-  if (!filt || !filtinv) {
-    mexErrMsgTxt("Could not create an MSER filter.") ;
+  for (k = 0 ; k < nthreads ; ++k) {
+    if (!filts [k]) {
+      for (k = 0 ; k < nthreads ; ++k) {
+        vl_mser_delete (filts [k]) ;
+        if (datainv [k]) vl_free (datainv [k]) ;
+      }
+      vl_free (filts) ; vl_free (datainv) ; vl_free (jobs) ;
+      vl_set_alloc_func (mxMalloc, mxRealloc, mxCalloc, mxFree) ;
+      mexErrMsgTxt("Could not create an MSER filter.") ;
+    }
   }
 
-  if (delta         >= 0) vl_mser_set_delta          (filt, (vl_mser_pix) delta) ;
-  if (max_area      >= 0) vl_mser_set_max_area       (filt, max_area) ;
-  if (min_area      >= 0) vl_mser_set_min_area       (filt, min_area) ;
-  if (max_variation >= 0) vl_mser_set_max_variation  (filt, max_variation) ;
-  if (min_diversity >= 0) vl_mser_set_min_diversity  (filt, min_diversity) ;
-  if (delta         >= 0) vl_mser_set_delta          (filtinv, (vl_mser_pix) delta) ;
-  if (max_area      >= 0) vl_mser_set_max_area       (filtinv, max_area) ;
-  if (min_area      >= 0) vl_mser_set_min_area       (filtinv, min_area) ;
-  if (max_variation >= 0) vl_mser_set_max_variation  (filtinv, max_variation) ;
-  if (min_diversity >= 0) vl_mser_set_min_diversity  (filtinv, min_diversity) ;
-
   if (verbose) {
     mexPrintf("mser: parameters:\n") ;
-    mexPrintf("mser:   delta         = %d\n", vl_mser_get_delta         (filt)) ;
-    mexPrintf("mser:   max_area      = %g\n", vl_mser_get_max_area      (filt)) ;
-    mexPrintf("mser:   min_area      = %g\n", vl_mser_get_min_area      (filt)) ;
-    mexPrintf("mser:   max_variation = %g\n", vl_mser_get_max_variation (filt)) ;
-    mexPrintf("mser:   min_diversity = %g\n", vl_mser_get_min_diversity (filt)) ;
-  }
-
-
-  if (dark_on_bright)
-  {
-    /* process the image */
-    vl_mser_process (filt, data) ;
-
-    /* save regions back to array */
-    nregions         = vl_mser_get_regions_num (filt) ;
-    regions          = vl_mser_get_regions     (filt) ;
-
-    if (nout > 1) {
-      vl_mser_ell_fit (filt) ;
-
-      dof     = vl_mser_get_ell_dof (filt) ;
-      nframes = vl_mser_get_ell_num (filt) ;
-      frames  = vl_mser_get_ell     (filt) ;
+    mexPrintf("mser:   delta         = %d\n", vl_mser_get_delta         (filts[0])) ;
+    mexPrintf("mser:   max_area      = %g\n", vl_mser_get_max_area      (filts[0])) ;
+    mexPrintf("mser:   min_area      = %g\n", vl_mser_get_min_area      (filts[0])) ;
+    mexPrintf("mser:   max_variation = %g\n", vl_mser_get_max_variation (filts[0])) ;
+    mexPrintf("mser:   min_diversity = %g\n", vl_mser_get_min_diversity (filts[0])) ;
+    if (batch) {
+      mexPrintf("mser:   images        = %d\n", nimages) ;
+      mexPrintf("mser:   threads       = %d\n", nthreads) ;
     }
   }
 
-  if (bright_on_dark)
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(nthreads) private(k)
+#endif
   {
-    datainv = mxMalloc(sizeof(vl_uint)*nel) ;
-    for(i=0; i<nel; i++) datainv[i] = ~data[i]; /* 255 - data */
-
-    /* process the image */
-    vl_mser_process (filtinv, datainv) ;
-
-    /* save regions back to array */
-    nregionsinv    = vl_mser_get_regions_num (filtinv) ;
-    regionsinv     = vl_mser_get_regions     (filtinv) ;
-
-    if (nout > 1) {
-      vl_mser_ell_fit (filtinv) ;
-
-      dof        = vl_mser_get_ell_dof (filtinv) ;
-      nframesinv = vl_mser_get_ell_num (filtinv) ;
-      framesinv  = vl_mser_get_ell     (filtinv) ;
+    int t = 0 ;
+#if defined(_OPENMP)
+    t = omp_get_thread_num () ;
+#pragma omp for schedule(dynamic,1)
+#endif
+    for (k = 0 ; k < njobs ; ++k) {
+      vl_mser_pix const *im = data + (size_t) (k / npol) * nel ;
+      if (polarity [k % npol]) {
+        vl_mser_pix *inv = datainv [t] ;
+        int j ;
+        for (j = 0 ; j < nel ; ++j) inv [j] = ~im [j] ; /* 255 - data */
+        im = inv ;
+      }
+      process_job (filts [t], jobs + k, im, nout > 1, nout > 2) ;
     }
   }
 
-  odims [0]        = nregions + nregionsinv ;
-  out [OUT_SEEDS] = mxCreateNumericArray (1, odims, mxDOUBLE_CLASS,mxREAL) ;
-  pt               = mxGetPr (out [OUT_SEEDS]) ;
-
-  for (i = 0 ; i < nregions ; ++i)
-    pt [i] = (int)regions [i] + 1 ;
-
-  for (i = nregions; i < nregions + nregionsinv; ++i)
-    pt [i] = -((int)regionsinv [i-nregions] + 1) ; /* Inverted seed means dark on bright */
-
-  /* optionally compute and save ellipsoids */
-  if (nout > 1) {
+  dof = vl_mser_get_ell_dof (filts[0]) ;
+  for (k = 0 ; k < nthreads ; ++k) {
+    vl_mser_delete (filts [k]) ;
+    if (datainv [k]) vl_free (datainv [k]) ;
+  }
+  vl_free (filts) ;
+  vl_free (datainv) ;
 
-    odims [0] = dof ;
-    odims [1] = nframes + nframesinv;
+  /* back to MATLAB memory for the outputs */
+  vl_set_alloc_func (mxMalloc, mxRealloc, mxCalloc, mxFree) ;
 
-    out [OUT_FRAMES] = mxCreateNumericArray (2, odims, mxDOUBLE_CLASS, mxREAL) ;
-    pt               = mxGetPr (out [OUT_FRAMES]) ;
+  /* -----------------------------------------------------------------
+   *                                                   Save the output
+   * -------------------------------------------------------------- */
 
-    for (i = 0 ; i < nframes ; ++i) {
-      for (j = 0 ; j < dof ; ++j) {
-        pt [i * dof + j] = frames [i * dof + j] + ((j < ndims)?1.0:0.0) ;
-      }
+  if (!batch) {
+    save_jobs (jobs, npol, sign, ndims, dof, out, VL_MAX (nout, 1)) ;
+  } else {
+    mxArray *res [3] ;
+    for (i = 0 ; i < VL_MAX (nout, 1) ; ++i) {
+      out [i] = mxCreateCellMatrix (1, nimages) ;
     }
-
-    for (i = nframes ; i < nframes + nframesinv ; ++i) {
-      for (j = 0 ; j < dof ; ++j) {
-        pt [i * dof + j] = framesinv [(i-nframes) * dof + j] + ((j < ndims)?1.0:0.0) ;
+    for (k = 0 ; k < nimages ; ++k) {
+      save_jobs (jobs + k * npol, npol, sign, ndims, dof, res, VL_MAX (nout, 1)) ;
+      for (i = 0 ; i < VL_MAX (nout, 1) ; ++i) {
+        mxSetCell (out [i], k, res [i]) ;
       }
     }
   }
 
+  memset (&stats, 0, sizeof(stats)) ;
+  for (k = 0 ; k < njobs ; ++k) {
+    stats.num_extremal     += jobs[k].stats.num_extremal ;
+    stats.num_unstable     += jobs[k].stats.num_unstable ;
+    stats.num_abs_unstable += jobs[k].stats.num_abs_unstable ;
+    stats.num_too_big      += jobs[k].stats.num_too_big ;
+    stats.num_too_small    += jobs[k].stats.num_too_small ;
+    stats.num_duplicates   += jobs[k].stats.num_duplicates ;
+    /* allocated from the C heap */
+    free (jobs[k].regions) ;
+    free (jobs[k].frames) ;
+    free (jobs[k].fill) ;
+    free (jobs[k].fill_off) ;
+    free (jobs[k].fill_area) ;
+  }
+  free (jobs) ;
+
   if (verbose) {
-    VlMserStats const* s = vl_mser_get_stats (filt) ;
-    VlMserStats const* sinv = vl_mser_get_stats (filtinv) ;
-    int tot = s-> num_extremal + sinv-> num_extremal ;
+    VlMserStats const* s = &stats ;
+    int tot = s-> num_extremal ;
 
     mexPrintf("mser: statistics:\n") ;
     mexPrintf("mser: %d extremal regions of which\n", tot) ;
@@ -290,16 +479,11 @@ mexFunction(int nout, mxArray *out[],
               tot-(num),100.0*(double)(tot-(num))/(tot+VL_EPSILON_D)) ; \
     tot -= (num) ;
 
-    REMAIN("maximally stable,", s-> num_unstable + sinv-> num_unstable ) ;
-    REMAIN("stable enough,",    s-> num_abs_unstable  + sinv-> num_abs_unstable ) ;
-    REMAIN("small enough,",     s-> num_too_big  + sinv->num_too_big ) ;
-    REMAIN("big enough,",       s-> num_too_small + sinv->num_too_small  ) ;
-    REMAIN("diverse enough.",   s-> num_duplicates + sinv->num_duplicates ) ;
+    REMAIN("maximally stable,", s-> num_unstable ) ;
+    REMAIN("stable enough,",    s-> num_abs_unstable ) ;
+    REMAIN("small enough,",     s-> num_too_big ) ;
+    REMAIN("big enough,",       s-> num_too_small ) ;
+    REMAIN("diverse enough.",   s-> num_duplicates ) ;
 
   }
-
-  /* cleanup */
-  if (datainv) mxFree(datainv);
-  vl_mser_delete (filt) ;
-  vl_mser_delete (filtinv) ;
 }
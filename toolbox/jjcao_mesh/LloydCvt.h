@@ -0,0 +1,450 @@
+/*=================================================================
+*
+* Lloyd relaxation towards a centroidal Voronoi tessellation (CVT), with a
+* density, for perform_lloyd_iteration_fast.cpp and perform_lloyd_mesh.cpp.
+*
+* GridCvt: sites in [0,1]^2 or [0,1]^3, the density is sampled on a grid
+*	whose nodes are at linspace(0,1,N) in each dimension, as
+*	perform_lloyd_iteration.m. The Voronoi cells are rasterized on the grid
+*	by jump flooding (Rong & Tan, "Jump flooding in GPU with applications to
+*	Voronoi diagram and distance transform", I3D 2006), steps N/2, ..., 1
+*	and two more passes of steps 2 and 1.
+*
+* MeshCvt: sites are vertices of a mesh, the geodesic Voronoi cells are
+*	given by the caller (perform_fast_marching_mesh in perform_lloyd_mesh),
+*	a site moves to the vertex of its cell nearest to the centroid of the
+*	cell weighted by vertex area * density.
+*
+*	Coincident sites are separated: on the grid by a jitter of one grid
+*	step, on the mesh by moving the site to the farthest free vertex.
+*
+*	The weighted sums of the cells are accumulated per thread, then merged
+*	in parallel over the sites.
+*
+*   GridCvt cvt(2, N, density);
+*   for (int it = 0; it < niter && cvt.step(X, n) > tol; ++it);
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#ifndef LLOYD_CVT_H
+#define LLOYD_CVT_H
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// weighted sums (w*x, w) of nsites cells, one copy per thread
+class CvtAccumulator
+{
+public:
+	void reset(int nsites, int dim)
+	{
+		n_ = nsites; stride_ = dim + 1;
+		int nthreads = 1;
+#ifdef _OPENMP
+		nthreads = omp_get_max_threads();
+#endif
+		sums_.assign((size_t)nthreads*n_*stride_, 0);
+	}
+	// the copy of the calling thread
+	double* local()
+	{
+		int t = 0;
+#ifdef _OPENMP
+		t = omp_get_thread_num();
+#endif
+		return &sums_[(size_t)t*n_*stride_];
+	}
+	void add(double* local, int site, const double* x, double w) const
+	{
+		double* s = local + (size_t)site*stride_;
+		for (int k = 0; k < stride_-1; ++k)
+			s[k] += w*x[k];
+		s[stride_-1] += w;
+	}
+	// sums of all the threads, in the first copy
+	const double* merge()
+	{
+		int nthreads = int(sums_.size()/((size_t)n_*stride_));
+		size_t len = (size_t)n_*stride_;
+		#pragma omp parallel for schedule(static)
+		for (int s = 0; s < n_; ++s)
+			for (int t = 1; t < nthreads; ++t)
+				for (int k = 0; k < stride_; ++k)
+					sums_[(size_t)s*stride_+k] += sums_[t*len + (size_t)s*stride_ + k];
+		return &sums_[0];
+	}
+private:
+	int n_, stride_;
+	std::vector<double> sums_;
+};
+
+class GridCvt
+{
+public:
+	// N: number of nodes in each dimension, density: N[0]*N[1](*N[2]) in
+	// Matlab order, NULL for a uniform density
+	GridCvt(int dim, const int* N, const double* density)
+		: dim_(dim), density_(density)
+	{
+		ncells_ = 1;
+		for (int k = 0; k < 3; ++k)
+		{
+			N_[k] = k < dim ? std::max(N[k], 1) : 1;
+			h_[k] = N_[k] > 1 ? 1.0/(N_[k]-1) : 0;
+			ncells_ *= N_[k];
+		}
+		label_.resize(ncells_);
+		buffer_.resize(ncells_);
+		random_ = 1;
+	}
+
+	// one Lloyd step: label the grid, then move the sites X (dim*n) to the
+	// centroids of their cells, clamped to [0,1]. Return the largest move.
+	double step(double* X, int n)
+	{
+		double moved = separate(X, n);
+		jump_flood(X, n);
+		acc_.reset(n, dim_);
+		#pragma omp parallel
+		{
+			double* local = acc_.local();
+			double p[3];
+			#pragma omp for schedule(static)
+			for (int c = 0; c < ncells_; ++c)
+			{
+				if (label_[c] < 0) continue;
+				double w = density_ ? density_[c] : 1;
+				if (w <= 0) continue;
+				node(c, p);
+				acc_.add(local, label_[c], p, w);
+			}
+		}
+		const double* sums = acc_.merge();
+		for (int s = 0; s < n; ++s)
+		{
+			const double* sum = sums + (size_t)s*(dim_+1);
+			if (sum[dim_] <= 0) continue;// empty cell, the site stays
+			double d2(0);
+			for (int k = 0; k < dim_; ++k)
+			{
+				double x = std::min(1.0, std::max(0.0, sum[k]/sum[dim_]));
+				d2 += (x - X[dim_*s+k])*(x - X[dim_*s+k]);
+				X[dim_*s+k] = x;
+			}
+			moved = std::max(moved, std::sqrt(d2));
+		}
+		return moved;
+	}
+	// A site at the same position as a site of smaller index has an empty
+	// cell and would never leave it: move it by up to one grid step in a
+	// pseudo random direction. Return the largest move.
+	double separate(double* X, int n)
+	{
+		std::vector<int> order(n);
+		for (int s = 0; s < n; ++s)
+			order[s] = s;
+		std::sort(order.begin(), order.end(), SiteLess(X, dim_));
+		std::vector<int> dup;
+		for (int r = 1; r < n; ++r)
+			if (!SiteLess(X, dim_)(order[r-1], order[r]))
+				dup.push_back(order[r]);
+		double moved(0);
+		for (size_t r = 0; r < dup.size(); ++r)
+		{
+			double d2(0);
+			for (int k = 0; k < dim_; ++k)
+			{
+				double& x = X[dim_*dup[r]+k];
+				double x0 = x;
+				x = std::min(1.0, std::max(0.0, x + (2*uniform()-1)*h_[k]));
+				d2 += (x-x0)*(x-x0);
+			}
+			moved = std::max(moved, std::sqrt(d2));
+		}
+		return moved;
+	}
+	// site of each grid node, -1 for none
+	const std::vector<int>& labels() const {return label_;}
+
+	// label each node with its nearest site (approximately, by jump flooding)
+	void jump_flood(const double* X, int n)
+	{
+		std::fill(label_.begin(), label_.end(), -1);
+		std::vector<int> seed(n);
+		for (int s = 0; s < n; ++s)
+		{
+			int idx[3] = {0, 0, 0};
+			for (int k = 0; k < dim_; ++k)
+				idx[k] = std::min(N_[k]-1, std::max(0, (int)floor(X[dim_*s+k]*(N_[k]-1) + 0.5)));
+			int c = seed[s] = idx[0] + N_[0]*(idx[1] + N_[1]*idx[2]);
+			double p[3];
+			node(c, p);
+			if (label_[c] < 0 || dist2(p, X, label_[c]) > dist2(p, X, s))
+				label_[c] = s;
+		}
+		int nmax = std::max(N_[0], std::max(N_[1], N_[2]));
+		std::vector<int> steps;
+		for (int k = 1; k < nmax; k *= 2)
+			steps.insert(steps.begin(), k);
+		steps.push_back(2);
+		steps.push_back(1);
+		for (size_t i = 0; i < steps.size(); ++i)
+		{
+			pass(X, steps[i]);
+			label_.swap(buffer_);
+		}
+		// a site sharing its node with a nearer one was never seeded: grow its
+		// (convex) cell from the nodes around its own
+		for (int s = 0; s < n; ++s)
+			if (label_[seed[s]] != s)
+				grow(X, s, seed[s]);
+	}
+
+private:
+	// lexicographic order of the sites
+	struct SiteLess
+	{
+		SiteLess(const double* X, int dim) : X(X), dim(dim) {}
+		bool operator()(int a, int b) const
+		{
+			return std::lexicographical_compare(X+dim*a, X+dim*(a+1), X+dim*b, X+dim*(b+1));
+		}
+		const double* X;
+		int dim;
+	};
+	// in [0,1), the same sequence for every run
+	double uniform()
+	{
+		random_ = random_*1103515245u + 12345u;
+		return ((random_ >> 8) & 0xffffff)/16777216.0;
+	}
+	void node(int c, double* p) const
+	{
+		int i = c % N_[0], j = (c / N_[0]) % N_[1], l = c / (N_[0]*N_[1]);
+		p[0] = i*h_[0]; p[1] = j*h_[1]; p[2] = l*h_[2];
+	}
+	double dist2(const double* p, const double* X, int s) const
+	{
+		double d(0);
+		for (int k = 0; k < dim_; ++k)
+			d += (p[k] - X[dim_*s+k])*(p[k] - X[dim_*s+k]);
+		return d;
+	}
+	bool closer(const double* X, int s, int c) const
+	{
+		if (label_[c] == s) return false;
+		if (label_[c] < 0) return true;
+		double p[3];
+		node(c, p);
+		return dist2(p, X, s) < dist2(p, X, label_[c]);
+	}
+	void grow(const double* X, int s, int c0)
+	{
+		std::vector<int> stack;
+		int i0 = c0 % N_[0], j0 = (c0 / N_[0]) % N_[1], l0 = c0 / (N_[0]*N_[1]);
+		int rz = dim_ == 3 ? 1 : 0;
+		for (int dz = -rz; dz <= rz; ++dz)
+			for (int dy = -1; dy <= 1; ++dy)
+				for (int dx = -1; dx <= 1; ++dx)
+				{
+					int i = i0+dx, j = j0+dy, l = l0+dz;
+					if (i < 0 || i >= N_[0] || j < 0 || j >= N_[1] || l < 0 || l >= N_[2]) continue;
+					int c = i + N_[0]*(j + N_[1]*l);
+					if (closer(X, s, c)) {label_[c] = s; stack.push_back(c);}
+				}
+		while (!stack.empty())
+		{
+			int c = stack.back();
+			stack.pop_back();
+			int idx[3] = {c % N_[0], (c / N_[0]) % N_[1], c / (N_[0]*N_[1])};
+			for (int k = 0; k < dim_; ++k)
+				for (int d = -1; d <= 1; d += 2)
+				{
+					int q[3] = {idx[0], idx[1], idx[2]};
+					q[k] += d;
+					if (q[k] < 0 || q[k] >= N_[k]) continue;
+					int cq = q[0] + N_[0]*(q[1] + N_[1]*q[2]);
+					if (closer(X, s, cq)) {label_[cq] = s; stack.push_back(cq);}
+				}
+		}
+	}
+	// one jump flooding pass of step k, from label_ to buffer_
+	void pass(const double* X, int k)
+	{
+		int rz = dim_ == 3 ? 1 : 0;
+		#pragma omp parallel for schedule(static)
+		for (int c = 0; c < ncells_; ++c)
+		{
+			int i = c % N_[0], j = (c / N_[0]) % N_[1], l = c / (N_[0]*N_[1]);
+			double p[3];
+			node(c, p);
+			int best = label_[c];
+			double bd = best >= 0 ? dist2(p, X, best) : std::numeric_limits<double>::max();
+			for (int dz = -rz; dz <= rz; ++dz)
+			{
+				int ll = l + dz*k;
+				if (ll < 0 || ll >= N_[2]) continue;
+				for (int dy = -1; dy <= 1; ++dy)
+				{
+					int jj = j + dy*k;
+					if (jj < 0 || jj >= N_[1]) continue;
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						int ii = i + dx*k;
+						if (ii < 0 || ii >= N_[0]) continue;
+						int s = label_[ii + N_[0]*(jj + N_[1]*ll)];
+						if (s < 0 || s == best) continue;
+						double d = dist2(p, X, s);
+						if (d < bd || (d == bd && s < best))
+						{
+							bd = d;
+							best = s;
+						}
+					}
+				}
+			}
+			buffer_[c] = best;
+		}
+	}
+
+	int dim_, N_[3], ncells_;
+	double h_[3];
+	const double* density_;
+	std::vector<int> label_, buffer_;
+	unsigned int random_;
+	CvtAccumulator acc_;
+};
+
+class MeshCvt
+{
+public:
+	// verts: 3*nverts, faces: 0 based, density: nverts or NULL
+	MeshCvt(const double* verts, int nverts, const std::vector<int>& faces, const double* density)
+		: verts_(verts), nverts_(nverts)
+	{
+		int nfaces = (int)faces.size()/3;
+		mass_.assign(nverts, 0);
+		for (int f = 0; f < nfaces; ++f)
+		{
+			const int* v = &faces[3*f];
+			double u[3], w[3];
+			for (int k = 0; k < 3; ++k)
+			{
+				u[k] = verts[3*v[1]+k] - verts[3*v[0]+k];
+				w[k] = verts[3*v[2]+k] - verts[3*v[0]+k];
+			}
+			double cx = u[1]*w[2]-u[2]*w[1], cy = u[2]*w[0]-u[0]*w[2], cz = u[0]*w[1]-u[1]*w[0];
+			double area = 0.5*std::sqrt(cx*cx + cy*cy + cz*cz);
+			for (int k = 0; k < 3; ++k)
+				mass_[v[k]] += area/3;
+		}
+		if (density)
+			for (int i = 0; i < nverts; ++i)
+				mass_[i] *= density[i];
+	}
+
+	// one Lloyd step on the sites (vertex indices), given the geodesic Voronoi
+	// cells of the sites: label[i] the site of vertex i (-1 if not reached)
+	// and dist[i] its distance to the site. A site with an empty cell (it
+	// shares its vertex with another one) is moved to the farthest vertex not
+	// yet taken. Return the number of sites moved.
+	int step(std::vector<int>& sites, const std::vector<int>& label, const std::vector<double>& dist)
+	{
+		int n = (int)sites.size();
+		acc_.reset(n, 3);
+		#pragma omp parallel
+		{
+			double* local = acc_.local();
+			#pragma omp for schedule(static)
+			for (int i = 0; i < nverts_; ++i)
+				if (label[i] >= 0 && mass_[i] > 0)
+					acc_.add(local, label[i], verts_ + 3*i, mass_[i]);
+		}
+		const double* sums = acc_.merge();
+		std::vector<double> centroid(3*n);
+		for (int s = 0; s < n; ++s)
+		{
+			const double* sum = sums + 4*(size_t)s;
+			for (int k = 0; k < 3; ++k)
+				centroid[3*s+k] = sum[3] > 0 ? sum[k]/sum[3] : verts_[3*sites[s]+k];
+		}
+
+		// vertex of each cell nearest to its centroid, per thread then merged
+		int nthreads = 1;
+#ifdef _OPENMP
+		nthreads = omp_get_max_threads();
+#endif
+		std::vector<std::pair<double,int> > best((size_t)nthreads*n, std::make_pair(std::numeric_limits<double>::max(), -1));
+		#pragma omp parallel
+		{
+			int t = 0;
+#ifdef _OPENMP
+			t = omp_get_thread_num();
+#endif
+			std::pair<double,int>* local = &best[(size_t)t*n];
+			#pragma omp for schedule(static)
+			for (int i = 0; i < nverts_; ++i)
+			{
+				int s = label[i];
+				if (s < 0) continue;
+				const double *p = verts_ + 3*i, *c = &centroid[3*s];
+				std::pair<double,int> d((p[0]-c[0])*(p[0]-c[0]) + (p[1]-c[1])*(p[1]-c[1]) + (p[2]-c[2])*(p[2]-c[2]), i);
+				if (d < local[s]) local[s] = d;
+			}
+		}
+		int moved(0);
+		std::vector<int> empty;
+		for (int s = 0; s < n; ++s)
+		{
+			std::pair<double,int> b = best[s];
+			for (int t = 1; t < nthreads; ++t)
+				b = std::min(b, best[(size_t)t*n+s]);
+			if (b.second < 0)
+				empty.push_back(s);
+			else if (b.second != sites[s])
+			{
+				sites[s] = b.second;
+				++moved;
+			}
+		}
+		if (!empty.empty())
+			moved += reseed(sites, empty, label, dist);
+		return moved;
+	}
+
+private:
+	// move the sites `empty` to the reached vertices farthest from the sites,
+	// skipping the vertices already holding a site
+	int reseed(std::vector<int>& sites, const std::vector<int>& empty,
+			   const std::vector<int>& label, const std::vector<double>& dist)
+	{
+		std::vector<char> taken(nverts_, 0);
+		for (size_t s = 0; s < sites.size(); ++s)
+			taken[sites[s]] = 1;
+		std::vector<std::pair<double,int> > far;
+		for (int i = 0; i < nverts_; ++i)
+			if (label[i] >= 0 && !taken[i])
+				far.push_back(std::make_pair(dist[i], i));
+		size_t m = std::min(far.size(), empty.size());
+		std::partial_sort(far.begin(), far.begin()+m, far.end(), std::greater<std::pair<double,int> >());
+		for (size_t r = 0; r < m; ++r)
+			sites[empty[r]] = far[r].second;
+		return (int)m;
+	}
+
+	const double* verts_;
+	int nverts_;
+	std::vector<double> mass_;
+	CvtAccumulator acc_;
+};
+
+#endif // LLOYD_CVT_H
@@ -166,6 +166,16 @@ if strcmp(lower(options.display),'iter') | strcmp(lower(options.display),'cycle'
 end
 
 
+% native solver, see perform_smacof.cpp
+if exist('perform_smacof','file') == 3 && ~XHISTORY,
+    if HISTORY,
+        [X,hist] = perform_smacof(D,options.X0,options);
+    else
+        X = perform_smacof(D,options.X0,options);
+    end
+    return;
+end
+
 % start optimization
 switch lower(options.method),
    case 'rre'      % vector extrapolation using RRE
@@ -0,0 +1,685 @@
+/*=================================================================
+*
+* Least-squares multidimensional scaling by SMACOF, native version of
+* smacof.m, smacof_rre.m and smacof_mg.m
+*
+* usage:
+		[X, hist] = perform_smacof(D, X0, options);
+* inputs:
+		D: N*N symmetric matrix of distances, double or single. A single matrix
+		   is used as is, the n^2 distances are never converted to double.
+		   In landmark mode D is N*L, the distances from all the points to the landmarks.
+		X0: N*dim initialization
+		options.method: 'smacof' | 'rre' | 'mg', default 'rre' as mds.m
+		options.iter: number of SMACOF iterations / internal iterations, default 50 | 10 | 3
+		options.cycles: number of RRE or MG cycles, default 5 | 3
+		options.rtol: relative stress change tolerance, default 0.01
+		options.atol: absolute stress tolerance, default 0
+		options.IND, options.UPMTX, options.DOWNMTX, options.lambda: grid hierarchy of
+		   the MG method, see mds.m
+		options.landmarks: 1*L indices of the columns of D. When set, only the
+		   stress between every point and the landmarks is minimized
+		   (sparse stress), the Guttman transform then needs the pseudo inverse of
+		   the weight Laplacian V, it is applied by a few Jacobi-preconditioned CG steps.
+		options.display: 'iter' | 'cycle' | 'off', default 'off'
+* outputs:
+		X: N*dim configuration
+		hist.s: stress per iteration (SMACOF, RRE) or per cycle (MG), starting with X0
+*
+*	B(X)X is computed by tiles of rows and columns of D, the rows in parallel, and
+*	gives the stress of X in the same pass.
+*
+* JJCAO, 2013
+*
+*=================================================================*/
+
+#include <mex.h>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+#define ROW_BLOCK 64
+#define COL_BLOCK 512
+#define CG_MAX_ITER 30
+
+/// sparse or dense interpolation/decimation matrix of the MG hierarchy
+struct GridMatrix
+{
+	int rows, cols;
+	const double* pr;
+	const mwIndex* ir;
+	const mwIndex* jc;
+	GridMatrix(const mxArray* a)
+	{
+		rows = (int)mxGetM(a);
+		cols = (int)mxGetN(a);
+		pr = mxGetPr(a);
+		ir = mxIsSparse(a) ? mxGetIr(a) : 0;
+		jc = mxIsSparse(a) ? mxGetJc(a) : 0;
+	}
+	/// y = A*x, x and y are row major with dim columns
+	void multiply(const vector<double>& x, vector<double>& y, int dim) const
+	{
+		y.assign(rows*dim, 0);
+		for (int c = 0; c < cols; ++c)
+		{
+			if (jc)
+			{
+				for (mwIndex p = jc[c]; p < jc[c+1]; ++p)
+					for (int d = 0; d < dim; ++d)
+						y[ir[p]*dim+d] += pr[p]*x[c*dim+d];
+			}
+			else
+			{
+				for (int r = 0; r < rows; ++r)
+					for (int d = 0; d < dim; ++d)
+						y[r*dim+d] += pr[r+rows*c]*x[c*dim+d];
+			}
+		}
+	}
+};
+
+template<class Real>
+class Smacof
+{
+public:
+	Smacof(const Real* D, int N, int ncols, int dim)
+		: D_(D), N_(N), ncols_(ncols), dim_(dim), verbose_(0)
+	{}
+
+	void set_landmarks(const vector<int>& landmarks)
+	{ landmarks_ = landmarks; }
+	void set_verbose(int verbose)
+	{ verbose_ = verbose; }
+
+	/// (B(X)X)_i = sum_j d_ij/|x_i-x_j| (x_i-x_j) on the sub matrix D(ind,ind), return the stress of X.
+	double guttman_product(const vector<int>* ind, const vector<double>& X, vector<double>& BX) const
+	{
+		int n = ind ? (int)ind->size() : N_;
+		int dim = dim_;
+		BX.assign(n*dim, 0);
+		int nblocks = (n+ROW_BLOCK-1)/ROW_BLOCK;
+		double stress = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:stress)
+		for (int b = 0; b < nblocks; ++b)
+		{
+			int i0 = b*ROW_BLOCK, i1 = min(n, i0+ROW_BLOCK);
+			for (int j0 = 0; j0 < n; j0 += COL_BLOCK)
+			{
+				int j1 = min(n, j0+COL_BLOCK);
+				for (int i = i0; i < i1; ++i)
+				{
+					// D is symmetric, so row i is read along the contiguous column i
+					const Real* Di = D_ + (size_t)N_*(ind ? (*ind)[i] : i);
+					const double* xi = &X[i*dim];
+					double* bxi = &BX[i*dim];
+					for (int j = j0; j < j1; ++j)
+					{
+						if (j == i) continue;
+						const double* xj = &X[j*dim];
+						double dx = 0;
+						for (int d = 0; d < dim; ++d)
+							dx += (xi[d]-xj[d])*(xi[d]-xj[d]);
+						dx = sqrt(dx);
+						double dij = (double)Di[ind ? (*ind)[j] : j];
+						stress += (dij-dx)*(dij-dx);
+						if (dx != 0)
+						{
+							double c = dij/dx;
+							for (int d = 0; d < dim; ++d)
+								bxi[d] += c*(xi[d]-xj[d]);
+						}
+					}
+				}
+			}
+		}
+		return 0.5*stress;
+	}
+
+	/// landmark version, the weight is one for each pair (i, landmark l), i!=l. BX = B(X)X
+	double landmark_product(const vector<double>& X, vector<double>& BX) const
+	{
+		int L = (int)landmarks_.size();
+		int dim = dim_;
+		BX.assign(N_*dim, 0);
+		double stress = 0;
+#pragma omp parallel for schedule(static) reduction(+:stress)
+		for (int i = 0; i < N_; ++i)
+		{
+			const double* xi = &X[i*dim];
+			double* bxi = &BX[i*dim];
+			for (int l = 0; l < L; ++l)
+			{
+				int j = landmarks_[l];
+				if (j == i) continue;
+				const double* xj = &X[j*dim];
+				double dx = 0;
+				for (int d = 0; d < dim; ++d)
+					dx += (xi[d]-xj[d])*(xi[d]-xj[d]);
+				dx = sqrt(dx);
+				double dij = (double)D_[i+(size_t)N_*l];
+				stress += (dij-dx)*(dij-dx);
+				double c = dx != 0 ? dij/dx : 0;
+				for (int d = 0; d < dim; ++d)
+					bxi[d] += c*(xi[d]-xj[d]);
+			}
+		}
+		// the symmetric terms, gathered per landmark (landmarks are distinct)
+#pragma omp parallel for schedule(static)
+		for (int l = 0; l < L; ++l)
+		{
+			int j = landmarks_[l];
+			const double* xj = &X[j*dim];
+			vector<double> acc(dim, 0);
+			for (int i = 0; i < N_; ++i)
+			{
+				if (i == j) continue;
+				const double* xi = &X[i*dim];
+				double dx = 0;
+				for (int d = 0; d < dim; ++d)
+					dx += (xi[d]-xj[d])*(xi[d]-xj[d]);
+				dx = sqrt(dx);
+				double dij = (double)D_[i+(size_t)N_*l];
+				double c = dx != 0 ? dij/dx : 0;
+				for (int d = 0; d < dim; ++d)
+					acc[d] += c*(xj[d]-xi[d]);
+			}
+			for (int d = 0; d < dim; ++d)
+				BX[j*dim+d] += acc[d];
+		}
+		return stress;
+	}
+
+	/// one Guttman transform of X, return the stress of the input X
+	double guttman_transform(vector<double>& X) const
+	{
+		vector<double> BX;
+		if (landmarks_.empty())
+		{
+			double stress = guttman_product(0, X, BX);
+			for (size_t k = 0; k < X.size(); ++k)
+				X[k] = BX[k]/N_;
+			return stress;
+		}
+		double stress = landmark_product(X, BX);
+		solve_V(BX, X);
+		return stress;
+	}
+
+	double stress(const vector<double>& X) const
+	{
+		vector<double> BX;
+		if (landmarks_.empty())
+			return guttman_product(0, X, BX);
+		return landmark_product(X, BX);
+	}
+
+	/// plain SMACOF, as smacof.m
+	void run_smacof(vector<double>& X, int iter, double rtol, double atol, vector<double>& hist) const
+	{
+		for (int it = 0; it <= iter; ++it)
+		{
+			vector<double> Xn(X);
+			double S = guttman_transform(Xn);
+			hist.push_back(S);
+			if (verbose_)
+				mexPrintf("%4d   %12.3g\n", it, S);
+			if (it == iter || S < atol)
+				break;
+			if (it > 0 && hist[it-1]/S-1 < rtol)
+				break;
+			X.swap(Xn);
+		}
+	}
+
+	/// SMACOF with reduced rank extrapolation, as smacof_rre.m
+	void run_rre(vector<double>& X, int cycles, int iter, double rtol, double atol, vector<double>& hist) const
+	{
+		double S = stress(X);
+		hist.push_back(S);
+		vector<double> cycle_start(1, S);
+		for (int cycle = 0; cycle < cycles; ++cycle)
+		{
+			vector< vector<double> > XX;
+			for (int it = 0; it < iter; ++it)
+			{
+				// the stress of an iterate comes with the next transform
+				double Sin = guttman_transform(X);
+				XX.push_back(X);
+				if (it == 0)
+					continue;
+				hist.push_back(Sin);
+				if (Sin < atol)
+					return;
+			}
+			S = stress(X);
+			hist.push_back(S);
+			vector<double> X_;
+			if (extrapolate(XX, X_))
+			{
+				double S_ = stress(X_);
+				if (verbose_)
+					mexPrintf("Extrap. stress: %12.3g, SMACOF stress: %12.3g\n", S_, S);
+				if (S_ <= S)
+				{
+					X.swap(X_);
+					S = S_;
+				}
+			}
+			if (verbose_)
+				mexPrintf("%4d   %12.3g\n", cycle+1, S);
+			if (cycle > 0 && cycle_start.back()/S-1 < rtol)
+				return;
+			cycle_start.push_back(S);
+		}
+	}
+
+	/// multigrid V-cycles, as smacof_mg.m
+	void run_mg(vector<double>& X, int cycles, int iter, double rtol, double atol, double lambda,
+				const vector< vector<int> >& IND, const vector<GridMatrix>& UP, const vector<GridMatrix>& DOWN,
+				vector<double>& hist) const
+	{
+		vector<double> T(X.size(), 0);
+		vector<double> G;
+		hist.push_back( mg_gradient(&IND[0], X, T, lambda, G, true) );
+		for (int cycle = 0; cycle < cycles; ++cycle)
+		{
+			vcycle(0, X, T, lambda, iter, IND, UP, DOWN);
+			vector<double> Z(X.size(), 0);
+			double S = mg_gradient(&IND[0], X, Z, 0, G, true);
+			hist.push_back(S);
+			if (verbose_)
+				mexPrintf("%4d   %12.3g\n", cycle+1, S);
+			if (S < atol)
+				return;
+			double Sprev = hist[hist.size()-2];
+			if (cycle > 0 && Sprev > S && Sprev/S-1 < rtol)
+				return;
+		}
+	}
+
+private:
+	/// gradient of the modified stress of smacof_mg.m, return the stress if asked
+	double mg_gradient(const vector<int>* ind, const vector<double>& X, const vector<double>& T, double lambda,
+						vector<double>& dF, bool bStress) const
+	{
+		int n = (int)ind->size();
+		int dim = dim_;
+		vector<double> BX;
+		double S = guttman_product(ind, X, BX);
+		vector<double> sum(dim, 0);
+		for (int i = 0; i < n; ++i)
+			for (int d = 0; d < dim; ++d)
+				sum[d] += X[i*dim+d];
+		dF.resize(n*dim);
+		for (int i = 0; i < n; ++i)
+			for (int d = 0; d < dim; ++d)
+				dF[i*dim+d] = 2*( (n*X[i*dim+d] - sum[d]) - BX[i*dim+d] ) - T[i*dim+d] + 2*lambda*sum[d];
+		if (!bStress)
+			return 0;
+		for (size_t k = 0; k < X.size(); ++k)
+			S -= X[k]*T[k];
+		for (int d = 0; d < dim; ++d)
+			S += lambda*sum[d]*sum[d];
+		return S;
+	}
+
+	void mg_relax(const vector<int>* ind, vector<double>& X, const vector<double>& T, double lambda, int niter) const
+	{
+		int n = (int)ind->size();
+		vector<double> dF;
+		for (int k = 0; k < niter; ++k)
+		{
+			mg_gradient(ind, X, T, lambda, dF, false);
+			for (size_t s = 0; s < X.size(); ++s)
+				X[s] -= 0.5*dF[s]/n;
+		}
+	}
+
+	void vcycle(int level, vector<double>& X, const vector<double>& T, double lambda, int iter,
+				const vector< vector<int> >& IND, const vector<GridMatrix>& UP, const vector<GridMatrix>& DOWN) const
+	{
+		const vector<int>* ind = &IND[level];
+		const vector<int>* ind2 = &IND[level+1];
+		mg_relax(ind, X, T, lambda, iter);
+		vector<double> G, GG, XX, TT, DG;
+		mg_gradient(ind, X, T, lambda, G, false);
+		DOWN[level].multiply(X, XX, dim_);
+		DOWN[level].multiply(T, TT, dim_);
+		mg_gradient(ind2, XX, TT, lambda, GG, false);
+		DOWN[level].multiply(G, DG, dim_);
+		vector<double> RR(GG.size());
+		for (size_t k = 0; k < GG.size(); ++k)
+			RR[k] = GG[k]-DG[k];
+		vector<double> XX_(XX);
+		if (level+2 >= (int)IND.size())
+			mg_relax(ind2, XX, RR, lambda, iter);
+		else
+			vcycle(level+1, XX, RR, lambda, iter, IND, UP, DOWN);
+		for (size_t k = 0; k < XX.size(); ++k)
+			XX[k] -= XX_[k];
+		vector<double> E;
+		UP[level].multiply(XX, E, dim_);
+		for (size_t k = 0; k < X.size(); ++k)
+			X[k] += E[k];
+		mg_relax(ind, X, T, lambda, iter);
+	}
+
+	/// reduced rank extrapolation of the iterates, as extrap.m
+	bool extrapolate(const vector< vector<double> >& XX, vector<double>& X_) const
+	{
+		int K = (int)XX.size()-1;
+		if (K < 1)
+			return false;
+		size_t len = XX[0].size();
+		vector< vector<double> > V(K, vector<double>(len));
+		for (int k = 0; k < K; ++k)
+			for (size_t s = 0; s < len; ++s)
+				V[k][s] = XX[k+1][s]-XX[k][s];
+		// modified Gram-Schmidt
+		vector<double> R(K*K, 0);
+		for (int i = 0; i < K; ++i)
+		{
+			double nrm = 0;
+			for (size_t s = 0; s < len; ++s)
+				nrm += V[i][s]*V[i][s];
+			nrm = sqrt(nrm);
+			if (nrm == 0)
+				return false;
+			R[i*K+i] = nrm;
+			for (size_t s = 0; s < len; ++s)
+				V[i][s] /= nrm;
+			for (int j = i+1; j < K; ++j)
+			{
+				double r = 0;
+				for (size_t s = 0; s < len; ++s)
+					r += V[i][s]*V[j][s];
+				R[i*K+j] = r;
+				for (size_t s = 0; s < len; ++s)
+					V[j][s] -= r*V[i][s];
+			}
+		}
+		// R'R gamma = 1
+		vector<double> y(K, 1), gamma(K);
+		for (int i = 0; i < K; ++i)
+		{
+			for (int j = 0; j < i; ++j)
+				y[i] -= R[j*K+i]*y[j];
+			y[i] /= R[i*K+i];
+		}
+		for (int i = K-1; i >= 0; --i)
+		{
+			gamma[i] = y[i];
+			for (int j = i+1; j < K; ++j)
+				gamma[i] -= R[i*K+j]*gamma[j];
+			gamma[i] /= R[i*K+i];
+		}
+		double sum = 0;
+		for (int k = 0; k < K; ++k)
+			sum += gamma[k];
+		if (sum == 0 || sum != sum)
+			return false;
+		X_.assign(len, 0);
+		for (int k = 0; k < K; ++k)
+			for (size_t s = 0; s < len; ++s)
+				X_[s] += gamma[k]/sum*XX[k][s];
+		return true;
+	}
+
+	/// Vp for one coordinate, V is the Laplacian of the pairs (i, landmark), so it costs O(N)
+	void apply_V(const vector<double>& p, vector<double>& Vp) const
+	{
+		int N = N_, L = (int)landmarks_.size();
+		double sum_all = 0, sum_landmarks = 0;
+		for (int i = 0; i < N; ++i)
+			sum_all += p[i];
+		for (int l = 0; l < L; ++l)
+			sum_landmarks += p[landmarks_[l]];
+		Vp.resize(N);
+		for (int i = 0; i < N; ++i)
+			Vp[i] = L*p[i] - sum_landmarks;
+		for (int l = 0; l < L; ++l)
+		{
+			int j = landmarks_[l];
+			Vp[j] += N*p[j] - sum_all;
+		}
+	}
+
+	/// X = V^+ Y by Jacobi preconditioned CG started from X, one coordinate at a time
+	void solve_V(const vector<double>& Y, vector<double>& X) const
+	{
+		int N = N_, dim = dim_;
+		int L = (int)landmarks_.size();
+		vector<double> diag(N, L);
+		for (int l = 0; l < L; ++l)
+			diag[landmarks_[l]] += N-2;	// L-1 landmarks and N-1 points
+		vector<double> x(N), r(N), z(N), p(N), Vp;
+		for (int d = 0; d < dim; ++d)
+		{
+			for (int i = 0; i < N; ++i)
+				x[i] = X[i*dim+d];
+			apply_V(x, Vp);
+			double rz = 0, rr0 = 0;
+			for (int i = 0; i < N; ++i)
+			{
+				r[i] = Y[i*dim+d]-Vp[i];
+				z[i] = r[i]/diag[i];
+				p[i] = z[i];
+				rz += r[i]*z[i];
+				rr0 += Y[i*dim+d]*Y[i*dim+d];
+			}
+			for (int it = 0; it < CG_MAX_ITER && rz > 1e-24*rr0; ++it)
+			{
+				apply_V(p, Vp);
+				double pVp = 0;
+				for (int i = 0; i < N; ++i)
+					pVp += p[i]*Vp[i];
+				if (pVp <= 0)
+					break;
+				double alpha = rz/pVp, rz_new = 0;
+				for (int i = 0; i < N; ++i)
+				{
+					x[i] += alpha*p[i];
+					r[i] -= alpha*Vp[i];
+					z[i] = r[i]/diag[i];
+					rz_new += r[i]*z[i];
+				}
+				for (int i = 0; i < N; ++i)
+					p[i] = z[i] + rz_new/rz*p[i];
+				rz = rz_new;
+			}
+			// the solution is defined up to a translation, keep it centered
+			double mean = 0;
+			for (int i = 0; i < N; ++i)
+				mean += x[i];
+			mean /= N;
+			for (int i = 0; i < N; ++i)
+				X[i*dim+d] = x[i]-mean;
+		}
+	}
+
+	const Real* D_;
+	int N_;
+	int ncols_;
+	int dim_;
+	int verbose_;
+	vector<int> landmarks_;
+};
+
+string get_string(const mxArray* options, const char* name, const char* def)
+{
+	mxArray* tmp = mxGetField(options,0,name);
+	if (!tmp || !mxIsChar(tmp))
+		return def;
+	char* str = mxArrayToString(tmp);
+	string s(str);
+	mxFree(str);
+	transform(s.begin(), s.end(), s.begin(), ::tolower);
+	return s;
+}
+
+double get_scalar(const mxArray* options, const char* name, double def)
+{
+	mxArray* tmp = mxGetField(options,0,name);
+	return tmp ? mxGetScalar(tmp) : def;
+}
+
+vector<int> get_indices(const mxArray* a, int nmax, const char* msg)
+{
+	int n = (int)mxGetNumberOfElements(a);
+	const double* p = mxGetPr(a);
+	vector<int> ind(n);
+	for (int k = 0; k < n; ++k)
+	{
+		ind[k] = (int)p[k]-1;
+		if (ind[k] < 0 || ind[k] >= nmax)
+			mexErrMsgTxt(msg);
+	}
+	return ind;
+}
+
+template<class Real>
+void run(const Real* D, int N, int ncols, const mxArray* options, vector<double>& X, int dim, vector<double>& hist)
+{
+	Smacof<Real> smacof(D, N, ncols, dim);
+	string method = "rre";
+	int iter = -1, cycles = -1;
+	double rtol = 0.01, atol = 0, lambda = 1;
+	if (options)
+	{
+		method = get_string(options, "method", "rre");
+		double v = get_scalar(options, "iter", -1);
+		iter = v < INT_MAX ? (int)v : INT_MAX;
+		v = get_scalar(options, "cycles", -1);
+		cycles = v < INT_MAX ? (int)v : INT_MAX;
+		rtol = get_scalar(options, "rtol", rtol);
+		atol = get_scalar(options, "atol", atol);
+		lambda = get_scalar(options, "lambda", lambda);
+		string display = get_string(options, "display", "off");
+		smacof.set_verbose(display == "iter" || display == "cycle");
+		mxArray* tmp = mxGetField(options,0,"landmarks");
+		if (tmp)
+		{
+			vector<int> landmarks = get_indices(tmp, N, "options.landmarks index out of range!");
+			if ((int)landmarks.size() != ncols)
+				mexErrMsgTxt("D must be of size N*length(options.landmarks) in landmark mode!");
+			vector<int> sorted(landmarks);
+			sort(sorted.begin(), sorted.end());
+			if (unique(sorted.begin(), sorted.end()) != sorted.end())
+				mexErrMsgTxt("options.landmarks should not contain duplicates.");
+			smacof.set_landmarks(landmarks);
+		}
+		else if (ncols != N)
+			mexErrMsgTxt("Matrix D must be square, exiting.");
+	}
+	else if (ncols != N)
+		mexErrMsgTxt("Matrix D must be square, exiting.");
+
+	if (method == "smacof")
+		smacof.run_smacof(X, iter < 0 ? 50 : iter, rtol, atol, hist);
+	else if (method == "rre")
+		smacof.run_rre(X, cycles < 0 ? 5 : cycles, iter < 0 ? 10 : iter, rtol, atol, hist);
+	else if (method == "mg")
+	{
+		if (ncols != N)
+			mexErrMsgTxt("The MG method needs the full distance matrix.");
+		mxArray* pIND = mxGetField(options,0,"IND");
+		mxArray* pUP = mxGetField(options,0,"UPMTX");
+		mxArray* pDOWN = mxGetField(options,0,"DOWNMTX");
+		if (!pIND || !mxIsCell(pIND))
+			mexErrMsgTxt("No grid hierarchy provided, exiting");
+		if (!pUP || !mxIsCell(pUP))
+			mexErrMsgTxt("No interpolation matrices provided, exiting");
+		if (!pDOWN || !mxIsCell(pDOWN))
+			mexErrMsgTxt("No decimation matrices provided, exiting");
+		int nlevels = (int)mxGetNumberOfElements(pIND);
+		if (nlevels < 2 || (int)mxGetNumberOfElements(pUP) < nlevels-1 || (int)mxGetNumberOfElements(pDOWN) < nlevels-1)
+			mexErrMsgTxt("The grid hierarchy needs at least 2 levels and one matrix between two levels.");
+		vector< vector<int> > IND(nlevels);
+		vector<GridMatrix> UP, DOWN;
+		for (int k = 0; k < nlevels; ++k)
+			IND[k] = get_indices(mxGetCell(pIND,k), N, "options.IND index out of range!");
+		if ((int)IND[0].size()*dim != (int)X.size())
+			mexErrMsgTxt("X0 and the finest grid dimensions mismatch.");
+		for (int k = 0; k+1 < nlevels; ++k)
+		{
+			UP.push_back(GridMatrix(mxGetCell(pUP,k)));
+			DOWN.push_back(GridMatrix(mxGetCell(pDOWN,k)));
+			if (DOWN[k].rows != (int)IND[k+1].size() || DOWN[k].cols != (int)IND[k].size() ||
+				UP[k].rows != (int)IND[k].size() || UP[k].cols != (int)IND[k+1].size())
+				mexErrMsgTxt("UPMTX/DOWNMTX and IND dimensions mismatch.");
+		}
+		smacof.run_mg(X, cycles < 0 ? 3 : cycles, iter < 0 ? 3 : iter, rtol, atol, lambda, IND, UP, DOWN, hist);
+	}
+	else
+		mexErrMsgTxt("Invalid method, exiting. Use method=smacof|rre|mg");
+}
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray*prhs[])
+{
+	///////////// Error Check
+	if ( nrhs < 2)
+		mexErrMsgTxt("Number of input should be > 1");
+	if ( nlhs > 2)
+		mexErrMsgTxt("Number of output should be 1 or 2");
+
+	///////////// input & output arguments
+	// input 0: D: N*N or N*L, double or single
+	int N = (int)mxGetM(prhs[0]);
+	int ncols = (int)mxGetN(prhs[0]);
+	if (!mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0]))
+		mexErrMsgTxt("D must be double or single!");
+	if (mxIsSparse(prhs[0]))
+		mexErrMsgTxt("D must be full!");
+
+	// input 1: X0: N*dim
+	if ((int)mxGetM(prhs[1]) != N)
+		mexErrMsgTxt("X0 and D dimensions mismatch, exiting. X0 must be a size(D,1)*dim matrix.");
+	int dim = (int)mxGetN(prhs[1]);
+	const double* X0 = mxGetPr(prhs[1]);
+
+	// input 2: options
+	const mxArray* options = 0;
+	if (nrhs > 2)
+	{
+		options = prhs[2];
+		if ( mxSTRUCT_CLASS != mxGetClassID(options))
+			mexErrMsgTxt("3rd arguments is not a structure!");
+	}
+
+	// column major N*dim -> row major
+	vector<double> X(N*dim);
+	for (int i = 0; i < N; ++i)
+		for (int d = 0; d < dim; ++d)
+			X[i*dim+d] = X0[i+N*d];
+
+	vector<double> hist;
+	if (mxIsSingle(prhs[0]))
+		run((const float*)mxGetData(prhs[0]), N, ncols, options, X, dim, hist);
+	else
+		run(mxGetPr(prhs[0]), N, ncols, options, X, dim, hist);
+
+	///////////////////////////////////////////////
+	// output 0
+	plhs[0] = mxCreateDoubleMatrix(N, dim, mxREAL);
+	double* pX = mxGetPr(plhs[0]);
+	for (int i = 0; i < N; ++i)
+		for (int d = 0; d < dim; ++d)
+			pX[i+N*d] = X[i*dim+d];
+
+	// output 1
+	if (nlhs > 1)
+	{
+		const char* fields[] = {"s"};
+		plhs[1] = mxCreateStructMatrix(1, 1, 1, fields);
+		mxArray* s = mxCreateDoubleMatrix(1, hist.size(), mxREAL);
+		if (!hist.empty())
+			memcpy(mxGetPr(s), &hist[0], hist.size()*sizeof(double));
+		mxSetField(plhs[1], 0, "s", s);
+	}
+}
@@ -0,0 +1,43 @@
+% test_perform_smacof
+%
+% canonical form by the native SMACOF: full double and single distances,
+% then the landmark (sparse stress) mode which only needs N*L distances.
+%
+% Copyright (c) 2026 Junjie Cao
+
+clear;clc;close all;
+MYTOOLBOXROOT='../../';
+addpath ([MYTOOLBOXROOT 'jjcao_interact'])
+
+load([MYTOOLBOXROOT 'data/man1']);
+X0 = [man.X,man.Y,man.Z];
+N = size(X0,1);
+
+options.method = 'rre';
+options.cycles = 5;
+options.iter = 10;
+options.rtol = 1e-4;
+
+%% full stress
+tic; [X1,hist1] = smacof_rre(man.D,X0,options.cycles,options.iter,'off','off',options.rtol,0); t1 = toc;
+tic; [X2,hist2] = perform_smacof(man.D,X0,options); t2 = toc;
+tic; [X3,hist3] = perform_smacof(single(man.D),X0,options); t3 = toc;
+fprintf('matlab rre: %8.3fs stress %g\n', t1, hist1.s(end));
+fprintf('native rre: %8.3fs stress %g\n', t2, hist2.s(end));
+fprintf('single D  : %8.3fs stress %g\n', t3, hist3.s(end));
+
+%% landmark mode
+L = 200;
+landmarks = randperm(N);
+landmarks = sort(landmarks(1:L));
+options.landmarks = landmarks;
+tic; [X4,hist4] = perform_smacof(man.D(:,landmarks),X0,options); t4 = toc;
+fprintf('landmarks : %8.3fs stress on the pairs %g\n', t4, hist4.s(end));
+
+figure('name','canonical forms'); set(gcf,'color','white');
+subplot(1,2,1); trisurf(man.TRIV,X2(:,1),X2(:,2),X2(:,3));
+shading interp, colormap([1 1 1]*0.9), lighting phong, camlight head
+axis image; axis off; title('full stress');
+subplot(1,2,2); trisurf(man.TRIV,X4(:,1),X4(:,2),X4(:,3));
+shading interp, colormap([1 1 1]*0.9), lighting phong, camlight head
+axis image; axis off; title(sprintf('%d landmarks', L));
@@ -9,11 +9,28 @@ mex minimaAndMaxima.cpp
 % mex -g -largeArrayDims -I"../../include/eigen-3.1.3" vertex_area.cpp % for debuging
 mex -largeArrayDims -I"../../include/eigen-3.1.3" vertex_area.cpp
 mex -largeArrayDims -I"../../include/eigen-3.1.3" perform_mesh_weight.cpp
+mex -largeArrayDims -I"../../include/eigen-3.1.3" COMPFLAGS="$COMPFLAGS /openmp" perform_mesh_heat_diffusion_fast.cpp
+mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" perform_lloyd_iteration_fast.cpp
+mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" perform_lloyd_mesh.cpp
 mex -largeArrayDims -I"../../include/eigen-3.1.3" 3d-transformation/create_rotation3d_line_angle.cpp
 if exist('create_rotation3d_line_angle.mexw64', 'file'); movefile('create_rotation3d_line_angle.mexw64', '3d-transformation/'); end
 
 mex -largeArrayDims -I"../../include/eigen-3.1.3" 3d-transformation/transform_point3d.cpp
 if exist('transform_point3d.mexw64', 'file'); movefile('transform_point3d.mexw64', '3d-transformation/'); end
+
+mex -largeArrayDims -I"../../include/eigen-3.1.3" COMPFLAGS="$COMPFLAGS /openmp" parameterization/ARAP/perform_arap.cpp
+if exist('perform_arap.mexw64', 'file'); movefile('perform_arap.mexw64', 'parameterization/ARAP/'); end
+mex -largeArrayDims -I"../../examples/04-fileIO_String/Mesh_io/include" COMPFLAGS="$COMPFLAGS /openmp" parameterization/compute_parameterization_distortion.cpp
+if exist('compute_parameterization_distortion.mexw64', 'file'); movefile('compute_parameterization_distortion.mexw64', 'parameterization/'); end
+
+mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" accelerated_mds/perform_smacof.cpp
+if exist('perform_smacof.mexw64', 'file'); movefile('perform_smacof.mexw64', 'accelerated_mds/'); end
+mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" smoothing/perform_mesh_smoothing_fast.cpp
+if exist('perform_mesh_smoothing_fast.mexw64', 'file'); movefile('perform_mesh_smoothing_fast.mexw64', 'smoothing/'); end
+mex -largeArrayDims -I"../../include/eigen-3.1.3" COMPFLAGS="$COMPFLAGS /openmp" segmentation/perform_random_walk_segmentation.cpp
+if exist('perform_random_walk_segmentation.mexw64', 'file'); movefile('perform_random_walk_segmentation.mexw64', 'segmentation/'); end
+mex -largeArrayDims -I"../../include/eigen-3.1.3" COMPFLAGS="$COMPFLAGS /openmp" feature/compute_curvature_fast.cpp
+if exist('compute_curvature_fast.mexw64', 'file'); movefile('compute_curvature_fast.mexw64', 'feature/'); end
 %% geodesic - dijkstra
 % there are three implementations as follows:
 % geodesic 1: the speed is much faster than perform_front_propagation_mesh (geodesic 3), since it is shortest path distance rather than continuous
@@ -31,8 +48,8 @@ if exist('dijkstra.mexglx', 'file'); movefile('dijkstra.mexglx', 'geodesic/perfo
 if exist('dijkstra.mexmaci', 'file'); movefile('dijkstra.mexmaci', 'geodesic/perform_dijkstra_fast.mexmaci'); end
 
 %% geodesic 3:
-mex "-largeArrayDims" geodesic/mex/perform_front_propagation_2d.cpp geodesic/mex/perform_front_propagation_2d_mex.cpp geodesic/mex/fheap/fib.cpp 
-mex "-largeArrayDims" geodesic/mex/perform_front_propagation_3d.cpp geodesic/mex/perform_front_propagation_3d_mex.cpp geodesic/mex/fheap/fib.cpp 
+mex "-largeArrayDims" COMPFLAGS="$COMPFLAGS /openmp" geodesic/mex/perform_front_propagation_2d.cpp geodesic/mex/perform_front_propagation_2d_mex.cpp geodesic/mex/fheap/fib.cpp 
+mex "-largeArrayDims" COMPFLAGS="$COMPFLAGS /openmp" geodesic/mex/perform_front_propagation_3d.cpp geodesic/mex/perform_front_propagation_3d_mex.cpp geodesic/mex/fheap/fib.cpp 
 if exist('perform_front_propagation_2d.mexw32', 'file');  movefile('perform_front_propagation_2d.mexw32', 'geodesic/');end;
 if exist('perform_front_propagation_2d.mexw64', 'file');  movefile('perform_front_propagation_2d.mexw64', 'geodesic/');end;
 if exist('perform_front_propagation_3d.mexw32', 'file');  movefile('perform_front_propagation_3d.mexw32', 'geodesic/');end;
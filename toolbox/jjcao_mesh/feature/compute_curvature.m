@@ -14,6 +14,9 @@ function [Umin,Umax,Cmin,Cmax,Cmean,Cgauss,Normal] = compute_curvature(vertex,fa
 %
 %   options.curvature_smoothing controls the size of the ring used for
 %       averaging the curvature tensor.
+%   options.curvature_radius: if > 0, the tensor is averaged over the ball
+%       of this radius instead, only with compute_curvature_fast.cpp, which
+%       is used if options.use_c_implementation=1, the default.
 %
 %   The algorithm is detailed in 
 %       David Cohen-Steiner and Jean-Marie Morvan. 
@@ -36,6 +39,13 @@ verb = getoptions(options, 'verb', 1);
 
 [vertex,face] = check_face_vertex(vertex,face);
 
+use_c_implementation = getoptions(options, 'use_c_implementation', 1);% use fast C-coded version if possible
+if exist('compute_curvature_fast', 'file') && use_c_implementation
+    options.curvature_smoothing = naver;
+    [Umin,Umax,Cmin,Cmax,Cmean,Cgauss,Normal] = compute_curvature_fast(double(vertex), double(face), options);
+    return;
+end
+
 n = size(vertex,2);
 m = size(face,2);
 
@@ -0,0 +1,374 @@
+/*=================================================================
+*
+* principal curvatures by the normal cycle (Cohen-Steiner and Morvan,
+* "Restricted Delaunay triangulations and normal cycle", SoCG 2003), the
+* same as compute_curvature.m in one call
+*
+* usage:
+		[Umin,Umax,Cmin,Cmax,Cmean,Cgauss,Normal] = compute_curvature_fast(vertex, face, options);
+* compile:
+		mex -largeArrayDims -I"../../../include/eigen-3.1.3" COMPFLAGS="$COMPFLAGS /openmp" compute_curvature_fast.cpp
+* inputs:
+		vertex: 3*nverts
+		face: 3*nfaces
+		options.curvature_smoothing: number of averaging passes of the
+			tensors over the 1-ring, D^-1*(A+I) as perform_mesh_smoothing.m,
+			default 3
+		options.curvature_radius: if > 0, the tensors are averaged instead
+			over the vertices connected to the vertex inside the ball of this
+			radius, default 0
+* outputs:
+		Umin, Umax: 3*nverts, directions of minimum and maximum curvature
+		Cmin, Cmax, Cmean, Cgauss: nverts*1
+		Normal: 3*nverts, oriented as compute_normal.m
+*
+*	Every interior edge e gives the tensor |e|*beta(e)*e*e'/|e|^2, beta the
+*	signed dihedral angle, edge lengths divided by their mean as
+*	compute_curvature.m. A vertex averages the tensors of its edges, the
+*	6 coefficients are then averaged over the mesh and each 3*3 tensor is
+*	decomposed: the eigenvector of the smallest |eigenvalue| is the normal,
+*	the two others give the curvatures (with swapped directions).
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include <mex.h>
+#include <Eigen/Dense>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+inline void cross(const double* a, const double* b, double* c)
+{
+	c[0] = a[1]*b[2] - a[2]*b[1];
+	c[1] = a[2]*b[0] - a[0]*b[2];
+	c[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+/// interior edges i<j with the face of i->j and of j->i
+struct EdgeFaces
+{
+	int i, j, f1, f2;
+};
+
+void interior_edges(const vector<int>& faces, vector<EdgeFaces>& edges)
+{
+	int nfaces = (int)faces.size()/3;
+	// (min, max), direction, face
+	vector<pair<pair<int,int>, pair<int,int> > > half(3*nfaces);
+	for (int f = 0; f < nfaces; ++f)
+		for (int k = 0; k < 3; ++k)
+		{
+			int a = faces[3*f+k], b = faces[3*f+(k+1)%3];
+			half[3*f+k] = make_pair(make_pair(min(a,b), max(a,b)), make_pair(a < b ? 0 : 1, f));
+		}
+	sort(half.begin(), half.end());
+	edges.clear();
+	for (size_t h = 0; h < half.size(); )
+	{
+		size_t g = h;
+		while (g < half.size() && half[g].first == half[h].first) ++g;
+		// manifold interior edge: one face in each direction
+		if (g - h == 2 && half[h].second.first == 0 && half[h+1].second.first == 1 && half[h].first.first != half[h].first.second)
+		{
+			EdgeFaces e = {half[h].first.first, half[h].first.second, half[h].second.second, half[h+1].second.second};
+			edges.push_back(e);
+		}
+		h = g;
+	}
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	///////////// Error Check
+	if (nrhs < 2 || nrhs > 3)
+		mexErrMsgTxt("Usage: [Umin,Umax,Cmin,Cmax,Cmean,Cgauss,Normal] = compute_curvature_fast(vertex, face, options)");
+	if (nlhs > 7)
+		mexErrMsgTxt("Number of output should be 1 to 7");
+
+	int nverts = (int)mxGetN(prhs[0]);
+	if (!mxIsDouble(prhs[0]) || mxGetM(prhs[0]) != 3)
+		mexErrMsgTxt("vertex is excepted to be 3*nverts");
+	const double* verts = mxGetPr(prhs[0]);
+	int nfaces = (int)mxGetN(prhs[1]);
+	if (!mxIsDouble(prhs[1]) || mxGetM(prhs[1]) != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! face is excepted to be 3*nfaces");
+	vector<int> faces(3*nfaces);
+	for (int k = 0; k < 3*nfaces; ++k)
+	{
+		faces[k] = (int)mxGetPr(prhs[1])[k] - 1;
+		if (faces[k] < 0 || faces[k] >= nverts)
+			mexErrMsgTxt("face index out of range!");
+	}
+	const mxArray* options = (nrhs > 2 && mxIsStruct(prhs[2])) ? prhs[2] : NULL;
+	int naver = (int)get_option(options, "curvature_smoothing", 3);
+	double radius = get_option(options, "curvature_radius", 0);
+
+	///////////// unit normals of the faces and of the vertices
+	vector<double> nf(3*nfaces), nv(3*nverts, 0);
+	#pragma omp parallel for schedule(static)
+	for (int f = 0; f < nfaces; ++f)
+	{
+		const int* v = &faces[3*f];
+		double u[3], w[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			u[k] = verts[3*v[1]+k] - verts[3*v[0]+k];
+			w[k] = verts[3*v[2]+k] - verts[3*v[0]+k];
+		}
+		cross(u, w, &nf[3*f]);
+		double d = sqrt(nf[3*f]*nf[3*f] + nf[3*f+1]*nf[3*f+1] + nf[3*f+2]*nf[3*f+2]);
+		if (d < mxGetEps()) d = 1;
+		for (int k = 0; k < 3; ++k)
+			nf[3*f+k] /= d;
+	}
+	for (int f = 0; f < nfaces; ++f)
+		for (int l = 0; l < 3; ++l)
+			for (int k = 0; k < 3; ++k)
+				nv[3*faces[3*f+l]+k] += nf[3*f+k];
+
+	///////////// one pass over the edges
+	vector<EdgeFaces> edges;
+	interior_edges(faces, edges);
+	int ne = (int)edges.size();
+	vector<double> len(ne), te(6*ne);
+	double mean = 0;
+	for (int e = 0; e < ne; ++e)
+	{
+		const double *a = &verts[3*edges[e].i], *b = &verts[3*edges[e].j];
+		len[e] = sqrt((b[0]-a[0])*(b[0]-a[0]) + (b[1]-a[1])*(b[1]-a[1]) + (b[2]-a[2])*(b[2]-a[2]));
+		mean += len[e];
+	}
+	mean = ne > 0 ? mean/ne : 1;
+	#pragma omp parallel for schedule(static)
+	for (int e = 0; e < ne; ++e)
+	{
+		const double *a = &verts[3*edges[e].i], *b = &verts[3*edges[e].j];
+		const double *n1 = &nf[3*edges[e].f1], *n2 = &nf[3*edges[e].f2];
+		double u[3], c[3];
+		for (int k = 0; k < 3; ++k)
+			u[k] = len[e] > 0 ? (b[k]-a[k])/len[e] : 0;
+		double dp = n1[0]*n2[0] + n1[1]*n2[1] + n1[2]*n2[2];
+		double beta = acos(min(1.0, max(-1.0, dp)));
+		cross(n1, n2, c);
+		double s = c[0]*u[0] + c[1]*u[1] + c[2]*u[2];
+		beta *= (s > 0) - (s < 0);
+		double db = len[e]/mean*beta;
+		double* t = &te[6*e];// xx, xy, xz, yy, yz, zz
+		t[0] = db*u[0]*u[0]; t[1] = db*u[0]*u[1]; t[2] = db*u[0]*u[2];
+		t[3] = db*u[1]*u[1]; t[4] = db*u[1]*u[2]; t[5] = db*u[2]*u[2];
+	}
+
+	// vertex -> interior edges, and the 1-ring (all the edges)
+	vector<int> estart(nverts+1, 0), ering(2*ne);
+	for (int e = 0; e < ne; ++e)
+	{
+		++estart[edges[e].i+1];
+		++estart[edges[e].j+1];
+	}
+	for (int i = 0; i < nverts; ++i)
+		estart[i+1] += estart[i];
+	{
+		vector<int> pos(estart.begin(), estart.end()-1);
+		for (int e = 0; e < ne; ++e)
+		{
+			ering[pos[edges[e].i]++] = e;
+			ering[pos[edges[e].j]++] = e;
+		}
+	}
+	vector<pair<int,int> > links;
+	links.reserve(6*nfaces);
+	for (int f = 0; f < nfaces; ++f)
+		for (int k = 0; k < 3; ++k)
+		{
+			int a = faces[3*f+k], b = faces[3*f+(k+1)%3];
+			if (a == b) continue;
+			links.push_back(make_pair(a,b));
+			links.push_back(make_pair(b,a));
+		}
+	sort(links.begin(), links.end());
+	links.erase(unique(links.begin(), links.end()), links.end());
+	vector<int> start(nverts+1, 0), nb(links.size());
+	for (size_t l = 0; l < links.size(); ++l)
+	{
+		++start[links[l].first+1];
+		nb[l] = links[l].second;
+	}
+	for (int i = 0; i < nverts; ++i)
+		start[i+1] += start[i];
+
+	// pooling on the vertices
+	vector<double> tv(6*nverts, 0);
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nverts; ++i)
+	{
+		double* t = &tv[6*i];
+		for (int p = estart[i]; p < estart[i+1]; ++p)
+			for (int k = 0; k < 6; ++k)
+				t[k] += te[6*ering[p]+k];
+		int w = estart[i+1] - estart[i];
+		if (w > 0)
+			for (int k = 0; k < 6; ++k)
+				t[k] /= w;
+	}
+
+	///////////// averaging
+	vector<double> tmp(6*nverts);
+	if (radius > 0)
+	{
+		// the vertices connected to i inside the ball of i
+		int nthreads = 1;
+#ifdef _OPENMP
+		nthreads = omp_get_max_threads();
+#endif
+		vector<vector<int> > mark(nthreads, vector<int>(nverts, -1));
+		vector<vector<int> > queue(nthreads);
+		double r2 = radius*radius;
+		#pragma omp parallel for schedule(dynamic,64)
+		for (int i = 0; i < nverts; ++i)
+		{
+			int id = 0;
+#ifdef _OPENMP
+			id = omp_get_thread_num();
+#endif
+			vector<int>& m = mark[id];
+			vector<int>& q = queue[id];
+			const double* c = &verts[3*i];
+			q.clear();
+			q.push_back(i);
+			m[i] = i;
+			double* t = &tmp[6*i];
+			fill(t, t+6, 0.0);
+			for (size_t h = 0; h < q.size(); ++h)
+			{
+				int v = q[h];
+				for (int k = 0; k < 6; ++k)
+					t[k] += tv[6*v+k];
+				for (int p = start[v]; p < start[v+1]; ++p)
+				{
+					int j = nb[p];
+					if (m[j] == i) continue;
+					const double* x = &verts[3*j];
+					if ((x[0]-c[0])*(x[0]-c[0]) + (x[1]-c[1])*(x[1]-c[1]) + (x[2]-c[2])*(x[2]-c[2]) > r2) continue;
+					m[j] = i;
+					q.push_back(j);
+				}
+			}
+			for (int k = 0; k < 6; ++k)
+				t[k] /= q.size();
+		}
+		tv.swap(tmp);
+	}
+	else
+	{
+		for (int it = 0; it < naver; ++it)
+		{
+			#pragma omp parallel for schedule(static)
+			for (int i = 0; i < nverts; ++i)
+			{
+				double* t = &tmp[6*i];
+				for (int k = 0; k < 6; ++k)
+					t[k] = tv[6*i+k];
+				for (int p = start[i]; p < start[i+1]; ++p)
+					for (int k = 0; k < 6; ++k)
+						t[k] += tv[6*nb[p]+k];
+				double w = 1.0/(start[i+1] - start[i] + 1);
+				for (int k = 0; k < 6; ++k)
+					t[k] *= w;
+			}
+			tv.swap(tmp);
+		}
+	}
+
+	///////////// eigen decompositions
+	// orientation of the normals as compute_normal.m
+	for (int i = 0; i < nverts; ++i)
+	{
+		double* n = &nv[3*i];
+		double d = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+		if (d < mxGetEps()) d = 1;
+		for (int k = 0; k < 3; ++k)
+			n[k] /= d;
+	}
+	{
+		double s[3] = {0, 0, 0};
+		for (int i = 0; i < nverts; ++i)
+		{
+			const double* x = &verts[3*i];
+			double c = (x[0] + x[1] + x[2])/3;
+			for (int k = 0; k < 3; ++k)
+				s[k] += (x[k] - c)*nv[3*i+k];
+		}
+		int npos = (s[0] > 0) + (s[1] > 0) + (s[2] > 0);
+		int nneg = (s[0] < 0) + (s[1] < 0) + (s[2] < 0);
+		if (npos < nneg)
+			for (int k = 0; k < 3*nverts; ++k)
+				nv[k] = -nv[k];
+	}
+
+	plhs[0] = mxCreateDoubleMatrix(3, nverts, mxREAL);
+	plhs[1] = mxCreateDoubleMatrix(3, nverts, mxREAL);
+	plhs[2] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+	plhs[3] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+	plhs[4] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+	plhs[5] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+	plhs[6] = mxCreateDoubleMatrix(3, nverts, mxREAL);
+	double *umin = mxGetPr(plhs[0]), *umax = mxGetPr(plhs[1]);
+	double *cmin = mxGetPr(plhs[2]), *cmax = mxGetPr(plhs[3]);
+	double *cmean = mxGetPr(plhs[4]), *cgauss = mxGetPr(plhs[5]);
+	double *normal = mxGetPr(plhs[6]);
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nverts; ++i)
+	{
+		const double* t = &tv[6*i];
+		Eigen::Matrix3d T;
+		T << t[0], t[1], t[2],
+			 t[1], t[3], t[4],
+			 t[2], t[4], t[5];
+		Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(T);
+		const Eigen::Vector3d& d = eig.eigenvalues();
+		const Eigen::Matrix3d& u = eig.eigenvectors();
+		// sort according to |d|: normal, min curv, max curv
+		int I[3] = {0, 1, 2};
+		for (int a = 1; a < 3; ++a)
+			for (int b = a; b > 0 && fabs(d[I[b]]) < fabs(d[I[b-1]]); --b)
+				swap(I[b], I[b-1]);
+		double c1 = d[I[1]], c2 = d[I[2]];
+		int i1 = I[2], i2 = I[1];// the directions are swapped
+		if (c1 > c2)
+		{
+			swap(c1, c2);
+			swap(i1, i2);
+		}
+		cmin[i] = c1;
+		cmax[i] = c2;
+		cmean[i] = (c1 + c2)/2;
+		cgauss[i] = c1*c2;
+		const double* n = &nv[3*i];
+		double s = u(0,I[0])*n[0] + u(1,I[0])*n[1] + u(2,I[0])*n[2];
+		s = (s > 0) - (s < 0);
+		for (int k = 0; k < 3; ++k)
+		{
+			umin[3*i+k] = u(k,i1);
+			umax[3*i+k] = u(k,i2);
+			normal[3*i+k] = s*u(k,I[0]);
+		}
+	}
+}
@@ -30,3 +30,11 @@ plot_mesh_scalar(verts, faces, Cgauss, options);
 
 options.figname='abs(Cmin)+abs(Cmax)';options.position='south';
 plot_mesh_scalar(verts, faces, abs(Cmin)+abs(Cmax), options);
+
+%% curvature tensor averaged over a ball (compute_curvature_fast)
+options.curvature_radius = 2*mean(sqrt(sum((verts(faces(:,1),:)-verts(faces(:,2),:)).^2,2)));
+[Umin,Umax,Cmin,Cmax,Cmean,Cgauss,Normal] = compute_curvature(verts,faces,options);
+options.curvature_radius = 0;
+
+options.figname='Cmean, ball averaging';options.position='southeast';
+plot_mesh_scalar(verts, faces, Cmean, options);
@@ -97,10 +97,12 @@ void GW_GeodesicMesh::PerformFastMarching( GW_GeodesicVertex* pStartVertex )
 /*------------------------------------------------------------------------------*/
 void GW_GeodesicMesh::SetUpFastMarching( GW_GeodesicVertex* pStartVertex )
 {
-	GW_ASSERT( WeightCallback_!=NULL );
+	GW_ASSERT( WeightCallback_!=NULL || WeightCallbackCtx_!=NULL );
 
 	if( pStartVertex!=NULL )
 		this->AddStartVertex( *pStartVertex );
+	for( IT_GeodesicVertexVector it = ActiveVertex_.begin(); it!=ActiveVertex_.end(); ++it )
+		(*it)->SetHeuristicToGoal( this->CallHeuristicToGoalCallback(**it) );
 
 	std::make_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
 
@@ -86,6 +86,24 @@ public:
 	void RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunction pFunc );
 	//@}
 
+    //-------------------------------------------------------------------------
+    /** \name Re-entrant callbacks : the context given at registration is passed
+	 *  back at each call, so no global state is needed and several meshes can
+	 *  propagate in parallel threads. They replace the plain version (and reciprocally). */
+    //-------------------------------------------------------------------------
+    //@{
+	typedef GW_Float (*T_WeightCallbackFunctionCtx)( GW_GeodesicVertex& Vert, void* pContext );
+	void RegisterWeightCallbackFunction( T_WeightCallbackFunctionCtx pFunc, void* pContext );
+	typedef GW_Bool (*T_FastMarchingCallbackFunctionCtx)( GW_GeodesicVertex& Vert, void* pContext );
+	void RegisterForceStopCallbackFunction( T_FastMarchingCallbackFunctionCtx pFunc, void* pContext );
+	typedef void (*T_NewDeadVertexCallbackFunctionCtx)( GW_GeodesicVertex& Vert, void* pContext );
+	void RegisterNewDeadVertexCallbackFunction( T_NewDeadVertexCallbackFunctionCtx pFunc, void* pContext );
+	typedef GW_Bool (*T_VertexInsersionCallbackFunctionCtx)( GW_GeodesicVertex& Vert, GW_Float rNewDist, void* pContext );
+	void RegisterVertexInsersionCallbackFunction( T_VertexInsersionCallbackFunctionCtx pFunc, void* pContext );
+	typedef GW_Float (*T_HeuristicToGoalCallbackFunctionCtx)( GW_GeodesicVertex& Vert, void* pContext );
+	void RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunctionCtx pFunc, void* pContext );
+	//@}
+
 	virtual GW_Vertex* GetRandomVertex( GW_Bool bForceFar = GW_True );
 
 	static GW_Float BasicWeightCallback(GW_GeodesicVertex& Vert);
@@ -107,7 +125,19 @@ protected:
 	T_VertexInsersionCallbackFunction VertexInsersionCallback_;
 	/** a function called to give an heuristic for the remaining distance */
 	T_HeuristicToGoalCallbackFunction HeuristicToGoalCallbackFunction_;
-	
+
+	/** re-entrant callbacks and their contexts, used instead of the plain ones when not NULL */
+	T_WeightCallbackFunctionCtx WeightCallbackCtx_;
+	void* pWeightContext_;
+	T_FastMarchingCallbackFunctionCtx ForceStopCallbackCtx_;
+	void* pForceStopContext_;
+	T_NewDeadVertexCallbackFunctionCtx NewDeadVertexCallbackCtx_;
+	void* pNewDeadVertexContext_;
+	T_VertexInsersionCallbackFunctionCtx VertexInsersionCallbackCtx_;
+	void* pVertexInsersionContext_;
+	T_HeuristicToGoalCallbackFunctionCtx HeuristicToGoalCallbackFunctionCtx_;
+	void* pHeuristicToGoalContext_;
+
 	/** just to controle interactive mode */
 	GW_Bool bIsMarchingBegin_;
 	GW_Bool bIsMarchingEnd_;
@@ -115,6 +145,12 @@ protected:
 
 private:
 
+	GW_Float CallWeightCallback( GW_GeodesicVertex& Vert );
+	GW_Bool CallForceStopCallback( GW_GeodesicVertex& Vert );
+	void CallNewDeadVertexCallback( GW_GeodesicVertex& Vert );
+	GW_Bool CallVertexInsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist );
+	GW_Float CallHeuristicToGoalCallback( GW_GeodesicVertex& Vert );
+
 	GW_Float ComputeVertexDistance( GW_GeodesicFace& CurrentFace, GW_GeodesicVertex& CurrentVertex, 
 									GW_GeodesicVertex& Vert1, GW_GeodesicVertex& Vert2, GW_GeodesicVertex& CurrentFront );
 
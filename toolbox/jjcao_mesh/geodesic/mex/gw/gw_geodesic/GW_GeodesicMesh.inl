@@ -28,6 +28,16 @@ GW_GeodesicMesh::GW_GeodesicMesh()
 	ForceStopCallback_			( NULL ),
 	NewDeadVertexCallback_		( NULL ),
 	HeuristicToGoalCallbackFunction_	( NULL ),
+	WeightCallbackCtx_			( NULL ),
+	pWeightContext_				( NULL ),
+	ForceStopCallbackCtx_		( NULL ),
+	pForceStopContext_			( NULL ),
+	NewDeadVertexCallbackCtx_	( NULL ),
+	pNewDeadVertexContext_		( NULL ),
+	VertexInsersionCallbackCtx_	( NULL ),
+	pVertexInsersionContext_	( NULL ),
+	HeuristicToGoalCallbackFunctionCtx_	( NULL ),
+	pHeuristicToGoalContext_	( NULL ),
 	bIsMarchingBegin_			( GW_False ),
 	bIsMarchingEnd_				( GW_False )
 {
@@ -134,6 +144,8 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterForceStopCallbackFunction( T_FastMarchingCallbackFunction pFunc )
 {
 	ForceStopCallback_ = pFunc;
+	ForceStopCallbackCtx_ = NULL;
+	pForceStopContext_ = NULL;
 }
 
 
@@ -152,6 +164,8 @@ void GW_GeodesicMesh::RegisterWeightCallbackFunction( T_WeightCallbackFunction p
 {
 	GW_ASSERT( pFunc!=NULL );
 	WeightCallback_ = pFunc;
+	WeightCallbackCtx_ = NULL;
+	pWeightContext_ = NULL;
 }
 
 
@@ -169,6 +183,200 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunction pFunc )
 {
 	HeuristicToGoalCallbackFunction_ = pFunc;
+	HeuristicToGoalCallbackFunctionCtx_ = NULL;
+	pHeuristicToGoalContext_ = NULL;
+}
+
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::RegisterWeightCallbackFunction
+/**
+ *  \param  pFunc [T_WeightCallbackFunctionCtx] The function.
+ *  \param  pContext [void*] User data given back to \c pFunc.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Re-entrant version : the metric is read from \c pContext rather than
+ *	from a global.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::RegisterWeightCallbackFunction( T_WeightCallbackFunctionCtx pFunc, void* pContext )
+{
+	GW_ASSERT( pFunc!=NULL );
+	WeightCallback_ = NULL;
+	WeightCallbackCtx_ = pFunc;
+	pWeightContext_ = pContext;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::RegisterForceStopCallbackFunction
+/**
+ *  \param  pFunc [T_FastMarchingCallbackFunctionCtx] The function, NULL to remove it.
+ *  \param  pContext [void*] User data given back to \c pFunc.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Re-entrant version of the stopping test.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::RegisterForceStopCallbackFunction( T_FastMarchingCallbackFunctionCtx pFunc, void* pContext )
+{
+	ForceStopCallback_ = NULL;
+	ForceStopCallbackCtx_ = pFunc;
+	pForceStopContext_ = pContext;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::RegisterNewDeadVertexCallbackFunction
+/**
+ *  \param  pFunc [T_NewDeadVertexCallbackFunctionCtx] The function, NULL to remove it.
+ *  \param  pContext [void*] User data given back to \c pFunc.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Re-entrant version of the new dead vertex notification.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::RegisterNewDeadVertexCallbackFunction( T_NewDeadVertexCallbackFunctionCtx pFunc, void* pContext )
+{
+	NewDeadVertexCallback_ = NULL;
+	NewDeadVertexCallbackCtx_ = pFunc;
+	pNewDeadVertexContext_ = pContext;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::RegisterVertexInsersionCallbackFunction
+/**
+ *  \param  pFunc [T_VertexInsersionCallbackFunctionCtx] The function, NULL to remove it.
+ *  \param  pContext [void*] User data given back to \c pFunc.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Re-entrant version of the insertion test.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::RegisterVertexInsersionCallbackFunction( T_VertexInsersionCallbackFunctionCtx pFunc, void* pContext )
+{
+	VertexInsersionCallback_ = NULL;
+	VertexInsersionCallbackCtx_ = pFunc;
+	pVertexInsersionContext_ = pContext;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::RegisterHeuristicToGoalCallbackFunction
+/**
+ *  \param  pFunc [T_HeuristicToGoalCallbackFunctionCtx] The function, NULL to remove it.
+ *  \param  pContext [void*] User data given back to \c pFunc.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Re-entrant version of the A* heuristic.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunctionCtx pFunc, void* pContext )
+{
+	HeuristicToGoalCallbackFunction_ = NULL;
+	HeuristicToGoalCallbackFunctionCtx_ = pFunc;
+	pHeuristicToGoalContext_ = pContext;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::CallWeightCallback
+/**
+ *  \param  Vert [GW_GeodesicVertex&] Current vertex.
+ *  \return [GW_Float] The metric at this vertex.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Dispatch to the registered weight callback, plain or re-entrant.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_GeodesicMesh::CallWeightCallback( GW_GeodesicVertex& Vert )
+{
+	if( WeightCallbackCtx_!=NULL )
+		return WeightCallbackCtx_( Vert, pWeightContext_ );
+	return WeightCallback_( Vert );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::CallForceStopCallback
+/**
+ *  \param  Vert [GW_GeodesicVertex&] The vertex that has just been frozen.
+ *  \return [GW_Bool] Should the marching stop ?
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Bool GW_GeodesicMesh::CallForceStopCallback( GW_GeodesicVertex& Vert )
+{
+	if( ForceStopCallbackCtx_!=NULL )
+		return ForceStopCallbackCtx_( Vert, pForceStopContext_ );
+	if( ForceStopCallback_!=NULL )
+		return ForceStopCallback_( Vert );
+	return GW_False;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::CallNewDeadVertexCallback
+/**
+ *  \param  Vert [GW_GeodesicVertex&] The vertex that has just been frozen.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::CallNewDeadVertexCallback( GW_GeodesicVertex& Vert )
+{
+	if( NewDeadVertexCallbackCtx_!=NULL )
+		NewDeadVertexCallbackCtx_( Vert, pNewDeadVertexContext_ );
+	else if( NewDeadVertexCallback_!=NULL )
+		NewDeadVertexCallback_( Vert );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::CallVertexInsersionCallback
+/**
+ *  \param  Vert [GW_GeodesicVertex&] The far vertex reached by the front.
+ *  \param  rNewDist [GW_Float] Its tentative distance.
+ *  \return [GW_Bool] Should it be inserted in the heap ? True when no callback is set.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Bool GW_GeodesicMesh::CallVertexInsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist )
+{
+	if( VertexInsersionCallbackCtx_!=NULL )
+		return VertexInsersionCallbackCtx_( Vert, rNewDist, pVertexInsersionContext_ );
+	if( VertexInsersionCallback_!=NULL )
+		return VertexInsersionCallback_( Vert, rNewDist );
+	return GW_True;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::CallHeuristicToGoalCallback
+/**
+ *  \param  Vert [GW_GeodesicVertex&] The vertex entering the heap.
+ *  \return [GW_Float] Its estimated distance to the goal, 0 when no callback is set.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_GeodesicMesh::CallHeuristicToGoalCallback( GW_GeodesicVertex& Vert )
+{
+	if( HeuristicToGoalCallbackFunctionCtx_!=NULL )
+		return HeuristicToGoalCallbackFunctionCtx_( Vert, pHeuristicToGoalContext_ );
+	if( HeuristicToGoalCallbackFunction_!=NULL )
+		return HeuristicToGoalCallbackFunction_( Vert );
+	return 0;
 }
 
 
@@ -197,8 +405,7 @@ GW_Bool GW_GeodesicMesh::PerformFastMarchingOneStep()
 	ActiveVertex_.pop_back();
 	pCurVert->SetState( GW_GeodesicVertex::kDead );
 
-	if( NewDeadVertexCallback_!=NULL )
-		NewDeadVertexCallback_( *pCurVert );
+	this->CallNewDeadVertexCallback( *pCurVert );
 
 #if 0	// just for debug
 	for( IT_GeodesicVertexVector it = ActiveVertex_.begin(); it!=ActiveVertex_.end(); ++it )
@@ -239,10 +446,10 @@ GW_Bool GW_GeodesicMesh::PerformFastMarchingOneStep()
 			switch( pNewVert->GetState() ) {
 			case GW_GeodesicVertex::kFar:
 				/* ask to the callback if we should update this vertex and add it to the path */
-				if( VertexInsersionCallback_==NULL ||
-					VertexInsersionCallback_( *pNewVert,rNewDistance ) )
+				if( this->CallVertexInsersionCallback( *pNewVert,rNewDistance ) )
 				{
 					pNewVert->SetDistance( rNewDistance );
+					pNewVert->SetHeuristicToGoal( this->CallHeuristicToGoalCallback(*pNewVert) );
 					/* add the vertex to the heap */
 					ActiveVertex_.push_back( pNewVert );
 					std::push_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
@@ -284,8 +491,8 @@ GW_Bool GW_GeodesicMesh::PerformFastMarchingOneStep()
 	/* have we finished ? */
 	bIsMarchingEnd_ = ActiveVertex_.empty();
 	/* the user can force ending of the algorithm */
-	if( ForceStopCallback_!=NULL && bIsMarchingEnd_==GW_False )
-		bIsMarchingEnd_ = ForceStopCallback_(*pCurVert);
+	if( bIsMarchingEnd_==GW_False )
+		bIsMarchingEnd_ = this->CallForceStopCallback(*pCurVert);
 
 	return bIsMarchingEnd_;
 }
@@ -307,7 +514,7 @@ GW_INLINE
 GW_Float GW_GeodesicMesh::ComputeVertexDistance( GW_GeodesicFace& CurrentFace, GW_GeodesicVertex& CurrentVertex, 
 												 GW_GeodesicVertex& Vert1, GW_GeodesicVertex& Vert2, GW_GeodesicVertex& CurrentFront )
 {	
-	GW_Float F = this->WeightCallback_( CurrentVertex );
+	GW_Float F = this->CallWeightCallback( CurrentVertex );
 
 	if( Vert1.GetState()!=GW_GeodesicVertex::kFar ||
 		Vert2.GetState()!=GW_GeodesicVertex::kFar )
@@ -669,6 +876,8 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterVertexInsersionCallbackFunction( T_VertexInsersionCallbackFunction pFunc )
 {
 	VertexInsersionCallback_ = pFunc;
+	VertexInsersionCallbackCtx_ = NULL;
+	pVertexInsersionContext_ = NULL;
 }
 
 /*------------------------------------------------------------------------------*/
@@ -685,6 +894,8 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterNewDeadVertexCallbackFunction( T_NewDeadVertexCallbackFunction pFunc )
 {
 	NewDeadVertexCallback_ = pFunc;
+	NewDeadVertexCallbackCtx_ = NULL;
+	pNewDeadVertexContext_ = NULL;
 }
 
 /*------------------------------------------------------------------------------*/
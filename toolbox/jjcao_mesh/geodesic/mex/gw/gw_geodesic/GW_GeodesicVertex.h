@@ -55,6 +55,8 @@ public:
     //@{
 	GW_Float GetDistance();
 	void SetDistance( GW_Float rDistance );
+	GW_Float GetHeuristicToGoal();
+	void SetHeuristicToGoal( GW_Float rHeuristicToGoal );
 	void SetState( T_GeodesicVertexState nState );
 	T_GeodesicVertexState GetState();
 	GW_GeodesicVertex* GetFront();
@@ -142,6 +144,8 @@ private:
 
 	/** current distance */
 	GW_Float rDistance_;
+	/** estimated remaining distance to the goal, added to the distance to order the heap (A*) */
+	GW_Float rHeuristicToGoal_;
 	/** state of the vertex : can be far/alive/dead */
 	T_GeodesicVertexState nState_;
 	/** The vertex from which the front this vertex is in started.
@@ -24,6 +24,7 @@ GW_INLINE
 GW_GeodesicVertex::GW_GeodesicVertex()
 :	GW_Vertex	(),
 	rDistance_	( GW_INFINITE ),
+	rHeuristicToGoal_	( 0 ),
 	nState_		( kFar ),
 	pFront_		( NULL ),
 	bIsStoppingVertex_	( GW_False ),
@@ -80,6 +81,36 @@ void GW_GeodesicVertex::SetDistance( GW_Float rDistance )
 	rDistance_ = rDistance;
 }
 
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicVertex::GetHeuristicToGoal
+/**
+ *  \return [GW_Float] Estimated distance to the goal.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_GeodesicVertex::GetHeuristicToGoal()
+{
+	return rHeuristicToGoal_;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicVertex::SetHeuristicToGoal
+/**
+ *  \param  rHeuristicToGoal [GW_Float] Estimated distance to the goal.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Set by the mesh when a heuristic callback is registered, 0 otherwise.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicVertex::SetHeuristicToGoal( GW_Float rHeuristicToGoal )
+{
+	rHeuristicToGoal_ = rHeuristicToGoal;
+}
+
 /*------------------------------------------------------------------------------*/
 // Name : GW_GeodesicVertex::SetState
 /**
@@ -154,13 +185,14 @@ void GW_GeodesicVertex::SetFront( GW_GeodesicVertex* pFront )
  *  \author Gabriel Peyr?
  *  \date   4-10-2003
  * 
- *  Compare the distance of the 2 vertex. Used by the heap sorter.
+ *  Compare the distance of the 2 vertex, plus their heuristic to the goal
+ *  if any. Used by the heap sorter.
  */
 /*------------------------------------------------------------------------------*/
 GW_INLINE
 GW_Bool GW_GeodesicVertex::CompareVertex(GW_GeodesicVertex* pVert1, GW_GeodesicVertex* pVert2)
 {
-	return pVert1->GetDistance()>pVert2->GetDistance();
+	return pVert1->GetDistance()+pVert1->GetHeuristicToGoal() > pVert2->GetDistance()+pVert2->GetHeuristicToGoal();
 }
 
 /*------------------------------------------------------------------------------*/
@@ -176,6 +208,7 @@ GW_INLINE
 void GW_GeodesicVertex::ResetGeodesicVertex()
 {
 	rDistance_	= GW_INFINITE;
+	rHeuristicToGoal_	= 0;
 	nState_		= kFar;
 	pFront_		= NULL;
 	bIsStoppingVertex_	= GW_False;
@@ -561,7 +561,8 @@ void GW_Parameterization::SplitMesh( GW_GeodesicMesh& Mesh )
 	GeodesicPath.ComputePath( *pAwayAnother, 10000 );
 	/* add the path to the mesh */
 	GW_OutputComment("Extracting the cut.");
-	GW_VoronoiMesh::AddPathToMeshVertex( Mesh, GeodesicPath, VertPath );
+	T_VertexPathMultiMap BoundaryEdgeMap;
+	GW_VoronoiMesh::AddPathToMeshVertex( Mesh, GeodesicPath, VertPath, BoundaryEdgeMap );
 	/* remove redundant vertices */
 	T_GeodesicVertexList VertPath2;
 	Mesh.CheckIntegrity();
@@ -686,7 +687,10 @@ void GW_Parameterization::SplitMesh( GW_GeodesicMesh& Mesh )
 
 
 
-void GW_Parameterization::BuildConformalMatrix( GW_Mesh& Mesh, GW_SparseMatrix& K, const GW_MatrixNxP* M)
+/* The builders only use SetRowSize/SetData, so they are shared by
+   the LASPACK matrix and the CSR matrix. */
+template<class T_SparseMatrix>
+static void BuildConformalMatrix_Generic( GW_Mesh& Mesh, T_SparseMatrix& K, const GW_MatrixNxP* M )
 {
 	GW_U32 p = Mesh.GetNbrVertex();
 	for( GW_U32 i=0; i<p; ++i )
@@ -776,14 +780,15 @@ void GW_Parameterization::BuildConformalMatrix( GW_Mesh& Mesh, GW_SparseMatrix&
 
 
 
-void GW_Parameterization::BuildTutteMatrix( GW_Mesh& Mesh, GW_SparseMatrix& K )
+template<class T_SparseMatrix>
+static void BuildTutteMatrix_Generic( GW_Mesh& Mesh, T_SparseMatrix& K )
 {
 	GW_U32 p = Mesh.GetNbrVertex();
 	for( GW_U32 i=0; i<p; ++i )
 	{
 		GW_Vertex* pVerti = Mesh.GetVertex(i);
 		GW_U32 nNeigSize_i = pVerti->GetNumberNeighbor();
-		K.SetRowSize(i,nNeigSize_i);
+		K.SetRowSize(i,nNeigSize_i+1);
 		GW_Float rTotalWeight = 0;
 		for( GW_VertexIterator it = pVerti->BeginVertexIterator(); it!=pVerti->EndVertexIterator(); ++it )
 		{
@@ -797,6 +802,30 @@ void GW_Parameterization::BuildTutteMatrix( GW_Mesh& Mesh, GW_SparseMatrix& K )
 	}
 }
 
+void GW_Parameterization::BuildConformalMatrix( GW_Mesh& Mesh, GW_SparseMatrix& K, const GW_MatrixNxP* M)
+{
+	BuildConformalMatrix_Generic( Mesh, K, M );
+}
+
+void GW_Parameterization::BuildTutteMatrix( GW_Mesh& Mesh, GW_SparseMatrix& K )
+{
+	BuildTutteMatrix_Generic( Mesh, K );
+}
+
+void GW_Parameterization::BuildConformalMatrix( GW_Mesh& Mesh, GW_SparseMatrixCSR& K )
+{
+	K.Reset( Mesh.GetNbrVertex() );
+	BuildConformalMatrix_Generic( Mesh, K, (const GW_MatrixNxP*) NULL );
+	K.Finalize();
+}
+
+void GW_Parameterization::BuildTutteMatrix( GW_Mesh& Mesh, GW_SparseMatrixCSR& K )
+{
+	K.Reset( Mesh.GetNbrVertex() );
+	BuildTutteMatrix_Generic( Mesh, K );
+	K.Finalize();
+}
+
 void GW_Parameterization::ResolutionSpectral( GW_MatrixNxP& K, GW_MatrixNxP& L, GW_U32 EIG )
 {
 	GW_U32 p = L.GetNbrCols();
@@ -816,6 +845,136 @@ void GW_Parameterization::ResolutionSpectral( GW_MatrixNxP& K, GW_MatrixNxP& L,
 	}
 }
 
+/* operators for the Lanczos iterations ******************************************/
+/** y = K*x for a dense symmetric matrix */
+class GW_DenseOperator
+{
+public:
+	GW_DenseOperator( GW_MatrixNxP& K ) : K_(K) {}
+	void Apply( const GW_VectorND& x, GW_VectorND& y )
+	{
+		GW_U32 p = K_.GetNbrRows();
+		for( GW_U32 i=0; i<p; ++i )
+		{
+			GW_Float rVal = 0;
+			for( GW_U32 j=0; j<p; ++j )
+				rVal += K_[i][j]*x[j];
+			y[i] = rVal;
+		}
+	}
+private:
+	GW_MatrixNxP& K_;
+};
+/** y = (A)^-1*x using a factorization of A */
+class GW_ShiftInvertOperator
+{
+public:
+	GW_ShiftInvertOperator( GW_SparseCholesky& Factor ) : Factor_(Factor) {}
+	void Apply( const GW_VectorND& x, GW_VectorND& y )
+	{
+		Factor_.Solve( y, x );
+	}
+private:
+	GW_SparseCholesky& Factor_;
+};
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ResolutionSpectralLanczos
+/**
+ *  \param  K [GW_MatrixNxP&] A symmetric matrix whose eigenvalues are the embedding.
+ *  \param  L [GW_MatrixNxP&] The position of the vertices.
+ *  \param  EIG [GW_U32] Index of the first eigenvector used.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Same as the SVD version for a symmetric K (e.g. geodesic isomap), but only the
+ *  EIG+2 leading eigenvectors are computed, with O(p^2) work per Lanczos step
+ *  instead of a full O(p^3) SVD.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::ResolutionSpectralLanczos( GW_MatrixNxP& K, GW_MatrixNxP& L, GW_U32 EIG )
+{
+	GW_U32 p = L.GetNbrCols();
+	GW_U32 EIG1 = EIG;
+	GW_U32 EIG2 = EIG+1;
+	GW_DenseOperator Op( K );
+	GW_MatrixNxP U;
+	GW_VectorND Vp;
+	GW_Lanczos::ComputeLargestEigen( Op, p, EIG2+1, U, Vp );
+	GW_Float rScaleX = GW_ABS(Vp[EIG1]);
+	GW_Float rScaleY = GW_ABS(Vp[EIG2]);
+	for( GW_U32 i=0; i<p; ++i )
+	{
+		L.SetData(0,i, U.GetData(i,EIG1)/rScaleX );
+		L.SetData(1,i, U.GetData(i,EIG2)/rScaleY );
+	}
+}
+
+/* A = -K+sigma*Id */
+void GW_Parameterization::BuildShiftedSystem( GW_SparseMatrixCSR& K, GW_Float sigma, GW_SparseMatrixCSR& A )
+{
+	GW_U32 p = K.GetDim();
+	A.Reset( p );
+	for( GW_U32 i=0; i<p; ++i )
+	{
+		A.SetRowSize( i, K.GetRowSize(i)+1 );
+		for( GW_U32 entry=0; entry<K.GetRowSize(i); ++entry )
+		{
+			GW_U32 j;
+			GW_Float val = K.AccessEntry( i, entry, j );
+			A.SetData( i, j, -val );
+		}
+		A.SetData( i, i, sigma-K.GetData(i,i) );
+	}
+	A.Finalize();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ResolutionSpectral
+/**
+ *  \param  K [GW_SparseMatrixCSR&] A laplacian-like weight matrix (tutte or conformal).
+ *  \param  L [GW_MatrixNxP&] The position of the vertices.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ * 
+ *  Embedding given by the two smallest non-constant eigenvectors of -K.
+ *  They are computed by Lanczos on (-K+sigma*Id)^-1, the constant vector being
+ *  deflated, so that only one sparse factorization is needed.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::ResolutionSpectral( GW_SparseMatrixCSR& K, GW_MatrixNxP& L )
+{
+	GW_U32 p = K.GetDim();
+	/* small shift so that -K+sigma*Id is not singular */
+	GW_Float sigma = 1e-8*K.GetGershgorinBound();
+	GW_SparseMatrixCSR A;
+	GW_Parameterization::BuildShiftedSystem( K, sigma, A );
+
+	GW_SparseCholesky Factor;
+	if( !Factor.Factorize(A) )
+	{
+		GW_OutputComment("Spectral resolution : the matrix can't be factorized.");
+		GW_ASSERT( GW_False );
+		return;
+	}
+	GW_ShiftInvertOperator Op( Factor );
+	std::vector<GW_VectorND> Deflation( 1, GW_VectorND(p, 1/sqrt((GW_Float) p)) );
+	GW_MatrixNxP U;
+	GW_VectorND Vp;
+	GW_U32 nNbrConverged = GW_Lanczos::ComputeLargestEigen( Op, p, 2, U, Vp, &Deflation );
+	if( nNbrConverged<2 )
+		GW_OutputComment("Warning, the Lanczos iterations have not fully converged.");
+	for( GW_U32 k=0; k<2; ++k )
+	{
+		/* eigenvalue of -K, as in the dense version we normalize by it */
+		GW_Float rScale = 1/Vp[k]-sigma;
+		if( rScale<=0 )
+			rScale = 1;
+		for( GW_U32 i=0; i<p; ++i )
+			L.SetData(k,i, U.GetData(i,k)/rScale );
+	}
+}
+
 void GW_Parameterization::SolveSystem( GW_SparseMatrix& M, GW_VectorND& x, GW_VectorND& b )
 {
 #define USE_ERR_APPROX
@@ -1039,19 +1198,19 @@ void GW_Parameterization::ResolutionBoundaryFree( GW_Mesh& Mesh, GW_SparseMatrix
 
 
 /*------------------------------------------------------------------------------*/
-// Name : GW_Parameterization::ResolutionBoundaryFixed
+// Name : GW_Parameterization::ComputeBoundaryPositions
 /**
-*  \param  VoronoiMesh [GW_VoronoiMesh&] The coarse mesh to flatten.
-*  \param  K [GW_MatrixNxP&] The weight matrix for the flattening.
-*  \param   L [GW_MatrixNxP&] The position of the vertices.
-*  \param  M [GW_MatrixNxP&] The distance matrix.
+*  \param  Mesh [GW_Mesh&] The mesh to flatten.
+*  \param  Positions [T_Vector2DMap&] Output, position of the boundary points.
+*  \return GW_False if the mesh has no boundary.
 *  \author Gabriel Peyr?
 *  \date   1-24-2004
 * 
-*  Solve the flattening problem using boundary fixed formulation.
+*  Place the boundary on the unit circle (or on a convex polygon when the
+*  trissector information are given), shared by the boundary fixed solvers.
 */
 /*------------------------------------------------------------------------------*/
-void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrix& K, GW_MatrixNxP&  L, 
+GW_Bool GW_Parameterization::ComputeBoundaryPositions( GW_Mesh& Mesh, T_Vector2DMap& Positions, 
 								T_Vector2DMap* pInitialPos, T_TrissectorInfoMap* pTrissectorInfoMap, 
 								T_TrissectorInfoVector* pCyclicPosition )
 {
@@ -1062,13 +1221,12 @@ void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatri
 	{
 		GW_OutputComment("Closed mesh, can't flatten this mesh.");
 		GW_ASSERT( GW_False );
-		return;
+		return GW_False;
 	}
 	if( boundary_list.size()>1 )
 		GW_OutputComment("Warning, this mesh has more than 1 boundary.");
 	T_VertexList boundary = boundary_list.front();
 	/* find vertex position **************************************************/
-	T_Vector2DMap Positions;	// position of boundary points
 	if( pInitialPos!=NULL )
 	{
 		Positions = *pInitialPos;
@@ -1105,7 +1263,7 @@ void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatri
 		}
 		GW_ASSERT( it_start != boundary.end() );
 		if( it_start==boundary.end() )
-			return;
+			return GW_False;
 		/* now extract each sub-boundary */
 		std::list<T_VertexList> boundary_pieces;
 		IT_VertexList it_cur = it_start;
@@ -1179,6 +1337,30 @@ void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatri
 		}
 
 	}
+	return GW_True;
+}
+
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ResolutionBoundaryFixed
+/**
+*  \param  VoronoiMesh [GW_VoronoiMesh&] The coarse mesh to flatten.
+*  \param  K [GW_MatrixNxP&] The weight matrix for the flattening.
+*  \param   L [GW_MatrixNxP&] The position of the vertices.
+*  \param  M [GW_MatrixNxP&] The distance matrix.
+*  \author Gabriel Peyr?
+*  \date   1-24-2004
+* 
+*  Solve the flattening problem using boundary fixed formulation.
+*/
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrix& K, GW_MatrixNxP&  L, 
+								T_Vector2DMap* pInitialPos, T_TrissectorInfoMap* pTrissectorInfoMap, 
+								T_TrissectorInfoVector* pCyclicPosition )
+{
+	T_Vector2DMap Positions;	// position of boundary points
+	if( !GW_Parameterization::ComputeBoundaryPositions( Mesh, Positions, pInitialPos, pTrissectorInfoMap, pCyclicPosition ) )
+		return;
 	/* set up the new matrix ****************************************************/
 	GW_U32 p = Mesh.GetNbrVertex();
 	for( IT_Vector2DMap it=Positions.begin(); it!=Positions.end(); ++it )
@@ -1212,6 +1394,153 @@ void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatri
 }
 
 
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ResolutionBoundaryFixed
+/**
+*  \param  Mesh [GW_Mesh&] The coarse mesh to flatten.
+*  \param  K [GW_SparseMatrixCSR&] The weight matrix for the flattening, not modified.
+*  \param  L [GW_MatrixNxP&] The position of the vertices.
+*  \param  pFactorization [GW_SparseCholesky*] Cache for the factorization of the interior system.
+*  \author JJCAO
+*  \date   10-17-2026
+* 
+*  Boundary fixed formulation solved by a direct method. The boundary unknowns
+*  are eliminated, which leaves the symmetric system -K_II x_I = K_IB x_B.
+*  It is factorized once and back-substituted for both coordinates. If
+*  \c pFactorization is given and holds the factorization of this very -K_II
+*  (same pattern and values), it is reused, otherwise it is recomputed.
+*/
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, GW_MatrixNxP&  L, 
+								GW_SparseCholesky* pFactorization, T_Vector2DMap* pInitialPos, 
+								T_TrissectorInfoMap* pTrissectorInfoMap, T_TrissectorInfoVector* pCyclicPosition )
+{
+	T_Vector2DMap Positions;	// position of boundary points
+	if( !GW_Parameterization::ComputeBoundaryPositions( Mesh, Positions, pInitialPos, pTrissectorInfoMap, pCyclicPosition ) )
+		return;
+	/* number the interior vertices *********************************************/
+	GW_U32 p = Mesh.GetNbrVertex();
+	std::vector<GW_I32> Interior(p, -1);	// interior number, -1 for boundary vertices
+	GW_U32 nNbrInterior = 0;
+	for( GW_U32 i=0; i<p; ++i )
+		if( Positions.find(i)==Positions.end() )
+			Interior[i] = nNbrInterior++;
+
+	/* assemble -K_II **********************************************************/
+	GW_SparseMatrixCSR A(nNbrInterior);
+	for( GW_U32 i=0; i<p; ++i )
+	{
+		if( Interior[i]<0 )
+			continue;
+		A.SetRowSize( Interior[i], K.GetRowSize(i) );
+		for( GW_U32 entry=0; entry<K.GetRowSize(i); ++entry )
+		{
+			GW_U32 j;
+			GW_Float val = K.AccessEntry( i, entry, j );
+			if( Interior[j]>=0 )
+				A.SetData( Interior[i], Interior[j], -val );
+		}
+	}
+	A.Finalize();
+
+	/* factorize, unless the cache already holds the factor of this very matrix */
+	GW_SparseCholesky LocalFactorization;
+	GW_SparseCholesky* pFactor = pFactorization!=NULL ? pFactorization : &LocalFactorization;
+	if( !pFactor->IsFactorizationOf(A) )
+	{
+		cout << "  * Factorization." << endl;
+		if( !pFactor->Factorize(A) )
+		{
+			GW_ASSERT( GW_False );
+			return;
+		}
+	}
+
+	/* solve the system *********************************************************/
+	GW_VectorND b(nNbrInterior), x(nNbrInterior);
+	for( GW_U32 coord = 0; coord<2; ++coord )
+	{
+		/* build RHS : b = K_IB x_B */
+		for( GW_U32 i=0; i<p; ++i )
+		{
+			if( Interior[i]<0 )
+				continue;
+			GW_Float rVal = 0;
+			for( GW_U32 entry=0; entry<K.GetRowSize(i); ++entry )
+			{
+				GW_U32 j;
+				GW_Float val = K.AccessEntry( i, entry, j );
+				if( Interior[j]<0 )
+					rVal += val*Positions[j][coord];
+			}
+			b[Interior[i]] = rVal;
+		}
+		pFactor->Solve( x, b );
+
+		for( GW_U32 j=0; j<p; ++j )
+		{
+			if( Interior[j]<0 )
+				L.SetData(coord,j, Positions[j][coord] );
+			else
+				L.SetData(coord,j, x[Interior[j]] );
+		}
+	}
+}
+
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::BenchmarkSparseSolvers
+/**
+*  \param  Mesh [GW_Mesh&] The mesh, typically 10^5 to 10^6 vertices.
+*  \param  s [std::ostream&] Output stream.
+*  \param  nMaxCholesky [GW_U32] Largest system that is factorized.
+*  \author JJCAO
+*  \date   10-17-2026
+* 
+*  Time the solvers of GW_SparseMatrixCSR (product, iterative solve with no /
+*  Jacobi / multicolor SSOR preconditioner) and the sparse Cholesky on the
+*  Tutte and conformal systems of the mesh. The matrices are shifted so that
+*  closed meshes give definite systems too.
+*
+*  CG is only timed on systems known to be symmetric positive definite,
+*  BiCGSTAB otherwise : the conformal weights are negative on obtuse
+*  triangles, so that system may be neither diagonally dominant nor
+*  definite. Definiteness is read from the pivots of the Cholesky factor,
+*  which is only computed up to \c nMaxCholesky unknowns (its fill grows
+*  like p^1.5 on a mesh), above that only diagonal dominance is checked.
+*  gw_geodesic/test runs this benchmark on grid meshes of 10^5 and 10^6 vertices.
+*/
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::BenchmarkSparseSolvers( GW_Mesh& Mesh, std::ostream& s, GW_U32 nMaxCholesky )
+{
+	const char* Names[2] = { "Tutte", "Conformal" };
+	for( GW_U32 type=0; type<2; ++type )
+	{
+		GW_SparseMatrixCSR K, A;
+		GW_Float t = GW_SparseMatrixCSR::GetTime();
+		if( type==0 )
+			BuildTutteMatrix( Mesh, K );
+		else
+			BuildConformalMatrix( Mesh, K );
+		s << Names[type] << " system (built in " << GW_SparseMatrixCSR::GetTime()-t << "s)." << endl;
+		BuildShiftedSystem( K, 1e-6*K.GetGershgorinBound(), A );
+		GW_Bool bSymmetric = A.IsSymmetric();
+		GW_Bool bSymmetricDefinite = bSymmetric && A.IsDiagonallyDominant();
+		if( bSymmetric && A.GetDim()<=nMaxCholesky )
+		{
+			GW_SparseCholesky Factor;
+			t = GW_SparseMatrixCSR::GetTime();
+			Factor.Factorize( A );
+			s << "    Cholesky : " << GW_SparseMatrixCSR::GetTime()-t << "s, " << Factor.GetNbrNonZero() << " non zero." << endl;
+			bSymmetricDefinite = Factor.IsPositiveDefinite();
+		}
+		if( !bSymmetricDefinite )
+			s << "    Not known to be symmetric positive definite, BiCGSTAB is used." << endl;
+		GW_SparseMatrixCSR::Benchmark( A, s, 1e-8, 5000, bSymmetricDefinite );
+	}
+}
+
+
 /*------------------------------------------------------------------------------*/
 // Name : GW_Parameterization::ParameterizeMesh
 /**
@@ -1268,8 +1597,8 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 	}
 
 	GW_U32 EIG = 0;
-	GW_MatrixNxP K_full(p,p,0.0);	// a symmetric matrix whose eigenvalues are the embedding
-	GW_SparseMatrix	K_sparse(p);
+	GW_MatrixNxP K_full;			// a symmetric matrix whose eigenvalues are the embedding
+	GW_SparseMatrixCSR K_csr(p);	// the same for sparse weights
 	GW_Bool bUseSparse = GW_False;
 	
 	switch(ParamType) 
@@ -1279,6 +1608,7 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 			GW_MatrixNxP J(p,p,-1.0/p);			// centering matrix
 			for( GW_U32 i=0; i<p; ++i )
 				J[i][i] += 1;
+			K_full.Reset(p,p);
 			K_full = (J*M*J)*(-0.5);
 			EIG = 0;	// first eigenvalue
 		}
@@ -1286,7 +1616,7 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 	case kTutte:
 		{
 			/* build the weight matrix */
-			BuildTutteMatrix(VoronoiMesh, K_sparse);			
+			BuildTutteMatrix(VoronoiMesh, K_csr);
 			EIG = p-2;	// first eigenvalue
 			bUseSparse = GW_True;
 		}
@@ -1294,7 +1624,7 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 	case kGeodesicConformal:
 		{
 			/* build the weight matrix */
-			BuildConformalMatrix(VoronoiMesh, K_sparse, &M);
+			BuildConformalMatrix(VoronoiMesh, K_csr);
 			EIG = p-2;	//	first eigenvalue
 			bUseSparse = GW_True;
 		}
@@ -1309,19 +1639,35 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 
 	switch(ResolType) {
 	case kSpectral:
-	//	if( bUseSparse )
-	//		K_full.BuildFromSparse(K_sparse);
-		ResolutionSpectral( K_full, L, EIG );
+		if( bUseSparse )
+			ResolutionSpectral( K_csr, L );
+		else
+			ResolutionSpectralLanczos( K_full, L, EIG );
 		break;
 	case kBoundaryFree:
-		if( !bUseSparse )
-			K_sparse.BuildFromFull(K_full);
-		ResolutionBoundaryFree( VoronoiMesh, K_sparse, L, &M );
+		{
+			GW_SparseMatrix	K_sparse(p);
+			if( bUseSparse )
+			{
+				if( ParamType==kTutte )
+					BuildTutteMatrix(VoronoiMesh, K_sparse);
+				else
+					BuildConformalMatrix(VoronoiMesh, K_sparse, &M);
+			}
+			else
+				K_sparse.BuildFromFull(K_full);
+			ResolutionBoundaryFree( VoronoiMesh, K_sparse, L, &M );
+		}
 		break;
 	case kBoundaryFixed:
-		if( !bUseSparse )
+		if( bUseSparse )
+			ResolutionBoundaryFixed( VoronoiMesh, K_csr, L );
+		else
+		{
+			GW_SparseMatrix	K_sparse(p);
 			K_sparse.BuildFromFull(K_full);
-		ResolutionBoundaryFixed( VoronoiMesh, K_sparse,L );
+			ResolutionBoundaryFixed( VoronoiMesh, K_sparse, L );
+		}
 	default:
 		break;
 	};
@@ -15,6 +15,9 @@
 #include "../gw_core/GW_ProgressBar.h"
 #include "GW_GeodesicMesh.h"
 #include "GW_VoronoiMesh.h"
+#include "../gw_maths/GW_SparseMatrixCSR.h"
+#include "../gw_maths/GW_SparseCholesky.h"
+#include "../gw_maths/GW_Lanczos.h"
 
 namespace GW {
 
@@ -195,6 +198,16 @@ public:
 			T_Vector2DMap* pInitialPos = NULL, T_TrissectorInfoMap* pTrissectorInfoMap = NULL, 
 			T_TrissectorInfoVector* pCyclicPosition = NULL );
 
+	/* sparse (CSR) path, scales to large base meshes ****************************/
+	static void BuildConformalMatrix( GW_Mesh& VoronoiMesh, GW_SparseMatrixCSR& K );
+	static void BuildTutteMatrix( GW_Mesh& VoronoiMesh, GW_SparseMatrixCSR& K );
+	static void ResolutionSpectral( GW_SparseMatrixCSR& K, GW_MatrixNxP& L );
+	static void ResolutionSpectralLanczos( GW_MatrixNxP& K, GW_MatrixNxP& L, GW_U32 EIG = 0 );
+	static void ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, GW_MatrixNxP&  L, 
+			GW_SparseCholesky* pFactorization = NULL, T_Vector2DMap* pInitialPos = NULL, 
+			T_TrissectorInfoMap* pTrissectorInfoMap = NULL, T_TrissectorInfoVector* pCyclicPosition = NULL );
+	static void BenchmarkSparseSolvers( GW_Mesh& Mesh, std::ostream& s = cout, GW_U32 nMaxCholesky = 200000 );
+
 	void ParameterizeRegion( GW_GeodesicVertex& Seed, GW_GeodesicMesh& BaseDomain );
 	void ParameterizeAllRegions( T_GeodesicVertexList& VertList );
     //@}
@@ -243,6 +256,9 @@ private:
 
 	/* system resolution *********************************************************************/
 	static void SolveSystem( GW_SparseMatrix& M, GW_VectorND& x, GW_VectorND& b );
+	static void BuildShiftedSystem( GW_SparseMatrixCSR& K, GW_Float sigma, GW_SparseMatrixCSR& A );
+	static GW_Bool ComputeBoundaryPositions( GW_Mesh& Mesh, T_Vector2DMap& Positions, 
+			T_Vector2DMap* pInitialPos, T_TrissectorInfoMap* pTrissectorInfoMap, T_TrissectorInfoVector* pCyclicPosition );
 
 	/** record information about a cut */
 	class GW_EdgeCut
@@ -21,14 +21,6 @@
 
 using namespace GW;
 
-T_VoronoiVertexList GW_VoronoiMesh::CurrentTargetVertex_;
-GW_VoronoiVertex* GW_VoronoiMesh::pCurrentVoronoiVertex_ = NULL;
-T_VoronoiVertexMap GW_VoronoiMesh::VoronoiVertexMap_;
-T_VertexPathMultiMap GW_VoronoiMesh::BoundaryEdgeMap_;
-
-GW_U32 GW_VoronoiMesh::nNbrBaseVertex_RD_	= 0;
-T_FloatMap* GW_VoronoiMesh::pCurWeights_	= NULL;
-
 /*------------------------------------------------------------------------------*/
 // Name : GW_VoronoiMesh::PerformFastMarching
 /**
@@ -248,6 +240,7 @@ GW_U32 GW_VoronoiMesh::AddFurthestPointsIterate( T_GeodesicVertexList& VertList,
 // Name : GW_VoronoiMesh::FastMarchingCallbackFunction_MeshBuilding
 /**
 *  \param  CurVert [GW_GeodesicVertex&] The current vertex.
+*  \param  pContext [void*] The GW_VoronoiMesh being built.
 *  \return [GW_Bool] The new dead vertex.
 *  \author Gabriel Peyr?
 *  \date   5-13-2003
@@ -255,12 +248,14 @@ GW_U32 GW_VoronoiMesh::AddFurthestPointsIterate( T_GeodesicVertexList& VertList,
 *  Test if the vertex is a saddle point. 
 */
 /*------------------------------------------------------------------------------*/
-void GW_VoronoiMesh::FastMarchingCallbackFunction_MeshBuilding( GW_GeodesicVertex& CurVert )
+void GW_VoronoiMesh::FastMarchingCallbackFunction_MeshBuilding( GW_GeodesicVertex& CurVert, void* pContext )
 {
+	GW_VoronoiMesh* pThis = (GW_VoronoiMesh*) pContext;
+	GW_ASSERT( pThis!=NULL );
 	GW_GeodesicVertex* pFront = CurVert.GetFront();
 	GW_ASSERT( pFront!=NULL );
 	/* retrieve the voronoi vertex corresponding to the front */
-	GW_VoronoiVertex* pVoronoiVert0 = GW_VoronoiMesh::GetVoronoiFromGeodesic( *pFront );
+	GW_VoronoiVertex* pVoronoiVert0 = pThis->GetVoronoiFromGeodesic( *pFront );
 	GW_ASSERT( pVoronoiVert0!=NULL );
 	/* test if this point is a saddle point */
 	for( GW_VertexIterator it=CurVert.BeginVertexIterator(); it!=CurVert.EndVertexIterator(); ++it )
@@ -270,7 +265,7 @@ void GW_VoronoiMesh::FastMarchingCallbackFunction_MeshBuilding( GW_GeodesicVerte
 		if( pNeighborFront!=NULL && pNeighborFront!=pFront )
 		{
 			/* that's it ! */
-			GW_VoronoiVertex* pVoronoiVert1 = GW_VoronoiMesh::GetVoronoiFromGeodesic( *pNeighborFront );
+			GW_VoronoiVertex* pVoronoiVert1 = pThis->GetVoronoiFromGeodesic( *pNeighborFront );
 			GW_ASSERT( pVoronoiVert1!=NULL );
 			if( !pVoronoiVert0->IsNeighbor(*pVoronoiVert1) )
 			{
@@ -359,6 +354,7 @@ GW_Bool GW_VoronoiMesh::TestManifoldStructure( GW_VoronoiVertex& Vert0, GW_Voron
 void GW_VoronoiMesh::CreateVoronoiVertex()
 {
 	/* Create Vornoi vertex and make the inverse map GeodesicVertex->VoronoiVertex */
+	VoronoiVertexMap_.clear();
 	this->SetNbrVertex( (GW_U32) BaseVertexList_.size() );
 	GW_U32 nNum = 0;
 	for( IT_GeodesicVertexList it = BaseVertexList_.begin(); it!=BaseVertexList_.end(); ++it )
@@ -433,7 +429,7 @@ void GW_VoronoiMesh::BuildMesh( GW_GeodesicMesh& Mesh, GW_Bool bFixHole )
 
 	GW_OutputComment("Computing voronoi diagrams.");
 	/* perform once more a firestart to set up connectivity */		
-	Mesh.RegisterNewDeadVertexCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_MeshBuilding );
+	Mesh.RegisterNewDeadVertexCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_MeshBuilding, this );
 	Mesh.ResetGeodesicMesh();
 	GW_VoronoiMesh::PerformFastMarching( Mesh, BaseVertexList_ );
 	Mesh.RegisterNewDeadVertexCallbackFunction( NULL );
@@ -645,16 +641,17 @@ GW_Face& GW_VoronoiMesh::CreateNewFace()
 *  \author Gabriel Peyr?
 *  \date   4-12-2003
 * 
-*  A callback function for geodesic computations.
+*  A callback function for geodesic computations, \c pContext is the GW_VoronoiMesh.
 */
 /*------------------------------------------------------------------------------*/
-GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_Boundaries( GW_GeodesicVertex& CurVert )
+GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_Boundaries( GW_GeodesicVertex& CurVert, void* pContext )
 {
+	GW_VoronoiVertex* pCurrentVoronoiVertex = ((GW_VoronoiMesh*) pContext)->pCurrentVoronoiVertex_;
 	// \todo for the moment propagate on the full neighborhood
 //	for( IT_VoronoiVertexList it=CurrentTargetVertex_.begin(); it!=CurrentTargetVertex_.end(); ++it )
 //	{
-	GW_ASSERT( pCurrentVoronoiVertex_!=NULL );
-	for( GW_VertexIterator it=pCurrentVoronoiVertex_->BeginVertexIterator(); it!=pCurrentVoronoiVertex_->EndVertexIterator(); ++it )
+	GW_ASSERT( pCurrentVoronoiVertex!=NULL );
+	for( GW_VertexIterator it=pCurrentVoronoiVertex->BeginVertexIterator(); it!=pCurrentVoronoiVertex->EndVertexIterator(); ++it )
 	{
 		GW_VoronoiVertex* pVornoiVert = (GW_VoronoiVertex*) *it;
 		GW_ASSERT( pVornoiVert!=NULL );
@@ -677,7 +674,7 @@ GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_Boundaries( GW_GeodesicVert
 /*------------------------------------------------------------------------------*/
 void GW_VoronoiMesh::BuildGeodesicBoundaries( GW_GeodesicMesh& Mesh )
 {
-	Mesh.RegisterForceStopCallbackFunction( FastMarchingCallbackFunction_Boundaries );
+	Mesh.RegisterForceStopCallbackFunction( FastMarchingCallbackFunction_Boundaries, this );
 
 	VertexPathMap_.clear();
 	GeodesicDistanceMap_.clear();
@@ -723,7 +720,7 @@ void GW_VoronoiMesh::BuildGeodesicBoundaries( GW_GeodesicMesh& Mesh )
 			GW_GeodesicPath GeodesicPath;
 			GeodesicPath.ComputePath( *pGeodesicVert, 5000 );
 			/* convert the path into vertex */
-			this->AddPathToMeshVertex( Mesh, GeodesicPath, *pVertexGeodesicEdge );
+			GW_VoronoiMesh::AddPathToMeshVertex( Mesh, GeodesicPath, *pVertexGeodesicEdge, BoundaryEdgeMap_ );
 		}			
 	}
 
@@ -753,6 +750,7 @@ void GW_VoronoiMesh::BuildGeodesicBoundaries( GW_GeodesicMesh& Mesh )
 		}
 	}
 
+	pCurrentVoronoiVertex_ = NULL;
 	Mesh.RegisterForceStopCallbackFunction( NULL );
 	Mesh.ResetGeodesicMesh();
 }
@@ -762,13 +760,15 @@ void GW_VoronoiMesh::BuildGeodesicBoundaries( GW_GeodesicMesh& Mesh )
 // Name : GW_VoronoiMesh::AddPathToMeshVertex
 /**
  *  \param  CurPath [T_GeodesicVertexList&] The path to test.
+ *  \param  BoundaryEdgeMap [T_VertexPathMultiMap&] The edges of the paths already added, updated.
  *  \author Gabriel Peyr?
  *  \date   5-14-2003
  * 
  *  Test for path intersection and fix cracks.
  */
 /*------------------------------------------------------------------------------*/
-void GW_VoronoiMesh::AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath& GeodesicPath, T_GeodesicVertexList& VertexPath )
+void GW_VoronoiMesh::AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath& GeodesicPath, T_GeodesicVertexList& VertexPath,
+										  T_VertexPathMultiMap& BoundaryEdgeMap )
 {
 	GW_GeodesicVertex* pPrevVert = NULL;
 	T_GeodesicPointList& PointList = GeodesicPath.GetPointList();
@@ -835,9 +835,9 @@ void GW_VoronoiMesh::AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath
 
 		/* to avoid to reprocess already processed lists */
 		std::list<T_GeodesicVertexList*> PathToProccess;
-		IT_VertexPathMultiMultiMap itIntersectedPath = BoundaryEdgeMap_.find(nID);
+		IT_VertexPathMultiMultiMap itIntersectedPath = BoundaryEdgeMap.find(nID);
 		if( bIsNewVertCreated )		// fix only if new vertex is added
-		while( itIntersectedPath!=BoundaryEdgeMap_.end() &&  itIntersectedPath->first==nID )
+		while( itIntersectedPath!=BoundaryEdgeMap.end() &&  itIntersectedPath->first==nID )
 		{
 			PathToProccess.push_back( itIntersectedPath->second );
 			itIntersectedPath++;
@@ -865,11 +865,11 @@ void GW_VoronoiMesh::AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath
 				/* insert new vertex in path */
 				pIntersectedPath->insert( itIntersec, pNewVert );
 				/* divide previous edge in two */
-				// BoundaryEdgeMap_.erase( nID );	// \todo find the correct iterator and remove it
+				// BoundaryEdgeMap.erase( nID );	// \todo find the correct iterator and remove it
 				nID = GW_Vertex::ComputeUniqueId( *pVert1, *pNewVert );
-				BoundaryEdgeMap_.insert( std::pair<GW_U32, T_GeodesicVertexList*>( nID, pIntersectedPath ) );
+				BoundaryEdgeMap.insert( std::pair<GW_U32, T_GeodesicVertexList*>( nID, pIntersectedPath ) );
 				nID = GW_Vertex::ComputeUniqueId( *pVert2, *pNewVert );
-				BoundaryEdgeMap_.insert( std::pair<GW_U32, T_GeodesicVertexList*>( nID, pIntersectedPath ) );
+				BoundaryEdgeMap.insert( std::pair<GW_U32, T_GeodesicVertexList*>( nID, pIntersectedPath ) );
 			}
 			else
 				GW_ASSERT( GW_False );
@@ -881,7 +881,7 @@ void GW_VoronoiMesh::AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath
 		{	
 			nID = GW_Vertex::ComputeUniqueId( *pPrevVert, *pNewVert );
 			pPrevVert = pNewVert;
-			BoundaryEdgeMap_.insert( std::pair<GW_U32, T_GeodesicVertexList*>( nID, &VertexPath ) );
+			BoundaryEdgeMap.insert( std::pair<GW_U32, T_GeodesicVertexList*>( nID, &VertexPath ) );
 		}
 	}	
 }
@@ -892,17 +892,18 @@ void GW_VoronoiMesh::AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath
 *  \author Gabriel Peyr?
 *  \date   4-12-2003
 * 
-*  A callback function for geodesic computations.
+*  A callback function for geodesic computations, \c pContext is the GW_VoronoiMesh.
 */
 /*------------------------------------------------------------------------------*/
-GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_Parametrization( GW_GeodesicVertex& CurVert )
+GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_Parametrization( GW_GeodesicVertex& CurVert, void* pContext )
 {
-	GW_ASSERT( pCurrentVoronoiVertex_!=NULL );
+	GW_VoronoiVertex* pCurrentVoronoiVertex = ((GW_VoronoiMesh*) pContext)->pCurrentVoronoiVertex_;
+	GW_ASSERT( pCurrentVoronoiVertex!=NULL );
 
 	if( !CurVert.GetIsStoppingVertex() || !CurVert.GetBoundaryReached() )
 	{
 		/* add the parameter value */
-		CurVert.AddParameterVertex( *pCurrentVoronoiVertex_, CurVert.GetDistance() );
+		CurVert.AddParameterVertex( *pCurrentVoronoiVertex, CurVert.GetDistance() );
 		if( CurVert.GetIsStoppingVertex() )
 			CurVert.SetBoundaryReached( GW_True );
 	}
@@ -964,13 +965,13 @@ void GW_VoronoiMesh::PerformLocalFastMarching( GW_GeodesicMesh& Mesh, GW_Voronoi
 /*------------------------------------------------------------------------------*/
 void GW_VoronoiMesh::BuildGeodesicParametrization( GW_GeodesicMesh& Mesh )
 {
-	Mesh.RegisterForceStopCallbackFunction( FastMarchingCallbackFunction_Parametrization );
+	Mesh.RegisterForceStopCallbackFunction( FastMarchingCallbackFunction_Parametrization, this );
 	Mesh.ResetParametrizationData();
 	/* for each base vertex, perform front propagation on the surrounding faces */
 	for( GW_U32 i=0; i<this->GetNbrVertex(); ++i )
 	{
 		CurrentTargetVertex_.clear();
-		pCurrentVoronoiVertex_ = (GW_VoronoiVertex*) this->GetVertex(i);	// set up global data for callback function
+		pCurrentVoronoiVertex_ = (GW_VoronoiVertex*) this->GetVertex(i);	// set up the data read by the callback function
 		GW_ASSERT( pCurrentVoronoiVertex_!=NULL );
 
 		GW_OutputComment("Performing local fast marching.");
@@ -1308,13 +1309,14 @@ void GW_VoronoiMesh::FlattenBasePoints( GW_GeodesicMesh& Mesh, T_Vector2DMap& Fl
 *  Here we only record the natural neighbors in the weights map.
 */
 /*------------------------------------------------------------------------------*/
-GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD1( GW_GeodesicVertex& CurVert, GW_Float rNewDist )
+GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD1( GW_GeodesicVertex& CurVert, GW_Float rNewDist, void* pContext )
 {
-	GW_ASSERT( pCurWeights_!=NULL );
+	T_FloatMap* pCurWeights = ((GW_VoronoiMesh*) pContext)->pCurWeights_;
+	GW_ASSERT( pCurWeights!=NULL );
 	GW_GeodesicInformationDuplicata* pDuplicata = (GW_GeodesicInformationDuplicata*) CurVert.GetUserData();
 	GW_ASSERT( pDuplicata!=NULL );
 	GW_U32 nId = pDuplicata->pFront_->GetID();
-	(*pCurWeights_)[ nId ] = -1;	// this is one of our natural neighbor, yeah.
+	(*pCurWeights)[ nId ] = -1;	// this is one of our natural neighbor, yeah.
 	return pDuplicata->rDistance_+GW_EPSILON >= rNewDist;
 }
 
@@ -1331,20 +1333,22 @@ GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD1( GW_Geod
 *  Here we record the reciprocical of the distance.
 */
 /*------------------------------------------------------------------------------*/
-GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD2( GW_GeodesicVertex& CurVert, GW_Float rNewDist )
+GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD2( GW_GeodesicVertex& CurVert, GW_Float rNewDist, void* pContext )
 {
-	GW_ASSERT( pCurWeights_!=NULL );
+	GW_VoronoiMesh* pThis = (GW_VoronoiMesh*) pContext;
+	T_FloatMap* pCurWeights = pThis->pCurWeights_;
+	GW_ASSERT( pCurWeights!=NULL );
 	GW_U32 nId = CurVert.GetID();
-	if( pCurWeights_->find(nId)!=pCurWeights_->end() )	// this is one of our natural neighbor, yeah.
+	if( pCurWeights->find(nId)!=pCurWeights->end() )	// this is one of our natural neighbor, yeah.
 	{
-		if( (*pCurWeights_)[nId]<0 )
+		if( (*pCurWeights)[nId]<0 )
 		{
 			/* first time we encounter this vertex, sounds good */
 			if( rNewDist>0 )
-				(*pCurWeights_)[nId] = 1.0/(rNewDist);
+				(*pCurWeights)[nId] = 1.0/(rNewDist);
 			else
-				(*pCurWeights_)[nId] = GW_INFINITE;
-			nNbrBaseVertex_RD_++;
+				(*pCurWeights)[nId] = GW_INFINITE;
+			pThis->nNbrBaseVertex_RD_++;
 		}
 		else
 			GW_ASSERT( GW_False );
@@ -1353,9 +1357,10 @@ GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD2( GW_Geod
 }
 
 
-GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_ForceStopRD( GW_GeodesicVertex& Vert )
+GW_Bool GW_VoronoiMesh::FastMarchingCallbackFunction_ForceStopRD( GW_GeodesicVertex& Vert, void* pContext )
 {
-	return nNbrBaseVertex_RD_>=pCurWeights_->size();
+	GW_VoronoiMesh* pThis = (GW_VoronoiMesh*) pContext;
+	return pThis->nNbrBaseVertex_RD_>=pThis->pCurWeights_->size();
 }
 
 
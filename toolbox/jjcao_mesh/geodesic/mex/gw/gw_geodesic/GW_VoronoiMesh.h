@@ -132,8 +132,8 @@ public:
 	
 	/* \todo Should be private */
 	void PerformLocalFastMarching( GW_GeodesicMesh& Mesh, GW_VoronoiVertex& Vert );
-	static GW_Bool FastMarchingCallbackFunction_Parametrization( GW_GeodesicVertex& CurVert );
-	static GW_VoronoiVertex* pCurrentVoronoiVertex_;
+	static GW_Bool FastMarchingCallbackFunction_Parametrization( GW_GeodesicVertex& CurVert, void* pContext );
+	GW_VoronoiVertex* pCurrentVoronoiVertex_;
 	static void PerformFastMarching( GW_GeodesicMesh& OriginalMesh, T_GeodesicVertexList& VertList );
 
 	/** helpers for furthest point building */
@@ -155,8 +155,9 @@ public:
 	};
 
 	/** intermediate variable for boundaries bulding */
-	static T_VertexPathMultiMap BoundaryEdgeMap_;
-	static void AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath& GeodesicPath, T_GeodesicVertexList& VertexPath );	
+	T_VertexPathMultiMap BoundaryEdgeMap_;
+	static void AddPathToMeshVertex( GW_GeodesicMesh& Mesh, GW_GeodesicPath& GeodesicPath, T_GeodesicVertexList& VertexPath,
+									T_VertexPathMultiMap& BoundaryEdgeMap );	
 
 private:
 
@@ -172,15 +173,15 @@ private:
 	T_FloatMap GeodesicDistanceMap_;
 
 	/** helpers for mesh building */	
-	static T_VoronoiVertexMap VoronoiVertexMap_;
-	static void FastMarchingCallbackFunction_MeshBuilding( GW_GeodesicVertex& CurVert );
-	static GW_VoronoiVertex* GetVoronoiFromGeodesic( GW_GeodesicVertex& Vert );
+	T_VoronoiVertexMap VoronoiVertexMap_;
+	static void FastMarchingCallbackFunction_MeshBuilding( GW_GeodesicVertex& CurVert, void* pContext );
+	GW_VoronoiVertex* GetVoronoiFromGeodesic( GW_GeodesicVertex& Vert );
 	static GW_Bool TestManifoldStructure( GW_VoronoiVertex& Vert1, GW_VoronoiVertex& Vert2 );
 	void FixHole();
 
 	/** helper for parametrization building */
-	static T_VoronoiVertexList CurrentTargetVertex_;
-	static GW_Bool FastMarchingCallbackFunction_Boundaries( GW_GeodesicVertex& CurVert );
+	T_VoronoiVertexList CurrentTargetVertex_;
+	static GW_Bool FastMarchingCallbackFunction_Boundaries( GW_GeodesicVertex& CurVert, void* pContext );
 	T_VertexPathMap VertexPathMap_;
 	void ComputeVertexParameters( GW_GeodesicMesh& Mesh );
 
@@ -200,11 +201,11 @@ public:
 	static void PrepareInterpolation( GW_GeodesicMesh& Mesh );
 
 	/** helpers for reciprocical distance interpolation */
-	static GW_U32 nNbrBaseVertex_RD_;
-	static T_FloatMap* pCurWeights_;
-	static GW_Bool FastMarchingCallbackFunction_VertexInsersionRD1( GW_GeodesicVertex& CurVert, GW_Float rNewDist );
-	static GW_Bool FastMarchingCallbackFunction_VertexInsersionRD2( GW_GeodesicVertex& CurVert, GW_Float rNewDist );
-	static GW_Bool FastMarchingCallbackFunction_ForceStopRD( GW_GeodesicVertex& Vert );
+	GW_U32 nNbrBaseVertex_RD_;
+	T_FloatMap* pCurWeights_;
+	static GW_Bool FastMarchingCallbackFunction_VertexInsersionRD1( GW_GeodesicVertex& CurVert, GW_Float rNewDist, void* pContext );
+	static GW_Bool FastMarchingCallbackFunction_VertexInsersionRD2( GW_GeodesicVertex& CurVert, GW_Float rNewDist, void* pContext );
+	static GW_Bool FastMarchingCallbackFunction_ForceStopRD( GW_GeodesicVertex& Vert, void* pContext );
 
 };
 
@@ -24,7 +24,10 @@ namespace GW {
 GW_INLINE
 GW_VoronoiMesh::GW_VoronoiMesh()
 :	GW_Mesh(),
-	bInterpolationPreparationDone_( GW_False )
+	pCurrentVoronoiVertex_	( NULL ),
+	bInterpolationPreparationDone_( GW_False ),
+	nNbrBaseVertex_RD_		( 0 ),
+	pCurWeights_			( NULL )
 {
 	/* NOTHING */
 }
@@ -88,6 +91,8 @@ void GW_VoronoiMesh::Reset()
 		GW_DELETE(pVertList);
 	}
 	VertexPathMap_.clear();
+	VoronoiVertexMap_.clear();
+	BoundaryEdgeMap_.clear();
 }
 
 /*------------------------------------------------------------------------------*/
@@ -855,7 +860,7 @@ void GW_VoronoiMesh::GetReciprocicalDistanceWeights( T_FloatMap& Weights, GW_Geo
 	}
 
 	Weights.clear();
-	pCurWeights_		= &Weights;
+	pCurWeights_		= &Weights;	// read back by the callbacks through their context
 	nNbrBaseVertex_RD_	= 0;
 
 	/* special case for original point */
@@ -870,14 +875,14 @@ void GW_VoronoiMesh::GetReciprocicalDistanceWeights( T_FloatMap& Weights, GW_Geo
 
 	/* First step : compute the natural neighbors ************************************************/
 	/* perform a Fast Marching from the point */
-	Mesh.RegisterVertexInsersionCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD1 );
+	Mesh.RegisterVertexInsersionCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD1, this );
 	GW_VoronoiMesh::ResetOnlyVertexState( Mesh );
 	Mesh.PerformFastMarching( &Vert  );
 
 	/* Second step : compute the weights *********************************************************/
 	/* perform a Fast Marching from the point */
-	Mesh.RegisterVertexInsersionCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD2 );
-	Mesh.RegisterForceStopCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_ForceStopRD );
+	Mesh.RegisterVertexInsersionCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_VertexInsersionRD2, this );
+	Mesh.RegisterForceStopCallbackFunction( GW_VoronoiMesh::FastMarchingCallbackFunction_ForceStopRD, this );
 	Mesh.ResetGeodesicMesh();
 	Mesh.PerformFastMarching( &Vert  );
 
@@ -891,6 +896,7 @@ void GW_VoronoiMesh::GetReciprocicalDistanceWeights( T_FloatMap& Weights, GW_Geo
 
 	Mesh.RegisterVertexInsersionCallbackFunction( NULL );
 	Mesh.RegisterForceStopCallbackFunction( NULL );
+	pCurWeights_ = NULL;
 }
 
 
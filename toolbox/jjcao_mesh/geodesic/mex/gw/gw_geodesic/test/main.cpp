@@ -0,0 +1,67 @@
+/** This is a benchmark application for the sparse solvers of GW_Parameterization.
+	Usage : test [w1 w2 ...], each w gives a w x w grid mesh (default 320 and 1000,
+	i.e. about 10^5 and 10^6 vertices). */
+
+#include "../GW_Parameterization.h"
+
+using namespace GW;
+
+/** regular grid of the unit square lifted on a bump, with a random jitter so
+	that the conformal weights are not all equal. */
+static void BuildGridMesh( GW_Mesh& Mesh, GW_U32 w )
+{
+	GW_U32 nNbrVert = w*w;
+	GW_U32 nNbrFace = 2*(w-1)*(w-1);
+	GW_Float h = 1.0/(w-1);
+	Mesh.SetNbrVertex( nNbrVert );
+	for( GW_U32 i=0; i<nNbrVert; ++i )
+	{
+		GW_Float x = (i%w)*h, y = (i/w)*h;
+		if( i%w>0 && i%w<w-1 && i/w>0 && i/w<w-1 )
+		{
+			x += 0.3*h*(GW_RAND-0.5);
+			y += 0.3*h*(GW_RAND-0.5);
+		}
+		GW_Vertex& Vert = Mesh.CreateNewVertex();
+		Vert.SetPosition( GW_Vector3D(x, y, 0.2*sin(GW_PI*x)*sin(GW_PI*y)) );
+		Mesh.SetVertex( i, &Vert );
+	}
+	Mesh.SetNbrFace( nNbrFace );
+	GW_U32 f = 0;
+	for( GW_U32 j=0; j+1<w; ++j )
+	for( GW_U32 i=0; i+1<w; ++i )
+	{
+		GW_U32 a = i+j*w;
+		GW_Face& Face1 = Mesh.CreateNewFace();
+		Face1.SetVertex( *Mesh.GetVertex(a), *Mesh.GetVertex(a+1), *Mesh.GetVertex(a+w) );
+		Mesh.SetFace( f++, &Face1 );
+		GW_Face& Face2 = Mesh.CreateNewFace();
+		Face2.SetVertex( *Mesh.GetVertex(a+1), *Mesh.GetVertex(a+w+1), *Mesh.GetVertex(a+w) );
+		Mesh.SetFace( f++, &Face2 );
+	}
+	Mesh.BuildConnectivity();
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<GW_U32> SizeList;
+	for( int i=1; i<argc; ++i )
+		SizeList.push_back( (GW_U32) atoi(argv[i]) );
+	if( SizeList.empty() )
+	{
+		SizeList.push_back( 320 );
+		SizeList.push_back( 1000 );
+	}
+	cout << "############################################################" << endl;
+	cout << "     GeoWave Parameterization  --  Sparse solvers benchmark" << endl;
+	cout << "############################################################" << endl;
+	for( GW_U32 k=0; k<SizeList.size(); ++k )
+	{
+		GW_Mesh Mesh;
+		BuildGridMesh( Mesh, SizeList[k] );
+		cout << "Grid mesh " << SizeList[k] << "x" << SizeList[k] << ", " << Mesh.GetNbrVertex() << " vertices." << endl;
+		GW_Parameterization::BenchmarkSparseSolvers( Mesh, cout );
+	}
+	cout << "############################################################" << endl;
+	return 0;
+}
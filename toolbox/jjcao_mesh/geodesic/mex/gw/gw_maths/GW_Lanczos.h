@@ -0,0 +1,229 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_Lanczos.h
+ *  \brief  Definition of class \c GW_Lanczos
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_LANCZOS_H_
+#define _GW_LANCZOS_H_
+
+#include "GW_MathsConfig.h"
+#include "GW_VectorND.h"
+#include "GW_MatrixNxP.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_Lanczos
+ *  \brief  A few extremal eigenpairs of a symmetric operator.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ *
+ *  Lanczos iteration with full re-orthogonalization. The operator is only
+ *  accessed through its product, so \c T_Operator must provide
+ *  \code
+ *  void Apply( const GW_VectorND& x, GW_VectorND& y );	// y = A*x
+ *  \endcode
+ *  Use a shift-invert operator (see \c GW_SparseCholesky) to get the smallest
+ *  eigenvalues of a Laplacian.
+ *
+ *  Directions already known (e.g. the constant vector for a Laplacian) can be
+ *  deflated by passing them in \c pDeflation, they must be orthonormal.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_Lanczos
+{
+public:
+
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  \param  Op [T_Operator&] The symmetric operator.
+	 *  \param  n [GW_U32] Dimension of the operator.
+	 *  \param  nNbrEig [GW_U32] Number of eigenpairs wanted.
+	 *  \param  EigVect [GW_MatrixNxP&] n x nNbrEig, the eigenvectors in columns.
+	 *  \param  EigVal [GW_VectorND&] The eigenvalues, in decreasing order.
+	 *  \param  pDeflation [std::vector<GW_VectorND>*] Orthonormal vectors to ignore.
+	 *  \param  eps [GW_Float] Relative precision on the Ritz residuals.
+	 *  \param  nMaxIter [GW_U32] Maximum dimension of the Krylov space.
+	 *  \return Number of eigenpairs that have converged.
+	 *
+	 *  Compute the \c nNbrEig largest (algebraic) eigenpairs of \c Op.
+	 */
+	/*------------------------------------------------------------------------------*/
+	template<class T_Operator>
+	static GW_U32 ComputeLargestEigen( T_Operator& Op, GW_U32 n, GW_U32 nNbrEig, GW_MatrixNxP& EigVect, GW_VectorND& EigVal,
+									const std::vector<GW_VectorND>* pDeflation = NULL, GW_Float eps = 1e-10, GW_U32 nMaxIter = 300 )
+	{
+		GW_U32 nDeflation = pDeflation==NULL ? 0 : (GW_U32) pDeflation->size();
+		GW_ASSERT( nNbrEig+nDeflation<=n );
+		nMaxIter = GW_MIN( nMaxIter, n-nDeflation );
+		nMaxIter = GW_MAX( nMaxIter, nNbrEig );
+
+		std::vector<GW_VectorND> Q;		// the Lanczos basis
+		std::vector<GW_Float> Alpha, Beta;
+		GW_VectorND q(n), w(n);
+
+		/* random start vector */
+		for( GW_U32 i=0; i<n; ++i )
+			q[i] = GW_RAND-0.5;
+		GW_Lanczos::Orthogonalize( q, pDeflation, Q );
+		GW_Lanczos::Normalize( q );
+
+		GW_MatrixNxP S;			// eigenvectors of the tridiagonal matrix
+		std::vector<GW_U32> Order;	// indices of the Ritz values, largest first
+		GW_U32 nNbrConverged = 0;
+		GW_U32 m = 0;
+		for( m=0; m<nMaxIter; )
+		{
+			Q.push_back( q );
+			Op.Apply( q, w );
+			GW_Lanczos::Orthogonalize( w, pDeflation, Q, &Alpha );
+			m++;
+			GW_Float rBeta = GW_Lanczos::Norm( w );
+			Beta.push_back( rBeta );
+			GW_Bool bInvariant = rBeta<=eps*GW_ABS(Alpha.back()) || rBeta==0;
+
+			/* check convergence of the Ritz pairs */
+			if( m>=nNbrEig && ( m%5==0 || bInvariant || m==nMaxIter ) )
+			{
+				GW_Lanczos::SolveTridiagonal( Alpha, Beta, m, S, Order );
+				nNbrConverged = 0;
+				for( GW_U32 k=0; k<nNbrEig; ++k )
+				{
+					GW_U32 nCol = Order[k];
+					GW_Float rTheta = GW_ABS( S.GetData(m,nCol) );	// the Ritz value is stored on row m
+					GW_Float rResidual = GW_ABS( rBeta*S.GetData(m-1,nCol) );
+					if( rResidual<=eps*GW_MAX(rTheta,1e-30) || bInvariant )
+						nNbrConverged++;
+				}
+				if( nNbrConverged==nNbrEig )
+					break;
+			}
+			if( bInvariant )
+				break;
+			/* TNT arrays share their data on copy, so allocate the next basis vector */
+			GW_VectorND qNext(n);
+			for( GW_U32 i=0; i<n; ++i )
+				qNext[i] = w[i]/rBeta;
+			q = qNext;
+		}
+		if( Order.size()<nNbrEig || S.GetNbrRows()!=m+1 )
+			GW_Lanczos::SolveTridiagonal( Alpha, Beta, m, S, Order );
+
+		/* Ritz vectors */
+		nNbrEig = GW_MIN( nNbrEig, m );
+		EigVect.Reset( n, nNbrEig );
+		EigVal.Reset( nNbrEig );
+		for( GW_U32 k=0; k<nNbrEig; ++k )
+		{
+			GW_U32 nCol = Order[k];
+			EigVal[k] = S.GetData(m,nCol);
+			for( GW_U32 i=0; i<n; ++i )
+			{
+				GW_Float rVal = 0;
+				for( GW_U32 j=0; j<m; ++j )
+					rVal += Q[j][i]*S.GetData(j,nCol);
+				EigVect[i][k] = rVal;
+			}
+		}
+		return nNbrConverged;
+	}
+
+private:
+
+	static GW_Float Dot( const GW_VectorND& a, const GW_VectorND& b )
+	{
+		GW_Float rDot = 0;
+		for( GW_U32 i=0; i<a.GetDim(); ++i )
+			rDot += a[i]*b[i];
+		return rDot;
+	}
+	static GW_Float Norm( const GW_VectorND& a )
+	{
+		return sqrt( GW_Lanczos::Dot(a,a) );
+	}
+	static void Normalize( GW_VectorND& a )
+	{
+		GW_Float rNorm = GW_Lanczos::Norm(a);
+		if( rNorm>0 )
+			for( GW_U32 i=0; i<a.GetDim(); ++i )
+				a[i] /= rNorm;
+	}
+	static void AddScaled( GW_VectorND& a, GW_Float s, const GW_VectorND& b )
+	{
+		for( GW_U32 i=0; i<a.GetDim(); ++i )
+			a[i] += s*b[i];
+	}
+
+	/** Remove from \c w its components along the deflated space and the Lanczos basis.
+		Two Gram-Schmidt passes, the first projection on the last basis vector is the
+		Lanczos coefficient alpha. */
+	static void Orthogonalize( GW_VectorND& w, const std::vector<GW_VectorND>* pDeflation,
+						const std::vector<GW_VectorND>& Q, std::vector<GW_Float>* pAlpha = NULL )
+	{
+		for( GW_U32 pass=0; pass<2; ++pass )
+		{
+			if( pDeflation!=NULL )
+				for( GW_U32 k=0; k<pDeflation->size(); ++k )
+					GW_Lanczos::AddScaled( w, -GW_Lanczos::Dot( w, (*pDeflation)[k] ), (*pDeflation)[k] );
+			for( GW_I32 j=(GW_I32) Q.size()-1; j>=0; --j )
+			{
+				GW_Float rProj = GW_Lanczos::Dot( w, Q[j] );
+				if( pass==0 && pAlpha!=NULL && j==(GW_I32) Q.size()-1 )
+					pAlpha->push_back( rProj );
+				GW_Lanczos::AddScaled( w, -rProj, Q[j] );
+			}
+		}
+	}
+
+	/** Eigen-decomposition of the m x m tridiagonal matrix. On output S is (m+1) x m :
+		the first m rows are the eigenvectors, row m stores the eigenvalues. */
+	static void SolveTridiagonal( const std::vector<GW_Float>& Alpha, const std::vector<GW_Float>& Beta, GW_U32 m,
+								GW_MatrixNxP& S, std::vector<GW_U32>& Order )
+	{
+		GW_MatrixNxP T(m,m,0.0);
+		for( GW_U32 i=0; i<m; ++i )
+		{
+			T[i][i] = Alpha[i];
+			if( i+1<m )
+			{
+				T[i][i+1] = Beta[i];
+				T[i+1][i] = Beta[i];
+			}
+		}
+		GW_MatrixNxP V(m,m);
+		GW_VectorND RealEig(m);
+		T.Eigenvalue( V, NULL, &RealEig, NULL );
+		S.Reset( m+1, m );
+		std::vector< std::pair<GW_Float,GW_U32> > Sorted(m);
+		for( GW_U32 j=0; j<m; ++j )
+		{
+			for( GW_U32 i=0; i<m; ++i )
+				S[i][j] = V[i][j];
+			S[m][j] = RealEig[j];
+			Sorted[j] = std::make_pair( -RealEig[j], j );
+		}
+		std::sort( Sorted.begin(), Sorted.end() );
+		Order.resize(m);
+		for( GW_U32 j=0; j<m; ++j )
+			Order[j] = Sorted[j].second;
+	}
+
+};
+
+} // End namespace GW
+
+
+#endif // _GW_LANCZOS_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr?
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,321 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_SparseCholesky.h
+ *  \brief  Definition of class \c GW_SparseCholesky
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_SPARSECHOLESKY_H_
+#define _GW_SPARSECHOLESKY_H_
+
+#include "GW_MathsConfig.h"
+#include "GW_VectorND.h"
+#include "GW_SparseMatrixCSR.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_SparseCholesky
+ *  \brief  Sparse LDL^T factorization of a symmetric matrix.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ *
+ *  Up-looking LDL^T (see T. Davis, "Algorithm 849: a concise sparse Cholesky
+ *  factorization package") on a reverse Cuthill-McKee ordering of the matrix.
+ *  The input must store both triangles, as the parameterization builders do.
+ *
+ *  Once \c Factorize has succeeded, \c Solve only performs the two triangular
+ *  back-substitutions, so the object is meant to be kept and reused for every
+ *  right hand side sharing the same matrix. A copy of the factorized matrix is
+ *  kept so that \c IsFactorizationOf can tell a cached factor from a stale one.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_SparseCholesky
+{
+public:
+
+	GW_SparseCholesky()
+	{
+		nDim_ = 0;
+		bFactorized_ = GW_False;
+	}
+
+	GW_Bool IsFactorized() const
+	{
+		return bFactorized_;
+	}
+	GW_U32 GetDim() const
+	{
+		return nDim_;
+	}
+	GW_U32 GetNbrNonZero() const
+	{
+		return (GW_U32) Li_.size();
+	}
+	/** GW_True if every pivot of D is positive, i.e. the factorized matrix is positive definite. */
+	GW_Bool IsPositiveDefinite() const
+	{
+		if( !bFactorized_ )
+			return GW_False;
+		for( GW_U32 k=0; k<nDim_; ++k )
+			if( D_[k]<=0 )
+				return GW_False;
+		return GW_True;
+	}
+	void Clear()
+	{
+		nDim_ = 0;
+		bFactorized_ = GW_False;
+		Perm_.clear(); PermInv_.clear();
+		Lp_.clear(); Li_.clear(); Lx_.clear(); D_.clear();
+		Ap_.clear(); Ai_.clear(); Ax_.clear();
+	}
+
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  \param  A [GW_SparseMatrixCSR&] Symmetric matrix.
+	 *  \return GW_True if the stored factor was computed from exactly this matrix
+	 *			(same size, same pattern and same values).
+	 */
+	/*------------------------------------------------------------------------------*/
+	GW_Bool IsFactorizationOf( const GW_SparseMatrixCSR& A ) const
+	{
+		if( !bFactorized_ || A.GetDim()!=nDim_ || A.GetNbrNonZero()!=Ai_.size() )
+			return GW_False;
+		const GW_U32* Ap = A.GetRowPtr();
+		const GW_U32* Ai = A.GetColInd();
+		const GW_Float* Ax = A.GetValues();
+		for( GW_U32 i=0; i<=nDim_; ++i )
+			if( Ap[i]!=Ap_[i] )
+				return GW_False;
+		for( GW_U32 k=0; k<Ai_.size(); ++k )
+			if( Ai[k]!=Ai_[k] || Ax[k]!=Ax_[k] )
+				return GW_False;
+		return GW_True;
+	}
+
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  \param  A [GW_SparseMatrixCSR&] Symmetric matrix, both triangles stored.
+	 *  \return GW_False if a zero pivot was met.
+	 *
+	 *  Compute the ordering, the elimination tree and the numerical factor.
+	 */
+	/*------------------------------------------------------------------------------*/
+	GW_Bool Factorize( const GW_SparseMatrixCSR& A )
+	{
+		this->Clear();
+		nDim_ = A.GetDim();
+		GW_U32 n = nDim_;
+		const GW_U32* Ap = A.GetRowPtr();
+		const GW_U32* Ai = A.GetColInd();
+		const GW_Float* Ax = A.GetValues();
+		Ap_.assign( Ap, Ap+n+1 );
+		Ai_.assign( Ai, Ai+Ap[n] );
+		Ax_.assign( Ax, Ax+Ap[n] );
+
+		this->ComputeOrdering( A );
+
+		/* symbolic : elimination tree and column counts *************************/
+		std::vector<GW_I32> Parent(n), Flag(n);
+		std::vector<GW_U32> Lnz(n);
+		for( GW_U32 k=0; k<n; ++k )
+		{
+			Parent[k] = -1;
+			Flag[k] = (GW_I32) k;
+			Lnz[k] = 0;
+			GW_U32 kk = Perm_[k];
+			for( GW_U32 p=Ap[kk]; p<Ap[kk+1]; ++p )
+			{
+				GW_I32 i = (GW_I32) PermInv_[ Ai[p] ];
+				if( i<(GW_I32) k )
+				{
+					for( ; Flag[i]!=(GW_I32) k; i=Parent[i] )
+					{
+						if( Parent[i]==-1 )
+							Parent[i] = (GW_I32) k;
+						Lnz[i]++;
+						Flag[i] = (GW_I32) k;
+					}
+				}
+			}
+		}
+		Lp_.resize(n+1);
+		Lp_[0] = 0;
+		for( GW_U32 k=0; k<n; ++k )
+			Lp_[k+1] = Lp_[k]+Lnz[k];
+		Li_.resize( Lp_[n] );
+		Lx_.resize( Lp_[n] );
+		D_.resize( n );
+
+		/* numeric : one row of L at a time *************************************/
+		std::vector<GW_Float> Y(n, 0);
+		std::vector<GW_U32> Pattern(n);
+		for( GW_U32 k=0; k<n; ++k )
+		{
+			GW_U32 top = n;
+			Flag[k] = (GW_I32) k;
+			Lnz[k] = 0;
+			GW_U32 kk = Perm_[k];
+			for( GW_U32 p=Ap[kk]; p<Ap[kk+1]; ++p )
+			{
+				GW_I32 i = (GW_I32) PermInv_[ Ai[p] ];
+				if( i<=(GW_I32) k )
+				{
+					Y[i] += Ax[p];
+					GW_U32 len = 0;
+					for( ; Flag[i]!=(GW_I32) k; i=Parent[i] )
+					{
+						Pattern[len++] = (GW_U32) i;
+						Flag[i] = (GW_I32) k;
+					}
+					while( len>0 )
+						Pattern[--top] = Pattern[--len];
+				}
+			}
+			D_[k] = Y[k];
+			Y[k] = 0;
+			for( ; top<n; ++top )
+			{
+				GW_U32 i = Pattern[top];
+				GW_Float yi = Y[i];
+				Y[i] = 0;
+				GW_U32 p2 = Lp_[i]+Lnz[i];
+				for( GW_U32 p=Lp_[i]; p<p2; ++p )
+					Y[ Li_[p] ] -= Lx_[p]*yi;
+				GW_Float l_ki = yi/D_[i];
+				D_[k] -= l_ki*yi;
+				Li_[p2] = k;
+				Lx_[p2] = l_ki;
+				Lnz[i]++;
+			}
+			if( D_[k]==0 )
+			{
+				cerr << "GW_SparseCholesky : zero pivot at row " << Perm_[k] << ", matrix is singular." << endl;
+				this->Clear();
+				return GW_False;
+			}
+		}
+		bFactorized_ = GW_True;
+		return GW_True;
+	}
+
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  \param  x [GW_VectorND&] Solution.
+	 *  \param  b [GW_VectorND&] Right hand side.
+	 *
+	 *  Solve A x = b with the stored factor, x and b may be the same vector.
+	 */
+	/*------------------------------------------------------------------------------*/
+	void Solve( GW_VectorND& x, const GW_VectorND& b ) const
+	{
+		GW_ASSERT( bFactorized_ );
+		GW_ASSERT( b.GetDim()==nDim_ && x.GetDim()==nDim_ );
+		GW_U32 n = nDim_;
+		std::vector<GW_Float> y(n);
+		for( GW_U32 k=0; k<n; ++k )
+			y[k] = b[ Perm_[k] ];
+		/* L y = b */
+		for( GW_U32 j=0; j<n; ++j )
+		{
+			GW_Float yj = y[j];
+			for( GW_U32 p=Lp_[j]; p<Lp_[j+1]; ++p )
+				y[ Li_[p] ] -= Lx_[p]*yj;
+		}
+		/* D y = y */
+		for( GW_U32 j=0; j<n; ++j )
+			y[j] /= D_[j];
+		/* L^T y = y */
+		for( GW_I32 j=(GW_I32) n-1; j>=0; --j )
+		{
+			GW_Float yj = y[j];
+			for( GW_U32 p=Lp_[j]; p<Lp_[j+1]; ++p )
+				yj -= Lx_[p]*y[ Li_[p] ];
+			y[j] = yj;
+		}
+		for( GW_U32 k=0; k<n; ++k )
+			x[ Perm_[k] ] = y[k];
+	}
+
+private:
+
+	/** reverse Cuthill-McKee ordering, one breadth first search per connected component. */
+	void ComputeOrdering( const GW_SparseMatrixCSR& A )
+	{
+		GW_U32 n = A.GetDim();
+		const GW_U32* Ap = A.GetRowPtr();
+		const GW_U32* Ai = A.GetColInd();
+		Perm_.clear();
+		Perm_.reserve(n);
+		std::vector<GW_Bool> Visited(n, GW_False);
+		std::vector< std::pair<GW_U32,GW_U32> > Neighbors;	// (degree,vertex)
+		/* vertices sorted by increasing degree are used as component seeds */
+		std::vector< std::pair<GW_U32,GW_U32> > Seeds(n);
+		for( GW_U32 i=0; i<n; ++i )
+			Seeds[i] = std::make_pair( Ap[i+1]-Ap[i], i );
+		std::sort( Seeds.begin(), Seeds.end() );
+		for( GW_U32 s=0; s<n; ++s )
+		{
+			GW_U32 nSeed = Seeds[s].second;
+			if( Visited[nSeed] )
+				continue;
+			GW_U32 nHead = (GW_U32) Perm_.size();
+			Perm_.push_back( nSeed );
+			Visited[nSeed] = GW_True;
+			while( nHead<Perm_.size() )
+			{
+				GW_U32 i = Perm_[nHead++];
+				Neighbors.clear();
+				for( GW_U32 p=Ap[i]; p<Ap[i+1]; ++p )
+				{
+					GW_U32 j = Ai[p];
+					if( !Visited[j] )
+					{
+						Visited[j] = GW_True;
+						Neighbors.push_back( std::make_pair( Ap[j+1]-Ap[j], j ) );
+					}
+				}
+				std::sort( Neighbors.begin(), Neighbors.end() );
+				for( GW_U32 k=0; k<Neighbors.size(); ++k )
+					Perm_.push_back( Neighbors[k].second );
+			}
+		}
+		std::reverse( Perm_.begin(), Perm_.end() );
+		PermInv_.resize(n);
+		for( GW_U32 k=0; k<n; ++k )
+			PermInv_[ Perm_[k] ] = k;
+	}
+
+	GW_U32 nDim_;
+	GW_Bool bFactorized_;
+	/** Perm_[k] is the original index of the k-th pivot */
+	std::vector<GW_U32> Perm_;
+	std::vector<GW_U32> PermInv_;
+	/** strictly lower factor, compressed by column */
+	std::vector<GW_U32> Lp_;
+	std::vector<GW_U32> Li_;
+	std::vector<GW_Float> Lx_;
+	std::vector<GW_Float> D_;
+	/** the factorized matrix, to detect stale factors */
+	std::vector<GW_U32> Ap_;
+	std::vector<GW_U32> Ai_;
+	std::vector<GW_Float> Ax_;
+
+};
+
+} // End namespace GW
+
+
+#endif // _GW_SPARSECHOLESKY_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr?
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,696 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_SparseMatrixCSR.h
+ *  \brief  Definition of class \c GW_SparseMatrixCSR
+ *  \author JJCAO
+ *  \date   10-17-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_SPARSEMATRIXCSR_H_
+#define _GW_SPARSEMATRIXCSR_H_
+
+#include "GW_MathsConfig.h"
+#include "GW_VectorND.h"
+#include "GW_SparseMatrix.h"
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_SparseMatrixCSR
+ *  \brief  A square sparse matrix in compressed sparse row storage.
+ *  \author JJCAO
+ *  \date   10-17-2026
+ *
+ *  Unlike \c GW_SparseMatrix it does not rely on \c LASPACK, so the three
+ *  arrays can be handed directly to the sparse Cholesky and Lanczos solvers.
+ *
+ *  It offers the same \c SetRowSize / \c SetData filling interface, with the
+ *  restriction that rows must be filled in increasing order. Setting twice the
+ *  same entry of a row overwrites the previous value.
+ *
+ *  When compiled with OpenMP, the matrix/vector product and the iterative
+ *  solver run in parallel over rows. The SSOR preconditioner sweeps the rows
+ *  color by color (see \c ComputeColoring) : rows of a same color are not
+ *  coupled, so each color is relaxed in parallel.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_SparseMatrixCSR
+{
+public:
+
+	GW_SparseMatrixCSR( GW_U32 nSize = 0 )
+	{
+		this->Reset( nSize );
+	}
+	GW_SparseMatrixCSR( GW_SparseMatrix& Original )
+	{
+		this->BuildFromSparse( Original );
+	}
+
+	void Reset( GW_U32 nSize )
+	{
+		nDim_ = nSize;
+		RowPtr_.assign( 1, 0 );
+		ColInd_.clear();
+		Val_.clear();
+		this->ClearColoring();
+	}
+
+	void BuildFromSparse( GW_SparseMatrix& Original )
+	{
+		GW_U32 nSize = Original.GetDim();
+		this->Reset( nSize );
+		for( GW_U32 i=0; i<nSize; ++i )
+		{
+			GW_U32 nRowSize = Original.GetRowSize(i);
+			this->SetRowSize( i, nRowSize );
+			for( GW_U32 entry=0; entry<nRowSize; ++entry )
+			{
+				GW_U32 j;
+				GW_Float val = Original.AccessEntry( i, entry, j );
+				this->SetData( i, j, val );
+			}
+		}
+		this->Finalize();
+	}
+
+	GW_U32 GetDim() const
+	{
+		return nDim_;
+	}
+	GW_U32 GetNbrNonZero() const
+	{
+		return (GW_U32) ColInd_.size();
+	}
+
+	//-------------------------------------------------------------------------
+	/** \name filling */
+	//-------------------------------------------------------------------------
+	//@{
+	/** start row \c i, \c nSize is only a hint used to reserve memory. */
+	void SetRowSize( GW_U32 i, GW_U32 nSize )
+	{
+		GW_ASSERT( i<nDim_ );
+		GW_ASSERT( i+1>=RowPtr_.size() );	// rows are filled in increasing order
+		while( RowPtr_.size()<i+2 )
+			RowPtr_.push_back( RowPtr_.back() );
+		/* grow geometrically, reserving the exact size for each row would copy the arrays every time */
+		if( ColInd_.capacity()<ColInd_.size()+nSize )
+		{
+			ColInd_.reserve( 2*(ColInd_.size()+nSize) );
+			Val_.reserve( 2*(Val_.size()+nSize) );
+		}
+	}
+	void SetData( GW_U32 i, GW_U32 j, GW_Float rVal )
+	{
+		GW_ASSERT( j<nDim_ );
+		GW_ASSERT( i+2==RowPtr_.size() );	// only the last started row can be filled
+		for( GW_U32 k=RowPtr_[i]; k<RowPtr_[i+1]; ++k )
+		{
+			if( ColInd_[k]==j )
+			{
+				Val_[k] = rVal;
+				this->ClearColoring();
+				return;
+			}
+		}
+		ColInd_.push_back( j );
+		Val_.push_back( rVal );
+		RowPtr_.back()++;
+		this->ClearColoring();
+	}
+	/** close the remaining (empty) rows, must be called once filling is done. */
+	void Finalize()
+	{
+		while( RowPtr_.size()<nDim_+1 )
+			RowPtr_.push_back( RowPtr_.back() );
+	}
+	//@}
+
+	//-------------------------------------------------------------------------
+	/** \name accessors */
+	//-------------------------------------------------------------------------
+	//@{
+	GW_U32 GetRowSize( GW_U32 i ) const
+	{
+		GW_ASSERT( i<nDim_ );
+		if( i+1>=RowPtr_.size() )
+			return 0;
+		return RowPtr_[i+1]-RowPtr_[i];
+	}
+	GW_Float AccessEntry( GW_U32 i, GW_U32 entry, GW_U32& j ) const
+	{
+		GW_ASSERT( entry<this->GetRowSize(i) );
+		j = ColInd_[RowPtr_[i]+entry];
+		return Val_[RowPtr_[i]+entry];
+	}
+	GW_Float GetData( GW_U32 i, GW_U32 j ) const
+	{
+		GW_U32 nRowSize = this->GetRowSize(i);
+		for( GW_U32 k=0; k<nRowSize; ++k )
+			if( ColInd_[RowPtr_[i]+k]==j )
+				return Val_[RowPtr_[i]+k];
+		return 0;
+	}
+	const GW_U32* GetRowPtr() const		{ return &RowPtr_[0]; }
+	const GW_U32* GetColInd() const		{ return ColInd_.empty() ? NULL : &ColInd_[0]; }
+	const GW_Float* GetValues() const	{ return Val_.empty() ? NULL : &Val_[0]; }
+	//@}
+
+	//-------------------------------------------------------------------------
+	/** \name multiplication methods */
+	//-------------------------------------------------------------------------
+	//@{
+	GW_VectorND operator*(const GW_VectorND& v) const
+	{
+		GW_VectorND r(v.GetDim());
+		GW_SparseMatrixCSR::Multiply( *this, v, r );
+		return r;
+	}
+	static void Multiply( const GW_SparseMatrixCSR& a, const GW_VectorND& v, GW_VectorND& r )
+	{
+		GW_ASSERT( a.GetDim()==v.GetDim() );
+		GW_ASSERT( a.GetDim()==r.GetDim() );
+		GW_ASSERT( &v!=&r );
+		a.Multiply( &v[0], &r[0] );
+	}
+	/** r = A*v on raw arrays, rows are shared among threads. */
+	void Multiply( const GW_Float* v, GW_Float* r ) const
+	{
+		GW_I32 nRows = (GW_I32) RowPtr_.size()-1;
+		const GW_U32* Ap = &RowPtr_[0];
+		const GW_U32* Ai = this->GetColInd();
+		const GW_Float* Ax = this->GetValues();
+		#pragma omp parallel for schedule(static)
+		for( GW_I32 i=0; i<nRows; ++i )
+		{
+			GW_Float rVal = 0;
+			for( GW_U32 k=Ap[i]; k<Ap[i+1]; ++k )
+				rVal += Ax[k]*v[ Ai[k] ];
+			r[i] = rVal;
+		}
+		for( GW_U32 i=(GW_U32) nRows; i<nDim_; ++i )
+			r[i] = 0;
+	}
+	//@}
+
+	//-------------------------------------------------------------------------
+	/** \name iterative resolution */
+	//-------------------------------------------------------------------------
+	//@{
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  Greedy coloring of the adjacency graph of the matrix : two rows sharing a
+	 *  non zero entry get different colors. Laplacians of triangle meshes need
+	 *  about 7 colors. Computed on demand by the SSOR preconditioner.
+	 */
+	/*------------------------------------------------------------------------------*/
+	void ComputeColoring()
+	{
+		this->Finalize();
+		GW_U32 n = nDim_;
+		Color_.assign( n, 0 );
+		std::vector<GW_I32> Forbidden;	// Forbidden[c]==i if color c is used by a neighbor of i
+		GW_U32 nNbrColors = 0;
+		for( GW_U32 i=0; i<n; ++i )
+		{
+			for( GW_U32 k=RowPtr_[i]; k<RowPtr_[i+1]; ++k )
+			{
+				GW_U32 j = ColInd_[k];
+				if( j<i )
+					Forbidden[ Color_[j] ] = (GW_I32) i;
+			}
+			GW_U32 c = 0;
+			while( c<nNbrColors && Forbidden[c]==(GW_I32) i )
+				c++;
+			if( c==nNbrColors )
+			{
+				nNbrColors++;
+				Forbidden.push_back( -1 );
+			}
+			Color_[i] = c;
+		}
+		/* bucket the rows by color */
+		ColorPtr_.assign( nNbrColors+1, 0 );
+		for( GW_U32 i=0; i<n; ++i )
+			ColorPtr_[ Color_[i]+1 ]++;
+		for( GW_U32 c=0; c<nNbrColors; ++c )
+			ColorPtr_[c+1] += ColorPtr_[c];
+		ColorRows_.resize( n );
+		std::vector<GW_U32> Pos( ColorPtr_.begin(), ColorPtr_.end()-1 );
+		for( GW_U32 i=0; i<n; ++i )
+			ColorRows_[ Pos[Color_[i]]++ ] = i;
+	}
+	GW_U32 GetNbrColors() const
+	{
+		return ColorPtr_.empty() ? 0 : (GW_U32) ColorPtr_.size()-1;
+	}
+
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  \param  x [GW_VectorND&] Solution, also used as initial guess.
+	 *  \param  b [GW_VectorND&] Right hand side.
+	 *  \param  Preconditioner [T_PreconditionerType] Jacobi, SSOR or none (ILU is treated as SSOR).
+	 *  \param  eps [GW_Float] Stop when |b-A*x| < eps*|b|.
+	 *  \param  nMaxIter [GW_U32] Maximum number of iterations.
+	 *  \param  Omega [GW_Float] Relaxation parameter of SSOR, in ]0,2[.
+	 *  \param  pNbrIter [GW_U32*] If not NULL, receive the number of iterations.
+	 *  \return The norm of the final residual.
+	 *
+	 *  Preconditioned conjugate gradient, the matrix must be symmetric positive definite.
+	 */
+	/*------------------------------------------------------------------------------*/
+	GW_Float IterativeSolve( GW_VectorND& x, const GW_VectorND& b, GW_SparseMatrix::T_PreconditionerType Preconditioner, 
+							GW_Float eps = 1e-10, GW_U32 nMaxIter = 1000, GW_Float Omega = 1.2, GW_U32* pNbrIter = NULL )
+	{
+		GW_ASSERT( x.GetDim()==nDim_ && b.GetDim()==nDim_ );
+		this->Finalize();
+		if( Preconditioner==GW_SparseMatrix::Preconditioner_ILU )
+			Preconditioner = GW_SparseMatrix::Preconditioner_SSOR;
+		if( Preconditioner==GW_SparseMatrix::Preconditioner_SSOR && this->GetNbrColors()==0 )
+			this->ComputeColoring();
+		this->ExtractDiagonal();
+
+		GW_I32 n = (GW_I32) nDim_;
+		std::vector<GW_Float> r(n), z(n), p(n), q(n);
+		/* r = b - A*x */
+		this->Multiply( &x[0], &r[0] );
+		#pragma omp parallel for schedule(static)
+		for( GW_I32 i=0; i<n; ++i )
+			r[i] = b[i]-r[i];
+		GW_Float rNormB = sqrt( GW_SparseMatrixCSR::Dot( &b[0], &b[0], n ) );
+		if( rNormB==0 )
+			rNormB = 1;
+		this->ApplyPreconditioner( Preconditioner, Omega, &r[0], &z[0] );
+		p = z;
+		GW_Float rho = GW_SparseMatrixCSR::Dot( &r[0], &z[0], n );
+		GW_Float rResidual = sqrt( GW_SparseMatrixCSR::Dot( &r[0], &r[0], n ) );
+		GW_U32 nIter = 0;
+		while( nIter<nMaxIter && rResidual>eps*rNormB )
+		{
+			this->Multiply( &p[0], &q[0] );
+			GW_Float alpha = rho/GW_SparseMatrixCSR::Dot( &p[0], &q[0], n );
+			GW_Float rResidual2 = 0;
+			#pragma omp parallel for schedule(static) reduction(+:rResidual2)
+			for( GW_I32 i=0; i<n; ++i )
+			{
+				x[i] += alpha*p[i];
+				r[i] -= alpha*q[i];
+				rResidual2 += r[i]*r[i];
+			}
+			rResidual = sqrt( rResidual2 );
+			this->ApplyPreconditioner( Preconditioner, Omega, &r[0], &z[0] );
+			GW_Float rho_new = GW_SparseMatrixCSR::Dot( &r[0], &z[0], n );
+			GW_Float beta = rho_new/rho;
+			rho = rho_new;
+			#pragma omp parallel for schedule(static)
+			for( GW_I32 i=0; i<n; ++i )
+				p[i] = z[i]+beta*p[i];
+			nIter++;
+		}
+		if( pNbrIter!=NULL )
+			*pNbrIter = nIter;
+		return rResidual;
+	}
+
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  \param  x [GW_VectorND&] Solution, also used as initial guess.
+	 *  \param  b [GW_VectorND&] Right hand side.
+	 *  \param  Preconditioner [T_PreconditionerType] Jacobi, SSOR or none (ILU is treated as SSOR).
+	 *  \param  eps [GW_Float] Stop when |b-A*x| < eps*|b|.
+	 *  \param  nMaxIter [GW_U32] Maximum number of iterations.
+	 *  \param  Omega [GW_Float] Relaxation parameter of SSOR, in ]0,2[.
+	 *  \param  pNbrIter [GW_U32*] If not NULL, receive the number of iterations.
+	 *  \return The norm of the final residual.
+	 *
+	 *  Preconditioned BiCGSTAB (van der Vorst), for systems that are not
+	 *  symmetric positive definite. Stops early on a breakdown.
+	 */
+	/*------------------------------------------------------------------------------*/
+	GW_Float IterativeSolveBiCGSTAB( GW_VectorND& x, const GW_VectorND& b, GW_SparseMatrix::T_PreconditionerType Preconditioner, 
+							GW_Float eps = 1e-10, GW_U32 nMaxIter = 1000, GW_Float Omega = 1.2, GW_U32* pNbrIter = NULL )
+	{
+		GW_ASSERT( x.GetDim()==nDim_ && b.GetDim()==nDim_ );
+		this->Finalize();
+		if( Preconditioner==GW_SparseMatrix::Preconditioner_ILU )
+			Preconditioner = GW_SparseMatrix::Preconditioner_SSOR;
+		if( Preconditioner==GW_SparseMatrix::Preconditioner_SSOR && this->GetNbrColors()==0 )
+			this->ComputeColoring();
+		this->ExtractDiagonal();
+
+		GW_I32 n = (GW_I32) nDim_;
+		std::vector<GW_Float> r(n), r0(n), p(n, 0), v(n, 0), ph(n), sh(n), t(n);
+		/* r = b - A*x */
+		this->Multiply( &x[0], &r[0] );
+		#pragma omp parallel for schedule(static)
+		for( GW_I32 i=0; i<n; ++i )
+			r[i] = b[i]-r[i];
+		r0 = r;
+		GW_Float rNormB = sqrt( GW_SparseMatrixCSR::Dot( &b[0], &b[0], n ) );
+		if( rNormB==0 )
+			rNormB = 1;
+		GW_Float rho = 1, alpha = 1, omega = 1;
+		GW_Float rResidual = sqrt( GW_SparseMatrixCSR::Dot( &r[0], &r[0], n ) );
+		GW_U32 nIter = 0;
+		while( nIter<nMaxIter && rResidual>eps*rNormB )
+		{
+			GW_Float rho_new = GW_SparseMatrixCSR::Dot( &r0[0], &r[0], n );
+			if( rho_new==0 )
+				break;		// breakdown
+			GW_Float beta = (rho_new/rho)*(alpha/omega);
+			rho = rho_new;
+			#pragma omp parallel for schedule(static)
+			for( GW_I32 i=0; i<n; ++i )
+				p[i] = r[i]+beta*(p[i]-omega*v[i]);
+			this->ApplyPreconditioner( Preconditioner, Omega, &p[0], &ph[0] );
+			this->Multiply( &ph[0], &v[0] );
+			alpha = rho/GW_SparseMatrixCSR::Dot( &r0[0], &v[0], n );
+			/* s = r - alpha*v, stored in r */
+			#pragma omp parallel for schedule(static)
+			for( GW_I32 i=0; i<n; ++i )
+				r[i] -= alpha*v[i];
+			this->ApplyPreconditioner( Preconditioner, Omega, &r[0], &sh[0] );
+			this->Multiply( &sh[0], &t[0] );
+			GW_Float tt = GW_SparseMatrixCSR::Dot( &t[0], &t[0], n );
+			omega = tt>0 ? GW_SparseMatrixCSR::Dot( &t[0], &r[0], n )/tt : 0;
+			GW_Float rResidual2 = 0;
+			#pragma omp parallel for schedule(static) reduction(+:rResidual2)
+			for( GW_I32 i=0; i<n; ++i )
+			{
+				x[i] += alpha*ph[i]+omega*sh[i];
+				r[i] -= omega*t[i];
+				rResidual2 += r[i]*r[i];
+			}
+			rResidual = sqrt( rResidual2 );
+			nIter++;
+			if( omega==0 )
+				break;		// breakdown
+		}
+		if( pNbrIter!=NULL )
+			*pNbrIter = nIter;
+		return rResidual;
+	}
+	//@}
+
+	/** GW_True if the diagonal is positive and strictly dominates each row, which
+		together with symmetry is a sufficient condition for positive definiteness. */
+	GW_Bool IsDiagonallyDominant() const
+	{
+		for( GW_U32 i=0; i+1<RowPtr_.size(); ++i )
+		{
+			GW_Float rDiag = 0, rSum = 0;
+			for( GW_U32 k=RowPtr_[i]; k<RowPtr_[i+1]; ++k )
+				if( ColInd_[k]==i )
+					rDiag = Val_[k];
+				else
+					rSum += GW_ABS( Val_[k] );
+			if( rDiag<=rSum )
+				return GW_False;
+		}
+		return GW_True;
+	}
+
+	/** GW_True if the pattern and the values are symmetric. */
+	GW_Bool IsSymmetric() const
+	{
+		for( GW_U32 i=0; i+1<RowPtr_.size(); ++i )
+			for( GW_U32 k=RowPtr_[i]; k<RowPtr_[i+1]; ++k )
+			{
+				GW_U32 j = ColInd_[k];
+				if( j==i )
+					continue;
+				GW_Float rVal = 0;
+				GW_Bool bFound = GW_False;
+				for( GW_U32 l=RowPtr_[j]; l<RowPtr_[j+1] && !bFound; ++l )
+					if( ColInd_[l]==i )
+					{
+						rVal = Val_[l];
+						bFound = GW_True;
+					}
+				if( !bFound || rVal!=Val_[k] )
+					return GW_False;
+			}
+		return GW_True;
+	}
+
+	/** Largest row-wise l1 norm, an upper bound on the spectral radius (Gershgorin). */
+	GW_Float GetGershgorinBound() const
+	{
+		GW_Float rBound = 0;
+		for( GW_U32 i=0; i+1<RowPtr_.size(); ++i )
+		{
+			GW_Float rSum = 0;
+			for( GW_U32 k=RowPtr_[i]; k<RowPtr_[i+1]; ++k )
+				rSum += GW_ABS( Val_[k] );
+			rBound = GW_MAX( rBound, rSum );
+		}
+		return rBound;
+	}
+
+	/** wall clock time in seconds, used by the benchmark */
+	static GW_Float GetTime()
+	{
+#ifdef _OPENMP
+		return omp_get_wtime();
+#else
+		return ((GW_Float) clock())/CLOCKS_PER_SEC;
+#endif
+	}
+
+	/*------------------------------------------------------------------------------*/
+	/**
+	 *  \param  A [GW_SparseMatrixCSR&] The system matrix.
+	 *  \param  s [std::ostream&] Output stream.
+	 *  \param  bSymmetricDefinite [GW_Bool] Whether \c A is known to be symmetric positive definite.
+	 *
+	 *  Time the product and the preconditioned solver on one thread and on all
+	 *  the threads available (when compiled with OpenMP). CG is only used on
+	 *  symmetric positive definite matrices, BiCGSTAB otherwise.
+	 */
+	/*------------------------------------------------------------------------------*/
+	static void Benchmark( GW_SparseMatrixCSR& A, std::ostream &s = cout, GW_Float eps = 1e-8, GW_U32 nMaxIter = 5000, 
+							GW_Bool bSymmetricDefinite = GW_True )
+	{
+		GW_U32 n = A.GetDim();
+		GW_VectorND x(n, GW_Float(0)), b(n), r(n);
+		for( GW_U32 i=0; i<n; ++i )
+			b[i] = GW_RAND-0.5;
+		GW_Float t = GW_SparseMatrixCSR::GetTime();
+		A.ComputeColoring();
+		s << "  Size " << n << ", " << A.GetNbrNonZero() << " non zero, " << A.GetNbrColors() << " colors ("
+		  << GW_SparseMatrixCSR::GetTime()-t << "s)." << endl;
+#ifdef _OPENMP
+		GW_I32 nMaxThreads = omp_get_max_threads();
+		GW_I32 ThreadsList[2] = { 1, nMaxThreads };
+		GW_U32 nNbrRuns = nMaxThreads>1 ? 2 : 1;
+#else
+		GW_U32 nNbrRuns = 1;
+#endif
+		for( GW_U32 run=0; run<nNbrRuns; ++run )
+		{
+#ifdef _OPENMP
+			omp_set_num_threads( ThreadsList[run] );
+			s << "  - " << ThreadsList[run] << " thread(s)" << endl;
+#endif
+			GW_U32 nNbrProducts = 50;
+			t = GW_SparseMatrixCSR::GetTime();
+			for( GW_U32 k=0; k<nNbrProducts; ++k )
+				GW_SparseMatrixCSR::Multiply( A, b, r );
+			s << "    SpMV : " << (GW_SparseMatrixCSR::GetTime()-t)/nNbrProducts << "s." << endl;
+			const char* Names[3] = { "none", "Jacobi", "SSOR (multicolor)" };
+			GW_SparseMatrix::T_PreconditionerType Precond[3] = { GW_SparseMatrix::Preconditioner_NULL, 
+				GW_SparseMatrix::Preconditioner_Jacobi, GW_SparseMatrix::Preconditioner_SSOR };
+			for( GW_U32 k=0; k<3; ++k )
+			{
+				x.SetValue(0);
+				GW_U32 nIter = 0;
+				t = GW_SparseMatrixCSR::GetTime();
+				GW_Float err;
+				if( bSymmetricDefinite )
+					err = A.IterativeSolve( x, b, Precond[k], eps, nMaxIter, 1.2, &nIter );
+				else
+					err = A.IterativeSolveBiCGSTAB( x, b, Precond[k], eps, nMaxIter, 1.2, &nIter );
+				s << "    " << (bSymmetricDefinite ? "PCG " : "BiCGSTAB ") << Names[k] << " : " << nIter << " iterations, " 
+				  << GW_SparseMatrixCSR::GetTime()-t << "s, residual " << err << "." << endl;
+			}
+		}
+#ifdef _OPENMP
+		omp_set_num_threads( nMaxThreads );
+#endif
+	}
+
+	static void TestClass(std::ostream &s = cout)
+	{
+		TestClassHeader("GW_SparseMatrixCSR", s);
+		/* 5 points laplacian of a w x w grid, shifted to be definite : the system
+		   has the same structure than a Tutte system on a regular mesh */
+		GW_U32 SizeList[3] = { 30, 320, 1000 };		// up to 10^6 unknowns
+		for( GW_U32 t=0; t<3; ++t )
+		{
+			GW_U32 w = SizeList[t];
+			GW_U32 n = w*w;
+			GW_SparseMatrixCSR A(n);
+			for( GW_U32 i=0; i<n; ++i )
+			{
+				GW_U32 x = i%w, y = i/w;
+				A.SetRowSize(i,5);
+				if( y>0 )	A.SetData( i, i-w, -1 );
+				if( x>0 )	A.SetData( i, i-1, -1 );
+				A.SetData( i, i, 4.01 );
+				if( x+1<w )	A.SetData( i, i+1, -1 );
+				if( y+1<w )	A.SetData( i, i+w, -1 );
+			}
+			A.Finalize();
+			GW_SparseMatrixCSR::Benchmark( A, s );
+		}
+		TestClassFooter("GW_SparseMatrixCSR", s);
+	}
+
+	void Print(std::ostream &s) const
+	{
+		s << "Sparse CSR matrix, size " << this->GetDim() << "x" << this->GetDim()
+		  << ", " << this->GetNbrNonZero() << " non zero." << endl;
+		for( GW_U32 i=0; i+1<RowPtr_.size(); ++i )
+		{
+			s << i << " :";
+			for( GW_U32 k=RowPtr_[i]; k<RowPtr_[i+1]; ++k )
+				s << " (" << ColInd_[k] << "," << Val_[k] << ")";
+			s << endl;
+		}
+	}
+
+private:
+
+	static GW_Float Dot( const GW_Float* a, const GW_Float* b, GW_I32 n )
+	{
+		GW_Float rDot = 0;
+		#pragma omp parallel for schedule(static) reduction(+:rDot)
+		for( GW_I32 i=0; i<n; ++i )
+			rDot += a[i]*b[i];
+		return rDot;
+	}
+
+	void ClearColoring()
+	{
+		Color_.clear();
+		ColorPtr_.clear();
+		ColorRows_.clear();
+		Diag_.clear();
+	}
+
+	void ExtractDiagonal()
+	{
+		if( Diag_.size()==nDim_ )
+			return;
+		Diag_.assign( nDim_, 1 );
+		for( GW_U32 i=0; i+1<RowPtr_.size(); ++i )
+			for( GW_U32 k=RowPtr_[i]; k<RowPtr_[i+1]; ++k )
+				if( ColInd_[k]==i && Val_[k]!=0 )
+					Diag_[i] = Val_[k];
+	}
+
+	/** z = M^-1 r */
+	void ApplyPreconditioner( GW_SparseMatrix::T_PreconditionerType Preconditioner, GW_Float Omega, const GW_Float* r, GW_Float* z ) const
+	{
+		GW_I32 n = (GW_I32) nDim_;
+		switch( Preconditioner )
+		{
+		case GW_SparseMatrix::Preconditioner_Jacobi:
+			#pragma omp parallel for schedule(static)
+			for( GW_I32 i=0; i<n; ++i )
+				z[i] = r[i]/Diag_[i];
+			break;
+		case GW_SparseMatrix::Preconditioner_SSOR:
+			this->ApplySSOR( Omega, r, z );
+			break;
+		default:
+			memcpy( z, r, n*sizeof(GW_Float) );
+			break;
+		}
+	}
+
+	/** SSOR in the multicolor ordering, M = (D+wL) D^-1 (D+wU) / (w(2-w)), where
+		L (resp. U) gathers the entries whose column has a lower (resp. higher) color. */
+	void ApplySSOR( GW_Float Omega, const GW_Float* r, GW_Float* z ) const
+	{
+		GW_I32 nNbrColors = (GW_I32) this->GetNbrColors();
+		const GW_U32* Ap = &RowPtr_[0];
+		const GW_U32* Ai = this->GetColInd();
+		const GW_Float* Ax = this->GetValues();
+		/* forward sweep : (D+wL) z = r */
+		for( GW_I32 c=0; c<nNbrColors; ++c )
+		{
+			GW_I32 nStart = (GW_I32) ColorPtr_[c], nEnd = (GW_I32) ColorPtr_[c+1];
+			#pragma omp parallel for schedule(static)
+			for( GW_I32 k=nStart; k<nEnd; ++k )
+			{
+				GW_U32 i = ColorRows_[k];
+				GW_Float rVal = r[i];
+				for( GW_U32 p=Ap[i]; p<Ap[i+1]; ++p )
+					if( Color_[ Ai[p] ]<(GW_U32) c )
+						rVal -= Omega*Ax[p]*z[ Ai[p] ];
+				z[i] = rVal/Diag_[i];
+			}
+		}
+		/* backward sweep : (D+wU) z = D z */
+		for( GW_I32 c=nNbrColors-1; c>=0; --c )
+		{
+			GW_I32 nStart = (GW_I32) ColorPtr_[c], nEnd = (GW_I32) ColorPtr_[c+1];
+			#pragma omp parallel for schedule(static)
+			for( GW_I32 k=nStart; k<nEnd; ++k )
+			{
+				GW_U32 i = ColorRows_[k];
+				GW_Float rVal = Diag_[i]*z[i];
+				for( GW_U32 p=Ap[i]; p<Ap[i+1]; ++p )
+					if( Color_[ Ai[p] ]>(GW_U32) c )
+						rVal -= Omega*Ax[p]*z[ Ai[p] ];
+				z[i] = rVal/Diag_[i];
+			}
+		}
+		GW_Float rScale = Omega*(2-Omega);
+		GW_I32 n = (GW_I32) nDim_;
+		#pragma omp parallel for schedule(static)
+		for( GW_I32 i=0; i<n; ++i )
+			z[i] *= rScale;
+	}
+
+	GW_U32 nDim_;
+	/** offset of the first entry of each row, size nDim_+1 once finalized */
+	std::vector<GW_U32> RowPtr_;
+	std::vector<GW_U32> ColInd_;
+	std::vector<GW_Float> Val_;
+
+	/** multicolor ordering for the SSOR sweeps */
+	std::vector<GW_U32> Color_;
+	std::vector<GW_U32> ColorPtr_;
+	std::vector<GW_U32> ColorRows_;
+	/** diagonal, cached by the iterative solver */
+	std::vector<GW_Float> Diag_;
+
+};
+
+inline
+std::ostream& operator<<(std::ostream &s, const GW_SparseMatrixCSR &A)
+{
+	A.Print(s);
+	return s;
+}
+
+} // End namespace GW
+
+
+#endif // _GW_SPARSEMATRIXCSR_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr?
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,7 @@
 #include "../GW_Matrix4x4.h"
 #include "../GW_MatrixNxP.h"
 #include "../GW_SparseMatrix.h"
+#include "../GW_SparseMatrixCSR.h"
 #include "../GW_MatrixStatic.h"
 #include "../GW_Quaternion.h"
 
@@ -32,6 +33,7 @@ void main()
 	GW_Matrix4x4::TestClass();
 	GW_MatrixNxP::TestClass();
 	GW_SparseMatrix::TestClass();
+	GW_SparseMatrixCSR::TestClass();
 	GW_Quaternion::TestClass();
 	cout << "############################################################" << endl;
 }
\ No newline at end of file
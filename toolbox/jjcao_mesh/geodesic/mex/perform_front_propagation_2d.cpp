@@ -33,6 +33,7 @@
 #include "perform_front_propagation_2d.h"
 #include "fheap/fib.h"
 #include "fheap/fibpriv.h"
+#include "untidy_queue.h"
 
 #define kDead -1
 #define kOpen 0
@@ -345,4 +346,207 @@ void perform_front_propagation_2d(T_callback_intert_node callback_insert_node)
 		GW_DELETE( *it );
 	// free fibheap pool
 	GW_DELETEARRAY(heap_pool);
-}
\ No newline at end of file
+}
+
+/*=================================================================
+% Alternative engines.
+%
+%	Both work directly on the flat D/S/Q arrays, no per-point allocation.
+%	- untidy : fast marching with the bucketed queue of Yatziv, Bartesaghi and Sapiro,
+%	  "O(N) implementation of the fast marching algorithm", JCP 2006.
+%	- sweeping : fast sweeping (Zhao 2005), each sweep is done block by block,
+%	  the blocks of one anti-diagonal are independent and processed in parallel.
+*=================================================================*/
+
+#define SWEEP_BLOCK_SIZE 64
+
+// solve the upwind update at (ii,jj) from its 4 neighbors, k1 is set to the seed index of the smallest one
+inline
+double compute_update_2d( int ii, int jj, double h, T_callback_intert_node callback_insert_node, int& k1 )
+{
+	double P = h/W_(ii,jj);
+	double a1 = GW_INFINITE;
+	k1 = -1;
+	if( ii<n-1 && (callback_insert_node==NULL || callback_insert_node(ii,jj,ii+1,jj)) )
+	{
+		a1 = D_(ii+1,jj);
+		k1 = (int) Q_(ii+1,jj);
+	}
+	if( ii>0 && (callback_insert_node==NULL || callback_insert_node(ii,jj,ii-1,jj)) && D_(ii-1,jj)<a1 )
+	{
+		a1 = D_(ii-1,jj);
+		k1 = (int) Q_(ii-1,jj);
+	}
+	double a2 = GW_INFINITE;
+	int k2 = -1;
+	if( jj<p-1 && (callback_insert_node==NULL || callback_insert_node(ii,jj,ii,jj+1)) )
+	{
+		a2 = D_(ii,jj+1);
+		k2 = (int) Q_(ii,jj+1);
+	}
+	if( jj>0 && (callback_insert_node==NULL || callback_insert_node(ii,jj,ii,jj-1)) && D_(ii,jj-1)<a2 )
+	{
+		a2 = D_(ii,jj-1);
+		k2 = (int) Q_(ii,jj-1);
+	}
+	if( a1>a2 )	// swap so that a1<a2
+	{
+		double tmp = a1; a1 = a2; a2 = tmp;
+		int tmpi = k1; k1 = k2; k2 = tmpi;
+	}
+	// (a-a1)^2+(a-a2)^2 = P^2, with a >= a2 >= a1.
+	if( P*P > (a2-a1)*(a2-a1) )
+		return (a1+a2+sqrt(2*P*P-(a2-a1)*(a2-a1)))/2.0;
+	return a1 + P;
+}
+
+// set the seeds, all the other points are far
+void initialize_propagation_2d()
+{
+	for( int s=0; s<n*p; ++s )
+	{
+		D[s] = GW_INFINITE;
+		S[s] = kFar;
+		Q[s] = -1;
+	}
+	for( int k=0; k<nb_start_points; ++k )
+	{
+		int i = (int) start_points_(0,k);
+		int j = (int) start_points_(1,k);
+		D_(i,j) = values==NULL ? 0 : values[k];
+		S_(i,j) = kOpen;
+		Q_(i,j) = k;
+	}
+}
+
+void perform_front_propagation_2d_untidy(T_callback_intert_node callback_insert_node)
+{
+	double h = 1.0/n;
+	initialize_propagation_2d();
+
+	// the bucket width is the smallest step, the queue must span the largest one
+	double wmin = GW_INFINITE, wmax = 0;
+	for( int s=0; s<n*p; ++s )
+		if( W[s]>0 && W[s]<GW_INFINITE )
+		{
+			wmin = GW_MIN( wmin, W[s] );
+			wmax = GW_MAX( wmax, W[s] );
+		}
+	if( wmax==0 )
+		return;
+	double delta = h/wmax;
+	double span = (H==NULL ? 1 : 2) * h/wmin;
+	int nb_buckets = (int) GW_MIN( span/delta+2, UNTIDY_MAX_BUCKETS );
+	delta = GW_MAX( delta, span/(nb_buckets-2) );
+	untidy_queue open_queue( delta, nb_buckets );
+
+	for( int k=0; k<nb_start_points; ++k )
+	{
+		int pos = (int) start_points_(0,k) + n*((int) start_points_(1,k));
+		open_queue.push( pos, H==NULL ? D[pos] : D[pos]+H[pos] );
+	}
+
+	int num_iter = 0;
+	bool stop_iteration = GW_False;
+	while( !open_queue.empty() && num_iter<nb_iter_max && !stop_iteration )
+	{
+		int pos = open_queue.pop();
+		if( ((int) S[pos])==kDead )
+			continue;		// already extracted from an earlier bucket
+		num_iter++;
+		int i = pos%n;
+		int j = pos/n;
+		S[pos] = kDead;
+		stop_iteration = end_points_reached(i,j);
+
+		int nei_i[4] = {i+1,i,i-1,i};
+		int nei_j[4] = {j,j+1,j,j-1};
+		for( int k=0; k<4; ++k )
+		{
+			int ii = nei_i[k];
+			int jj = nei_j[k];
+			if( ii<0 || jj<0 || ii>=n || jj>=p )
+				continue;
+			if( callback_insert_node!=NULL && !callback_insert_node(i,j,ii,jj) )
+				continue;
+			int k1;
+			double A1 = compute_update_2d( ii,jj, h, callback_insert_node, k1 );
+			int npos = ii+n*jj;
+			if( A1>=D[npos] )
+				continue;
+			if( ((int) S[npos])==kDead )
+			{
+				D[npos] = A1;
+				Q[npos] = k1;
+			}
+			else if( ((int) S[npos])==kOpen || L==NULL || A1<=L[npos] )
+			{
+				// an open point is pushed again, the old entry is skipped once it is dead
+				S[npos] = kOpen;
+				D[npos] = A1;
+				Q[npos] = k1;
+				open_queue.push( npos, H==NULL ? A1 : A1+H[npos] );
+			}
+		}
+	}
+}
+
+void perform_front_propagation_2d_sweeping(T_callback_intert_node callback_insert_node)
+{
+	double h = 1.0/n;
+	initialize_propagation_2d();
+	// seeds are frozen, reached points stay open until the end
+	for( int s=0; s<n*p; ++s )
+		if( ((int) S[s])==kOpen )
+			S[s] = kDead;
+
+	int nbx = (n+SWEEP_BLOCK_SIZE-1)/SWEEP_BLOCK_SIZE;
+	int nby = (p+SWEEP_BLOCK_SIZE-1)/SWEEP_BLOCK_SIZE;
+	int dirs[4][2] = { {1,1}, {-1,1}, {-1,-1}, {1,-1} };
+	for( int round=0; round<nb_iter_max; ++round )
+	{
+		int nb_changed = 0;
+		for( int d=0; d<4; ++d )
+		{
+			int si = dirs[d][0], sj = dirs[d][1];
+			for( int diag=0; diag<nbx+nby-1; ++diag )
+			{
+				int bx_start = GW_MAX( 0, diag-nby+1 );
+				int bx_end = GW_MIN( nbx-1, diag );
+#pragma omp parallel for schedule(dynamic) reduction(+:nb_changed)
+				for( int bx=bx_start; bx<=bx_end; ++bx )
+				{
+					int by = diag-bx;
+					// block coordinates in sweep order
+					int bi = si>0 ? bx : nbx-1-bx;
+					int bj = sj>0 ? by : nby-1-by;
+					int i0 = bi*SWEEP_BLOCK_SIZE, i1 = GW_MIN( n, i0+SWEEP_BLOCK_SIZE );
+					int j0 = bj*SWEEP_BLOCK_SIZE, j1 = GW_MIN( p, j0+SWEEP_BLOCK_SIZE );
+					for( int jc=0; jc<j1-j0; ++jc )
+					for( int ic=0; ic<i1-i0; ++ic )
+					{
+						int ii = si>0 ? i0+ic : i1-1-ic;
+						int jj = sj>0 ? j0+jc : j1-1-jc;
+						if( ((int) S_(ii,jj))==kDead )
+							continue;
+						int k1;
+						double A1 = compute_update_2d( ii,jj, h, callback_insert_node, k1 );
+						if( A1<D_(ii,jj) && (L==NULL || A1<=L_(ii,jj)) )
+						{
+							if( D_(ii,jj)-A1 > GW_EPSILON*h )
+								nb_changed++;
+							D_(ii,jj) = A1;
+							Q_(ii,jj) = k1;
+							S_(ii,jj) = kOpen;
+						}
+					}
+				}
+			}
+		}
+		if( nb_changed==0 )
+			break;
+	}
+	for( int s=0; s<n*p; ++s )
+		if( ((int) S[s])==kOpen )
+			S[s] = kDead;
+}
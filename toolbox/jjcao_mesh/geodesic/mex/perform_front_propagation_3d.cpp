@@ -35,6 +35,7 @@
 #include "perform_front_propagation_3d.h"
 #include "fheap/fib.h"
 #include "fheap/fibpriv.h"
+#include "untidy_queue.h"
 
 #define kDead -1
 #define kOpen 0
@@ -304,4 +305,225 @@ void perform_front_propagation_3d( T_callback_intert_node callback_insert_node )
 	GW_DELETEARRAY(heap_pool);
 	
 	return;
-}
\ No newline at end of file
+}
+
+/*=================================================================
+% Alternative engines.
+%
+%	Both work directly on the flat D/S/Q arrays, no per-point allocation.
+%	- untidy : fast marching with the bucketed queue of Yatziv, Bartesaghi and Sapiro,
+%	  "O(N) implementation of the fast marching algorithm", JCP 2006.
+%	- sweeping : fast sweeping (Zhao 2005), each sweep is done block by block,
+%	  the blocks of one anti-diagonal plane are independent and processed in parallel.
+*=================================================================*/
+
+#define SWEEP_BLOCK_SIZE 16
+
+// solve the upwind update at (ii,jj,kk) from its 6 neighbors, k1 is set to the seed index of the smallest one
+inline
+double compute_update_3d( int ii, int jj, int kk, double h, T_callback_intert_node callback_insert_node, int& k1 )
+{
+	double P = h/W_(ii,jj,kk);
+	double a[3] = { GW_INFINITE, GW_INFINITE, GW_INFINITE };
+	int ka[3] = { -1, -1, -1 };
+	int nei[6][3] = { {ii+1,jj,kk}, {ii-1,jj,kk}, {ii,jj+1,kk}, {ii,jj-1,kk}, {ii,jj,kk+1}, {ii,jj,kk-1} };
+	for( int s=0; s<6; ++s )
+	{
+		int i = nei[s][0], j = nei[s][1], k = nei[s][2];
+		if( i<0 || j<0 || k<0 || i>=n || j>=p || k>=q )
+			continue;
+		if( callback_insert_node!=NULL && !callback_insert_node(ii,jj,kk,i,j,k) )
+			continue;
+		if( D_(i,j,k)<a[s/2] )
+		{
+			a[s/2] = D_(i,j,k);
+			ka[s/2] = (int) Q_(i,j,k);
+		}
+	}
+	// order so that a1<a2<a3
+	for( int s=0; s<2; ++s )
+	for( int t=0; t<2-s; ++t )
+		if( a[t]>a[t+1] )
+		{
+			double tmp = a[t]; a[t] = a[t+1]; a[t+1] = tmp;
+			int tmpi = ka[t]; ka[t] = ka[t+1]; ka[t+1] = tmpi;
+		}
+	double a1 = a[0], a2 = a[1], a3 = a[2];
+	k1 = ka[0];
+	// same resolution as perform_front_propagation_3d
+	double delta = (a2+a1+a3)*(a2+a1+a3) - 3*(a1*a1 + a2*a2 + a3*a3 - P*P);
+	double A1 = 0;
+	if( delta>=0 )
+		A1 = ( a2+a1+a3 + sqrt(delta) )/3.0;
+	if( A1<=a3 )
+	{
+		delta = (a2+a1)*(a2+a1) - 2*(a1*a1 + a2*a2 - P*P);
+		A1 = 0;
+		if( delta>=0 )
+			A1 = 0.5 * ( a2+a1 +sqrt(delta) );
+		if( A1<=a2 )
+			A1 = a1 + P;
+	}
+	return A1;
+}
+
+// set the seeds, all the other points are far
+void initialize_propagation_3d()
+{
+	for( int s=0; s<n*p*q; ++s )
+	{
+		D[s] = GW_INFINITE;
+		S[s] = kFar;
+		Q[s] = -1;
+	}
+	for( int s=0; s<nb_start_points; ++s )
+	{
+		int i = (int) start_points_(0,s);
+		int j = (int) start_points_(1,s);
+		int k = (int) start_points_(2,s);
+		D_(i,j,k) = values==NULL ? 0 : values[s];
+		S_(i,j,k) = kOpen;
+		Q_(i,j,k) = s;
+	}
+}
+
+void perform_front_propagation_3d_untidy( T_callback_intert_node callback_insert_node )
+{
+	double h = 1.0/n;
+	initialize_propagation_3d();
+
+	// the bucket width is the smallest step, the queue must span the largest one
+	double wmin = GW_INFINITE, wmax = 0;
+	for( int s=0; s<n*p*q; ++s )
+		if( W[s]>0 && W[s]<GW_INFINITE )
+		{
+			wmin = GW_MIN( wmin, W[s] );
+			wmax = GW_MAX( wmax, W[s] );
+		}
+	if( wmax==0 )
+		return;
+	double delta = h/wmax;
+	double span = (H==NULL ? 1 : 2) * h/wmin;
+	int nb_buckets = (int) GW_MIN( span/delta+2, UNTIDY_MAX_BUCKETS );
+	delta = GW_MAX( delta, span/(nb_buckets-2) );
+	untidy_queue open_queue( delta, nb_buckets );
+
+	for( int s=0; s<nb_start_points; ++s )
+	{
+		int pos = (int) start_points_(0,s) + n*((int) start_points_(1,s)) + n*p*((int) start_points_(2,s));
+		open_queue.push( pos, H==NULL ? D[pos] : D[pos]+H[pos] );
+	}
+
+	int num_iter = 0;
+	bool stop_iteration = GW_False;
+	while( !open_queue.empty() && num_iter<nb_iter_max && !stop_iteration )
+	{
+		int pos = open_queue.pop();
+		if( ((int) S[pos])==kDead )
+			continue;		// already extracted from an earlier bucket
+		num_iter++;
+		int i = pos%n;
+		int j = (pos/n)%p;
+		int k = pos/(n*p);
+		S[pos] = kDead;
+		stop_iteration = end_points_reached(i,j,k);
+
+		int nei_i[6] = {i+1,i,i-1,i,i,i};
+		int nei_j[6] = {j,j+1,j,j-1,j,j};
+		int nei_k[6] = {k,k,k,k,k-1,k+1};
+		for( int s=0; s<6; ++s )
+		{
+			int ii = nei_i[s];
+			int jj = nei_j[s];
+			int kk = nei_k[s];
+			if( ii<0 || jj<0 || kk<0 || ii>=n || jj>=p || kk>=q )
+				continue;
+			if( callback_insert_node!=NULL && !callback_insert_node(i,j,k,ii,jj,kk) )
+				continue;
+			int k1;
+			double A1 = compute_update_3d( ii,jj,kk, h, callback_insert_node, k1 );
+			int npos = ii+n*jj+n*p*kk;
+			if( A1>=D[npos] )
+				continue;
+			if( ((int) S[npos])==kDead )
+			{
+				D[npos] = A1;
+				Q[npos] = k1;
+			}
+			else if( ((int) S[npos])==kOpen || L==NULL || A1<=L[npos] )
+			{
+				// an open point is pushed again, the old entry is skipped once it is dead
+				S[npos] = kOpen;
+				D[npos] = A1;
+				Q[npos] = k1;
+				open_queue.push( npos, H==NULL ? A1 : A1+H[npos] );
+			}
+		}
+	}
+}
+
+void perform_front_propagation_3d_sweeping( T_callback_intert_node callback_insert_node )
+{
+	double h = 1.0/n;
+	initialize_propagation_3d();
+	// seeds are frozen, reached points stay open until the end
+	for( int s=0; s<n*p*q; ++s )
+		if( ((int) S[s])==kOpen )
+			S[s] = kDead;
+
+	int nbx = (n+SWEEP_BLOCK_SIZE-1)/SWEEP_BLOCK_SIZE;
+	int nby = (p+SWEEP_BLOCK_SIZE-1)/SWEEP_BLOCK_SIZE;
+	int nbz = (q+SWEEP_BLOCK_SIZE-1)/SWEEP_BLOCK_SIZE;
+	for( int round=0; round<nb_iter_max; ++round )
+	{
+		int nb_changed = 0;
+		for( int d=0; d<8; ++d )
+		{
+			int si = (d&1) ? -1 : 1, sj = (d&2) ? -1 : 1, sk = (d&4) ? -1 : 1;
+			for( int diag=0; diag<nbx+nby+nbz-2; ++diag )
+			{
+				// blocks (bx,by,bz) with bx+by+bz==diag, flattened on (bx,by)
+				int nb_plane = nbx*nby;
+#pragma omp parallel for schedule(dynamic) reduction(+:nb_changed)
+				for( int b=0; b<nb_plane; ++b )
+				{
+					int bx = b%nbx, by = b/nbx, bz = diag-bx-by;
+					if( bz<0 || bz>=nbz )
+						continue;
+					// block coordinates in sweep order
+					int bi = si>0 ? bx : nbx-1-bx;
+					int bj = sj>0 ? by : nby-1-by;
+					int bk = sk>0 ? bz : nbz-1-bz;
+					int i0 = bi*SWEEP_BLOCK_SIZE, i1 = GW_MIN( n, i0+SWEEP_BLOCK_SIZE );
+					int j0 = bj*SWEEP_BLOCK_SIZE, j1 = GW_MIN( p, j0+SWEEP_BLOCK_SIZE );
+					int k0 = bk*SWEEP_BLOCK_SIZE, k1 = GW_MIN( q, k0+SWEEP_BLOCK_SIZE );
+					for( int kc=0; kc<k1-k0; ++kc )
+					for( int jc=0; jc<j1-j0; ++jc )
+					for( int ic=0; ic<i1-i0; ++ic )
+					{
+						int ii = si>0 ? i0+ic : i1-1-ic;
+						int jj = sj>0 ? j0+jc : j1-1-jc;
+						int kk = sk>0 ? k0+kc : k1-1-kc;
+						if( ((int) S_(ii,jj,kk))==kDead )
+							continue;
+						int kmin;
+						double A1 = compute_update_3d( ii,jj,kk, h, callback_insert_node, kmin );
+						if( A1<D_(ii,jj,kk) && (L==NULL || A1<=L_(ii,jj,kk)) )
+						{
+							if( D_(ii,jj,kk)-A1 > GW_EPSILON*h )
+								nb_changed++;
+							D_(ii,jj,kk) = A1;
+							Q_(ii,jj,kk) = kmin;
+							S_(ii,jj,kk) = kOpen;
+						}
+					}
+				}
+			}
+		}
+		if( nb_changed==0 )
+			break;
+	}
+	for( int s=0; s<n*p*q; ++s )
+		if( ((int) S[s])==kOpen )
+			S[s] = kDead;
+}
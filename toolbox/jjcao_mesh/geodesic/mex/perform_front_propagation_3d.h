@@ -30,4 +30,11 @@ typedef bool (*T_callback_intert_node)(int i, int j, int k, int ii, int jj, int
 // main function
 void perform_front_propagation_3d(T_callback_intert_node callback_insert_node = NULL);
 
+// alternative engines, same inputs and outputs (D,S,Q) as perform_front_propagation_3d
+// untidy priority queue : O(1) bucketed queue, the ordering is only exact up to the bucket width.
+void perform_front_propagation_3d_untidy(T_callback_intert_node callback_insert_node = NULL);
+// block fast sweeping : Gauss-Seidel sweeps over blocks processed in parallel along anti-diagonals,
+// nb_iter_max is the maximum number of sweep rounds, H and end_points are ignored.
+void perform_front_propagation_3d_sweeping(T_callback_intert_node callback_insert_node = NULL);
+
 #endif // _PERFORM_FRONT_PROPAGATION_3D_H_
\ No newline at end of file
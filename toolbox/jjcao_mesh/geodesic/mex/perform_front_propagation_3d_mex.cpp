@@ -2,7 +2,7 @@
 % perform_front_propagation_3d - perform a Fast Marching front propagation.
 %
 %   OLD : [D,S] = perform_front_propagation_2d(W,start_points,end_points,nb_iter_max,H);
-%	[D,S,Q] = perform_front_propagation_3d(W,start_points,end_points,nb_iter_max, H, L);
+%	[D,S,Q] = perform_front_propagation_3d(W,start_points,end_points,nb_iter_max, H, L, values, method);
 %
 %   'D' is a 2D array containing the value of the distance function to seed.
 %	'S' is a 2D array containing the state of each point : 
@@ -13,6 +13,12 @@
 %	'start_points' is a 3 x num_start_points matrix where k is the number of starting points.
 %	'H' is an heuristic (distance that remains to goal). This is a 2D matrix.
 %   
+%	method selects the engine :
+%		'fm' (default) : fast marching with a Fibonacci heap.
+%		'untidy' : fast marching with a bucketed (untidy) priority queue, O(N).
+%		'sweeping' : parallel block fast sweeping, nb_iter_max is then the maximum
+%			number of sweep rounds, H and end_points are ignored.
+%   
 %   Copyright (c) 2004 Gabriel Peyré
 *=================================================================*/
 
@@ -25,7 +31,7 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 { 
 	/* retrive arguments */
 	if( nrhs<4 ) 
-		mexErrMsgTxt("4 - 7 input arguments are required."); 
+		mexErrMsgTxt("4 - 8 input arguments are required."); 
 	if( nlhs<1 ) 
 		mexErrMsgTxt("1, 2 or 3 output arguments are required."); 
 
@@ -65,6 +71,8 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 	if( nrhs>=6 )
 	{
 		L = mxGetPr(prhs[5]);
+		if( mxGetM(prhs[5])==0 && mxGetN(prhs[5])==0 )
+			L=NULL;
 		if( L!=NULL && (mxGetDimensions(prhs[5])[0]!=n || mxGetDimensions(prhs[5])[1]!=p || mxGetDimensions(prhs[5])[2]!=q) )
 			mexErrMsgTxt("L must be of size n x p x q."); 
 	}
@@ -81,6 +89,22 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 	}
 	else
 		values = NULL;
+	// argument 8: engine
+	int method = 0;
+	if( nrhs>=8 )
+	{
+		char str[32];
+		if( mxGetString(prhs[7], str, 32)!=0 )
+			mexErrMsgTxt("method must be a string.");
+		if( strcmp(str,"fm")==0 )
+			method = 0;
+		else if( strcmp(str,"untidy")==0 )
+			method = 1;
+		else if( strcmp(str,"sweeping")==0 )
+			method = 2;
+		else
+			mexErrMsgTxt("method must be 'fm', 'untidy' or 'sweeping'.");
+	}
 		
 	// first ouput : distance
 	int dims[3] = {n,p,q};
@@ -109,7 +133,12 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 
 	
 	// launch the propagation
-	perform_front_propagation_3d();
+	if( method==1 )
+		perform_front_propagation_3d_untidy();
+	else if( method==2 )
+		perform_front_propagation_3d_sweeping();
+	else
+		perform_front_propagation_3d();
 
 	if( nlhs<2 )
 		GW_DELETEARRAY(S);		
@@ -46,71 +46,63 @@ inline void display_message(const char* mess, int v)
 
 
 
-double* vertex = NULL;
-int nverts = -1; 
-double* faces = NULL;
-int nfaces = -1; 
-double* start_points = NULL;
-int nstart = -1;
-double* end_points = NULL;
-int nend = -1;
-double* H = NULL;	// heuristic
-double* L = NULL;	// bound on current distance
-double* Ww = NULL;	// weight
-int niter_max = -1;
-double dmax = 1e9;
-double* values = NULL;
-// outputs 
-double* D = NULL;	// distance
-double* S = NULL;	// state
-double* Q = NULL;	// nearest neighbor
-
 #define faces_(k,i) faces[k+3*i]
 #define vertex_(k,i) vertex[k+3*i]
 
+/* State read by the callbacks. It is given to the mesh as the callback context
+   rather than stored in globals, so several propagations can run concurrently. */
+struct FastMarchingContext
+{
+	double* H;	// heuristic
+	double* L;	// bound on current distance
+	double* Ww;	// weight
+	int niter_max;
+	double dmax;
+	int nbr_iter;
+	std::vector<bool> is_end_point;	// O(1) test of the end points
+};
 
-GW_Float WeightCallback(GW_GeodesicVertex& Vert)
+GW_Float WeightCallback( GW_GeodesicVertex& Vert, void* pContext )
 {
+	FastMarchingContext* ctx = (FastMarchingContext*) pContext;
 	GW_U32 i = Vert.GetID();
-	return Ww[i];
+	return ctx->Ww[i];
 }
 
-GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert )
+GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert, void* pContext )
 {
+	FastMarchingContext* ctx = (FastMarchingContext*) pContext;
 	// check if the end point has been reached
 	GW_U32 i = Vert.GetID();
-//	display_message("ind %d",i );
-//	display_message("dist %f",Vert.GetDistance() );
-	if( Vert.GetDistance()>dmax )
+	if( Vert.GetDistance()>ctx->dmax )
 		return true;
-	for( int k=0; k<nend; ++k )
-		if( end_points[k]==i )
-			return true;
-	return false;
+	return ctx->is_end_point[i];
 }
-int nbr_iter = 0;
-GW_Bool InsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist )
+GW_Bool InsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist, void* pContext )
 {
+	FastMarchingContext* ctx = (FastMarchingContext*) pContext;
 	// check if the distance of the new point is less than the given distance
 	GW_U32 i = Vert.GetID();
-	bool doinsersion = nbr_iter<=niter_max;
-	if( L!=NULL )
-		doinsersion = doinsersion && (rNewDist<L[i]);
-	nbr_iter++;
+	bool doinsersion = ctx->nbr_iter<=ctx->niter_max;
+	if( ctx->L!=NULL )
+		doinsersion = doinsersion && (rNewDist<ctx->L[i]);
+	ctx->nbr_iter++;
 	return doinsersion;
 }
-GW_Float HeuristicCallback( GW_GeodesicVertex& Vert )
+GW_Float HeuristicCallback( GW_GeodesicVertex& Vert, void* pContext )
 {
+	FastMarchingContext* ctx = (FastMarchingContext*) pContext;
 	// return the heuristic distance
 	GW_U32 i = Vert.GetID();
-	return H[i];
+	return ctx->H[i];
 }
 
 
 void mexFunction(	int nlhs, mxArray *plhs[], 
 				 int nrhs, const mxArray*prhs[] ) 
 { 
-	nbr_iter = 0;
+	FastMarchingContext ctx;
+	ctx.nbr_iter = 0;
 	/* retrive arguments */
 	if( nrhs<6 ) 
 		mexErrMsgTxt("6 or 7 input arguments are required."); 
@@ -118,56 +110,64 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 		mexErrMsgTxt("1 or 2 output arguments are required."); 
 
 	// arg1 : vertex
-	vertex = mxGetPr(prhs[0]);
-	nverts = mxGetN(prhs[0]); 
+	double* vertex = mxGetPr(prhs[0]);
+	int nverts = mxGetN(prhs[0]); 
 	if( mxGetM(prhs[0])!=3 )
 		mexErrMsgTxt("vertex must be of size 3 x nverts."); 
 	// arg2 : faces
-	faces = mxGetPr(prhs[1]);
-	nfaces = mxGetN(prhs[1]);
+	double* faces = mxGetPr(prhs[1]);
+	int nfaces = mxGetN(prhs[1]);
 	if( mxGetM(prhs[1])!=3 )
 		mexErrMsgTxt("face must be of size 3 x nfaces."); 
 	// arg3 : W
-	Ww = mxGetPr(prhs[2]);
+	ctx.Ww = mxGetPr(prhs[2]);
 	int m = mxGetM(prhs[2]);
 	if( m!=nverts )
 		mexErrMsgTxt("W must be of same size as vertex."); 
 	// arg4 : start_points
-	start_points = mxGetPr(prhs[3]);
-	nstart = mxGetM(prhs[3]);
+	double* start_points = mxGetPr(prhs[3]);
+	int nstart = mxGetM(prhs[3]);
 	// arg5 : end_points
-	end_points = mxGetPr(prhs[4]);
-	nend = mxGetM(prhs[4]);
+	double* end_points = mxGetPr(prhs[4]);
+	int nend = mxGetM(prhs[4]);
+	ctx.is_end_point.assign( nverts, false );
+	for( int k=0; k<nend; ++k )
+	{
+		int i = (int) end_points[k];
+		if( i>=0 && i<nverts )	// other values were never reached
+			ctx.is_end_point[i] = true;
+	}
 	// arg6 : niter_max
-	niter_max = (int) *mxGetPr(prhs[5]);
+	ctx.niter_max = (int) *mxGetPr(prhs[5]);
 	// arg7 : H
 	if( nrhs>=7 )
 	{
-		H = mxGetPr(prhs[6]);
+		ctx.H = mxGetPr(prhs[6]);
 		int m =mxGetM(prhs[6]);
 		if( m>0 && m!=nverts )
 			mexErrMsgTxt("H must be of size nverts."); 
 		if( m==0 )
-			H = NULL;
+			ctx.H = NULL;
 	}
 	else
 	{
-		H = NULL;
+		ctx.H = NULL;
 	}
 	// arg8 : L
 	if( nrhs>=8 )
 	{
-		L = mxGetPr(prhs[7]);
+		ctx.L = mxGetPr(prhs[7]);
 		int m =mxGetM(prhs[7]);
 		if( m>0 && mxGetM(prhs[7])!=nverts )
 			mexErrMsgTxt("L must be of size nverts."); 
 		if( m==0 )
-			L = NULL;
+			ctx.L = NULL;
 	}
 	else
-		L = NULL;
+		ctx.L = NULL;
 		
 	// argument 9: value list
+	double* values = NULL;
 	if( nrhs>=9 )
 	{
 		values = mxGetPr(prhs[8]);
@@ -176,24 +176,22 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 		if( values!=NULL && (mxGetM(prhs[8])!=nstart || mxGetN(prhs[8])!=1) )
 			mexErrMsgTxt("values must be of size nb_start_points x 1."); 
 	}
-	else
-		values = NULL;
 	// argument 10: dmax
-	if( nrhs>=9 )
-		dmax = *mxGetPr(prhs[9]);
+	if( nrhs>=10 )
+		ctx.dmax = *mxGetPr(prhs[9]);
 	else
-		dmax = 1e9;
+		ctx.dmax = 1e9;
 
 
 	// first ouput : distance
 	plhs[0] = mxCreateDoubleMatrix(nverts, 1, mxREAL); 
-	D = mxGetPr(plhs[0]);
+	double* D = mxGetPr(plhs[0]);
 	// second output : state
 	plhs[1] = mxCreateDoubleMatrix(nverts, 1, mxREAL); 
-	S = mxGetPr(plhs[1]);
+	double* S = mxGetPr(plhs[1]);
 	// second output : segmentation
 	plhs[2] = mxCreateDoubleMatrix(nverts, 1, mxREAL); 
-	Q = mxGetPr(plhs[2]);
+	double* Q = mxGetPr(plhs[2]);
 
 	// create the mesh
 	GW_GeodesicMesh Mesh;
@@ -225,11 +223,11 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 		Mesh.AddStartVertex( *v );
 	}
 	Mesh.SetUpFastMarching();
-	Mesh.RegisterWeightCallbackFunction( WeightCallback );
-	Mesh.RegisterForceStopCallbackFunction( StopMarchingCallback );
-	Mesh.RegisterVertexInsersionCallbackFunction( InsersionCallback );
-	if( H!=NULL )
-		Mesh.RegisterHeuristicToGoalCallbackFunction( HeuristicCallback );
+	Mesh.RegisterWeightCallbackFunction( WeightCallback, &ctx );
+	Mesh.RegisterForceStopCallbackFunction( StopMarchingCallback, &ctx );
+	Mesh.RegisterVertexInsersionCallbackFunction( InsersionCallback, &ctx );
+	if( ctx.H!=NULL )
+		Mesh.RegisterHeuristicToGoalCallbackFunction( HeuristicCallback, &ctx );
 	// initialize the distance of the starting points
 	if( values!=NULL )
 	for( int i=0; i<nstart; ++i )
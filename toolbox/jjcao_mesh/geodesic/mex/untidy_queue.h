@@ -0,0 +1,64 @@
+/*=================================================================
+% untidy_queue - O(1) bucketed priority queue shared by the untidy engines
+%	of perform_front_propagation_2d and perform_front_propagation_3d.
+%
+%	Yatziv, Bartesaghi and Sapiro, "O(N) implementation of the fast
+%	marching algorithm", JCP 2006. Keys are rounded down to a bucket of
+%	width delta, so the ordering is only exact up to delta.
+*=================================================================*/
+
+#ifndef _UNTIDY_QUEUE_H_
+#define _UNTIDY_QUEUE_H_
+
+#include <math.h>
+#include <vector>
+
+#define UNTIDY_MAX_BUCKETS 65536
+
+// circular array of FIFO buckets of width delta
+class untidy_queue
+{
+public:
+	untidy_queue( double delta_, int nb_buckets )
+	{
+		delta = delta_;
+		buckets.resize( nb_buckets );
+		heads.resize( nb_buckets, 0 );
+		cur = 0;
+		size = 0;
+	}
+	bool empty()
+	{ return size==0; }
+	void push( int pos, double key )
+	{
+		int nb = (int) buckets.size();
+		double b = floor( key/delta );
+		int slot = cur;
+		if( b>cur+nb-1 )
+			slot = cur+nb-1;
+		else if( b>cur )
+			slot = (int) b;
+		buckets[slot%nb].push_back( pos );
+		size++;
+	}
+	int pop()
+	{
+		int nb = (int) buckets.size();
+		while( heads[cur%nb]>=(int) buckets[cur%nb].size() )
+		{
+			buckets[cur%nb].clear();
+			heads[cur%nb] = 0;
+			cur++;
+		}
+		size--;
+		return buckets[cur%nb][ heads[cur%nb]++ ];
+	}
+private:
+	double delta;
+	std::vector< std::vector<int> > buckets;
+	std::vector<int> heads;
+	int cur;	// absolute index of the current bucket
+	int size;
+};
+
+#endif // _UNTIDY_QUEUE_H_
@@ -0,0 +1,49 @@
+% test_perform_front_propagation
+%
+% compare the engines of perform_front_propagation_2d/3d: 
+% 'fm' (Fibonacci heap), 'untidy' (bucketed queue) and 'sweeping' (parallel block fast sweeping).
+%
+% Copyright (c) 2026 Junjie Cao
+
+clear;clc;close all;
+MYTOOLBOXROOT='../..';
+addpath ([MYTOOLBOXROOT '/jjcao_mesh/geodesic'])
+
+engines = {'fm', 'untidy', 'sweeping'};
+
+%% 2D images
+for n = [256 512 1024]
+    [X,Y] = meshgrid(1:n,1:n);
+    W = 1 + 0.5*sin(X/20).*cos(Y/30);
+    start_points = [round(n/3) round(2*n/3); round(n/2) round(n/3)];
+    fprintf('2D %d x %d\n', n, n);
+    for m = 1:length(engines)
+        tic;
+        [D,S,Q] = perform_front_propagation_2d(W, start_points, [], n*n, [], [], [], engines{m});
+        t = toc;
+        if m==1
+            D0 = D;
+        end
+        fprintf('  %-9s %8.3fs  max|D-D_fm| = %g\n', engines{m}, t, max(abs(D(:)-D0(:))));
+    end
+end
+figure('name', '2D distance, sweeping'); imagesc(D); axis image; colorbar;
+
+%% 3D volumes
+for n = [64 128 256]
+    [X,Y,Z] = ndgrid(1:n,1:n,1:n);
+    W = 1 + 0.5*sin(X/10).*cos(Y/15).*sin(Z/12);
+    clear X Y Z;
+    start_points = [round(n/3) round(2*n/3); round(n/2) round(n/3); round(n/2) 1];
+    fprintf('3D %d x %d x %d\n', n, n, n);
+    for m = 1:length(engines)
+        tic;
+        [D,S,Q] = perform_front_propagation_3d(W, start_points, [], n^3, [], [], [], engines{m});
+        t = toc;
+        if m==1
+            D0 = D;
+        end
+        fprintf('  %-9s %8.3fs  max|D-D_fm| = %g\n', engines{m}, t, max(abs(D(:)-D0(:))));
+    end
+end
+figure('name', '3D distance, middle slice'); imagesc(D(:,:,round(end/2))); axis image; colorbar;
@@ -0,0 +1,419 @@
+/*=================================================================
+*
+* As-rigid-as-possible local/global solver, for UV parameterization and 3D deformation
+*
+* usage:
+		[Y, iterations, E] = perform_arap(verts, faces, Y0, options);
+* inputs:
+		verts: 3*nverts, rest pose
+		faces: 3*nfaces
+		Y0: initial guess, its number of rows selects the problem
+			2*nverts: UV parameterization, one rotation per triangle.
+			%          Refer to A Local/Global Approach to Mesh Parameterization_08.
+			3*nverts: deformation, one rotation per vertex (the cell is its one ring).
+			%          Refer to As-Rigid-As-Possible Surface Modeling_07.
+		options.tolerance: stop when the energy changes less than it, default 0.001 as ARAP.m
+		options.nb_iter_max: default 100
+		options.handles: 1*k indices of the constrained vertices, default 1.
+		options.handle_pos: (2 or 3)*k positions of the handles, default Y0(:,handles).
+* outputs:
+		Y: the result, same size as Y0
+		iterations: number of local/global iterations
+		E: the final rigidity energy
+*
+*	The cotangent Laplacian restricted to the free vertices is factorized once,
+*	each global step is then only a multi right hand side back substitution.
+*	The local step uses closed form rotations (2*2) or a 3*3 Jacobi SVD, in parallel.
+*
+* JJCAO, 2013
+*
+*=================================================================*/
+
+#include <mex.h>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/Dense>
+#include <Eigen/SVD>
+#include <vector>
+#include <sstream>
+#include <cmath>
+#include <climits>
+
+using namespace Eigen;
+using namespace std;
+
+typedef Triplet<double> T;
+
+/// Return cotangent of (P,Q,R) corner (ie cotan of QP,QR angle).
+double cotangent(const Vector3d& P,
+                    const Vector3d& Q,
+                    const Vector3d& R)
+{
+    Vector3d u = P - Q;
+    Vector3d v = R - Q;
+    double dot = u.dot(v);
+    Vector3d cross_vector = u.cross(v);
+    double cross_norm = std::sqrt(cross_vector.dot(cross_vector));
+    if(cross_norm != 0.0)
+        return (dot/cross_norm);
+    else
+        return 0.0; // undefined
+}
+
+class ArapSolver
+{
+public:
+	ArapSolver(const double* verts, int nverts, const vector<int>& faces, int dim)
+		: verts_(verts), nverts_(nverts), faces_(faces), nfaces_((int)faces.size()/3), dim_(dim)
+	{
+		compute_cot_weight();
+		if (dim_ == 2)
+			compute_flattened_edges();
+	}
+
+	/// factorize the Laplacian on the free vertices, false if it is singular
+	bool set_handles(const vector<int>& handles)
+	{
+		handle_.assign(nverts_, -1);
+		for (size_t k = 0; k < handles.size(); ++k)
+			handle_[handles[k]] = (int)k;
+		free_id_.assign(nverts_, -1);
+		int nfree = 0;
+		for (int i = 0; i < nverts_; ++i)
+			if (handle_[i] < 0)
+				free_id_[i] = nfree++;
+
+		vector<T> coef;
+		coef.reserve(L_.nonZeros());
+		for (int j = 0; j < L_.outerSize(); ++j)
+			for (SparseMatrix<double>::InnerIterator it(L_, j); it; ++it)
+				if (free_id_[it.row()] >= 0 && free_id_[it.col()] >= 0)
+					coef.push_back(T(free_id_[it.row()], free_id_[it.col()], it.value()));
+		SparseMatrix<double> Lff(nfree, nfree);
+		Lff.setFromTriplets(coef.begin(), coef.end());
+		solver_.compute(Lff);
+		return solver_.info() == Success;
+	}
+
+	/// Y: dim*nverts, handles already at their positions. Return the energy.
+	double solve(double* Y, double tolerance, int nb_iter_max, int& iterations)
+	{
+		double E = -1, Epre = 0;
+		for (iterations = 0; iterations < nb_iter_max && std::abs(Epre - E) > tolerance; )
+		{
+			++iterations;
+			Epre = E;
+			local_step(Y);
+			global_step(Y);
+			E = energy(Y);
+		}
+		return E;
+	}
+
+private:
+	/// cot_[3*f+l] is the cotangent of corner l, it weights the opposite edge. L_ = sum of them.
+	void compute_cot_weight()
+	{
+		cot_.resize(3*nfaces_);
+		vector<T> coef;
+		coef.reserve(12*nfaces_);
+		for (int f = 0; f < nfaces_; ++f)
+		{
+			for (int l = 0; l < 3; ++l)
+			{
+				int i = faces_[3*f+l], j = faces_[3*f+(l+1)%3], k = faces_[3*f+(l+2)%3];
+				Vector3d p(verts_[3*j],verts_[3*j+1],verts_[3*j+2]);
+				Vector3d q(verts_[3*i],verts_[3*i+1],verts_[3*i+2]);
+				Vector3d r(verts_[3*k],verts_[3*k+1],verts_[3*k+2]);
+				double c = cotangent(p, q, r);
+				cot_[3*f+l] = c;
+				coef.push_back(T(j,j,c));
+				coef.push_back(T(k,k,c));
+				coef.push_back(T(j,k,-c));
+				coef.push_back(T(k,j,-c));
+			}
+		}
+		L_.resize(nverts_, nverts_);
+		L_.setFromTriplets(coef.begin(), coef.end());
+		L_.makeCompressed();
+	}
+
+	/// isometric flattening of each triangle, edge_[3*f+l] is the edge opposite to corner l, as CalEdgeVectors.m
+	void compute_flattened_edges()
+	{
+		edge_.resize(3*nfaces_);
+		for (int f = 0; f < nfaces_; ++f)
+		{
+			Vector3d v[3];
+			for (int l = 0; l < 3; ++l)
+			{
+				int i = faces_[3*f+l];
+				v[l] = Vector3d(verts_[3*i],verts_[3*i+1],verts_[3*i+2]);
+			}
+			double a = (v[1]-v[0]).norm();
+			double c = (v[2]-v[0]).norm();
+			Vector3d ex = (v[1]-v[0]) / (a > 0 ? a : 1);
+			double x3 = (v[2]-v[0]).dot(ex);
+			double y3 = std::sqrt(std::max(c*c - x3*x3, 0.0));
+			Vector2d p1(0,0), p2(a,0), p3(x3,y3);
+			edge_[3*f]   = p3 - p2;
+			edge_[3*f+1] = p1 - p3;
+			edge_[3*f+2] = p2 - p1;
+		}
+	}
+
+	Vector3d rest(int i) const
+	{ return Vector3d(verts_[3*i],verts_[3*i+1],verts_[3*i+2]); }
+
+	void local_step(const double* Y)
+	{
+		if (dim_ == 2)
+		{
+			rot2_.resize(nfaces_);
+#pragma omp parallel for schedule(static)
+			for (int f = 0; f < nfaces_; ++f)
+			{
+				Matrix2d M = Matrix2d::Zero();	// sum c * u * e^T
+				for (int l = 0; l < 3; ++l)
+				{
+					int j = faces_[3*f+(l+1)%3], k = faces_[3*f+(l+2)%3];
+					Vector2d u(Y[2*k]-Y[2*j], Y[2*k+1]-Y[2*j+1]);
+					M += cot_[3*f+l] * u * edge_[3*f+l].transpose();
+				}
+				// the rotation maximizing trace(R^T M)
+				double a = M(0,0)+M(1,1), b = M(1,0)-M(0,1);
+				double r = std::sqrt(a*a+b*b);
+				if (r > 0) { a /= r; b /= r; }
+				else { a = 1; b = 0; }
+				rot2_[f] << a, -b, b, a;
+			}
+		}
+		else
+		{
+			rot3_.resize(nverts_);
+#pragma omp parallel for schedule(dynamic,256)
+			for (int i = 0; i < nverts_; ++i)
+			{
+				Matrix3d S = Matrix3d::Zero();	// sum w * e * e'^T
+				Vector3d pi = rest(i);
+				Vector3d yi(Y[3*i],Y[3*i+1],Y[3*i+2]);
+				for (SparseMatrix<double>::InnerIterator it(L_, i); it; ++it)
+				{
+					int j = (int)it.row();
+					if (j == i) continue;
+					Vector3d e = pi - rest(j);
+					Vector3d e2 = yi - Vector3d(Y[3*j],Y[3*j+1],Y[3*j+2]);
+					S += (-it.value()) * e * e2.transpose();
+				}
+				JacobiSVD<Matrix3d> svd(S, ComputeFullU | ComputeFullV);
+				Matrix3d U = svd.matrixU();
+				Matrix3d R = svd.matrixV() * U.transpose();
+				if (R.determinant() < 0)
+				{
+					U.col(2) *= -1;	// smallest singular value
+					R = svd.matrixV() * U.transpose();
+				}
+				rot3_[i] = R;
+			}
+		}
+	}
+
+	void global_step(double* Y)
+	{
+		MatrixXd b = MatrixXd::Zero(nverts_, dim_);
+		if (dim_ == 2)
+		{
+			for (int f = 0; f < nfaces_; ++f)
+				for (int l = 0; l < 3; ++l)
+				{
+					int j = faces_[3*f+(l+1)%3], k = faces_[3*f+(l+2)%3];
+					Vector2d Re = cot_[3*f+l] * (rot2_[f] * edge_[3*f+l]);
+					b.row(k) += Re.transpose();
+					b.row(j) -= Re.transpose();
+				}
+		}
+		else
+		{
+#pragma omp parallel for schedule(dynamic,256)
+			for (int i = 0; i < nverts_; ++i)
+			{
+				Vector3d bi = Vector3d::Zero();
+				Vector3d pi = rest(i);
+				for (SparseMatrix<double>::InnerIterator it(L_, i); it; ++it)
+				{
+					int j = (int)it.row();
+					if (j == i) continue;
+					bi += (-it.value()) * 0.5 * ((rot3_[i] + rot3_[j]) * (pi - rest(j)));
+				}
+				b.row(i) = bi.transpose();
+			}
+		}
+
+		// move the handles to the right hand side
+		int nfree = (int)solver_.rows();
+		MatrixXd bf(nfree, dim_);
+		for (int i = 0; i < nverts_; ++i)
+			if (free_id_[i] >= 0)
+				bf.row(free_id_[i]) = b.row(i);
+		for (int j = 0; j < nverts_; ++j)
+		{
+			if (handle_[j] < 0) continue;
+			for (SparseMatrix<double>::InnerIterator it(L_, j); it; ++it)
+				if (free_id_[it.row()] >= 0)
+					for (int d = 0; d < dim_; ++d)
+						bf(free_id_[it.row()], d) -= it.value() * Y[dim_*j+d];
+		}
+		MatrixXd x = solver_.solve(bf);
+		for (int i = 0; i < nverts_; ++i)
+			if (free_id_[i] >= 0)
+				for (int d = 0; d < dim_; ++d)
+					Y[dim_*i+d] = x(free_id_[i], d);
+	}
+
+	double energy(const double* Y) const
+	{
+		double E = 0;
+		if (dim_ == 2)
+		{
+#pragma omp parallel for schedule(static) reduction(+:E)
+			for (int f = 0; f < nfaces_; ++f)
+				for (int l = 0; l < 3; ++l)
+				{
+					int j = faces_[3*f+(l+1)%3], k = faces_[3*f+(l+2)%3];
+					Vector2d u(Y[2*k]-Y[2*j], Y[2*k+1]-Y[2*j+1]);
+					E += cot_[3*f+l] * (u - rot2_[f]*edge_[3*f+l]).squaredNorm();
+				}
+		}
+		else
+		{
+#pragma omp parallel for schedule(dynamic,256) reduction(+:E)
+			for (int i = 0; i < nverts_; ++i)
+			{
+				Vector3d pi = rest(i);
+				Vector3d yi(Y[3*i],Y[3*i+1],Y[3*i+2]);
+				for (SparseMatrix<double>::InnerIterator it(L_, i); it; ++it)
+				{
+					int j = (int)it.row();
+					if (j == i) continue;
+					Vector3d e2 = yi - Vector3d(Y[3*j],Y[3*j+1],Y[3*j+2]);
+					E += (-it.value()) * (e2 - rot3_[i]*(pi - rest(j))).squaredNorm();
+				}
+			}
+		}
+		return E;
+	}
+
+	const double* verts_;
+	int nverts_;
+	const vector<int>& faces_;
+	int nfaces_;
+	int dim_;
+
+	vector<double> cot_;
+	SparseMatrix<double> L_;
+	vector<Vector2d, aligned_allocator<Vector2d> > edge_;
+	vector<Matrix2d, aligned_allocator<Matrix2d> > rot2_;
+	vector<Matrix3d> rot3_;
+
+	vector<int> handle_;	// index in handles, -1 for a free vertex
+	vector<int> free_id_;	// row in the reduced system, -1 for a handle
+	SimplicialLDLT< SparseMatrix<double> > solver_;
+};
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray*prhs[])
+{
+	///////////// Error Check
+	if ( nrhs < 3)
+		mexErrMsgTxt("Number of input should be > 2");
+	if ( nlhs < 1 || nlhs > 3)
+		mexErrMsgTxt("Number of output should be 1, 2 or 3");
+
+	///////////// input & output arguments
+	// input 0: verts: 3*nverts
+	int row = mxGetM(prhs[0]);
+	int nverts = mxGetN(prhs[0]);
+	if(row != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! it is excepted to be 3*n");
+	double *verts = mxGetPr(prhs[0]);
+
+	// input 1: faces: 3*nfaces
+	row = mxGetM(prhs[1]);
+	int nfaces = mxGetN(prhs[1]);
+	if(row != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! it is excepted to be 3*n");
+	double* pfaces = mxGetPr(prhs[1]);
+	vector<int> faces(3*nfaces);
+	for(int i = 0; i < nfaces*3; ++i)
+	{
+		faces[i] = (int)pfaces[i] - 1;
+		if (faces[i] < 0 || faces[i] >= nverts)
+			mexErrMsgTxt("faces index out of range!");
+	}
+
+	// input 2: Y0: 2*nverts or 3*nverts
+	int dim = mxGetM(prhs[2]);
+	if ( (dim != 2 && dim != 3) || mxGetN(prhs[2]) != nverts)
+		mexErrMsgTxt("Y0 is excepted to be 2*nverts or 3*nverts");
+
+	// input 3: options
+	double tolerance = 0.001;
+	int nb_iter_max = 100;
+	vector<int> handles(1, 0);
+	double* handle_pos(0);
+	if ( nrhs > 3)
+	{
+		mxArray* tmp;
+		const mxArray *options = prhs[3];
+		if ( mxSTRUCT_CLASS != mxGetClassID(options))
+			mexErrMsgTxt("4th arguments is not a structure!");
+		tmp = mxGetField(options,0,"tolerance");
+		if (tmp)
+			tolerance = mxGetScalar(tmp);
+		tmp = mxGetField(options,0,"nb_iter_max");
+		if (tmp)
+			nb_iter_max = mxGetScalar(tmp) < INT_MAX ? (int)mxGetScalar(tmp) : INT_MAX;
+		tmp = mxGetField(options,0,"handles");
+		if (tmp)
+		{
+			int nhandles = mxGetNumberOfElements(tmp);
+			double* ph = mxGetPr(tmp);
+			handles.resize(nhandles);
+			for (int k = 0; k < nhandles; ++k)
+			{
+				handles[k] = (int)ph[k] - 1;
+				if (handles[k] < 0 || handles[k] >= nverts)
+					mexErrMsgTxt("options.handles index out of range!");
+			}
+		}
+		tmp = mxGetField(options,0,"handle_pos");
+		if (tmp)
+		{
+			if (mxGetM(tmp) != dim || mxGetN(tmp) != handles.size())
+				mexErrMsgTxt("options.handle_pos must be of size size(Y0,1)*length(options.handles)");
+			handle_pos = mxGetPr(tmp);
+		}
+	}
+	if (handles.empty())
+		mexErrMsgTxt("At least one handle is needed!");
+
+	///////////////////////////////////////////////
+	// output 0
+	plhs[0] = mxCreateDoubleMatrix(dim, nverts, mxREAL);
+	double* Y = mxGetPr(plhs[0]);
+	memcpy(Y, mxGetPr(prhs[2]), dim*nverts*sizeof(double));
+	if (handle_pos)
+		for (size_t k = 0; k < handles.size(); ++k)
+			for (int d = 0; d < dim; ++d)
+				Y[dim*handles[k]+d] = handle_pos[dim*k+d];
+
+	ArapSolver arap(verts, nverts, faces, dim);
+	if (!arap.set_handles(handles))
+		mexErrMsgTxt("The cotangent Laplacian can not be factorized, check the mesh and the handles!");
+	int iterations = 0;
+	double E = arap.solve(Y, tolerance, nb_iter_max, iterations);
+
+	if (nlhs > 1)
+		plhs[1] = mxCreateDoubleScalar(iterations);
+	if (nlhs > 2)
+		plhs[2] = mxCreateDoubleScalar(E);
+}
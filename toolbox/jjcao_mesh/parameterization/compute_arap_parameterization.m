@@ -6,6 +6,17 @@ if nargin < 4
     tolerance = 0.001;
 end
 
+%%%%%%%%%%%%%%%%%%%% Native solver, same energy and constraint u(1)=[0,0] %%%%%%%%%%%%%%%%%%%%
+if exist('perform_arap', 'file') == 3
+    options.tolerance = tolerance;
+    options.nb_iter_max = Inf;
+    options.handles = 1;
+    options.handle_pos = [0;0];
+    [vt, iterations] = perform_arap(verts', faces', vt(:,1:2)', options);
+    vt = vt';
+    return;
+end
+
 %%%%%%%%%%%%%%%%%%%% Pre-Computations %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 EV=CalEdgeVectors(verts,faces);   %Calculate edge vectors of all the triangles
 C=CalCots(verts,faces);   %Calculate cot weights of each angle in each triangle 
@@ -0,0 +1,107 @@
+/*=================================================================
+*
+* Distortion of a batch of parameterizations of one triangle mesh
+*
+* usage:
+		[D, l2PerFace, anglePerVertex] = compute_parameterization_distortion(verts, faces, uv);
+* compile:
+		mex -I../../../examples/04-fileIO_String/Mesh_io/include COMPFLAGS="$COMPFLAGS /openmp" compute_parameterization_distortion.cpp
+* inputs:
+		verts: 3*nverts
+		faces: 3*nfaces
+		uv: 2*nverts*k, k candidate parameterizations
+* outputs:
+		D: k*5, per parameterization [L2 stretch, L_infinite stretch, angle
+			distortion, area distortion, number of flipped faces], see
+			DGAL::Parameterization_measurer_array.
+		l2PerFace: nfaces*k, L2 stretch of each face
+		anglePerVertex: nverts*k, angle distortion of each vertex
+*
+*	The mesh dependent part (3D areas and angles, border) is computed once,
+*	the candidates are then measured in parallel.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "mex.h"
+#include <vector>
+// DGAL/config.h pulls CGAL, only its namespace macros are needed here
+#define DGAL_CONFIG_H
+#define DGAL_BEGIN_NAMESPACE namespace DGAL {
+#define DGAL_END_NAMESPACE }
+#include <DGAL/Parameterization_measurer_array.h>
+using namespace std;
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray*prhs[])
+{
+	///////////// Error Check
+	if ( nrhs != 3)
+		mexErrMsgTxt("Number of input should be 3");
+	if ( nlhs > 3)
+		mexErrMsgTxt("Number of output should be 1, 2 or 3");
+
+	///////////// input & output arguments
+	// input 0: verts: 3*nverts
+	int row = mxGetM(prhs[0]);
+	int nverts = mxGetN(prhs[0]);
+	if(row != 3)
+		mexErrMsgTxt("verts is excepted to be 3*n");
+	double *verts = mxGetPr(prhs[0]);
+
+	// input 1: faces: 3*nfaces
+	row = mxGetM(prhs[1]);
+	int nfaces = mxGetN(prhs[1]);
+	if(row != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! it is excepted to be 3*n");
+	double* pfaces = mxGetPr(prhs[1]);
+	vector<int> faces(3*nfaces);
+	for(int i = 0; i < nfaces*3; ++i)
+	{
+		faces[i] = (int)pfaces[i] - 1;
+		if (faces[i] < 0 || faces[i] >= nverts)
+			mexErrMsgTxt("faces index out of range!");
+	}
+
+	// input 2: uv: 2*nverts*k
+	const mwSize *dims = mxGetDimensions(prhs[2]);
+	int ndim = mxGetNumberOfDimensions(prhs[2]);
+	if( !mxIsDouble(prhs[2]) || dims[0] != 2 || (int)dims[1] != nverts || ndim > 3)
+		mexErrMsgTxt("uv is excepted to be 2*nverts*k");
+	int k = ndim == 3 ? (int)dims[2] : 1;
+	double *uv = mxGetPr(prhs[2]);
+
+	DGAL::Parameterization_measurer_array measurer(verts, nverts, nfaces ? &faces[0] : NULL, nfaces);
+
+	// output
+	plhs[0] = mxCreateDoubleMatrix(k, 5, mxREAL);
+	double *D = mxGetPr(plhs[0]);
+	double *l2PerFace = NULL, *anglePerVertex = NULL;
+	if ( nlhs > 1)
+	{
+		plhs[1] = mxCreateDoubleMatrix(nfaces, k, mxREAL);
+		l2PerFace = mxGetPr(plhs[1]);
+	}
+	if ( nlhs > 2)
+	{
+		plhs[2] = mxCreateDoubleMatrix(nverts, k, mxREAL);
+		anglePerVertex = mxGetPr(plhs[2]);
+	}
+
+	// one candidate: parallel over its faces; a batch: parallel over the candidates
+	#pragma omp parallel for schedule(dynamic,1) if(k > 1)
+	for (int j = 0; j < k; ++j)
+	{
+		DGAL::Parameterization_distortion d;
+		measurer.measure(uv + 2*(size_t)nverts*j, d);
+		D[j] = d.l2;
+		D[j+k] = d.l_infinite;
+		D[j+2*k] = d.angle;
+		D[j+3*k] = d.area;
+		D[j+4*k] = d.num_flip_facets;
+		if (l2PerFace)
+			copy(d.l2_per_facet.begin(), d.l2_per_facet.end(), l2PerFace + (size_t)nfaces*j);
+		if (anglePerVertex)
+			copy(d.angle_per_vertex.begin(), d.angle_per_vertex.end(), anglePerVertex + (size_t)nverts*j);
+	}
+}
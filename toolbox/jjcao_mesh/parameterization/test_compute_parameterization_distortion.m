@@ -0,0 +1,33 @@
+% test_compute_parameterization_distortion
+%
+% distortion of a batch of parameterizations in one call
+%
+% Copyright (c) 2026 Junjie Cao
+
+clear;clc;close all;
+MYTOOLBOXROOT='../..';
+addpath ([MYTOOLBOXROOT '/jjcao_common'])
+addpath ([MYTOOLBOXROOT '/jjcao_io'])
+addpath ([MYTOOLBOXROOT '/jjcao_mesh'])
+addpath ([MYTOOLBOXROOT '/jjcao_mesh/parameterization/arap'])
+mex -I../../../examples/04-fileIO_String/Mesh_io/include COMPFLAGS="$COMPFLAGS /openmp" compute_parameterization_distortion.cpp
+
+%% candidates: the input uv and its ARAP iterations
+filename = 'data/Isis_dABF.obj';
+[verts, faces, normal, vt] = read_obj(filename);
+nb = 8;
+uv = zeros(2, size(verts,1), nb);
+uv(:,:,1) = vt(:,1:2)';
+options.handles = 1;
+options.handle_pos = [0;0];
+for i = 2:nb
+    options.nb_iter_max = i-1;
+    uv(:,:,i) = perform_arap(verts', faces', vt(:,1:2)', options);
+end
+
+%% measure all of them
+tic
+[D, l2PerFace, anglePerVertex] = compute_parameterization_distortion(verts', faces', uv);
+toc
+disp('    L2    L_inf   angle   area   flips');
+disp(D);
@@ -0,0 +1,60 @@
+% test_perform_arap
+%
+% as-rigid-as-possible parameterization and deformation by the native solver
+%
+% Copyright (c) 2026 Junjie Cao
+
+clear;clc;close all;
+MYTOOLBOXROOT='../..';
+addpath ([MYTOOLBOXROOT '/jjcao_common'])
+addpath ([MYTOOLBOXROOT '/jjcao_io'])
+addpath ([MYTOOLBOXROOT '/jjcao_plot'])
+addpath ([MYTOOLBOXROOT '/jjcao_interact'])
+addpath ([MYTOOLBOXROOT '/jjcao_mesh'])
+addpath ([MYTOOLBOXROOT '/jjcao_mesh/parameterization/arap'])
+
+%% parameterization: compare with the matlab implementation
+filename = 'data/Isis_dABF.obj';
+[verts, faces, normal, vt] = read_obj(filename);
+
+options.tolerance = 0.001;
+options.nb_iter_max = Inf;
+options.handles = 1;
+options.handle_pos = [0;0];
+tic
+[uv, iterations, E] = perform_arap(verts', faces', vt(:,1:2)', options);
+toc
+uv = uv';
+
+EV=CalEdgeVectors(verts,faces);
+C=CalCots(verts,faces);
+R=ARAP_Local(uv,faces,EV,C);
+sprintf('%d iterations, energy %f, matlab energy %f', iterations, E, CalRigidEnergy(EV,faces,uv,C,R))
+
+figure('Name','ARAP parameterization'); set(gcf,'color','white');
+trimesh(faces,uv(:,1),uv(:,2)); axis equal;
+title([num2str(iterations),' Iterations']);
+
+%% deformation: fix the lowest vertices, translate the highest ones
+nverts = size(verts,1);
+[~, order] = sort(verts(:,3));
+nhandles = max(round(nverts*0.05),1);
+fixed = order(1:nhandles);
+moved = order(end-nhandles+1:end);
+diagLength = norm(max(verts)-min(verts));
+
+clear options;
+options.tolerance = 1e-6;
+options.nb_iter_max = 50;
+options.handles = [fixed; moved]';
+options.handle_pos = [verts(fixed,:); verts(moved,:) + repmat([0.3*diagLength,0,0],nhandles,1)]';
+tic
+[Y, iterations, E] = perform_arap(verts', faces', verts', options);
+toc
+Y = Y';
+
+figure('Name','ARAP deformation'); set(gcf,'color','white');
+h = plot_mesh(Y, faces); hold on;
+scatter3(Y(options.handles,1),Y(options.handles,2),Y(options.handles,3),20,'r','filled');
+view3d rot;
+title(sprintf('%d iterations, energy %f', iterations, E));
@@ -10,11 +10,24 @@ function X = perform_lloyd_iteration(X,options)
 %
 %   You can give a local density using an image options.density
 %
+%   perform_lloyd_iteration_fast is used if options.use_c_implementation=1
+%   (default 0), X can then also be (3,n) with a 3D density. It does not
+%   give the same points: the cells are rasterized on the density grid (or
+%   a options.ndensity grid for a uniform density) instead of exact
+%   polygons, the density is used as given (not rescaled in each cell), and
+%   it stops before options.niter when no point moves more than options.tol
+%   if given.
+%
 %   Copyright (c) Gabriel Peyr   
 
 options.null = 0;
 niter = getoptions(options, 'niter',1);
 D = getoptions(options, 'density',[]);
+use_c_implementation = getoptions(options, 'use_c_implementation', 0);% fast C-coded version, see above
+if exist('perform_lloyd_iteration_fast', 'file') && use_c_implementation
+    X = perform_lloyd_iteration_fast(X, D, options);
+    return;
+end
 
 n = size(X,2);
 ndensity = size(D,1);
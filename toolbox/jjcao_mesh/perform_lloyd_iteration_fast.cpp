@@ -0,0 +1,111 @@
+/*=================================================================
+*
+* Lloyd relaxation of points in [0,1]^2 or [0,1]^3 with a density, the
+* iterations of perform_lloyd_iteration.m in one call, see LloydCvt.h
+*
+* usage:
+		[X, iterations, Q] = perform_lloyd_iteration_fast(X, density, options);
+* compile:
+		mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" perform_lloyd_iteration_fast.cpp
+* inputs:
+		X: 2*n or 3*n points in [0,1]^2 or [0,1]^3
+		density: N1*N2 (or N1*N2*N3) nonnegative density at the nodes
+			linspace(0,1,Ni), density(i,j) is at the point (x(i),y(j)) as
+			perform_lloyd_iteration.m, or [] for a uniform density
+		options.niter: max number of iterations, default 1
+		options.tol: stop when no point moves more than it, default none
+			(options.niter iterations)
+		options.ndensity: resolution of the grid for a uniform density,
+			default 256 in 2D, 64 in 3D. Use a grid with more nodes than
+			points, a point without node keeps its position.
+			Points at the same position are moved apart by a random step
+			of one grid spacing.
+* outputs:
+		X: the relaxed points
+		iterations: number of iterations done
+		Q: N1*N2(*N3) index of the Voronoi cell of each node, of the last
+			iteration, 0 for none
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "mex.h"
+#include "LloydCvt.h"
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	///////////// Error Check
+	if (nrhs < 1 || nrhs > 3)
+		mexErrMsgTxt("Usage: [X, iterations, Q] = perform_lloyd_iteration_fast(X, density, options)");
+	if (nlhs > 3)
+		mexErrMsgTxt("Number of output should be 1, 2 or 3");
+
+	int dim = (int)mxGetM(prhs[0]), n = (int)mxGetN(prhs[0]);
+	if (!mxIsDouble(prhs[0]) || (dim != 2 && dim != 3))
+		mexErrMsgTxt("X is excepted to be 2*n or 3*n");
+	const mxArray* options = (nrhs > 2 && mxIsStruct(prhs[2])) ? prhs[2] : NULL;
+	int niter = (int)get_option(options, "niter", 1);
+	double tol = get_option(options, "tol", -1);
+
+	int N[3] = {1, 1, 1};
+	const double* density = NULL;
+	if (nrhs > 1 && !mxIsEmpty(prhs[1]))
+	{
+		int nd = (int)mxGetNumberOfDimensions(prhs[1]);
+		if (!mxIsDouble(prhs[1]) || nd > dim || (dim == 3 && nd != 3))
+			mexErrMsgTxt("density is excepted to be N1*N2 for 2*n points, N1*N2*N3 for 3*n points");
+		for (int k = 0; k < nd; ++k)
+			N[k] = (int)mxGetDimensions(prhs[1])[k];
+		density = mxGetPr(prhs[1]);
+		for (size_t c = 0; c < mxGetNumberOfElements(prhs[1]); ++c)
+			if (density[c] < 0)
+				mexErrMsgTxt("density must be nonnegative");
+	}
+	else
+	{
+		int nd = (int)get_option(options, "ndensity", dim == 2 ? 256 : 64);
+		for (int k = 0; k < dim; ++k)
+			N[k] = nd;
+	}
+	if ((double)N[0]*N[1]*N[2] > 2147483647.0)
+		mexErrMsgTxt("the density grid is too large");
+
+	plhs[0] = mxDuplicateArray(prhs[0]);
+	double* X = mxGetPr(plhs[0]);
+	for (int k = 0; k < dim*n; ++k)
+		X[k] = std::min(1.0, std::max(0.0, X[k]));
+
+	GridCvt cvt(dim, N, density);
+	int it = 0;
+	while (it < niter)
+	{
+		double moved = cvt.step(X, n);
+		++it;
+		if (moved <= tol) break;
+	}
+
+	if (nlhs > 1)
+		plhs[1] = mxCreateDoubleScalar(it);
+	if (nlhs > 2)
+	{
+		if (it == 0)
+			cvt.jump_flood(X, n);
+		mwSize dims[3] = {(mwSize)N[0], (mwSize)N[1], (mwSize)N[2]};
+		plhs[2] = mxCreateNumericArray(dim, dims, mxDOUBLE_CLASS, mxREAL);
+		double* Q = mxGetPr(plhs[2]);
+		const std::vector<int>& label = cvt.labels();
+		for (size_t c = 0; c < label.size(); ++c)
+			Q[c] = label[c] + 1;
+	}
+}
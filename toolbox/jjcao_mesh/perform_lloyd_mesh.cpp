@@ -0,0 +1,149 @@
+/*=================================================================
+*
+* Lloyd relaxation of sites on a mesh surface: geodesic Voronoi cells by
+* perform_fast_marching_mesh, sites moved to the (density weighted)
+* centroids of their cells, see LloydCvt.h
+*
+* usage:
+		[sites, Q, D, iterations] = perform_lloyd_mesh(vertex, faces, sites, options);
+* compile:
+		mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" perform_lloyd_mesh.cpp
+		perform_front_propagation_mesh must be compiled too, see compile_mex.m
+* inputs:
+		vertex: 3*nverts
+		faces: 3*nfaces
+		sites: 1*n vertex indices, e.g. from perform_farthest_point_sampling_mesh
+		options.density: nverts*1 nonnegative, default uniform
+		options.niter: max number of iterations, default 10, the iterations
+			stop when no site moves
+* outputs:
+		sites: the relaxed sites, vertex indices
+		Q: nverts*1, Q(i) is the Voronoi cell number of the i th vertex, for
+			the final sites, 0 if not connected to any site
+		D: nverts*1, the geodesic distance to the site of the cell
+		iterations: number of iterations done
+*
+*	A site moves to the vertex of its cell nearest (in 3D) to the centroid
+*	of the cell. Sites given twice are spread to the farthest vertices.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "mex.h"
+#include "LloydCvt.h"
+
+// geodesic Voronoi cells of the sites by the toolbox: label[i] is the index
+// in sites of the cell of vertex i, -1 if not reached, dist[i] the distance
+void voronoi_mesh(const mxArray* vertex, const mxArray* faces, const std::vector<int>& sites,
+				  std::vector<int>& label, std::vector<double>& dist)
+{
+	int nverts = (int)mxGetN(vertex), n = (int)sites.size();
+	mxArray* in[3] = {const_cast<mxArray*>(vertex), const_cast<mxArray*>(faces), mxCreateDoubleMatrix(1, n, mxREAL)};
+	for (int s = 0; s < n; ++s)
+		mxGetPr(in[2])[s] = sites[s] + 1;
+	mxArray* out[3] = {NULL, NULL, NULL};
+	mexCallMATLAB(3, out, 3, in, "perform_fast_marching_mesh");
+	// Q holds the vertex of the nearest site, the first site on that vertex wins
+	std::vector<int> site_of(nverts, -1);
+	for (int s = n-1; s >= 0; --s)
+		site_of[sites[s]] = s;
+	const double *D = mxGetPr(out[0]), *Q = mxGetPr(out[2]);
+	label.resize(nverts);
+	dist.resize(nverts);
+	for (int i = 0; i < nverts; ++i)
+	{
+		int q = (int)Q[i] - 1;
+		label[i] = q >= 0 && q < nverts && mxIsFinite(D[i]) ? site_of[q] : -1;
+		dist[i] = D[i];
+	}
+	for (int k = 0; k < 3; ++k)
+		mxDestroyArray(out[k]);
+	mxDestroyArray(in[2]);
+}
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	///////////// Error Check
+	if (nrhs < 3 || nrhs > 4)
+		mexErrMsgTxt("Usage: [sites, Q, D, iterations] = perform_lloyd_mesh(vertex, faces, sites, options)");
+	if (nlhs > 4)
+		mexErrMsgTxt("Number of output should be 1 to 4");
+
+	int nverts = (int)mxGetN(prhs[0]);
+	if (!mxIsDouble(prhs[0]) || mxGetM(prhs[0]) != 3)
+		mexErrMsgTxt("vertex is excepted to be 3*nverts");
+	const double* verts = mxGetPr(prhs[0]);
+	int nfaces = (int)mxGetN(prhs[1]);
+	if (!mxIsDouble(prhs[1]) || mxGetM(prhs[1]) != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! faces is excepted to be 3*nfaces");
+	const double* pfaces = mxGetPr(prhs[1]);
+	std::vector<int> faces(3*nfaces);
+	for (int k = 0; k < 3*nfaces; ++k)
+	{
+		faces[k] = (int)pfaces[k] - 1;
+		if (faces[k] < 0 || faces[k] >= nverts)
+			mexErrMsgTxt("faces index out of range!");
+	}
+	int n = (int)mxGetNumberOfElements(prhs[2]);
+	if (!mxIsDouble(prhs[2]) || n < 1)
+		mexErrMsgTxt("sites is excepted to be 1*n vertex indices");
+	std::vector<int> sites(n);
+	for (int s = 0; s < n; ++s)
+	{
+		sites[s] = (int)mxGetPr(prhs[2])[s] - 1;
+		if (sites[s] < 0 || sites[s] >= nverts)
+			mexErrMsgTxt("sites index out of range!");
+	}
+	const mxArray* options = (nrhs > 3 && mxIsStruct(prhs[3])) ? prhs[3] : NULL;
+	int niter = (int)get_option(options, "niter", 10);
+	const double* density = NULL;
+	mxArray* field = options ? mxGetField(options, 0, "density") : NULL;
+	if (field && !mxIsEmpty(field))
+	{
+		if (!mxIsDouble(field) || (int)mxGetNumberOfElements(field) != nverts)
+			mexErrMsgTxt("options.density is excepted to be nverts*1");
+		density = mxGetPr(field);
+	}
+
+	MeshCvt cvt(verts, nverts, faces, density);
+	std::vector<int> label;
+	std::vector<double> dist;
+	int it = 0;
+	voronoi_mesh(prhs[0], prhs[1], sites, label, dist);
+	while (it < niter)
+	{
+		++it;
+		int moved = cvt.step(sites, label, dist);
+		voronoi_mesh(prhs[0], prhs[1], sites, label, dist);
+		if (moved == 0) break;
+	}
+
+	plhs[0] = mxCreateDoubleMatrix(mxGetM(prhs[2]), mxGetN(prhs[2]), mxREAL);
+	for (int s = 0; s < n; ++s)
+		mxGetPr(plhs[0])[s] = sites[s] + 1;
+	if (nlhs > 1)
+	{
+		plhs[1] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+		for (int i = 0; i < nverts; ++i)
+			mxGetPr(plhs[1])[i] = label[i] + 1;
+	}
+	if (nlhs > 2)
+	{
+		plhs[2] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+		for (int i = 0; i < nverts; ++i)
+			mxGetPr(plhs[2])[i] = label[i] < 0 ? mxGetInf() : dist[i];
+	}
+	if (nlhs > 3)
+		plhs[3] = mxCreateDoubleScalar(it);
+}
@@ -1,8 +1,8 @@
-function vertex1 = perform_mesh_heat_diffusion(vertex,face,L,options)
+function [vertex1, snapshots] = perform_mesh_heat_diffusion(vertex,face,L,options)
 
 % perform_mesh_heat_diffusion - perform heat diffusion
 %
-%   vertex1 = perform_mesh_heat_diffusion(vertex,face,L,options);
+%   [vertex1, snapshots] = perform_mesh_heat_diffusion(vertex,face,L,options);
 %
 %   L can be a laplacian or a string containing the type of laplacian.
 %
@@ -13,6 +13,13 @@ function vertex1 = perform_mesh_heat_diffusion(vertex,face,L,options)
 %   options.dt should be small enough (CLF condition) so that the scheme is
 %   stable.
 %
+%   If options.implicit=1, the scheme is implicit: (M+dt*L)*f(t+dt) = M*f(t),
+%   unconditionally stable. L is then symmetric: for a string, D-W with
+%   M=D (the same flow as I-D^-1*W); for a matrix, M is options.mass (the
+%   identity by default). The system is factorized once, by
+%   perform_mesh_heat_diffusion_fast if options.use_c_implementation=1.
+%   snapshots(:,:,k) is vertex1 after options.snapshots(k) steps.
+%
 %   Copyright (c) 2007 Gabriel Peyre
 
 options.null = 0;
@@ -31,8 +38,44 @@ if isfield(options, 'verb')
 else
     verb = 1;
 end
-    
+implicit = getoptions(options, 'implicit', 0);
+snapshots = [];
 
+if implicit
+    n = size(vertex,2);
+    if isstr(L)
+        options.symmetrize = 1;
+        options.normalize = 0;
+        L = compute_mesh_laplacian(vertex,face,L,options);
+        M = spdiags(full(diag(L)),0,n,n);
+    else
+        M = getoptions(options, 'mass', speye(n));
+    end
+    use_c_implementation = getoptions(options, 'use_c_implementation', 1);% use fast C-coded version if possible
+    if exist('perform_mesh_heat_diffusion_fast', 'file') && use_c_implementation
+        options.dt = dt; options.Tmax = Tmax;
+        [vertex1, snapshots] = perform_mesh_heat_diffusion_fast(L, M, vertex', options);
+        vertex1 = vertex1';
+        snapshots = permute(snapshots, [2 1 3]);
+        return;
+    end
+    % factorize once: R'*R = S'*(M+dt*L)*S
+    [R,p,S] = chol(M + dt*L);
+    if p>0
+        error('M + dt*L is not positive definite!');
+    end
+    steps = getoptions(options, 'snapshots', []);
+    niter = round(Tmax/dt);
+    vertex1 = vertex;
+    snapshots = zeros(size(vertex,1), n, length(steps));
+    snapshots(:,:,steps==0) = repmat(vertex1, [1 1 sum(steps==0)]);
+    for i=1:niter
+        vertex1 = (S*(R\(R'\(S'*(M*vertex1')))))';
+        snapshots(:,:,steps==i) = repmat(vertex1, [1 1 sum(steps==i)]);
+    end
+    return;
+end
+    
 if isstr(L)
     options.symmetrize = 0;
     options.normalize = 1;
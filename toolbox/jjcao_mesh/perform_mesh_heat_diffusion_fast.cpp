@@ -0,0 +1,186 @@
+/*=================================================================
+*
+* implicit heat diffusion on a mesh, (M + dt*L)*f(t+dt) = M*f(t), with the
+* system factorized once for all the time steps and all the channels of f
+*
+* usage:
+		[f, snapshots] = perform_mesh_heat_diffusion_fast(L, M, f, options);
+* compile:
+		mex -largeArrayDims -I"../../include/eigen-3.1.3" COMPFLAGS="$COMPFLAGS /openmp" perform_mesh_heat_diffusion_fast.cpp
+* inputs:
+		L: nverts*nverts sparse, symmetric positive semi-definite, e.g.
+			D-W of compute_mesh_laplacian with options.symmetrize = 1 and
+			options.normalize = 0
+		M: nverts*nverts sparse, or nverts*1 for a diagonal, or [] for
+			the identity; D for the same flow as L = I-D^-1*W
+		f: nverts*nchannels, e.g. vertex'
+		options.dt: time step, default 0.05
+		options.Tmax: default 3, round(Tmax/dt) steps as perform_mesh_heat_diffusion.m
+		options.snapshots: 1*k steps (in 0:round(Tmax/dt)) to record, in any
+			order and possibly repeated, default []
+* outputs:
+		f: nverts*nchannels, at time Tmax
+		snapshots: nverts*nchannels*k, f at the recorded steps
+*
+*	M + dt*L is factorized once by a sparse Cholesky (SimplicialLLT), every
+*	step is then M*f and two triangular solves, one channel per thread.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include <mex.h>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/Dense>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace Eigen;
+using namespace std;
+
+typedef Triplet<double> T;
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+/// Matlab sparse matrix to Eigen, n*n
+void to_sparse(const mxArray* a, int n, SparseMatrix<double>& sm)
+{
+	const double* pr = mxGetPr(a);
+	const mwIndex* ir = mxGetIr(a);
+	const mwIndex* jc = mxGetJc(a);
+	vector<T> coef;
+	coef.reserve(jc[n]);
+	for (int j = 0; j < n; ++j)
+		for (mwIndex p = jc[j]; p < jc[j+1]; ++p)
+			coef.push_back(T((int)ir[p], j, pr[p]));
+	sm.resize(n, n);
+	sm.setFromTriplets(coef.begin(), coef.end());
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	///////////// Error Check
+	if (nrhs < 3 || nrhs > 4)
+		mexErrMsgTxt("Usage: [f, snapshots] = perform_mesh_heat_diffusion_fast(L, M, f, options)");
+	if (nlhs > 2)
+		mexErrMsgTxt("Number of output should be 1 or 2");
+
+	int n = (int)mxGetM(prhs[0]);
+	if (!mxIsSparse(prhs[0]) || (int)mxGetN(prhs[0]) != n)
+		mexErrMsgTxt("L is excepted to be a sparse nverts*nverts matrix");
+	SparseMatrix<double> L;
+	to_sparse(prhs[0], n, L);
+	SparseMatrix<double> Lt = L.transpose();
+	if ((L - Lt).norm() > 1e-10*L.norm())
+		mexErrMsgTxt("L is excepted to be symmetric, use options.symmetrize = 1 and options.normalize = 0 and M = D for L = I-D^-1*W");
+
+	// M: sparse, diagonal or identity
+	SparseMatrix<double> M;
+	bool identity = mxIsEmpty(prhs[1]);
+	if (!identity)
+	{
+		if (mxIsSparse(prhs[1]))
+		{
+			if ((int)mxGetM(prhs[1]) != n || (int)mxGetN(prhs[1]) != n)
+				mexErrMsgTxt("M is excepted to be nverts*nverts");
+			to_sparse(prhs[1], n, M);
+		}
+		else
+		{
+			if (!mxIsDouble(prhs[1]) || (int)mxGetNumberOfElements(prhs[1]) != n)
+				mexErrMsgTxt("M is excepted to be nverts*nverts sparse, or nverts*1");
+			const double* d = mxGetPr(prhs[1]);
+			vector<T> coef;
+			for (int i = 0; i < n; ++i)
+				coef.push_back(T(i, i, d[i]));
+			M.resize(n, n);
+			M.setFromTriplets(coef.begin(), coef.end());
+		}
+	}
+
+	if (!mxIsDouble(prhs[2]) || (int)mxGetM(prhs[2]) != n)
+		mexErrMsgTxt("f is excepted to be nverts*nchannels");
+	int nc = (int)mxGetN(prhs[2]);
+
+	const mxArray* options = (nrhs > 3 && mxIsStruct(prhs[3])) ? prhs[3] : NULL;
+	double dt = get_option(options, "dt", 0.05);
+	double Tmax = get_option(options, "Tmax", 3);
+	if (dt <= 0)
+		mexErrMsgTxt("options.dt must be positive");
+	int niter = (int)floor(Tmax/dt + 0.5);
+	// snapshot indices of step s are record[rstart[s]..rstart[s+1]), a step
+	// may be asked several times
+	vector<int> rstart(niter+2, 0), record;
+	int nsnap = 0;
+	mxArray* snap = options ? mxGetField(options, 0, "snapshots") : NULL;
+	if (snap && !mxIsEmpty(snap))
+	{
+		nsnap = (int)mxGetNumberOfElements(snap);
+		for (int k = 0; k < nsnap; ++k)
+		{
+			int s = (int)mxGetPr(snap)[k];
+			if (s < 0 || s > niter)
+				mexErrMsgTxt("options.snapshots is excepted to be in 0:round(Tmax/dt)");
+			++rstart[s+1];
+		}
+		for (int s = 0; s <= niter; ++s)
+			rstart[s+1] += rstart[s];
+		record.resize(nsnap);
+		vector<int> pos(rstart.begin(), rstart.end()-1);
+		for (int k = 0; k < nsnap; ++k)
+			record[pos[(int)mxGetPr(snap)[k]]++] = k;
+	}
+	if (nlhs < 2)
+		std::fill(rstart.begin(), rstart.end(), 0);
+
+	///////////// factorize once
+	SparseMatrix<double> A = identity ? SparseMatrix<double>(dt*L) : SparseMatrix<double>(M + dt*L);
+	if (identity)
+		for (int i = 0; i < n; ++i)
+			A.coeffRef(i,i) += 1;
+	SimplicialLLT<SparseMatrix<double> > solver(A);
+	if (solver.info() != Success)
+		mexErrMsgTxt("M + dt*L is not positive definite!");
+
+	///////////// time steps
+	plhs[0] = mxCreateDoubleMatrix(n, nc, mxREAL);
+	double* out = mxGetPr(plhs[0]);
+	std::copy(mxGetPr(prhs[2]), mxGetPr(prhs[2]) + (size_t)n*nc, out);
+	double* psnap = NULL;
+	if (nlhs > 1)
+	{
+		mwSize dims[3] = {(mwSize)n, (mwSize)nc, (mwSize)nsnap};
+		plhs[1] = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+		psnap = mxGetPr(plhs[1]);
+	}
+
+	#pragma omp parallel for schedule(dynamic,1)
+	for (int c = 0; c < nc; ++c)
+	{
+		Map<VectorXd> f(out + (size_t)c*n, n);
+		VectorXd rhs(n);
+		for (int it = 0; it <= niter; ++it)
+		{
+			if (it > 0)
+			{
+				if (identity)
+					rhs = f;
+				else
+					rhs.noalias() = M*f;
+				f = solver.solve(rhs);
+			}
+			for (int r = rstart[it]; r < rstart[it+1]; ++r)
+				std::copy(f.data(), f.data() + n, psnap + ((size_t)record[r]*nc + c)*n);
+		}
+	}
+}
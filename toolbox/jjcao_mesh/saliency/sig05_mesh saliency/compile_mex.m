@@ -1 +1,2 @@
-mex -I"../../../kdtree" compute_gaussian_weighted_curvature.cpp
\ No newline at end of file
+mex -I"../../../kdtree" compute_gaussian_weighted_curvature.cpp
+mex -I"../../../kdtree" COMPFLAGS="$COMPFLAGS /openmp" compute_mesh_saliency.cpp
\ No newline at end of file
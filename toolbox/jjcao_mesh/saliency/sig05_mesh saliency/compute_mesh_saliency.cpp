@@ -0,0 +1,220 @@
+/*=================================================================
+*
+* Multi-scale mesh saliency in one pass, refer to: Lee et al., "Mesh
+* Saliency", SIGGRAPH 2005. Same as the loop of demo_mesh_saliency.m over
+* compute_gaussian_weighted_curvature and suppression.
+*
+* usage:
+		[saliency, perScale, G] = compute_mesh_saliency(verts, faces, Cmean, sigmas);
+* compile:
+		mex -I"../../../kdtree" COMPFLAGS="$COMPFLAGS /openmp" compute_mesh_saliency.cpp
+* inputs:
+		verts: nverts*3
+		faces: nfaces*3, for the local maxima of the nonlinear normalization
+		Cmean: nverts*1, mean curvature
+		sigmas: 1*nscales, e.g. (2:6)*eps
+* outputs:
+		saliency: nverts*1, sum over the scales of the normalized perScale
+		perScale: nverts*nscales, |G(sigma) - G(2*sigma)|, before the
+			normalization
+		G: nverts*(2*nscales), the Gaussian weighted mean curvatures
+			G(sigma) and G(2*sigma) of each scale, as returned by
+			compute_gaussian_weighted_curvature
+*
+*	The neighbors within the largest radius, 4*max(sigmas), are gathered
+*	once per vertex and sorted by distance, every Gaussian then uses a
+*	prefix of them (cut at 2*its sigma, as compute_gaussian_weighted_curvature).
+*	Gaussians shared by two scales (2*sigma_i == sigma_j) are evaluated once.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "KDTree.h"
+#include "mex.h"
+#include <algorithm>
+#include <utility>
+
+// 1-ring of each vertex in compressed form
+void vertex_rings(const double* faces, int nfaces, int nverts, vector<int>& start, vector<int>& ring)
+{
+	vector<pair<int,int> > edges;
+	edges.reserve(6*nfaces);
+	for (int f = 0; f < nfaces; ++f)
+		for (int k = 0; k < 3; ++k)
+		{
+			int a = (int)faces[k*nfaces+f] - 1, b = (int)faces[((k+1)%3)*nfaces+f] - 1;
+			if (a < 0 || a >= nverts || b < 0 || b >= nverts)
+				mexErrMsgTxt("faces index out of range!");
+			edges.push_back(make_pair(a,b));
+			edges.push_back(make_pair(b,a));
+		}
+	sort(edges.begin(), edges.end());
+	edges.erase(unique(edges.begin(), edges.end()), edges.end());
+	start.assign(nverts+1, 0);
+	ring.resize(edges.size());
+	for (size_t e = 0; e < edges.size(); ++e)
+	{
+		++start[edges[e].first+1];
+		ring[e] = edges[e].second;
+	}
+	for (int i = 0; i < nverts; ++i)
+		start[i+1] += start[i];
+}
+
+// suppression.m: scale to [0,1], then multiply by (1-m)^2, m the mean of
+// the local maxima other than the global one
+void suppression(double* s, int nverts, const vector<int>& start, const vector<int>& ring)
+{
+	double smin(s[0]), smax(s[0]);
+	for (int i = 1; i < nverts; ++i)
+	{
+		smin = min(smin, s[i]);
+		smax = max(smax, s[i]);
+	}
+	double range = smax > smin ? smax - smin : 1;
+	for (int i = 0; i < nverts; ++i)
+		s[i] = (s[i] - smin)/range;
+
+	double sum(0);
+	int count(0);
+	#pragma omp parallel for reduction(+:sum,count)
+	for (int i = 0; i < nverts; ++i)
+	{
+		if (start[i] == start[i+1]) continue;
+		bool maximum(true);
+		for (int k = start[i]; k < start[i+1] && maximum; ++k)
+			maximum = s[i] >= s[ring[k]];
+		if (maximum)
+		{
+			sum += s[i];
+			++count;
+		}
+	}
+	// the global maximum, 1, is one of them
+	double average = count > 1 ? (sum - 1.0)/(count - 1) : 0;
+	double factor = (1.0 - average)*(1.0 - average);
+	for (int i = 0; i < nverts; ++i)
+		s[i] *= factor;
+}
+
+void mexFunction(int nlhs, mxArray * plhs[], int nrhs, const mxArray * prhs[])
+{
+	///////////// Error Check
+	if (nrhs != 4)
+		mexErrMsgTxt("Usage: [saliency, perScale, G] = compute_mesh_saliency(verts, faces, Cmean, sigmas)");
+	if (nlhs > 3)
+		mexErrMsgTxt("Number of output should be 1, 2 or 3");
+
+	int nverts = mxGetM(prhs[0]);
+	if (!mxIsDouble(prhs[0]) || mxGetN(prhs[0]) != 3 || nverts < 1)
+		mexErrMsgTxt("verts is excepted to be nverts*3");
+	const double* verts = mxGetPr(prhs[0]);
+	int nfaces = mxGetM(prhs[1]);
+	if (!mxIsDouble(prhs[1]) || mxGetN(prhs[1]) != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! faces is excepted to be nfaces*3");
+	const double* faces = mxGetPr(prhs[1]);
+	if (!mxIsDouble(prhs[2]) || (int)mxGetNumberOfElements(prhs[2]) != nverts)
+		mexErrMsgTxt("Cmean is excepted to be nverts*1");
+	const double* curvature = mxGetPr(prhs[2]);
+	int nscales = mxGetNumberOfElements(prhs[3]);
+	if (!mxIsDouble(prhs[3]) || nscales < 1)
+		mexErrMsgTxt("sigmas is excepted to be 1*nscales");
+	const double* sigmas = mxGetPr(prhs[3]);
+
+	///////////// the distinct Gaussians, by increasing sigma
+	vector<double> gs;
+	for (int s = 0; s < nscales; ++s)
+	{
+		if (sigmas[s] <= 0)
+			mexErrMsgTxt("sigmas must be positive");
+		gs.push_back(sigmas[s]);
+		gs.push_back(2*sigmas[s]);
+	}
+	sort(gs.begin(), gs.end());
+	for (size_t g = 1; g < gs.size(); ++g)
+		if (gs[g] - gs[g-1] <= 1e-12*gs[g])
+			gs[g] = gs[g-1];
+	gs.erase(unique(gs.begin(), gs.end()), gs.end());
+	int ng = gs.size();
+	// Gaussians of scale s
+	vector<int> fine(nscales), coarse(nscales);
+	for (int s = 0; s < nscales; ++s)
+	{
+		fine[s] = int(lower_bound(gs.begin(), gs.end(), sigmas[s]*(1-1e-12)) - gs.begin());
+		coarse[s] = int(lower_bound(gs.begin(), gs.end(), 2*sigmas[s]*(1-1e-12)) - gs.begin());
+	}
+
+	vector<Point> points(nverts, Point(3));
+	for (int i = 0; i < nverts; ++i)
+		for (int d = 0; d < 3; ++d)
+			points[i][d] = verts[d*nverts+i];
+	KDTree tree(points);
+	double radius = 2*gs.back();
+
+	///////////// Gaussian weighted mean curvature, all the scales
+	vector<double> G((size_t)nverts*ng);
+	#pragma omp parallel
+	{
+		vector<int> idxs;
+		vector<double> dists;
+		vector<pair<double,int> > nb;
+		#pragma omp for schedule(dynamic,64)
+		for (int i = 0; i < nverts; ++i)
+		{
+			idxs.clear(); dists.clear();
+			tree.ball_query(points[i], radius, idxs, dists);
+			nb.resize(idxs.size());
+			for (size_t k = 0; k < idxs.size(); ++k)
+				nb[k] = make_pair(dists[k]*dists[k], idxs[k]);
+			sort(nb.begin(), nb.end());
+			size_t end(0);
+			for (int g = 0; g < ng; ++g)
+			{
+				double r2 = 4*gs[g]*gs[g], c = -1/(2*gs[g]*gs[g]);
+				while (end < nb.size() && nb[end].first <= r2) ++end;
+				double sw(0), swc(0);
+				for (size_t k = 0; k < end; ++k)
+				{
+					double w = exp(nb[k].first*c);
+					sw += w;
+					swc += w*curvature[nb[k].second];
+				}
+				G[(size_t)g*nverts+i] = sw > 0 ? swc/sw : curvature[i];
+			}
+		}
+	}
+
+	///////////// center-surround and normalization
+	plhs[0] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+	double* saliency = mxGetPr(plhs[0]);
+	mxArray* perScaleArr = mxCreateDoubleMatrix(nverts, nscales, mxREAL);
+	double* perScale = mxGetPr(perScaleArr);
+	vector<int> start, ring;
+	vertex_rings(faces, nfaces, nverts, start, ring);
+	vector<double> s(nverts);
+	for (int sc = 0; sc < nscales; ++sc)
+	{
+		const double *g1 = &G[(size_t)fine[sc]*nverts], *g2 = &G[(size_t)coarse[sc]*nverts];
+		for (int i = 0; i < nverts; ++i)
+			s[i] = perScale[(size_t)sc*nverts+i] = fabs(g1[i] - g2[i]);
+		suppression(&s[0], nverts, start, ring);
+		for (int i = 0; i < nverts; ++i)
+			saliency[i] += s[i];
+	}
+
+	if (nlhs > 1)
+		plhs[1] = perScaleArr;
+	else
+		mxDestroyArray(perScaleArr);
+	if (nlhs > 2)
+	{
+		plhs[2] = mxCreateDoubleMatrix(nverts, 2*nscales, mxREAL);
+		double* pG = mxGetPr(plhs[2]);
+		for (int sc = 0; sc < nscales; ++sc)
+		{
+			copy(&G[(size_t)fine[sc]*nverts], &G[(size_t)fine[sc]*nverts]+nverts, pG + (size_t)(2*sc)*nverts);
+			copy(&G[(size_t)coarse[sc]*nverts], &G[(size_t)coarse[sc]*nverts]+nverts, pG + (size_t)(2*sc+1)*nverts);
+		}
+	}
+}
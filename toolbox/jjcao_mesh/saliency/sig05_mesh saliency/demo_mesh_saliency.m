@@ -7,6 +7,7 @@
 clear;clc;close all;
 
 DEBUG=true;
+USE_MEX=true; % all the scales and the normalization in one call, see compute_mesh_saliency.cpp
 
 %MYTOOLBOXROOT='E:/jjcaolib/toolbox';
 MYTOOLBOXROOT='../..';
@@ -44,6 +45,11 @@ if DEBUG
 end
 
 %%
+if USE_MEX
+    tic
+    [finalsalency, saliency] = compute_mesh_saliency(M.verts, M.faces, Cmean, (2:6)*eps);
+    toc
+else
 finalsalency = zeros(M.nverts,1);
 saliency = zeros(M.nverts,5);
 for i= 2:size(saliency,2)+1
@@ -65,6 +71,7 @@ tic
     finalsalency = finalsalency + suppression(M.faces,saliency(:,i-1));
 toc
 end
+end
 kdtree_delete(tree)
 
 %%
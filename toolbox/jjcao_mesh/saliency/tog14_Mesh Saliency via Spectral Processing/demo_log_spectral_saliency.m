@@ -17,6 +17,7 @@ options.bSymmetrize=1;
 options.bNormalize=0;
 options.diagLength = 800;
 options.n = 9;
+USE_MEX = 1; % spectral_saliency.cpp: Lanczos for the smallest options.k eigenpairs
 epsilon = 0.002 * options.diagLength; % see the paper
 t = (1:1:5)*epsilon^2; % see the paper: (1:1:5)*epsilon^2; % 5+(1:2:10)*epsilon^2
 dist_const = 2.5; % see the paper
@@ -33,6 +34,14 @@ M.filename = 'wolf2_v753.off';
 M.nverts = size(M.verts, 1);
 tree = kdtree_build(M.verts);
 
+if USE_MEX
+    mex -largeArrayDims -I"../../../../include/eigen-3.1.3" -I"../../../kdtree" COMPFLAGS="$COMPFLAGS /openmp" spectral_saliency.cpp
+    % options.k = M.nverts; % the full spectrum, as log_spectral_saliency
+    saliency_fun = @spectral_saliency;
+else
+    saliency_fun = @log_spectral_saliency;
+end
+
 %% compute k by eq 17, not understand it still!
 A = triangulation2adjacency(M.faces); % adjacency matrix 
 ind = find(A>0);
@@ -51,11 +60,11 @@ for i = t
     % Mt
     [verts1, nneigh] = gaussian_smoothing(M.verts, M.verts, dist_const*sqrt(i)*ones(M.nverts,1), i*ones(M.nverts,1), tree);    
     % SMt: saliency of Mt
-    SMt = log_spectral_saliency(verts1, M.faces, options);
+    SMt = saliency_fun(verts1, M.faces, options);
     % Mkt
     [verts2, nneigh] = gaussian_smoothing(M.verts, M.verts,dist_const*sqrt(i*k), i*k, tree);
     % SMkt: saliency of Mkt
-    SMkt = log_spectral_saliency(verts2, M.faces, options);   
+    SMkt = saliency_fun(verts2, M.faces, options);   
     % absolute difference of them
     S(:,j) = abs(SMkt - SMt);
     j = j + 1;
@@ -0,0 +1,364 @@
+/*=================================================================
+*
+* Single scale spectral mesh saliency, native version of
+* log_spectral_saliency.m, refer to: Song et al., "Mesh Saliency via
+* Spectral Processing", TOG 2014.
+*
+* usage:
+		[saliency, fullSaliency, Hf] = spectral_saliency(verts, faces, options, fullVerts);
+* compile:
+		mex -largeArrayDims -I"../../../../include/eigen-3.1.3" -I"../../../kdtree" COMPFLAGS="$COMPFLAGS /openmp" spectral_saliency.cpp
+* inputs:
+		verts: nverts*3, usually a simplified mesh
+		faces: nfaces*3
+		options.n: width of the averaging filter of the log spectrum, default 9
+		options.bNormalize: 0: L = D-W, 1: L = I-D^-1/2*W*D^-1/2, default 0
+		options.cotangent: 0: W(i,j) = |vi-vj|^2+1e-7 as log_spectral_saliency.m
+			(1.0\x is x), 1: cotangent weights, default 0
+		options.k: number of eigenpairs of smallest eigenvalues, default
+			min(nverts, 500). k = nverts is the full spectrum of the .m file.
+		options.lanczos_steps: default min(nverts, 2*k+20), the full dense
+			eigen-decomposition is used when it reaches nverts
+			The steps are doubled, up to 4*lanczos_steps, while the Ritz residual
+			|L*v-lambda*v| of a pair is above 1e-8*|L|, then a warning is issued.
+		fullVerts: nfull*3 (optional), vertices of the full resolution mesh
+* outputs:
+		saliency: nverts*1, in [0,1]
+		fullSaliency: nfull*1, saliency of the nearest vertex of verts
+		Hf: k*1, the eigenvalues, increasing
+*
+*	The eigenpairs of smallest eigenvalues are computed by a Lanczos
+*	iteration on (L+sigma*I)^-1 (shift-invert, one sparse LDLt), with full
+*	reorthogonalization. S = V*diag(exp(Rf))*V'*W is never formed: the rows
+*	of |S| are summed block by block, in parallel.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "KDTree.h"
+#include <mex.h>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/Dense>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+using namespace Eigen;
+typedef Triplet<double> T;
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+double cotangent(const Vector3d& p, const Vector3d& q, const Vector3d& r)
+{
+	// cotangent of the angle at q
+	Vector3d a = p - q, b = r - q;
+	double s = a.cross(b).norm();
+	return s > 1e-300 ? a.dot(b)/s : 0.0;
+}
+
+/// symmetric weights W on the edges of the mesh
+void edge_weights(const double* verts, int nverts, const vector<int>& faces, bool cot, SparseMatrix<double>& W)
+{
+	int nfaces = (int)faces.size()/3;
+	vector<T> coef;
+	coef.reserve(6*nfaces);
+	for (int f = 0; f < nfaces; ++f)
+		for (int l = 0; l < 3; ++l)
+		{
+			int i = faces[3*f+l], j = faces[3*f+(l+1)%3], k = faces[3*f+(l+2)%3];
+			Vector3d p(verts[j],verts[nverts+j],verts[2*nverts+j]);
+			Vector3d q(verts[i],verts[nverts+i],verts[2*nverts+i]);
+			Vector3d r(verts[k],verts[nverts+k],verts[2*nverts+k]);
+			if (cot)
+			{
+				// corner i weights the opposite edge jk, as perform_arap
+				double c = cotangent(p, q, r);
+				coef.push_back(T(j,k,c));
+				coef.push_back(T(k,j,c));
+			}
+			else
+			{
+				// edge ij, both directions come from the two faces, or from this one on the border
+				coef.push_back(T(i,j,1));
+				coef.push_back(T(j,i,1));
+			}
+		}
+	W.resize(nverts, nverts);
+	W.setFromTriplets(coef.begin(), coef.end());
+	if (!cot)
+		for (int j = 0; j < W.outerSize(); ++j)
+			for (SparseMatrix<double>::InnerIterator it(W, j); it; ++it)
+			{
+				int a = it.row(), b = it.col();
+				double d2 = 0;
+				for (int c = 0; c < 3; ++c)
+					d2 += (verts[c*nverts+a]-verts[c*nverts+b])*(verts[c*nverts+a]-verts[c*nverts+b]);
+				it.valueRef() = d2 + 0.0000001;
+			}
+	W.makeCompressed();
+}
+
+/// h = Q(:,0:m)'*w, then w -= Q(:,0:m)*h, in parallel
+void orthogonalize(const MatrixXd& Q, int m, VectorXd& w)
+{
+	int n = (int)Q.rows();
+	VectorXd h(m);
+	#pragma omp parallel for
+	for (int j = 0; j < m; ++j)
+		h[j] = Q.col(j).dot(w);
+	#pragma omp parallel for
+	for (int i = 0; i < n; ++i)
+	{
+		double s = 0;
+		for (int j = 0; j < m; ++j)
+			s += Q(i,j)*h[j];
+		w[i] -= s;
+	}
+}
+
+/// Ritz pairs of `steps` Lanczos steps on (L+sigma*I)^-1, the k of smallest
+/// eigenvalues of L, increasing
+void lanczos_eigenpairs(const SimplicialLDLT<SparseMatrix<double> >& solver, double sigma, int n,
+						int k, int steps, VectorXd& evals, MatrixXd& evecs)
+{
+	MatrixXd Q(n, steps);
+	VectorXd alpha(steps), beta(steps);
+	srand(0);
+	VectorXd w = VectorXd::Random(n);
+	Q.col(0) = w.normalized();
+	int m = 0;
+	for (; m < steps; ++m)
+	{
+		w = solver.solve(Q.col(m));
+		alpha[m] = Q.col(m).dot(w);
+		// full reorthogonalization, twice is enough
+		orthogonalize(Q, m+1, w);
+		orthogonalize(Q, m+1, w);
+		beta[m] = w.norm();
+		if (m+1 == steps) break;
+		if (beta[m] <= 1e-10*std::abs(alpha[m]))
+		{
+			// invariant subspace, e.g. a multiple eigenvalue: restart with a new direction
+			beta[m] = 0;
+			w = VectorXd::Random(n);
+			orthogonalize(Q, m+1, w);
+			orthogonalize(Q, m+1, w);
+			Q.col(m+1) = w.normalized();
+		}
+		else
+			Q.col(m+1) = w/beta[m];
+	}
+	int p = std::min(m+1, steps);
+
+	MatrixXd Tm = MatrixXd::Zero(p, p);
+	for (int j = 0; j < p; ++j)
+	{
+		Tm(j,j) = alpha[j];
+		if (j+1 < p) Tm(j,j+1) = Tm(j+1,j) = beta[j];
+	}
+	SelfAdjointEigenSolver<MatrixXd> es(Tm, ComputeEigenvectors);
+	// Ritz values theta, increasing: the last k are the smallest 1/theta-sigma
+	k = std::min(k, p);
+	evals.resize(k);
+	MatrixXd Y(p, k);
+	for (int j = 0; j < k; ++j)
+	{
+		evals[j] = 1.0/es.eigenvalues()[p-1-j] - sigma;
+		Y.col(j) = es.eigenvectors().col(p-1-j);
+	}
+	evecs.noalias() = Q.leftCols(p)*Y;
+}
+
+/// k eigenpairs of the smallest eigenvalues of the symmetric L, increasing.
+/// A pair is converged when |L*v-lambda*v| <= tol*|L|_inf; while some are
+/// not, the Lanczos iteration is run again with twice the steps (at most
+/// 4 times the requested number). Returns the number of converged pairs.
+int smallest_eigenpairs(const SparseMatrix<double>& L, int k, int steps, VectorXd& evals, MatrixXd& evecs,
+						double tol = 1e-8)
+{
+	int n = (int)L.rows();
+	if (steps >= n)
+	{
+		SelfAdjointEigenSolver<MatrixXd> es(MatrixXd(L), ComputeEigenvectors);
+		evals = es.eigenvalues().head(k);// increasing
+		evecs = es.eigenvectors().leftCols(k);
+		return k;
+	}
+
+	// shift-invert: the largest eigenvalues of (L+sigma*I)^-1
+	double sigma = 1e-6*L.diagonal().cwiseAbs().mean();
+	SparseMatrix<double> Ls(L);
+	for (int i = 0; i < n; ++i)
+		Ls.coeffRef(i,i) += sigma;
+	SimplicialLDLT<SparseMatrix<double> > solver(Ls);
+	if (solver.info() != Success)
+		mexErrMsgTxt("factorization of the Laplacian failed!");
+
+	// |L|_inf, L is symmetric
+	VectorXd rowSum = VectorXd::Zero(n);
+	for (int j = 0; j < L.outerSize(); ++j)
+		for (SparseMatrix<double>::InnerIterator it(L, j); it; ++it)
+			rowSum[it.row()] += std::abs(it.value());
+	double normL = rowSum.maxCoeff();
+
+	int maxSteps = std::min(n-1, 4*steps);
+	int nConverged = 0;
+	for (;;)
+	{
+		lanczos_eigenpairs(solver, sigma, n, k, steps, evals, evecs);
+		MatrixXd R = L*evecs - evecs*evals.asDiagonal();
+		nConverged = 0;
+		for (int j = 0; j < evals.size(); ++j)
+			if (R.col(j).norm() <= tol*normL*evecs.col(j).norm())
+				++nConverged;
+		if (nConverged == evals.size() || steps >= maxSteps)
+			break;
+		steps = std::min(maxSteps, 2*steps);
+	}
+	if (nConverged < evals.size())
+		mexWarnMsgTxt("some eigenpairs have not converged, increase options.lanczos_steps.");
+	return nConverged;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	///////////// Error Check
+	if (nrhs < 2 || nrhs > 4)
+		mexErrMsgTxt("Usage: [saliency, fullSaliency, Hf] = spectral_saliency(verts, faces, options, fullVerts)");
+	if (nlhs > 3)
+		mexErrMsgTxt("Number of output should be 1, 2 or 3");
+
+	int nverts = (int)mxGetM(prhs[0]);
+	if (!mxIsDouble(prhs[0]) || mxGetN(prhs[0]) != 3 || nverts < 2)
+		mexErrMsgTxt("verts is excepted to be nverts*3");
+	const double* verts = mxGetPr(prhs[0]);
+	int nfaces = (int)mxGetM(prhs[1]);
+	if (!mxIsDouble(prhs[1]) || mxGetN(prhs[1]) != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! faces is excepted to be nfaces*3");
+	const double* pfaces = mxGetPr(prhs[1]);
+	vector<int> faces(3*nfaces);
+	for (int f = 0; f < nfaces; ++f)
+		for (int l = 0; l < 3; ++l)
+		{
+			faces[3*f+l] = (int)pfaces[l*nfaces+f] - 1;
+			if (faces[3*f+l] < 0 || faces[3*f+l] >= nverts)
+				mexErrMsgTxt("faces index out of range!");
+		}
+	const mxArray* options = (nrhs > 2 && mxIsStruct(prhs[2])) ? prhs[2] : NULL;
+	int filterWidth = (int)get_option(options, "n", 9);
+	bool bNormalize = get_option(options, "bNormalize", 0) != 0;
+	bool cot = get_option(options, "cotangent", 0) != 0;
+	int k = std::max(1, std::min(nverts, (int)get_option(options, "k", 500)));
+	int steps = std::max(k, std::min(nverts, (int)get_option(options, "lanczos_steps", 2*k+20)));
+	if (filterWidth < 1)
+		mexErrMsgTxt("options.n must be positive");
+
+	///////////// Laplacian
+	SparseMatrix<double> W;
+	edge_weights(verts, nverts, faces, cot, W);
+	VectorXd d = VectorXd::Zero(nverts);
+	for (int j = 0; j < W.outerSize(); ++j)
+		for (SparseMatrix<double>::InnerIterator it(W, j); it; ++it)
+			d[it.row()] += it.value();
+	SparseMatrix<double> L;
+	{
+		vector<T> coef;
+		coef.reserve(W.nonZeros() + nverts);
+		for (int j = 0; j < W.outerSize(); ++j)
+			for (SparseMatrix<double>::InnerIterator it(W, j); it; ++it)
+				coef.push_back(T(it.row(), it.col(), bNormalize ? -it.value()/std::sqrt(d[it.row()]*d[it.col()]) : -it.value()));
+		for (int i = 0; i < nverts; ++i)
+			coef.push_back(T(i, i, bNormalize ? 1.0 : d[i]));
+		L.resize(nverts, nverts);
+		L.setFromTriplets(coef.begin(), coef.end());
+	}
+
+	///////////// spectrum
+	VectorXd Hf;
+	MatrixXd V;
+	smallest_eigenpairs(L, k, steps, Hf, V);
+	k = (int)Hf.size();
+
+	// log spectrum and its spectral residual, as the .m file
+	VectorXd Lf(k), Rf(k);
+	for (int i = 0; i < k; ++i)
+		Lf[i] = std::log(std::abs(i == 0 ? 1.0 : Hf[i]));// jjcao: pay attention!! Hf(1) = 1
+	for (int i = 0; i < k; ++i)
+	{
+		// filter(ones(n,1), n, Lf): causal mean, zeros before the first one
+		double s = 0;
+		for (int j = std::max(0, i-filterWidth+1); j <= i; ++j)
+			s += Lf[j];
+		Rf[i] = std::exp(std::abs(Lf[i] - s/filterWidth));
+	}
+
+	///////////// saliency = sum(abs(V*diag(exp(Rf))*V'*W), 2)
+	MatrixXd A = V*Rf.asDiagonal();
+	MatrixXd Bt = W*V;// W symmetric: (V'*W)' = W*V
+	MatrixXd B = Bt.transpose();
+	plhs[0] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+	double* saliency = mxGetPr(plhs[0]);
+	const int block = 64;
+	int nblocks = (nverts + block - 1)/block;
+	#pragma omp parallel
+	{
+		MatrixXd S;
+		#pragma omp for schedule(dynamic,1)
+		for (int b = 0; b < nblocks; ++b)
+		{
+			int i0 = b*block, rows = std::min(block, nverts - i0);
+			S.noalias() = A.middleRows(i0, rows)*B;
+			for (int r = 0; r < rows; ++r)
+				saliency[i0+r] = S.row(r).cwiseAbs().sum();
+		}
+	}
+	double smin = *std::min_element(saliency, saliency+nverts);
+	double smax = *std::max_element(saliency, saliency+nverts);
+	double range = smax > smin ? smax - smin : 1;
+	for (int i = 0; i < nverts; ++i)
+		saliency[i] = (saliency[i] - smin)/range;
+
+	///////////// transfer to the full resolution mesh
+	if (nlhs > 1)
+	{
+		if (nrhs > 3 && !mxIsEmpty(prhs[3]))
+		{
+			int nfull = (int)mxGetM(prhs[3]);
+			if (!mxIsDouble(prhs[3]) || mxGetN(prhs[3]) != 3)
+				mexErrMsgTxt("fullVerts is excepted to be nfull*3");
+			const double* full = mxGetPr(prhs[3]);
+			vector<Point> points(nverts, Point(3));
+			for (int i = 0; i < nverts; ++i)
+				for (int c = 0; c < 3; ++c)
+					points[i][c] = verts[c*nverts+i];
+			KDTree tree(points);
+			plhs[1] = mxCreateDoubleMatrix(nfull, 1, mxREAL);
+			double* fullSaliency = mxGetPr(plhs[1]);
+			#pragma omp parallel for schedule(dynamic,256)
+			for (int i = 0; i < nfull; ++i)
+			{
+				Point p(3);
+				for (int c = 0; c < 3; ++c)
+					p[c] = full[c*nfull+i];
+				fullSaliency[i] = saliency[tree.closest_point(p)];
+			}
+		}
+		else
+			plhs[1] = mxCreateDoubleMatrix(0, 1, mxREAL);
+	}
+	if (nlhs > 2)
+	{
+		plhs[2] = mxCreateDoubleMatrix(k, 1, mxREAL);
+		std::copy(Hf.data(), Hf.data()+k, mxGetPr(plhs[2]));
+	}
+}
@@ -7,6 +7,7 @@ MYTOOLBOXROOT='../..';
 addpath(genpath(MYTOOLBOXROOT));
 
 DEBUG=1;
+USE_MEX=1; % perform_random_walk_segmentation: L_uu factorized once, seeds can be added later
 
 %% input
 
@@ -39,6 +40,13 @@ options.USE_CONCAVE_WEIGHT = M.USE_CONCAVE_WEIGHT;
 options.verts = M.verts;
 options.faces = M.faces;
 options.seed_id = M.rank_set(1:min(length(M.rank_set),M.nsegments));
+if USE_MEX && exist('perform_random_walk_segmentation', 'file')
+    seed_id = options.seed_id; options.seed_id = [];
+    W = compute_random_walk_graph(M.patch_adjancy,M.patch_normal,M.patch_curvature_hist,M.verts_between_patch,options);
+    W = (W+W')*0.5;
+    P = perform_random_walk_segmentation(W, seed_id, 1:length(seed_id));
+    % more seeds: P = perform_random_walk_segmentation('add', seeds, labels);
+else
 [A B] =compute_random_walk_graph(M.patch_adjancy,M.patch_normal,M.patch_curvature_hist,M.verts_between_patch,options);
 % Distances less than ThresDist are set to 0. 
 % if DEBUG
@@ -48,6 +56,7 @@ options.seed_id = M.rank_set(1:min(length(M.rank_set),M.nsegments));
 % A(A<M.thresDist) = 0 ;
 % P = inv(A) * B;
 P = A\B;
+end
 [C cluster_id] = max(P,[],2);
 
 %% run clustering from rank set.
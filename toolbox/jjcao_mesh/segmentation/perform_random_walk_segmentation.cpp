@@ -0,0 +1,462 @@
+/*=================================================================
+*
+* random walks segmentation (Grady, "Random walks for image segmentation",
+* PAMI 2006) of a graph: P(i,k) is the probability that a walker from node
+* i first reaches a seed of label k. Same result as P = A\B of
+* demo_random_walks_segmentation.m, the nodes may be patches, faces or
+* vertices.
+*
+* usage:
+		[P, labels] = perform_random_walk_segmentation(W, seeds, seed_labels, options);
+		[P, labels] = perform_random_walk_segmentation(verts, faces, seeds, seed_labels, options);
+		[P, labels] = perform_random_walk_segmentation('add', seeds, seed_labels);
+		perform_random_walk_segmentation('clear');
+* compile:
+		mex -largeArrayDims -I"../../../include/eigen-3.1.3" COMPFLAGS="$COMPFLAGS /openmp" perform_random_walk_segmentation.cpp
+* inputs:
+		W: n*n sparse symmetric weights, e.g. A of compute_random_walk_graph
+			without seed_id
+		verts, faces: nverts*3 and nfaces*3, the graph is built on the mesh:
+			options.graph: 'faces' (default, faces sharing an edge) or
+			'vertices' (the edges), with W(i,j) = exp(-beta*d_ij/mean(d)),
+			d_ij = |n_i-n_j|^2 of the (face or vertex) normals, as
+			compute_random_walk_graph.m
+			options.beta: default 4
+		seeds: 1*m node indices
+		seed_labels: 1*m labels in 1:K, default 1:m
+		'add': adds seeds (and possibly new labels) to the last problem
+		options.max_update: number of seeds added before the system is
+			factorized again, default 32
+* outputs:
+		P: n*K probabilities
+		labels: n*1, argmax of P, 0 for a node not connected to any seed
+*
+*	The Laplacian is assembled once (compressed columns) and the block of
+*	the unseeded nodes, L_uu, is factorized once (SimplicialLDLT). The K
+*	labels are solved together, blocks of columns in parallel. Added seeds
+*	S' do not factorize again: with Z = L_uu^-1*E (E the columns of the
+*	identity at S') and C = E'*Z, X = X0 + Z*C^-1*(G - E'*X0), where X0 is
+*	the solution for the previous seeds and G the potentials of S'.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include <mex.h>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/Dense>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstring>
+
+using namespace Eigen;
+using namespace std;
+
+typedef Triplet<double> T;
+
+#define RW_BLOCK 8
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+/// X = solver^-1*B, blocks of RW_BLOCK columns in parallel
+template<class Solver>
+void solve_blocked(const Solver& solver, const MatrixXd& B, MatrixXd& X)
+{
+	int ncols = (int)B.cols(), nblocks = (ncols + RW_BLOCK - 1)/RW_BLOCK;
+	X.resize(B.rows(), ncols);
+	#pragma omp parallel for schedule(dynamic,1)
+	for (int b = 0; b < nblocks; ++b)
+	{
+		int c0 = b*RW_BLOCK, nc = min(RW_BLOCK, ncols - c0);
+		MatrixXd xb = solver.solve(B.middleCols(c0, nc));
+		X.middleCols(c0, nc) = xb;
+	}
+}
+
+class RandomWalker
+{
+public:
+	RandomWalker():n_(0), K_(0), maxUpdate_(32) {}
+
+	void setGraph(const SparseMatrix<double>& W)
+	{
+		W_ = W;
+		n_ = (int)W.rows();
+		d_ = VectorXd::Zero(n_);
+		for (int j = 0; j < W_.outerSize(); ++j)
+			for (SparseMatrix<double>::InnerIterator it(W_, j); it; ++it)
+				if (it.row() != j)
+					d_[it.row()] += it.value();
+	}
+	void clear()
+	{
+		W_.resize(0, 0);
+		n_ = K_ = 0;
+		seed_.clear();
+		uid_.clear();
+		X0_.resize(0, 0);
+		added_.clear();
+		Z_.resize(0, 0);
+	}
+	void setMaxUpdate(int m) {maxUpdate_ = max(0, m);}
+	bool empty() const {return n_ == 0;}
+
+	/// seeds: node indices, labels: 0 based. Factorize L_uu and solve.
+	void setSeeds(const vector<int>& seeds, const vector<int>& labels)
+	{
+		seed_.assign(n_, -1);
+		for (size_t s = 0; s < seeds.size(); ++s)
+			seed_[seeds[s]] = labels[s];
+		K_ = 0;
+		factorize();
+	}
+
+	/// more seeds or new labels of seeds, by a low rank update of the last
+	/// factorization, the system is factorized again after max_update seeds
+	void addSeeds(const vector<int>& seeds, const vector<int>& labels)
+	{
+		bool refactor = false;
+		vector<int> s;
+		for (size_t k = 0; k < seeds.size(); ++k)
+		{
+			int i = seeds[k];
+			if (seed_[i] == labels[k]) continue;
+			if (uid_[i] < 0)
+				refactor = true;// relabel a seed of the factorized system
+			else if (seed_[i] < 0 && find(s.begin(), s.end(), i) == s.end())
+				s.push_back(i);
+			seed_[i] = labels[k];
+		}
+		for (size_t k = 0; k < labels.size(); ++k)
+			if (labels[k] >= K_)
+			{
+				// new labels: no seed of the factorized system has them
+				int K = labels[k] + 1;
+				X0_.conservativeResize(NoChange, K);
+				X0_.rightCols(K - K_).setZero();
+				K_ = K;
+			}
+		if (refactor || (int)(added_.size() + s.size()) > maxUpdate_)
+		{
+			factorize();
+			return;
+		}
+		if (s.empty()) return;
+
+		// Z = L_uu^-1*E, E the columns of the identity at the new seeds
+		MatrixXd E = MatrixXd::Zero(X0_.rows(), (int)s.size());
+		for (size_t k = 0; k < s.size(); ++k)
+			E(uid_[s[k]], k) = 1;
+		MatrixXd Zs;
+		solve_blocked(solver_, E, Zs);
+		int m = (int)Z_.cols();
+		Z_.conservativeResize(NoChange, m + (int)s.size());
+		Z_.rightCols(s.size()) = Zs;
+		added_.insert(added_.end(), s.begin(), s.end());
+	}
+
+	/// P: n*K, labels: n (1 based, 0 for none)
+	void probabilities(double* P, double* labels) const
+	{
+		int m = (int)added_.size();
+		MatrixXd X = X0_;
+		if (m > 0)
+		{
+			MatrixXd C(m, m), R(m, K_);
+			for (int a = 0; a < m; ++a)
+			{
+				int ua = uid_[added_[a]];
+				C.row(a) = Z_.row(ua);
+				for (int k = 0; k < K_; ++k)
+					R(a, k) = (seed_[added_[a]] == k ? 1.0 : 0.0) - X0_(ua, k);
+			}
+			MatrixXd lambda = C.ldlt().solve(R);
+			X.noalias() += Z_*lambda;
+		}
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n_; ++i)
+		{
+			int best = -1;
+			double pmax = 0;
+			for (int k = 0; k < K_; ++k)
+			{
+				double p = uid_[i] >= 0 ? X(uid_[i], k) : (seed_[i] == k ? 1.0 : 0.0);
+				P[(size_t)k*n_+i] = p;
+				if (p > pmax) {pmax = p; best = k;}
+			}
+			if (labels) labels[i] = best + 1;
+		}
+	}
+	int numNodes() const {return n_;}
+	int numLabels() const {return K_;}
+
+private:
+	/// L_uu of the nodes which are not in seed_, and X0 = L_uu^-1*B
+	void factorize()
+	{
+		added_.clear();
+		uid_.assign(n_, -1);
+		int nu = 0;
+		for (int i = 0; i < n_; ++i)
+		{
+			if (seed_[i] < 0)
+				uid_[i] = nu++;
+			else
+				K_ = max(K_, seed_[i] + 1);
+		}
+
+		// L_uu, regularized so that a component without seed stays solvable
+		double eps = 1e-12*(n_ ? d_.mean() : 1);
+		vector<T> coef;
+		coef.reserve(W_.nonZeros() + nu);
+		MatrixXd B = MatrixXd::Zero(nu, K_);
+		for (int j = 0; j < W_.outerSize(); ++j)
+		{
+			if (uid_[j] >= 0)
+				coef.push_back(T(uid_[j], uid_[j], d_[j] + eps));
+			for (SparseMatrix<double>::InnerIterator it(W_, j); it; ++it)
+			{
+				int i = (int)it.row();
+				if (i == j || uid_[i] < 0) continue;
+				if (uid_[j] >= 0)
+					coef.push_back(T(uid_[i], uid_[j], -it.value()));
+				else
+					B(uid_[i], seed_[j]) += it.value();
+			}
+		}
+		SparseMatrix<double> Luu(nu, nu);
+		Luu.setFromTriplets(coef.begin(), coef.end());
+		solver_.compute(Luu);
+		if (solver_.info() != Success)
+			mexErrMsgTxt("factorization of the Laplacian failed!");
+		solve_blocked(solver_, B, X0_);
+		Z_.resize(nu, 0);
+	}
+
+	SparseMatrix<double> W_;
+	VectorXd d_;
+	int n_, K_, maxUpdate_;
+	vector<int> seed_;				// label of each seed, -1 for the other nodes
+	vector<int> uid_;				// row in L_uu, -1 for a seed of the factorized system
+	SimplicialLDLT<SparseMatrix<double> > solver_;
+	MatrixXd X0_;					// solution of the factorized system
+	vector<int> added_;				// seeds added since
+	MatrixXd Z_;					// L_uu^-1 at the added seeds
+};
+
+static RandomWalker walker;
+
+/// weights of the face or vertex graph of a mesh, from the normals
+void mesh_graph(const double* verts, int nverts, const double* pfaces, int nfaces, bool onFaces, double beta, SparseMatrix<double>& W)
+{
+	vector<int> faces(3*nfaces);
+	for (int f = 0; f < nfaces; ++f)
+		for (int k = 0; k < 3; ++k)
+		{
+			faces[3*f+k] = (int)pfaces[k*nfaces+f] - 1;
+			if (faces[3*f+k] < 0 || faces[3*f+k] >= nverts)
+				mexErrMsgTxt("faces index out of range!");
+		}
+	vector<double> fn(3*nfaces), vn(3*nverts, 0);
+	for (int f = 0; f < nfaces; ++f)
+	{
+		const int* v = &faces[3*f];
+		double u[3], w[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			u[k] = verts[k*nverts+v[1]] - verts[k*nverts+v[0]];
+			w[k] = verts[k*nverts+v[2]] - verts[k*nverts+v[0]];
+		}
+		double c[3] = {u[1]*w[2]-u[2]*w[1], u[2]*w[0]-u[0]*w[2], u[0]*w[1]-u[1]*w[0]};
+		double len = sqrt(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+		for (int k = 0; k < 3; ++k)
+		{
+			fn[3*f+k] = len > 0 ? c[k]/len : 0;
+			for (int l = 0; l < 3; ++l)
+				vn[3*v[l]+k] += c[k];// area weighted
+		}
+	}
+	for (int i = 0; i < nverts; ++i)
+	{
+		double len = sqrt(vn[3*i]*vn[3*i] + vn[3*i+1]*vn[3*i+1] + vn[3*i+2]*vn[3*i+2]);
+		if (len > 0)
+			for (int k = 0; k < 3; ++k) vn[3*i+k] /= len;
+	}
+
+	// node pairs
+	vector<pair<int,int> > pairs;
+	if (onFaces)
+	{
+		vector<pair<pair<int,int>,int> > edges;
+		edges.reserve(3*nfaces);
+		for (int f = 0; f < nfaces; ++f)
+			for (int k = 0; k < 3; ++k)
+			{
+				int a = faces[3*f+k], b = faces[3*f+(k+1)%3];
+				edges.push_back(make_pair(make_pair(min(a,b), max(a,b)), f));
+			}
+		sort(edges.begin(), edges.end());
+		for (size_t e = 0; e < edges.size(); ++e)
+			for (size_t e2 = e+1; e2 < edges.size() && edges[e2].first == edges[e].first; ++e2)
+				pairs.push_back(make_pair(edges[e].second, edges[e2].second));
+	}
+	else
+		for (int f = 0; f < nfaces; ++f)
+			for (int k = 0; k < 3; ++k)
+			{
+				int a = faces[3*f+k], b = faces[3*f+(k+1)%3];
+				pairs.push_back(make_pair(min(a,b), max(a,b)));
+			}
+	sort(pairs.begin(), pairs.end());
+	pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+	const vector<double>& nrm = onFaces ? fn : vn;
+	vector<double> d(pairs.size());
+	double mean(0);
+	for (size_t e = 0; e < pairs.size(); ++e)
+	{
+		const double *a = &nrm[3*pairs[e].first], *b = &nrm[3*pairs[e].second];
+		d[e] = (a[0]-b[0])*(a[0]-b[0]) + (a[1]-b[1])*(a[1]-b[1]) + (a[2]-b[2])*(a[2]-b[2]);
+		mean += d[e];
+	}
+	mean = pairs.empty() ? 0 : mean/pairs.size();
+	vector<T> coef;
+	coef.reserve(2*pairs.size());
+	for (size_t e = 0; e < pairs.size(); ++e)
+	{
+		double w = mean > 0 ? exp(-beta*d[e]/mean) : 1;
+		coef.push_back(T(pairs[e].first, pairs[e].second, w));
+		coef.push_back(T(pairs[e].second, pairs[e].first, w));
+	}
+	int n = onFaces ? nfaces : nverts;
+	W.resize(n, n);
+	W.setFromTriplets(coef.begin(), coef.end());
+}
+
+void read_seeds(const mxArray* s, const mxArray* l, int n, vector<int>& seeds, vector<int>& labels)
+{
+	int m = (int)mxGetNumberOfElements(s);
+	if (!mxIsDouble(s))
+		mexErrMsgTxt("seeds is excepted to be 1*m node indices");
+	if (l && !mxIsEmpty(l) && (!mxIsDouble(l) || (int)mxGetNumberOfElements(l) != m))
+		mexErrMsgTxt("seed_labels is excepted to be 1*m, as seeds");
+	seeds.resize(m);
+	labels.resize(m);
+	for (int k = 0; k < m; ++k)
+	{
+		seeds[k] = (int)mxGetPr(s)[k] - 1;
+		labels[k] = (l && !mxIsEmpty(l)) ? (int)mxGetPr(l)[k] - 1 : k;
+		if (seeds[k] < 0 || seeds[k] >= n)
+			mexErrMsgTxt("seeds index out of range!");
+		if (labels[k] < 0)
+			mexErrMsgTxt("seed_labels must be positive");
+	}
+}
+
+void output(int nlhs, mxArray *plhs[])
+{
+	plhs[0] = mxCreateDoubleMatrix(walker.numNodes(), walker.numLabels(), mxREAL);
+	double* labels = NULL;
+	if (nlhs > 1)
+	{
+		plhs[1] = mxCreateDoubleMatrix(walker.numNodes(), 1, mxREAL);
+		labels = mxGetPr(plhs[1]);
+	}
+	walker.probabilities(mxGetPr(plhs[0]), labels);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	if (nrhs < 1)
+		mexErrMsgTxt("Usage: [P, labels] = perform_random_walk_segmentation(W, seeds, seed_labels, options)");
+	if (nlhs > 2)
+		mexErrMsgTxt("Number of output should be 1 or 2");
+
+	if (mxIsChar(prhs[0]))
+	{
+		char cmd[16];
+		mxGetString(prhs[0], cmd, sizeof(cmd));
+		if (!strcmp(cmd, "clear"))
+		{
+			walker.clear();
+			return;
+		}
+		if (strcmp(cmd, "add"))
+			mexErrMsgTxt("unknown command, expected 'add' or 'clear'.");
+		if (walker.empty())
+			mexErrMsgTxt("no graph, call perform_random_walk_segmentation(W, seeds) first.");
+		if (nrhs < 2)
+			mexErrMsgTxt("Usage: [P, labels] = perform_random_walk_segmentation('add', seeds, seed_labels)");
+		vector<int> seeds, labels;
+		read_seeds(prhs[1], nrhs > 2 ? prhs[2] : NULL, walker.numNodes(), seeds, labels);
+		if (nrhs < 3 || mxIsEmpty(prhs[2]))
+			for (size_t k = 0; k < labels.size(); ++k)
+				labels[k] += walker.numLabels();// new labels
+		walker.addSeeds(seeds, labels);
+		output(nlhs, plhs);
+		return;
+	}
+
+	SparseMatrix<double> W;
+	int arg;
+	const mxArray* options = NULL;
+	if (mxIsSparse(prhs[0]))
+	{
+		int n = (int)mxGetM(prhs[0]);
+		if ((int)mxGetN(prhs[0]) != n || nrhs < 2)
+			mexErrMsgTxt("W is excepted to be a sparse n*n matrix");
+		const double* pr = mxGetPr(prhs[0]);
+		const mwIndex *ir = mxGetIr(prhs[0]), *jc = mxGetJc(prhs[0]);
+		vector<T> coef;
+		coef.reserve(jc[n]);
+		for (int j = 0; j < n; ++j)
+			for (mwIndex p = jc[j]; p < jc[j+1]; ++p)
+				coef.push_back(T((int)ir[p], j, pr[p]));
+		W.resize(n, n);
+		W.setFromTriplets(coef.begin(), coef.end());
+		arg = 1;
+		options = (nrhs > 3 && mxIsStruct(prhs[3])) ? prhs[3] : NULL;
+	}
+	else
+	{
+		if (nrhs < 3)
+			mexErrMsgTxt("Usage: [P, labels] = perform_random_walk_segmentation(verts, faces, seeds, seed_labels, options)");
+		int nverts = (int)mxGetM(prhs[0]), nfaces = (int)mxGetM(prhs[1]);
+		if (!mxIsDouble(prhs[0]) || mxGetN(prhs[0]) != 3)
+			mexErrMsgTxt("verts is excepted to be nverts*3");
+		if (!mxIsDouble(prhs[1]) || mxGetN(prhs[1]) != 3)
+			mexErrMsgTxt("The mesh must be triangle mesh! faces is excepted to be nfaces*3");
+		options = (nrhs > 4 && mxIsStruct(prhs[4])) ? prhs[4] : NULL;
+		bool onFaces = true;
+		mxArray* field = options ? mxGetField(options, 0, "graph") : NULL;
+		if (field && mxIsChar(field))
+		{
+			char graph[16];
+			mxGetString(field, graph, sizeof(graph));
+			if (!strcmp(graph, "vertices"))
+				onFaces = false;
+			else if (strcmp(graph, "faces"))
+				mexErrMsgTxt("options.graph is excepted to be 'faces' or 'vertices'");
+		}
+		mesh_graph(mxGetPr(prhs[0]), nverts, mxGetPr(prhs[1]), nfaces, onFaces, get_option(options, "beta", 4), W);
+		arg = 2;
+	}
+
+	vector<int> seeds, labels;
+	read_seeds(prhs[arg], nrhs > arg+1 ? prhs[arg+1] : NULL, (int)W.rows(), seeds, labels);
+	walker.setMaxUpdate((int)get_option(options, "max_update", 32));
+	walker.setGraph(W);
+	walker.setSeeds(seeds, labels);
+	output(nlhs, plhs);
+}
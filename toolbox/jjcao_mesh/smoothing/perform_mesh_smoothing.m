@@ -6,6 +6,11 @@ function f = perform_mesh_smoothing(face,vertex,f,options)
 %
 %   Smooth a function f on a width of options.niter_averaging vertices.
 %
+%   options.averaging_type can also be 'taubin' or 'bilateral', see
+%   perform_mesh_smoothing_fast.cpp for their options. The mex is used (for
+%   all the columns of f at once) if options.use_c_implementation=1, the
+%   default.
+%
 %   Copyright (c) 2007 Gabriel Peyre
 
 options.null = 0;
@@ -23,6 +28,57 @@ if size(f,1)<size(f,2)
 end
 [vertex,face] = check_face_vertex(vertex,face);
 
+use_c_implementation = getoptions(options, 'use_c_implementation', 1);% use fast C-coded version if possible
+ntype = find(strcmpi(type, {'combinatorial','conformal','taubin','bilateral'})) - 1;
+if exist('perform_mesh_smoothing_fast', 'file') && use_c_implementation && ~isempty(ntype)
+    f = perform_mesh_smoothing_fast(vertex, face, double(f), ntype, options);
+    return;
+end
+
+n = max(face(:));
+if strcmpi(type, 'taubin')
+    % lambda step then mu step with the umbrella operator, on all the columns
+    lambda = getoptions(options, 'lambda', 0.5);
+    mu = getoptions(options, 'mu', -0.53);
+    if getoptions(options, 'cotangent', 0)
+        options.normalize = 1;
+        U = compute_mesh_weight(vertex,face,'conformal',options);
+    else
+        A = triangulation2adjacency(face);
+        U = spdiags(full(sum(A,2).^(-1)),0,n,n)*A;
+    end
+    for k=1:naver
+        f = f + lambda*(U*f-f);
+        f = f + mu*(U*f-f);
+    end
+    return;
+end
+if strcmpi(type, 'bilateral')
+    % positions moved along their normal by the bilateral average of the
+    % heights of the 1-ring
+    if size(f,2)~=3
+        error('f is excepted to be nverts*3 for bilateral smoothing');
+    end
+    [i,j] = find(triangulation2adjacency(face));
+    sigma_c = getoptions(options, 'sigma_c', mean(sqrt(sum((f(i,:)-f(j,:)).^2,2))));
+    sigma_s = getoptions(options, 'sigma_s', sigma_c);
+    for k=1:naver
+        % area weighted vertex normals
+        fn = cross(f(face(2,:),:)-f(face(1,:),:), f(face(3,:),:)-f(face(1,:),:), 2);
+        N = zeros(n,3);
+        for c=1:3
+            N = N + sparse(face(c,:), 1:size(face,2), 1, n, size(face,2)) * fn;
+        end
+        N = N ./ repmat(max(sqrt(sum(N.^2,2)), eps), 1, 3);
+        d = f(j,:)-f(i,:);
+        h = sum(d.*N(i,:),2);
+        w = exp(-sum(d.^2,2)/(2*sigma_c^2) - h.^2/(2*sigma_s^2));
+        dh = accumarray(i, w.*h, [n 1]) ./ max(accumarray(i, w, [n 1]), realmin);
+        f = f + repmat(dh,1,3).*N;
+    end
+    return;
+end
+
 if size(f,2)>1
     for i=1:size(f,2)
         f(:,i) = perform_mesh_smoothing(face,vertex,f(:,i),options);
@@ -30,8 +86,6 @@ if size(f,2)>1
     return;
 end
 
-n = max(face(:));
-
 % compute normalized averaging matrix
 if strcmp(type, 'combinatorial')
     %add diagonal
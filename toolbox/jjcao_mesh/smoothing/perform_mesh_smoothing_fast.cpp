@@ -0,0 +1,356 @@
+/*=================================================================
+*
+* iterative smoothing of functions defined on a mesh, the averaging loop of
+* perform_mesh_smoothing.m in one call, on all the channels of f at once
+*
+* usage:
+		f = perform_mesh_smoothing_fast(verts, faces, f, type, options);
+* compile:
+		mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" perform_mesh_smoothing_fast.cpp
+* inputs:
+		verts: 3*nverts
+		faces: 3*nfaces
+		f: nverts*nchannels, e.g. verts'
+		type:
+			0: 'combinatorial': f = D^-1*(A+I)*f, as perform_mesh_smoothing.m
+			1: 'conformal': f = D^-1*W*f, W(i,j) = cot(alpha_ij)+cot(beta_ij)
+			2: 'taubin': f = f + lambda*(U*f-f), then f = f + mu*(U*f-f), U
+				the combinatorial umbrella operator D^-1*A (or the conformal one
+				when options.cotangent = 1), refer to Taubin, "A signal
+				processing approach to fair surface design", SIGGRAPH 1995.
+			3: 'bilateral': f (nverts*3, positions) is moved along its vertex
+				normal by the bilateral average of the heights of the 1-ring,
+				refer to Fleishman et al., "Bilateral mesh denoising",
+				SIGGRAPH 2003. The normals are updated every iteration.
+		options.niter_averaging: number of iterations, default 1 (for
+			'taubin', one lambda step and one mu step)
+		options.lambda: default 0.5, options.mu: default -0.53, for 'taubin'
+		options.cotangent: 0 or 1, weights of 'taubin', default 0
+		options.sigma_c: default the mean edge length of f, options.sigma_s:
+			default sigma_c, for 'bilateral'
+* outputs:
+		f: nverts*nchannels, smoothed
+*
+*	The 1-ring and its weights are built once (compressed rows). The
+*	channels of a vertex are stored together, padded to 4, so that the
+*	averaging of a vertex is vectorized over the channels; threads work on
+*	blocks of vertices. Two buffers are swapped between the iterations.
+*	A row of conformal weights summing to 0 or less is left unchanged.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "mex.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+using namespace std;
+
+#define SMOOTHING_BLOCK 1024
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+
+// compressed 1-ring: neighbors of i are nb[start[i]..start[i+1]), increasing
+struct MeshRings
+{
+	vector<int> start, nb;
+	vector<double> w;// weight of each neighbor
+	vector<double> self;// weight of the vertex itself
+	vector<int> fstart, fring;// incident faces, for the normals
+
+	void build(const vector<int>& faces, int nverts)
+	{
+		int nfaces = (int)faces.size()/3;
+		vector<pair<int,int> > edges;
+		edges.reserve(6*nfaces);
+		fstart.assign(nverts+1, 0);
+		for (int f = 0; f < nfaces; ++f)
+			for (int k = 0; k < 3; ++k)
+			{
+				int a = faces[3*f+k], b = faces[3*f+(k+1)%3];
+				edges.push_back(make_pair(a,b));
+				edges.push_back(make_pair(b,a));
+				++fstart[a+1];
+			}
+		sort(edges.begin(), edges.end());
+		edges.erase(unique(edges.begin(), edges.end()), edges.end());
+		start.assign(nverts+1, 0);
+		nb.resize(edges.size());
+		for (size_t e = 0; e < edges.size(); ++e)
+		{
+			++start[edges[e].first+1];
+			nb[e] = edges[e].second;
+		}
+		for (int i = 0; i < nverts; ++i)
+		{
+			start[i+1] += start[i];
+			fstart[i+1] += fstart[i];
+		}
+		fring.resize(3*nfaces);
+		vector<int> pos(fstart.begin(), fstart.end()-1);
+		for (int f = 0; f < nfaces; ++f)
+			for (int k = 0; k < 3; ++k)
+				fring[pos[faces[3*f+k]]++] = f;
+		w.assign(nb.size(), 0);
+		self.assign(nverts, 0);
+	}
+	int edge(int i, int j) const
+	{
+		return int(lower_bound(nb.begin()+start[i], nb.begin()+start[i+1], j) - nb.begin());
+	}
+	// D^-1*(A+I) if withSelf, else D^-1*A
+	void combinatorial(bool withSelf)
+	{
+		int nverts = (int)self.size();
+		for (int i = 0; i < nverts; ++i)
+		{
+			int deg = start[i+1] - start[i];
+			if (deg == 0) {self[i] = 1; continue;}
+			double v = 1.0/(withSelf ? deg + 1 : deg);
+			self[i] = withSelf ? v : 0;
+			for (int e = start[i]; e < start[i+1]; ++e)
+				w[e] = v;
+		}
+	}
+	// D^-1*W, W(i,j) = cot(alpha_ij)+cot(beta_ij)
+	void conformal(const vector<int>& faces, const double* verts)
+	{
+		int nfaces = (int)faces.size()/3, nverts = (int)self.size();
+		for (int f = 0; f < nfaces; ++f)
+			for (int l = 0; l < 3; ++l)
+			{
+				// corner i weights the opposite edge jk
+				int i = faces[3*f+l], j = faces[3*f+(l+1)%3], k = faces[3*f+(l+2)%3];
+				const double *p = verts+3*i, *q = verts+3*j, *r = verts+3*k;
+				double u[3] = {q[0]-p[0], q[1]-p[1], q[2]-p[2]}, v[3] = {r[0]-p[0], r[1]-p[1], r[2]-p[2]};
+				double cx = u[1]*v[2]-u[2]*v[1], cy = u[2]*v[0]-u[0]*v[2], cz = u[0]*v[1]-u[1]*v[0];
+				double s = sqrt(cx*cx + cy*cy + cz*cz);
+				double c = s > 0 ? (u[0]*v[0]+u[1]*v[1]+u[2]*v[2])/s : 0;
+				w[edge(j,k)] += c;
+				w[edge(k,j)] += c;
+			}
+		for (int i = 0; i < nverts; ++i)
+		{
+			double sum(0);
+			for (int e = start[i]; e < start[i+1]; ++e)
+				sum += w[e];
+			if (sum > 0)
+			{
+				for (int e = start[i]; e < start[i+1]; ++e)
+					w[e] /= sum;
+				self[i] = 0;
+			}
+			else
+			{
+				for (int e = start[i]; e < start[i+1]; ++e)
+					w[e] = 0;
+				self[i] = 1;
+			}
+		}
+	}
+};
+
+// y_i = a*x_i + b*(self_i*x_i + sum_j w_ij*x_j), S the stride, 0 for a stride s known at run time only
+template<int S>
+inline void average(const MeshRings& r, int i, const double* x, double* y, int s, double a, double b)
+{
+	const int stride = S ? S : s;
+	const double *xi = x + (size_t)i*stride;
+	double *yi = y + (size_t)i*stride;
+	double c0 = a + b*r.self[i];
+	for (int c = 0; c < stride; ++c)
+		yi[c] = c0*xi[c];
+	for (int e = r.start[i]; e < r.start[i+1]; ++e)
+	{
+		const double *xj = x + (size_t)r.nb[e]*stride;
+		double we = b*r.w[e];
+		for (int c = 0; c < stride; ++c)
+			yi[c] += we*xj[c];
+	}
+}
+
+// one linear step over all the vertices, by blocks
+template<int S>
+void linear_step(const MeshRings& r, int nverts, const double* x, double* y, int s, double a, double b)
+{
+	int nblocks = (nverts + SMOOTHING_BLOCK - 1)/SMOOTHING_BLOCK;
+	#pragma omp for schedule(dynamic,1)
+	for (int bl = 0; bl < nblocks; ++bl)
+	{
+		int end = min(nverts, (bl+1)*SMOOTHING_BLOCK);
+		for (int i = bl*SMOOTHING_BLOCK; i < end; ++i)
+			average<S>(r, i, x, y, s, a, b);
+	}
+}
+
+// area weighted vertex normals of the positions x (stride 4), unit length
+void vertex_normals(const MeshRings& r, const vector<int>& faces, int nverts, const double* x, double* n)
+{
+	#pragma omp for schedule(dynamic,SMOOTHING_BLOCK)
+	for (int i = 0; i < nverts; ++i)
+	{
+		double nx(0), ny(0), nz(0);
+		for (int k = r.fstart[i]; k < r.fstart[i+1]; ++k)
+		{
+			const int *fc = &faces[3*r.fring[k]];
+			const double *p = x+4*fc[0], *q = x+4*fc[1], *t = x+4*fc[2];
+			double u[3] = {q[0]-p[0], q[1]-p[1], q[2]-p[2]}, v[3] = {t[0]-p[0], t[1]-p[1], t[2]-p[2]};
+			nx += u[1]*v[2]-u[2]*v[1];
+			ny += u[2]*v[0]-u[0]*v[2];
+			nz += u[0]*v[1]-u[1]*v[0];
+		}
+		double len = sqrt(nx*nx + ny*ny + nz*nz);
+		if (len > 0) len = 1/len;
+		n[4*i] = nx*len; n[4*i+1] = ny*len; n[4*i+2] = nz*len; n[4*i+3] = 0;
+	}
+}
+
+// one step of bilateral denoising of the positions x (stride 4)
+void bilateral_step(const MeshRings& r, int nverts, const double* x, const double* n, double* y, double sc, double ss)
+{
+	double ic = -1/(2*sc*sc), is = -1/(2*ss*ss);
+	int nblocks = (nverts + SMOOTHING_BLOCK - 1)/SMOOTHING_BLOCK;
+	#pragma omp for schedule(dynamic,1)
+	for (int bl = 0; bl < nblocks; ++bl)
+	{
+		int end = min(nverts, (bl+1)*SMOOTHING_BLOCK);
+		for (int i = bl*SMOOTHING_BLOCK; i < end; ++i)
+		{
+			const double *xi = x+4*i, *ni = n+4*i;
+			double sum(0), norm(0);
+			for (int e = r.start[i]; e < r.start[i+1]; ++e)
+			{
+				const double *xj = x+4*r.nb[e];
+				double d[3] = {xj[0]-xi[0], xj[1]-xi[1], xj[2]-xi[2]};
+				double t2 = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
+				double h = d[0]*ni[0] + d[1]*ni[1] + d[2]*ni[2];
+				double wt = exp(t2*ic + h*h*is);
+				sum += wt*h;
+				norm += wt;
+			}
+			double dh = norm > 0 ? sum/norm : 0;
+			for (int c = 0; c < 4; ++c)
+				y[4*i+c] = xi[c] + dh*ni[c];
+		}
+	}
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	///////////// Error Check
+	if (nrhs < 4 || nrhs > 5)
+		mexErrMsgTxt("Usage: f = perform_mesh_smoothing_fast(verts, faces, f, type, options)");
+	if (nlhs > 1)
+		mexErrMsgTxt("Number of output should be 1");
+
+	int nverts = (int)mxGetN(prhs[0]);
+	if (!mxIsDouble(prhs[0]) || mxGetM(prhs[0]) != 3)
+		mexErrMsgTxt("verts is excepted to be 3*nverts");
+	const double* verts = mxGetPr(prhs[0]);
+	int nfaces = (int)mxGetN(prhs[1]);
+	if (!mxIsDouble(prhs[1]) || mxGetM(prhs[1]) != 3)
+		mexErrMsgTxt("The mesh must be triangle mesh! faces is excepted to be 3*nfaces");
+	const double* pfaces = mxGetPr(prhs[1]);
+	vector<int> faces(3*nfaces);
+	for (int k = 0; k < 3*nfaces; ++k)
+	{
+		faces[k] = (int)pfaces[k] - 1;
+		if (faces[k] < 0 || faces[k] >= nverts)
+			mexErrMsgTxt("faces index out of range!");
+	}
+	if (!mxIsDouble(prhs[2]) || (int)mxGetM(prhs[2]) != nverts)
+		mexErrMsgTxt("f is excepted to be nverts*nchannels");
+	int nc = (int)mxGetN(prhs[2]);
+	const double* f = mxGetPr(prhs[2]);
+	int type = (int)mxGetScalar(prhs[3]);
+	if (type < 0 || type > 3)
+		mexErrMsgTxt("type is excepted to be 0 (combinatorial), 1 (conformal), 2 (taubin) or 3 (bilateral)");
+	if (type == 3 && nc != 3)
+		mexErrMsgTxt("f is excepted to be nverts*3 for bilateral smoothing");
+	const mxArray* options = (nrhs > 4 && mxIsStruct(prhs[4])) ? prhs[4] : NULL;
+	int niter = (int)get_option(options, "niter_averaging", 1);
+	double lambda = get_option(options, "lambda", 0.5);
+	double mu = get_option(options, "mu", -0.53);
+
+	///////////// 1-ring and weights, once
+	MeshRings rings;
+	rings.build(faces, nverts);
+	if (type == 0)
+		rings.combinatorial(true);
+	else if (type == 1 || (type == 2 && get_option(options, "cotangent", 0) != 0))
+		rings.conformal(faces, verts);
+	else if (type == 2)
+		rings.combinatorial(false);
+
+	///////////// channels of a vertex together, padded to 4 (a scalar field is not padded)
+	int s = nc == 1 ? 1 : (nc + 3)/4*4;
+	vector<double> X((size_t)nverts*s, 0), Y((size_t)nverts*s, 0), N;
+	#pragma omp parallel for
+	for (int i = 0; i < nverts; ++i)
+		for (int c = 0; c < nc; ++c)
+			X[(size_t)i*s+c] = f[(size_t)c*nverts+i];
+
+	double sc(0), ss(0);
+	if (type == 3)
+	{
+		double sum(0);
+		for (int i = 0; i < nverts; ++i)
+			for (int e = rings.start[i]; e < rings.start[i+1]; ++e)
+			{
+				const double *a = &X[4*i], *b = &X[4*rings.nb[e]];
+				sum += sqrt((a[0]-b[0])*(a[0]-b[0]) + (a[1]-b[1])*(a[1]-b[1]) + (a[2]-b[2])*(a[2]-b[2]));
+			}
+		sc = get_option(options, "sigma_c", rings.nb.empty() ? 1 : sum/rings.nb.size());
+		ss = get_option(options, "sigma_s", sc);
+		if (sc <= 0 || ss <= 0)
+			mexErrMsgTxt("sigma_c and sigma_s must be positive");
+		N.resize((size_t)nverts*4);
+	}
+	int nsteps = type == 2 ? 2*niter : niter;
+
+	#pragma omp parallel
+	{
+		// every thread swaps its own copy of the buffer pointers, after the barrier of each step
+		double *src = &X[0], *dst = &Y[0];
+		for (int it = 0; it < nsteps; ++it)
+		{
+			double a(0), b(1);
+			if (type == 2)
+			{
+				double l = it%2 ? mu : lambda;
+				a = 1 - l; b = l;
+			}
+			if (type == 3)
+			{
+				vertex_normals(rings, faces, nverts, src, &N[0]);
+				bilateral_step(rings, nverts, src, &N[0], dst, sc, ss);
+			}
+			else if (s == 1)
+				linear_step<1>(rings, nverts, src, dst, s, a, b);
+			else if (s == 4)
+				linear_step<4>(rings, nverts, src, dst, s, a, b);
+			else
+				linear_step<0>(rings, nverts, src, dst, s, a, b);
+			swap(src, dst);
+		}
+	}
+	const double* result = nsteps%2 ? &Y[0] : &X[0];
+
+	plhs[0] = mxCreateDoubleMatrix(nverts, nc, mxREAL);
+	double* out = mxGetPr(plhs[0]);
+	#pragma omp parallel for
+	for (int i = 0; i < nverts; ++i)
+		for (int c = 0; c < nc; ++c)
+			out[(size_t)c*nverts+i] = result[(size_t)i*s+c];
+}
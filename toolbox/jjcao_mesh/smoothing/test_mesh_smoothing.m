@@ -95,4 +95,34 @@ for i=1:length(Tlist)
     plot_mesh(vertex1,face,options);
     shading interp; camlight; axis tight;
 end
-saveas(gcf, [rep name '-l1reg-' laplacian_type '.png'], 'png');
\ No newline at end of file
+saveas(gcf, [rep name '-l1reg-' laplacian_type '.png'], 'png');
+
+%% implicit heat diffusion flow: one factorization, large time steps
+options.implicit = 1;
+options.dt = 5;
+options.Tmax = Tlist(end);
+options.snapshots = round(Tlist/options.dt);
+tic; [vertex1, snapshots] = perform_mesh_heat_diffusion(vertex,face,laplacian_type,options); toc
+clf;
+for i=1:length(Tlist)
+    subplot(1,length(Tlist),i);
+    plot_mesh(snapshots(:,:,i),face,options);
+    shading interp; camlight; axis tight;
+end
+saveas(gcf, [rep name '-implicit-' laplacian_type '.png'], 'png');
+options.implicit = 0;
+
+%% iterative smoothing, C-coded: all the coordinates at once
+% mex -largeArrayDims perform_mesh_smoothing_fast.cpp
+types = {'combinatorial', 'conformal', 'taubin', 'bilateral'};
+options.niter_averaging = 10;
+clf;
+for i=1:length(types)
+    options.averaging_type = types{i};
+    tic; vertex1 = perform_mesh_smoothing(face,vertex,vertex,options); toc
+    % display
+    subplot(1,length(types),i);
+    plot_mesh(vertex1,face,options);
+    shading interp; camlight; axis tight;
+end
+saveas(gcf, [rep name '-averaging.png'], 'png');
@@ -55,3 +55,27 @@ end
 
 saveas(gcf, [rep 'lloyd-' density '-' num2str(n) '.png'], 'png');
 
+%% stippling with many points, C-coded: density grid labeled by jump flooding
+% mex -largeArrayDims perform_lloyd_iteration_fast.cpp
+n = 1e4;
+X = rand(2,n);
+ndensity = 1024;
+x = linspace(-1,1,ndensity);
+[a,b] = meshgrid(x,x);
+options.density = rescale(exp( -(a.^2+b.^2)/.2 ),.01,1);
+options.niter = 50;
+options.tol = 1e-5;
+tic; X = perform_lloyd_iteration_fast(X, options.density, options); toc
+clf; plot(X(1,:),X(2,:),'k.','MarkerSize',2); axis([0 1 0 1]); axis equal; axis off;
+saveas(gcf, [rep 'lloyd-stippling-' num2str(n) '.png'], 'png');
+
+%% Lloyd on a mesh: geodesic Voronoi cells
+% mex -largeArrayDims perform_lloyd_mesh.cpp
+[verts,faces] = read_mesh('../../data/wolf0.off');
+[verts,faces] = check_face_vertex(verts,faces);
+landmark = perform_farthest_point_sampling_mesh(verts,faces,[],100);
+options.density = [];
+options.niter = 20;
+[landmark, Q] = perform_lloyd_mesh(verts, faces, landmark, options);
+options.start_points = landmark;
+clf; plot_fast_marching_mesh(verts,faces, Q, [], options);
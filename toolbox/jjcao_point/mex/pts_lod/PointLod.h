@@ -0,0 +1,481 @@
+/*=================================================================
+*
+* Out-of-core octree level of detail for point clouds
+*
+* PointLodBuilder writes a cloud into a .lod file: an octree whose inner
+* nodes keep a spatially uniform subsample of at most "budget" points (one
+* per cell of a grid over the node) and pass the rest to their children, so
+* the points of a node and of all its ancestors together are a coarse
+* version of the subtree. The points are stored node by node, in depth
+* first order.
+*
+* PointLodFile maps such a file in memory; the chunk of a node is paged in
+* only when it is touched.
+*
+* PointLodFile::select traverses the octree for a camera: a node is drawn if
+* it is in the view frustum, and its children are visited while the
+* projected point spacing of the node is larger than a threshold in pixels,
+* the nodes with the largest error first, until a point budget is reached.
+* pick and pickRect only look at the selected nodes. All of this is plain
+* C++, the viewers only draw the selected chunks.
+*
+*   PointLodBuilder::build(pts, npts, colors, normals, 4096, "cloud.lod");
+*   PointLodFile lod;
+*   lod.open("cloud.lod");
+*   PointLodCamera camera(mvp, viewport);//OpenGL matrices
+*   vector<int> nodes;
+*   lod.select(camera, 1.5, 1000000, nodes);
+*   long long id = lod.pick(camera, nodes, x, y, 5);
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#ifndef POINT_LOD_H
+#define POINT_LOD_H
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <queue>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define POINT_LOD_MAGIC "PTSLOD1"
+
+struct PointLodHeader{
+	char magic[8];
+	int flags;// POINT_LOD_COLORS | POINT_LOD_NORMALS
+	int nnodes;
+	long long npoints;
+	int budget;
+	int depth;
+	double bbox[6];// cube: min x y z, max x y z
+	// byte offsets of the arrays in the file
+	long long nodeOffset, xyzOffset, idOffset, colorOffset, normalOffset;
+};
+enum {POINT_LOD_COLORS = 1, POINT_LOD_NORMALS = 2};
+
+struct PointLodNode{
+	float center[3];
+	float halfSize;
+	float spacing;// distance between the points of the node
+	int level;
+	int child[8];// -1 if none
+	long long first;// first point of the node, points are stored node by node
+	int count;
+	int reserved;
+};
+
+// world to window, with OpenGL conventions: mvp = projection*modelview in
+// column major order, viewport = x, y, width, height, window y goes up
+struct PointLodCamera{
+	double mvp[16];
+	double viewport[4];
+
+	PointLodCamera(){
+		for (int i = 0; i < 16; ++i) mvp[i] = (i%5==0);
+		viewport[0] = viewport[1] = 0; viewport[2] = viewport[3] = 1;
+	}
+	PointLodCamera(const double *m, const double *vp){
+		std::copy(m, m+16, mvp);
+		std::copy(vp, vp+4, viewport);
+	}
+	PointLodCamera(const double *modelview, const double *projection, const double *vp){
+		for (int c = 0; c < 4; ++c)
+			for (int r = 0; r < 4; ++r){
+				double s(0);
+				for (int k = 0; k < 4; ++k) s += projection[k*4+r]*modelview[c*4+k];
+				mvp[c*4+r] = s;
+			}
+		std::copy(vp, vp+4, viewport);
+	}
+	double row(int r, double x, double y, double z) const{
+		return mvp[r] *x + mvp[4+r]*y + mvp[8+r]*z + mvp[12+r];
+	}
+	// window coordinates and depth in [0,1]; false if behind the camera
+	bool project(double x, double y, double z, double &wx, double &wy, double &wz) const{
+		double w = row(3,x,y,z);
+		if (w <= 0) return false;
+		wx = viewport[0] + viewport[2]*(row(0,x,y,z)/w + 1)*0.5;
+		wy = viewport[1] + viewport[3]*(row(1,x,y,z)/w + 1)*0.5;
+		wz = (row(2,x,y,z)/w + 1)*0.5;
+		return true;
+	}
+	// is the box center +- h at least partly in the view frustum?
+	bool visible(const float *c, double h) const{
+		for (int p = 0; p < 6; ++p){
+			int r = p/2; double s = (p%2) ? -1 : 1;
+			double a = mvp[3] + s*mvp[r], b = mvp[7] + s*mvp[4+r], cc = mvp[11] + s*mvp[8+r], d = mvp[15] + s*mvp[12+r];
+			double dist = a*c[0] + b*c[1] + cc*c[2] + d + h*(fabs(a) + fabs(b) + fabs(cc));
+			if (dist < 0) return false;
+		}
+		return true;
+	}
+	// size in pixels of a length len at the point c
+	double pixels(const float *c, double len) const{
+		double w = row(3,c[0],c[1],c[2]);
+		if (w <= 1e-12) return 1e30;// the camera is in the node
+		double sx = sqrt(mvp[0]*mvp[0] + mvp[4]*mvp[4] + mvp[8]*mvp[8])*viewport[2];
+		double sy = sqrt(mvp[1]*mvp[1] + mvp[5]*mvp[5] + mvp[9]*mvp[9])*viewport[3];
+		return 0.5*len*std::max(sx, sy)/w;
+	}
+};
+
+// read only view of a .lod file, memory mapped
+class PointLodFile{
+public:
+	PointLodFile():m_data(0),m_size(0){
+#ifdef _WIN32
+		m_file = INVALID_HANDLE_VALUE; m_mapping = 0;
+#else
+		m_fd = -1;
+#endif
+	}
+	~PointLodFile(){close();}
+
+	bool open(const char *filename){
+		close();
+#ifdef _WIN32
+		m_file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, 0);
+		if (m_file == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER size;
+		GetFileSizeEx(m_file, &size);
+		m_size = size.QuadPart;
+		m_mapping = CreateFileMappingA(m_file, 0, PAGE_READONLY, 0, 0, 0);
+		if (m_mapping) m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		m_fd = ::open(filename, O_RDONLY);
+		if (m_fd < 0) return false;
+		struct stat st;
+		if (fstat(m_fd, &st) == 0 && st.st_size > 0){
+			m_size = st.st_size;
+			void *p = mmap(0, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+			if (p != MAP_FAILED) m_data = (const char*)p;
+		}
+#endif
+		if (!m_data || m_size < (long long)sizeof(PointLodHeader) || strcmp(header().magic, POINT_LOD_MAGIC)){
+			close();
+			return false;
+		}
+		return true;
+	}
+	void close(){
+#ifdef _WIN32
+		if (m_data) UnmapViewOfFile(m_data);
+		if (m_mapping) CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE; m_mapping = 0;
+#else
+		if (m_data) munmap((void*)m_data, m_size);
+		if (m_fd >= 0) ::close(m_fd);
+		m_fd = -1;
+#endif
+		m_data = 0; m_size = 0;
+	}
+	bool isOpen() const {return m_data != 0;}
+
+	const PointLodHeader& header() const {return *(const PointLodHeader*)m_data;}
+	int getNNodes() const {return header().nnodes;}
+	long long getNPoints() const {return header().npoints;}
+	bool hasColors() const {return (header().flags & POINT_LOD_COLORS) != 0;}
+	bool hasNormals() const {return (header().flags & POINT_LOD_NORMALS) != 0;}
+	const PointLodNode& node(int i) const {return ((const PointLodNode*)(m_data + header().nodeOffset))[i];}
+	// chunks of node i
+	const float* xyz(int i) const {return (const float*)(m_data + header().xyzOffset) + 3*node(i).first;}
+	const long long* ids(int i) const {return (const long long*)(m_data + header().idOffset) + node(i).first;}
+	const unsigned char* colors(int i) const {return hasColors() ? (const unsigned char*)(m_data + header().colorOffset) + 3*node(i).first : 0;}
+	const float* normals(int i) const {return hasNormals() ? (const float*)(m_data + header().normalOffset) + 3*node(i).first : 0;}
+
+	// nodes to draw for the camera, at most about pointBudget points.
+	// Children are refined while the spacing of their parent is more than
+	// threshold pixels. Returns the number of selected points.
+	long long select(const PointLodCamera &camera, double threshold, long long pointBudget, std::vector<int> &nodes) const{
+		nodes.clear();
+		if (!isOpen() || getNNodes() == 0) return 0;
+		std::priority_queue<std::pair<double,int> > front;
+		const PointLodNode &root = node(0);
+		if (camera.visible(root.center, root.halfSize))
+			front.push(std::make_pair(camera.pixels(root.center, root.spacing), 0));
+		long long total(0);
+		while (!front.empty() && total < pointBudget){
+			double error = front.top().first;
+			int i = front.top().second;
+			front.pop();
+			const PointLodNode &n = node(i);
+			nodes.push_back(i);
+			total += n.count;
+			if (error <= threshold) continue;
+			for (int k = 0; k < 8; ++k){
+				int c = n.child[k];
+				if (c < 0) continue;
+				const PointLodNode &cn = node(c);
+				if (camera.visible(cn.center, cn.halfSize))
+					front.push(std::make_pair(camera.pixels(cn.center, cn.spacing), c));
+			}
+		}
+		return total;
+	}
+
+	// nearest visible point within radius pixels of window position (x,y):
+	// the smallest depth wins. Returns its id (0-based), -1 if none.
+	long long pick(const PointLodCamera &camera, const std::vector<int> &nodes, double x, double y, double radius, float *pos = 0) const{
+		long long best(-1);
+		double bestDepth(2);
+		for (size_t k = 0; k < nodes.size(); ++k){
+			int i = nodes[k];
+			if (!nodeOnScreen(camera, i, x-radius, y-radius, x+radius, y+radius)) continue;
+			const float *p = xyz(i);
+			for (int j = 0; j < node(i).count; ++j){
+				double wx, wy, wz;
+				if (!camera.project(p[3*j], p[3*j+1], p[3*j+2], wx, wy, wz) || wz > 1) continue;
+				if ((wx-x)*(wx-x) + (wy-y)*(wy-y) > radius*radius || wz >= bestDepth) continue;
+				bestDepth = wz;
+				best = ids(i)[j];
+				if (pos) std::copy(p+3*j, p+3*j+3, pos);
+			}
+		}
+		return best;
+	}
+	// ids of the visible points inside the window rectangle [x0,x1]x[y0,y1]
+	void pickRect(const PointLodCamera &camera, const std::vector<int> &nodes, double x0, double y0, double x1, double y1, std::vector<long long> &result) const{
+		result.clear();
+		if (x0 > x1) std::swap(x0, x1);
+		if (y0 > y1) std::swap(y0, y1);
+		for (size_t k = 0; k < nodes.size(); ++k){
+			int i = nodes[k];
+			if (!nodeOnScreen(camera, i, x0, y0, x1, y1)) continue;
+			const float *p = xyz(i);
+			const long long *id = ids(i);
+			for (int j = 0; j < node(i).count; ++j){
+				double wx, wy, wz;
+				if (camera.project(p[3*j], p[3*j+1], p[3*j+2], wx, wy, wz) && wz <= 1 &&
+					wx >= x0 && wx <= x1 && wy >= y0 && wy <= y1)
+					result.push_back(id[j]);
+			}
+		}
+	}
+
+private:
+	// may the window rectangle see a point of the node?
+	bool nodeOnScreen(const PointLodCamera &camera, int i, double x0, double y0, double x1, double y1) const{
+		const PointLodNode &n = node(i);
+		double bx0(1e300), by0(1e300), bx1(-1e300), by1(-1e300);
+		for (int k = 0; k < 8; ++k){
+			double wx, wy, wz;
+			if (!camera.project(n.center[0] + ((k&1) ? n.halfSize : -n.halfSize),
+								n.center[1] + ((k&2) ? n.halfSize : -n.halfSize),
+								n.center[2] + ((k&4) ? n.halfSize : -n.halfSize), wx, wy, wz))
+				return true;// a corner behind the camera: no bound
+			bx0 = std::min(bx0, wx); bx1 = std::max(bx1, wx);
+			by0 = std::min(by0, wy); by1 = std::max(by1, wy);
+		}
+		return bx1 >= x0 && bx0 <= x1 && by1 >= y0 && by0 <= y1;
+	}
+
+	const char *m_data;
+	long long m_size;
+#ifdef _WIN32
+	HANDLE m_file, m_mapping;
+#else
+	int m_fd;
+#endif
+};
+
+class PointLodBuilder{
+public:
+	// pts, colors (in [0,1]) and normals are npts*3, column major as in
+	// Matlab; colors and normals may be NULL. Returns false if the file can
+	// not be written.
+	static bool build(const double *pts, long long npts, const double *colors, const double *normals,
+					  int budget, const char *filename, int maxDepth = 21){
+		PointLodBuilder b(pts, npts, budget < 1 ? 1 : budget, maxDepth);
+		b.buildTree();
+		return b.write(colors, normals, filename);
+	}
+
+private:
+	PointLodBuilder(const double *pts, long long npts, int budget, int maxDepth)
+		:m_pts(pts), m_npts(npts), m_budget(budget), m_maxDepth(maxDepth), m_depth(0){
+		m_grid = std::max(1, (int)floor(pow((double)budget, 1.0/3) + 1e-9));
+	}
+	double coord(long long i, int d) const {return m_pts[d*m_npts + i];}
+
+	void buildTree(){
+		double lo[3] = {1e300, 1e300, 1e300}, hi[3] = {-1e300, -1e300, -1e300};
+		for (int d = 0; d < 3; ++d)
+			for (long long i = 0; i < m_npts; ++i){
+				lo[d] = std::min(lo[d], coord(i,d));
+				hi[d] = std::max(hi[d], coord(i,d));
+			}
+		double h(0);
+		for (int d = 0; d < 3; ++d){
+			if (m_npts == 0) lo[d] = hi[d] = 0;
+			h = std::max(h, 0.5*(hi[d]-lo[d]));
+		}
+		if (h <= 0) h = 1;
+		h *= 1.0001;// keep the points strictly inside
+		for (int d = 0; d < 3; ++d){
+			m_center[d] = 0.5*(lo[d]+hi[d]);
+			m_bbox[d] = m_center[d] - h; m_bbox[d+3] = m_center[d] + h;
+		}
+		m_halfSize = h;
+
+		m_order.resize(m_npts);
+		for (long long i = 0; i < m_npts; ++i) m_order[i] = i;
+		m_nodes.clear();
+		m_nodes.reserve((size_t)(m_npts/m_budget)*2 + 8);
+		double c[3] = {m_center[0], m_center[1], m_center[2]};
+		buildNode(0, m_npts, c, h, 0);
+	}
+
+	// build the node of m_order[b,e), returns its index
+	int buildNode(long long b, long long e, const double *c, double h, int level){
+		int id = (int)m_nodes.size();
+		m_nodes.push_back(PointLodNode());
+		PointLodNode n;
+		memset(&n, 0, sizeof(n));
+		for (int d = 0; d < 3; ++d) n.center[d] = (float)c[d];
+		n.halfSize = (float)h;
+		n.level = level;
+		n.first = b;
+		for (int k = 0; k < 8; ++k) n.child[k] = -1;
+		m_depth = std::max(m_depth, level);
+
+		if (e-b <= m_budget || level >= m_maxDepth){
+			n.count = (int)(e-b);
+			n.spacing = (float)(2*h/std::max(1.0, pow((double)n.count, 1.0/3)));
+			m_nodes[id] = n;
+			return id;
+		}
+
+		// one point per cell of a grid over the node stays here
+		int g = m_grid;
+		std::vector<char> used(g*g*g, 0);
+		long long k = b;
+		for (long long i = b; i < e; ++i){
+			int cell(0);
+			for (int d = 0; d < 3; ++d){
+				int ci = (int)((coord(m_order[i],d) - (c[d]-h))/(2*h)*g);
+				cell = cell*g + std::max(0, std::min(g-1, ci));
+			}
+			if (!used[cell]){
+				used[cell] = 1;
+				std::swap(m_order[k++], m_order[i]);
+			}
+		}
+		n.count = (int)(k-b);
+		n.spacing = (float)(2*h/g);
+
+		// the others go to the octants, counting sort
+		long long start[9] = {0};
+		std::vector<long long> rest(m_order.begin()+k, m_order.begin()+e);
+		std::vector<unsigned char> oct(rest.size());
+		for (size_t i = 0; i < rest.size(); ++i){
+			int o(0);
+			for (int d = 0; d < 3; ++d)
+				if (coord(rest[i],d) >= c[d]) o |= 1<<d;
+			oct[i] = (unsigned char)o;
+			++start[o+1];
+		}
+		for (int o = 0; o < 8; ++o) start[o+1] += start[o];
+		std::vector<long long> fill(start, start+8);
+		for (size_t i = 0; i < rest.size(); ++i)
+			m_order[k + fill[oct[i]]++] = rest[i];
+		std::vector<long long>().swap(rest);
+
+		m_nodes[id] = n;
+		for (int o = 0; o < 8; ++o){
+			if (start[o+1] == start[o]) continue;
+			double cc[3];
+			for (int d = 0; d < 3; ++d) cc[d] = c[d] + ((o>>d)&1 ? 0.5*h : -0.5*h);
+			int child = buildNode(k+start[o], k+start[o+1], cc, 0.5*h, level+1);
+			m_nodes[id].child[o] = child;
+		}
+		return id;
+	}
+
+	bool write(const double *colors, const double *normals, const char *filename) const{
+		FILE *fp = fopen(filename, "wb");
+		if (!fp) return false;
+
+		PointLodHeader hd;
+		memset(&hd, 0, sizeof(hd));
+		strcpy(hd.magic, POINT_LOD_MAGIC);
+		hd.flags = (colors ? POINT_LOD_COLORS : 0) | (normals ? POINT_LOD_NORMALS : 0);
+		hd.nnodes = (int)m_nodes.size();
+		hd.npoints = m_npts;
+		hd.budget = m_budget;
+		hd.depth = m_depth;
+		std::copy(m_bbox, m_bbox+6, hd.bbox);
+		hd.nodeOffset = sizeof(hd);
+		hd.xyzOffset = hd.nodeOffset + (long long)sizeof(PointLodNode)*hd.nnodes;
+		hd.idOffset = hd.xyzOffset + 12*m_npts;
+		hd.idOffset = (hd.idOffset + 7)/8*8;
+		hd.colorOffset = hd.idOffset + 8*m_npts;
+		hd.normalOffset = hd.colorOffset + (colors ? 3*m_npts : 0);
+		hd.normalOffset = (hd.normalOffset + 7)/8*8;
+
+		bool ok = fwrite(&hd, sizeof(hd), 1, fp) == 1;
+		if (!m_nodes.empty())
+			ok = ok && fwrite(&m_nodes[0], sizeof(PointLodNode), m_nodes.size(), fp) == m_nodes.size();
+
+		// the arrays in chunks, in the order of the nodes
+		const long long chunk = 1<<16;
+		std::vector<float> fbuf(3*chunk);
+		for (long long b = 0; ok && b < m_npts; b += chunk){
+			long long e = std::min(m_npts, b+chunk);
+			for (long long i = b; i < e; ++i)
+				for (int d = 0; d < 3; ++d) fbuf[3*(i-b)+d] = (float)coord(m_order[i],d);
+			ok = fwrite(&fbuf[0], sizeof(float), 3*(e-b), fp) == (size_t)(3*(e-b));
+		}
+		ok = ok && pad(fp, hd.idOffset - (hd.xyzOffset + 12*m_npts));
+		if (ok && m_npts)
+			ok = fwrite(&m_order[0], sizeof(long long), m_npts, fp) == (size_t)m_npts;
+		if (colors){
+			std::vector<unsigned char> cbuf(3*chunk);
+			for (long long b = 0; ok && b < m_npts; b += chunk){
+				long long e = std::min(m_npts, b+chunk);
+				for (long long i = b; i < e; ++i)
+					for (int d = 0; d < 3; ++d){
+						double v = colors[d*m_npts + m_order[i]];
+						cbuf[3*(i-b)+d] = (unsigned char)(std::max(0.0, std::min(1.0, v))*255 + 0.5);
+					}
+				ok = fwrite(&cbuf[0], 1, 3*(e-b), fp) == (size_t)(3*(e-b));
+			}
+		}
+		ok = ok && pad(fp, hd.normalOffset - (hd.colorOffset + (colors ? 3*m_npts : 0)));
+		if (normals){
+			for (long long b = 0; ok && b < m_npts; b += chunk){
+				long long e = std::min(m_npts, b+chunk);
+				for (long long i = b; i < e; ++i)
+					for (int d = 0; d < 3; ++d) fbuf[3*(i-b)+d] = (float)normals[d*m_npts + m_order[i]];
+				ok = fwrite(&fbuf[0], sizeof(float), 3*(e-b), fp) == (size_t)(3*(e-b));
+			}
+		}
+		return (fclose(fp) == 0) && ok;
+	}
+	// zeros to align the next array on 8 bytes
+	static bool pad(FILE *fp, long long n){
+		char zero[8] = {0};
+		return fwrite(zero, 1, (size_t)n, fp) == (size_t)n;
+	}
+
+	const double *m_pts;
+	long long m_npts;
+	int m_budget, m_maxDepth, m_depth, m_grid;
+	double m_center[3], m_halfSize, m_bbox[6];
+	std::vector<long long> m_order;
+	std::vector<PointLodNode> m_nodes;
+};
+
+#endif // POINT_LOD_H
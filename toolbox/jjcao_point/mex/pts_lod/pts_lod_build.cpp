@@ -0,0 +1,82 @@
+/*=================================================================
+*
+* Build the octree level of detail of a point cloud into a .lod file, which
+* pts_lod_query, show_pts_gl and show_pts_vtk then read out of core.
+*
+* usage:
+		nnodes = pts_lod_build(pts, filename, colors, normals, budget);
+* compile:
+		mex pts_lod_build.cpp
+* inputs:
+		pts: npts*3
+		filename: the .lod file to write
+		colors: npts*3 in [0,1], or [] (optional)
+		normals: npts*3, or [] (optional)
+		budget: max number of points kept by an inner node of the octree,
+			default 4096
+* outputs:
+		nnodes: number of nodes of the octree
+*
+*	The octree is built in memory, only its use is out of core.
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "mex.h"
+#include "PointLod.h"
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray*prhs[])
+{
+	///////////// Error Check
+	if ( nrhs < 2 || nrhs > 5)
+		mexErrMsgTxt("Usage: nnodes = pts_lod_build(pts, filename, colors, normals, budget)");
+	if ( nlhs > 1)
+		mexErrMsgTxt("Number of output should be 0 or 1");
+
+	///////////// input arguments
+	long long npts = mxGetM(prhs[0]);
+	if ( !mxIsDouble(prhs[0]) || mxGetN(prhs[0]) != 3)
+		mexErrMsgTxt("pts is excepted to be npts*3");
+	const double *pts = mxGetPr(prhs[0]);
+
+	if ( !mxIsChar(prhs[1]))
+		mexErrMsgTxt("filename is excepted to be a string");
+	int buflen = (int)(mxGetM(prhs[1]) * mxGetN(prhs[1])) + 1;
+	char *filename = (char*) mxMalloc(buflen);
+	mxGetString(prhs[1], filename, buflen);
+
+	const double *colors = 0, *normals = 0;
+	if ( nrhs > 2 && !mxIsEmpty(prhs[2]))
+	{
+		if ( !mxIsDouble(prhs[2]) || (long long)mxGetM(prhs[2]) != npts || mxGetN(prhs[2]) != 3)
+			mexErrMsgTxt("colors is excepted to be npts*3");
+		colors = mxGetPr(prhs[2]);
+	}
+	if ( nrhs > 3 && !mxIsEmpty(prhs[3]))
+	{
+		if ( !mxIsDouble(prhs[3]) || (long long)mxGetM(prhs[3]) != npts || mxGetN(prhs[3]) != 3)
+			mexErrMsgTxt("normals is excepted to be npts*3");
+		normals = mxGetPr(prhs[3]);
+	}
+	int budget = nrhs > 4 ? (int)mxGetScalar(prhs[4]) : 4096;
+
+	if ( !PointLodBuilder::build(pts, npts, colors, normals, budget, filename))
+	{
+		mxFree(filename);
+		mexErrMsgTxt("can not write the lod file!");
+	}
+
+	///////////// output
+	if ( nlhs > 0)
+	{
+		PointLodFile lod;
+		if ( !lod.open(filename))
+		{
+			mxFree(filename);
+			mexErrMsgTxt("can not read the lod file back!");
+		}
+		plhs[0] = mxCreateDoubleScalar(lod.getNNodes());
+	}
+	mxFree(filename);
+}
@@ -0,0 +1,132 @@
+/*=================================================================
+*
+* Points of a .lod file seen by a camera, and picking among them, without
+* any window: the same traversal as show_pts_gl and show_pts_vtk.
+*
+* usage:
+		[ids, pickId, nodes] = pts_lod_query(filename, mvp, viewport, options);
+* compile:
+		mex pts_lod_query.cpp
+* inputs:
+		filename: built by pts_lod_build
+		mvp: 4*4, projection*modelview as in OpenGL
+		viewport: [x y width height] in pixels
+		options:
+			threshold: a node is refined while its point spacing is more than
+				threshold pixels, default 1.5
+			budget: max number of selected points, default 1e6
+			pick: [x y], window position to pick at (y goes up), default none
+			radius: pick radius in pixels, default 5
+			rect: [x0 y0 x1 y1], ids returns the points inside it, default none
+* outputs:
+		ids: 1-based indices of the selected points (in the rect if given)
+		pickId: 1-based index of the point picked, 0 if none
+		nodes: 1-based indices of the selected octree nodes
+*
+* JJCAO, 2026
+*
+*=================================================================*/
+
+#include "mex.h"
+#include "PointLod.h"
+using namespace std;
+
+double get_option( const mxArray *options, const char *name, double value )
+{
+	if( options==NULL )
+		return value;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return value;
+	return mxGetScalar(field);
+}
+// the n values of a field, false if it is missing
+bool get_option( const mxArray *options, const char *name, double *values, int n )
+{
+	if( options==NULL )
+		return false;
+	mxArray *field = mxGetField( options, 0, name );
+	if( field==NULL || mxIsEmpty(field) )
+		return false;
+	if( !mxIsDouble(field) || (int)mxGetNumberOfElements(field)!=n )
+		mexErrMsgTxt("wrong size of a field of options");
+	copy(mxGetPr(field), mxGetPr(field)+n, values);
+	return true;
+}
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray*prhs[])
+{
+	///////////// Error Check
+	if ( nrhs < 3 || nrhs > 4)
+		mexErrMsgTxt("Usage: [ids, pickId, nodes] = pts_lod_query(filename, mvp, viewport, options)");
+	if ( nlhs > 3)
+		mexErrMsgTxt("Number of output should be 0 to 3");
+
+	///////////// input arguments
+	if ( !mxIsChar(prhs[0]))
+		mexErrMsgTxt("filename is excepted to be a string");
+	int buflen = (int)(mxGetM(prhs[0]) * mxGetN(prhs[0])) + 1;
+	char *filename = (char*) mxMalloc(buflen);
+	mxGetString(prhs[0], filename, buflen);
+	PointLodFile lod;
+	bool opened = lod.open(filename);
+	mxFree(filename);
+	if ( !opened)
+		mexErrMsgTxt("can not open the lod file!");
+
+	if ( !mxIsDouble(prhs[1]) || mxGetM(prhs[1]) != 4 || mxGetN(prhs[1]) != 4)
+		mexErrMsgTxt("mvp is excepted to be 4*4");
+	if ( !mxIsDouble(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 4)
+		mexErrMsgTxt("viewport is excepted to be [x y width height]");
+	// a Matlab matrix is column major, as OpenGL
+	PointLodCamera camera(mxGetPr(prhs[1]), mxGetPr(prhs[2]));
+
+	const mxArray *options = ( nrhs>3 && mxIsStruct(prhs[3]) ) ? prhs[3] : NULL;
+	double threshold = get_option(options, "threshold", 1.5);
+	long long budget = (long long)get_option(options, "budget", 1e6);
+	double radius = get_option(options, "radius", 5);
+	double pickAt[2], rect[4];
+	bool doPick = get_option(options, "pick", pickAt, 2);
+	bool doRect = get_option(options, "rect", rect, 4);
+
+	///////////// traversal
+	vector<int> nodes;
+	lod.select(camera, threshold, budget, nodes);
+
+	///////////// output
+	if ( doRect)
+	{
+		vector<long long> ids;
+		lod.pickRect(camera, nodes, rect[0], rect[1], rect[2], rect[3], ids);
+		plhs[0] = mxCreateDoubleMatrix(ids.size(), 1, mxREAL);
+		double *pIds = mxGetPr(plhs[0]);
+		for (size_t i = 0; i < ids.size(); ++i)
+			pIds[i] = (double)ids[i] + 1;
+	}
+	else
+	{
+		size_t n(0);
+		for (size_t k = 0; k < nodes.size(); ++k)
+			n += lod.node(nodes[k]).count;
+		plhs[0] = mxCreateDoubleMatrix(n, 1, mxREAL);
+		double *pIds = mxGetPr(plhs[0]);
+		for (size_t k = 0; k < nodes.size(); ++k)
+		{
+			const long long *id = lod.ids(nodes[k]);
+			for (int j = 0; j < lod.node(nodes[k]).count; ++j)
+				*pIds++ = (double)id[j] + 1;
+		}
+	}
+	if ( nlhs > 1)
+	{
+		long long id = doPick ? lod.pick(camera, nodes, pickAt[0], pickAt[1], radius) : -1;
+		plhs[1] = mxCreateDoubleScalar((double)(id + 1));
+	}
+	if ( nlhs > 2)
+	{
+		plhs[2] = mxCreateDoubleMatrix(nodes.size(), 1, mxREAL);
+		double *pNodes = mxGetPr(plhs[2]);
+		for (size_t k = 0; k < nodes.size(); ++k)
+			pNodes[k] = nodes[k] + 1;
+	}
+}
@@ -0,0 +1,49 @@
+% test_pts_lod
+%
+% octree level of detail of a point cloud: build it once, then select and
+% pick the points seen by a camera without loading the whole cloud
+%
+% Copyright (c) 2026 Junjie Cao
+
+clear;clc;close all;
+mex pts_lod_build.cpp
+mex pts_lod_query.cpp
+
+%% a big cloud: points on a sphere
+npts = 2e6;
+pts = randn(npts,3);
+pts = pts./repmat(sqrt(sum(pts.^2,2)),1,3);
+colors = (pts+1)*0.5;
+filename = 'sphere.lod';
+tic
+nnodes = pts_lod_build(pts, filename, colors, pts, 4096);
+toc
+fprintf('%d nodes\n', nnodes);
+
+%% camera: looking at the sphere from z = 5, as gluPerspective & gluLookAt
+f = 3; n = 1; fa = 10;
+P = [f 0 0 0; 0 f 0 0; 0 0 -(fa+n)/(fa-n) -2*fa*n/(fa-n); 0 0 -1 0];
+MV = eye(4); MV(3,4) = -5;
+viewport = [0 0 800 800];
+
+options.threshold = 1.5;
+options.budget = 1e6;
+options.pick = [400 400];
+tic
+[ids, pickId, nodes] = pts_lod_query(filename, P*MV, viewport, options);
+toc
+fprintf('%d points of %d nodes selected, picked %d at [%g %g %g]\n', length(ids), length(nodes), pickId, pts(pickId,:));
+
+figure('Name','selected points');set(gcf,'color','white');
+scatter3(pts(ids,1),pts(ids,2),pts(ids,3),1,colors(ids,:),'.'); axis off;axis equal; hold on;
+plot3(pts(pickId,1),pts(pickId,2),pts(pickId,3),'b*','MarkerSize',12);
+view3d rot;
+
+%% points in a window rectangle
+options.rect = [0 0 400 800];
+inRect = pts_lod_query(filename, P*MV, viewport, options);
+fprintf('%d points in the left half, all with x<0: %d\n', length(inRect), all(pts(inRect,1)<=0));
+
+%% the viewers draw the same selection
+% show_pts_gl(filename, 1.5, 2e6);
+% show_pts_vtk(filename, 1.5, 2e6);
@@ -15,6 +15,7 @@
 #include <GL/glut.h>
 #include "myutil.h"
 #include "MyHeaps.h"
+#include "../pts_lod/PointLod.h"
 
 using namespace std;
 
@@ -83,6 +84,15 @@ class Pcloud;
 Pcloud* pcloud(0); // the point cloud
 double *pickedPtsIdx; // picked points' id, results of the program
 
+// out of core point cloud, when a .lod file is shown
+PointLodFile* lod(0);
+PointLodCamera lod_camera; // camera of the last frame
+vector<int> lod_nodes; // octree nodes drawn in the last frame
+double lod_threshold = 1.5; // max point spacing in pixels
+long long lod_budget = 2000000; // max number of points drawn
+long long lod_pick_id = -1;
+float lod_pick_pos[3];
+
 // Local classes
 class Pcloud{
 public:
@@ -433,6 +443,45 @@ public:
 	}
 };
 
+// draw the nodes of the .lod file selected for the current camera
+void drawLod(){
+	double mv[16], pj[16], viewport[4]; int vp[4];
+	glGetDoublev(GL_MODELVIEW_MATRIX, mv);
+	glGetDoublev(GL_PROJECTION_MATRIX, pj);
+	glGetIntegerv(GL_VIEWPORT, vp);
+	for (int i = 0; i < 4; ++i) viewport[i] = vp[i];
+	lod_camera = PointLodCamera(mv, pj, viewport);
+	lod->select(lod_camera, lod_threshold, lod_budget, lod_nodes);
+
+	glDisable(GL_LIGHTING);
+	glPointSize(2);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	bool percolor = colorwhat==1 && lod->hasColors();
+	if (percolor)
+		glEnableClientState(GL_COLOR_ARRAY);
+	else
+		glColor3fv(surfelcolor);
+	for (size_t k = 0; k < lod_nodes.size(); ++k){
+		int i = lod_nodes[k];
+		glVertexPointer(3, GL_FLOAT, 0, lod->xyz(i));
+		if (percolor) glColorPointer(3, GL_UNSIGNED_BYTE, 0, lod->colors(i));
+		glDrawArrays(GL_POINTS, 0, lod->node(i).count);
+	}
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glEnable(GL_LIGHTING);
+
+	if (lod_pick_id < 0) return;
+	GLUquadricObj *q = gluNewQuadric();
+	gluQuadricNormals (q,GLU_FALSE);
+	glPushMatrix();
+	glTranslatef( lod_pick_pos[0], lod_pick_pos[1], lod_pick_pos[2] );
+	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, vertPickColor);
+	gluSphere(q, markersize*0.7, 10, 10);
+	glPopMatrix();
+	gluDeleteQuadric(q);
+}
+
 void displayCallback() {
 	// clear background
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
@@ -462,11 +511,14 @@ void displayCallback() {
 	//draw_axis_simple(); // added by jjcao
 
 	// Draw the point cloud
-	if( tranparencyEnabled )
+	if( lod )
+		drawLod();
+	else if( tranparencyEnabled )
 		pcloud->draw_transp( markersize, show_backpointing, colorwhat );
 	else
 		pcloud->draw( markersize, show_backpointing, colorwhat, showsplats );
-	pcloud->drawPickedPoints(markersize, show_backpointing, colorwhat, showsplats );
+	if( pcloud )
+		pcloud->drawPickedPoints(markersize, show_backpointing, colorwhat, showsplats );
 
 	// Draw the axis
 	//draw_axis();
@@ -589,6 +641,15 @@ void mouseCallback(int button, int state, int x, int y) {
 			//cout << "middle button" << endl;
 			modelview_status = PICKING;
 
+			if (lod){// on the points drawn in the last frame, no dragging
+				lod_pick_id = lod->pick(lod_camera, lod_nodes, x, window_height-y, 5, lod_pick_pos);
+				stringstream ss;	ss << "point picked: " << lod_pick_id << " points size: " << lod->getNPoints();
+				print(ss.str().c_str());
+				modelview_sx = x;
+				modelview_sy = y;
+				glutPostRedisplay();
+				return;
+			}
 			startPicking(x,y);
 			picking();
 			stopPicking();
@@ -724,6 +785,7 @@ void keyboardCallback(unsigned char key, int x, int y) {
 	case 'h':
 		print("EXAMPLE SYNTAX: pickedPtsIdx = show_pts_gl(verts) \n");
 		print("EXAMPLE SYNTAX: pickedPtsIdx = show_pts_gl(verts, colors, normals, radius) \n");
+		print("EXAMPLE SYNTAX: show_pts_gl(lodfile, threshold, budget), lodfile built by pts_lod_build \n");
 		print("h: show this help\n");
 		print("= / -: zoom/unzoom the model\n");
 		print("[ / ]: decrease/increase size of splats or spherelets\n");
@@ -751,6 +813,7 @@ void keyboardCallback(unsigned char key, int x, int y) {
 		break;
 	case 'l': //clear picked vertex and edge
 		pick_vid = -1;
+		lod_pick_id = -1;
 		break;
 	}
 	glutPostRedisplay();
@@ -767,28 +830,45 @@ void mexFunction(int nlhs, mxArray*plhs[],
 	mexWarnMsgTxt("begin \n");
 	mexPrintf("begin \n");
 
+	/* Show a .lod file out of core: show_pts_gl(lodfile, threshold, budget) */
+	if (mxIsChar(prhs[0])) {
+		int buflen = (int)(mxGetM(prhs[0]) * mxGetN(prhs[0])) + 1;
+		char *filename = (char*) mxMalloc(buflen);
+		mxGetString(prhs[0], filename, buflen);
+		lod = new PointLodFile;
+		bool opened = lod->open(filename);
+		mxFree(filename);
+		if (!opened)
+			mexErrMsgTxt("can not open the lod file!");
+		if (nrhs > 1) lod_threshold = mxGetScalar(prhs[1]);
+		if (nrhs > 2) lod_budget = (long long)mxGetScalar(prhs[2]);
+		plhs[0] = mxCreateDoubleMatrix(0, 1, mxREAL);
+	}
+
 	/* Handle parameters and outputs. */
 	int npts, radius_dim(0);
 	double *pts(0), *colors(0), *normals(0), *radius(0);
 
-	npts = mxGetM(prhs[0]);
-	pts = mxGetPr(prhs[0]);
-	if (nrhs > 1) {
-		colors = mxGetPr(prhs[1]);
-	}
-	if (nrhs > 2) {
-		normals = mxGetPr(prhs[2]);
-	}
-	if (nrhs > 3) {
-		radius = mxGetPr(prhs[3]);
-		radius_dim = mxGetN(prhs[3]);
-	}
+	if (!lod) {
+		npts = mxGetM(prhs[0]);
+		pts = mxGetPr(prhs[0]);
+		if (nrhs > 1) {
+			colors = mxGetPr(prhs[1]);
+		}
+		if (nrhs > 2) {
+			normals = mxGetPr(prhs[2]);
+		}
+		if (nrhs > 3) {
+			radius = mxGetPr(prhs[3]);
+			radius_dim = mxGetN(prhs[3]);
+		}
 
-	plhs[0] = mxCreateDoubleMatrix(npts, 1, mxREAL);
-	pickedPtsIdx = mxGetPr(plhs[0]);
+		plhs[0] = mxCreateDoubleMatrix(npts, 1, mxREAL);
+		pickedPtsIdx = mxGetPr(plhs[0]);
 
-	/* build data structure. */
-	pcloud = new Pcloud(npts, pts, colors, normals, radius, radius_dim); // added by jjcao
+		/* build data structure. */
+		pcloud = new Pcloud(npts, pts, colors, normals, radius, radius_dim); // added by jjcao
+	}
 
 	/* initialize glut stuff and create window. */
 	int argc(1); char* argv[1]; argv[0]="show_pts_gl.exe";
@@ -37,6 +37,9 @@
 #include <vtkPointPicker.h>
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
+#include <vtkMatrix4x4.h>
+#include <vtkUnsignedCharArray.h>
+#include "../pts_lod/PointLod.h"
 
 #pragma comment(lib,"vtkCommon.lib ") // for vtkSmartPointer
 #pragma comment(lib,"vtkFiltering.lib ") // for *->GetOutputPort()
@@ -46,12 +49,21 @@
 
 #include <sstream>
 #include <vector>
+#include <map>
 using namespace std;
 
 double *pts(0), *radius(0), *pickPtsIdx(0);
 int npts(0), radius_dim(0);
 vector<vtkSmartPointer<vtkActor> > pickActors;
 
+// out of core point cloud, when a .lod file is shown
+PointLodFile* lod(0);
+PointLodCamera lod_camera; // camera of the last frame
+vector<int> lod_nodes; // octree nodes shown in the last frame
+double lod_threshold = 1.5; // max point spacing in pixels
+long long lod_budget = 2000000; // max number of points shown
+map<long long, vtkSmartPointer<vtkActor> > lodPickActors;
+
 VTK_CREATE(vtkPolyData, polyData);
 VTK_CREATE(vtkLODActor, actor);
 VTK_CREATE(vtkPolyDataMapper, mapper);
@@ -135,6 +147,64 @@ void matlabDataToVtkPolyData(double*pts, int npts, double* scalars, int scalars_
 	}
 }
 
+// points of the selected nodes of the .lod file
+void lodNodesToVtkPolyData(const vector<int>& nodes)
+{
+	vtkIdType n(0);
+	for (size_t k = 0; k < nodes.size(); ++k)
+		n += lod->node(nodes[k]).count;
+
+	VTK_CREATE(vtkPoints, points);
+	points->SetNumberOfPoints(n);
+	VTK_CREATE(vtkCellArray, verts);
+	verts->Allocate(verts->EstimateSize(1,n));
+	verts->InsertNextCell(n);
+	VTK_CREATE(vtkUnsignedCharArray, cs);
+	cs->SetNumberOfComponents(3);	cs->SetNumberOfTuples(lod->hasColors() ? n : 0);	cs->SetName("Scalars");
+	VTK_CREATE(vtkFloatArray, ns);
+	ns->SetNumberOfComponents(3);	ns->SetNumberOfTuples(lod->hasNormals() ? n : 0);	ns->SetName("Normals");
+
+	vtkIdType id(0);
+	for (size_t k = 0; k < nodes.size(); ++k){
+		int i = nodes[k];
+		const float *xyz = lod->xyz(i), *normal = lod->normals(i);
+		const unsigned char *color = lod->colors(i);
+		for (int j = 0; j < lod->node(i).count; ++j, ++id){
+			points->SetPoint(id, xyz[3*j], xyz[3*j+1], xyz[3*j+2]);
+			verts->InsertCellPoint(id);
+			if (color) cs->SetTupleValue(id, color + 3*j);
+			if (normal) ns->SetTupleValue(id, normal + 3*j);
+		}
+	}
+	polyData->SetPoints(points);
+	polyData->SetVerts(verts);
+	polyData->GetPointData()->SetScalars(lod->hasColors() ? cs.GetPointer() : 0);
+	polyData->GetPointData()->SetNormals(lod->hasNormals() ? ns.GetPointer() : 0);
+	polyData->Modified();
+}
+// select the nodes for the camera before each render
+static void lodCallback( vtkObject* object,
+						unsigned long event,
+						void* vtkNotUsed(clientdata),
+						void* vtkNotUsed(calldata) )
+{
+	vtkRenderer* ren1 = vtkRenderer::SafeDownCast(object);
+	int* size = ren1->GetRenderWindow()->GetSize();
+	vtkMatrix4x4* m = ren1->GetActiveCamera()->GetCompositeProjectionTransformMatrix(ren1->GetTiledAspectRatio(), -1, 1);
+	double mvp[16], viewport[4] = {0, 0, (double)size[0], (double)size[1]};
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c)
+			mvp[c*4+r] = m->GetElement(r,c);
+	lod_camera = PointLodCamera(mvp, viewport);
+
+	vector<int> nodes;
+	lod->select(lod_camera, lod_threshold, lod_budget, nodes);
+	if (nodes != lod_nodes){
+		lod_nodes.swap(nodes);
+		lodNodesToVtkPolyData(lod_nodes);
+	}
+}
+
 // if want each splat be an ellipse, which long and short axis vary according to two scalars, we've to use vtkProgrammableGlyphFilter.
 // Maybe refer to vtkTensorGlyph, 
 // No time. So let it go.
@@ -299,6 +369,9 @@ static void keyCallback( vtkObject* object,
 			print(ss.str().c_str());
 			break;
 		case 'u': // clear picked points
+			for(map<long long, vtkSmartPointer<vtkActor> >::iterator it = lodPickActors.begin(); it != lodPickActors.end(); ++it)
+				ren1->RemoveActor(it->second);
+			lodPickActors.clear();
 			for(int i=0; i<npts; ++i){
 				bool tmp = pickPtsIdx[i];
 				if(tmp) ren1->RemoveActor(pickActors[i]);
@@ -312,7 +385,35 @@ static void keyCallback( vtkObject* object,
 
 	rwi->Render();
 }
+// on the points shown in the last frame, window coordinates as vtk events
+void pickLod(int x, int y, vtkRenderer* ren1){
+	float pos[3];
+	long long id = lod->pick(lod_camera, lod_nodes, x, y, 5, pos);
+	stringstream ss;
+	ss << "CTRL pressed: " << "Picked id: " << id << endl;
+	if (id>-1) ss << "Global position: " << pos[0] << ", " << pos[1] << ", " << pos[2] << endl;
+	print(ss.str().c_str());
+	if (id<0) return;
+
+	map<long long, vtkSmartPointer<vtkActor> >::iterator it = lodPickActors.find(id);
+	if (it == lodPickActors.end()){
+		VTK_CREATE(vtkActor, sa);
+		sa->SetMapper(pickMapper);
+		sa->GetProperty()->SetColor(pointPickColor);
+		sa->SetPosition(pos[0], pos[1], pos[2]);
+		sa->SetPickable(0);
+		lodPickActors[id] = sa;
+		ren1->AddActor(sa);
+	}else{
+		ren1->RemoveActor(it->second);
+		lodPickActors.erase(it);
+	}
+}
 void pick(int x, int y, vtkRenderer* ren1, vtkRenderWindowInteractor* rwi){
+	if (lod){
+		pickLod(x, y, ren1);
+		return;
+	}
 	vtkPointPicker *picker = vtkPointPicker::SafeDownCast(rwi->GetPicker());
 	picker->Pick((double)x, (double)y, 0.0, ren1);
 
@@ -428,18 +529,33 @@ void mexFunction(int nlhs, mxArray*plhs[],
 	int scalars_dim(0);
 	double *scalars(0), *normals(0);
 
-	npts = mxGetM(prhs[0]);
-	pts = mxGetPr(prhs[0]);
-	if (nrhs > 1) {
-		scalars = mxGetPr(prhs[1]);
-		scalars_dim = mxGetN(prhs[1]);
-	}
-	if (nrhs > 2) {
-		normals = mxGetPr(prhs[2]);
-	}
-	if (nrhs > 3) {
-		radius = mxGetPr(prhs[3]);
-		radius_dim = mxGetN(prhs[3]);
+	if (mxIsChar(prhs[0])) {// show_pts_vtk(lodfile, threshold, budget), out of core
+		int buflen = (int)(mxGetM(prhs[0]) * mxGetN(prhs[0])) + 1;
+		char *filename = (char*) mxMalloc(buflen);
+		mxGetString(prhs[0], filename, buflen);
+		lod = new PointLodFile;
+		bool opened = lod->open(filename);
+		mxFree(filename);
+		if (!opened)
+			mexErrMsgTxt("can not open the lod file!");
+		if (nrhs > 1) lod_threshold = mxGetScalar(prhs[1]);
+		if (nrhs > 2) lod_budget = (long long)mxGetScalar(prhs[2]);
+		// no in-memory cloud: nothing left from a previous call is shown or picked
+		npts = 0; pts = 0; radius = 0; radius_dim = 0;
+	}else{
+		npts = mxGetM(prhs[0]);
+		pts = mxGetPr(prhs[0]);
+		if (nrhs > 1) {
+			scalars = mxGetPr(prhs[1]);
+			scalars_dim = mxGetN(prhs[1]);
+		}
+		if (nrhs > 2) {
+			normals = mxGetPr(prhs[2]);
+		}
+		if (nrhs > 3) {
+			radius = mxGetPr(prhs[3]);
+			radius_dim = mxGetN(prhs[3]);
+		}
 	}
 
 	plhs[0] = mxCreateDoubleMatrix(npts, 1, mxREAL);
@@ -453,7 +569,18 @@ void mexFunction(int nlhs, mxArray*plhs[],
 	initScene(render, renWin, rwi, style);
 
 	 /******************** prepare data. ****************************/
-	matlabDataToVtkPolyData(pts, npts, scalars, scalars_dim, normals, radius, radius_dim);	
+	if (lod){
+		// the root node until the first render, it covers the whole cloud
+		const double* bb = lod->header().bbox;
+		sphereRadius = sqrt(3.0)*(bb[3]-bb[0])*0.01;
+		pickSource->SetRadius(sphereRadius*pickRadiusRadio);
+		lod_nodes.assign(1, 0);
+		lodNodesToVtkPolyData(lod_nodes);
+		VTK_CREATE(vtkCallbackCommand, lodCommand);
+		lodCommand->SetCallback(lodCallback);
+		render->AddObserver(vtkCommand::StartEvent, lodCommand);
+	}else
+		matlabDataToVtkPolyData(pts, npts, scalars, scalars_dim, normals, radius, radius_dim);	
 	mapper->SetInput(polyData);
 	actor->SetMapper(mapper);
 	vtkProperty* prop = actor->GetProperty();
@@ -477,5 +604,11 @@ void mexFunction(int nlhs, mxArray*plhs[],
 	rwi->Initialize();
 	rwi->Start();
 
+	if (lod){
+		lodPickActors.clear();
+		lod_nodes.clear();
+		delete lod;
+		lod = 0;
+	}
 	mexPrintf("show_pts_vtk terminated correctly.\n");
 }